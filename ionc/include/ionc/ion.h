@@ -22,6 +22,8 @@
 #define ION_H_
 
 #include "ion_types.h"  /// ion_types.h includes ion_errors.h
+#include "ion_allocator.h"
+#include "ion_perf.h"
 #include "ion_string.h"
 #include "ion_timestamp.h"
 #include "ion_decimal.h"
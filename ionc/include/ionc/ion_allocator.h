@@ -0,0 +1,160 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**@file */
+
+/**
+ * Runtime allocators for the memory Ion allocates.
+ *
+ * Readers, writers and catalogs allocate in blocks that they (and everything they create, like symbol tables and
+ * temporary values) own, and free the blocks all at once when they are closed. By default those blocks come from a
+ * thread-local pool of pages that's backed by malloc. An allocator given in the reader or writer options, or to
+ * `ion_catalog_open_with_allocator`, is used for every block of that object instead, bypassing the page pool, so
+ * its memory can come from an arena or a huge page pool, and be counted separately from everything else.
+ *
+ * Blocks are freed with the allocator they came from, so the allocator must outlive the object. An allocator shared
+ * by objects that are used on different threads must be thread safe.
+ *
+ * Each thread's page pool only holds pages that thread freed, so pages freed on one thread (say, by a reader that was
+ * handed to a worker) can't be used by another. The shared page pool sits behind the threads' pools: a thread whose
+ * pool is full gives a batch of pages to it, and a thread whose pool is empty takes a batch back. It also keeps the
+ * blocks that are a few pages long, which would otherwise go back to the system every time.
+ */
+
+#ifndef ION_ALLOCATOR_H
+#define ION_ALLOCATOR_H
+
+#include "ion_types.h"
+#include "ion_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocates size bytes, aligned for any type, or returns NULL.
+ *
+ * @param context - The allocator's context.
+ */
+typedef void *(*ION_ALLOCATOR_ALLOC_FN)(void *context, SIZE size);
+
+/**
+ * Frees memory the same allocator allocated. Never called with NULL.
+ *
+ * @param context - The allocator's context.
+ */
+typedef void (*ION_ALLOCATOR_FREE_FN)(void *context, void *ptr);
+
+struct _ion_allocator {
+    ION_ALLOCATOR_ALLOC_FN alloc;
+    ION_ALLOCATOR_FREE_FN  free;
+
+    /**
+     * Passed to alloc and free. May be NULL.
+     */
+    void *context;
+};
+
+/**
+ * Replaces malloc and free as the allocator behind the page pool and everything else Ion allocates outside of an
+ * object with an allocator of its own, such as stream buffers and the digits of ION_INTs. The allocator is copied.
+ * Passing NULL restores malloc and free.
+ *
+ * This must be called before anything is allocated, since memory is always freed with the allocator that's current
+ * at that time.
+ */
+ION_API_EXPORT void ion_initialize_allocator(ION_ALLOCATOR *allocator);
+
+/**
+ * Sets the page size and the number of free pages the calling thread's page pool keeps.
+ */
+ION_API_EXPORT void ion_initialize_page_pool(SIZE page_size, int free_page_limit);
+
+/**
+ * Frees the pages in the calling thread's page pool, or gives them to the shared page pool if it's active, and
+ * stops the thread's pool. A worker thread calls this when it's done, so its pages don't sit unused.
+ */
+ION_API_EXPORT void ion_release_page_pool(void);
+
+typedef struct _ion_shared_page_pool_options {
+    /**
+     * The number of pages that move between a thread's pool and the shared pool at a time. If 0, 8.
+     */
+    int batch_size;
+
+    /**
+     * The number of free pages each thread keeps for itself while the shared pool is active. If 0, twice batch_size.
+     */
+    int thread_page_limit;
+
+    /**
+     * The number of block sizes the shared pool keeps: pages, and blocks of 2, 4, ... pages, up to
+     * 2^(size_class_count - 1) pages. Longer blocks always go back to the system. If 0, 4. At most 16.
+     */
+    int size_class_count;
+
+    /**
+     * The most memory the shared pool holds on to. Blocks freed while it's full go back to the system. If 0,
+     * 256 pages.
+     */
+    SIZE max_retained_bytes;
+
+} ION_SHARED_PAGE_POOL_OPTIONS;
+
+typedef struct _ion_shared_page_pool_stats {
+    /**
+     * Pages and blocks that were taken from the shared pool.
+     */
+    int64_t hits;
+
+    /**
+     * Pages and blocks that had to be allocated because the shared pool had none.
+     */
+    int64_t misses;
+
+    /**
+     * The memory the shared pool holds right now.
+     */
+    int64_t bytes_retained;
+
+} ION_SHARED_PAGE_POOL_STATS;
+
+/**
+ * Starts the shared page pool, which every thread's page pool then draws from and gives back to. Each of its stacks
+ * is guarded by a spin lock that's only held to link or unlink one batch of pages. It may be used by any number of
+ * threads, but it must be started before they allocate anything and released after they're done. The pages are those of the calling thread's page pool.
+ *
+ * @param options - May be NULL, for the defaults.
+ * @return IERR_INVALID_STATE if the shared page pool has already been started, IERR_INVALID_ARG if an option is out
+ *  of range.
+ */
+ION_API_EXPORT iERR ion_initialize_shared_page_pool(ION_SHARED_PAGE_POOL_OPTIONS *options);
+
+/**
+ * Gets the shared page pool's counters, which are zero while it isn't active. With other threads allocating, they
+ * may be a little behind.
+ */
+ION_API_EXPORT void ion_shared_page_pool_stats(ION_SHARED_PAGE_POOL_STATS *stats);
+
+/**
+ * Frees the memory the shared page pool holds and stops it. No other thread may be allocating while it's released.
+ * Pages left in threads' own pools stay there, and are freed as usual.
+ */
+ION_API_EXPORT void ion_release_shared_page_pool(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_ALLOCATOR_H
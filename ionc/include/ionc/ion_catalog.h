@@ -33,6 +33,14 @@ extern "C" {
  */
 ION_API_EXPORT iERR ion_catalog_open                      (hCATALOG *p_hcatalog);
 
+/**
+ * Allocates a new catalog with itself as its memory owner, like `ion_catalog_open`, whose memory comes from the given
+ * allocator. The symbol tables added to the catalog are copied into that memory too.
+ * @param p_hcatalog - Pointer to a handle to the newly-allocated catalog.
+ * @param allocator - The allocator, which must outlive the catalog. If NULL, this is the same as `ion_catalog_open`.
+ */
+ION_API_EXPORT iERR ion_catalog_open_with_allocator       (hCATALOG *p_hcatalog, ION_ALLOCATOR *allocator);
+
 /**
  * Allocates a new catalog with the given owner as its memory owner.
  * @param p_hcatalog - Pointer to a handle to the newly-allocated catalog.
@@ -46,6 +54,16 @@ ION_API_EXPORT iERR ion_catalog_find_symbol_table         (hCATALOG hcatalog, iS
 ION_API_EXPORT iERR ion_catalog_find_best_match           (hCATALOG hcatalog, iSTRING name, long version, hSYMTAB *p_symtab); // or newest version of a symtab pass in version == 0
 ION_API_EXPORT iERR ion_catalog_release_symbol_table      (hCATALOG hcatalog, hSYMTAB symtab);
 
+/**
+ * Freezes the given catalog, after which it, and every symbol table in it, is immutable and may be used by any number
+ * of readers and writers on any number of threads at once, without locking. Tables can no longer be added to or
+ * released from a frozen catalog (IERR_IS_IMMUTABLE). Load the shared symbol tables, freeze the catalog, then hand it
+ * to the readers and writers; it must outlive all of them, and must be closed by one thread once they're done.
+ * Freezing a frozen catalog does nothing.
+ */
+ION_API_EXPORT iERR ion_catalog_freeze                    (hCATALOG hcatalog);
+ION_API_EXPORT iERR ion_catalog_is_frozen                 (hCATALOG hcatalog, BOOL *p_is_frozen);
+
 /**
  * If the given catalog is its own memory owner, its memory and everything it owns is freed. If the given catalog has an
  * external owner and that owner has not been freed, this does nothing; this catalog will be freed when its memory owner
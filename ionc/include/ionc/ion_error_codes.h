@@ -92,6 +92,8 @@
     ERROR_CODE( IERR_INVALID_LEADING_ZEROS,     52 )
     ERROR_CODE( IERR_INVALID_LOB_TERMINATOR,    53 )
 
+    ERROR_CODE( IERR_NEED_MORE_DATA,            54 )
+
 
 // if it was defined we undefine it now
 #undef ERROR_CODE
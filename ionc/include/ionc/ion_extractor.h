@@ -311,6 +311,80 @@ ION_API_EXPORT iERR ion_extractor_path_append_ordinal(hPATH path, POSITION value
  */
 ION_API_EXPORT iERR ion_extractor_path_append_wildcard(hPATH path);
 
+/**
+ * How a value is compared to the operand of a predicate.
+ */
+typedef enum _ion_extractor_comparison {
+    ION_EXTRACTOR_EQUALS                    = 0,
+    ION_EXTRACTOR_NOT_EQUALS                = 1,
+    ION_EXTRACTOR_LESS_THAN                 = 2,
+    ION_EXTRACTOR_LESS_THAN_OR_EQUALS       = 3,
+    ION_EXTRACTOR_GREATER_THAN              = 4,
+    ION_EXTRACTOR_GREATER_THAN_OR_EQUALS    = 5,
+} ION_EXTRACTOR_COMPARISON;
+
+/**
+ * The following functions add a predicate to the last component appended to the given path (or, if none has been
+ * appended yet, to the top-level value the path starts from). A value matches the component only if it satisfies all
+ * of the component's predicates, so a value that doesn't is neither passed to the path's callback nor stepped into to
+ * match the rest of the path. For example, the path `(status)` with the predicate `== 500` only matches `status` fields
+ * whose value is 500, and the path `(message)` with the predicate that its top-level value be annotated `error` skips
+ * the contents of every top-level value that isn't.
+ *
+ * Predicates are evaluated by the extractor before any callback is invoked, without moving the reader off the value.
+ * On a binary reader they work on the value's encoded bytes and symbol IDs: integers, floats and timestamps aren't
+ * decoded into ION_INTs or ION_TIMESTAMPs (except timestamps with fractional seconds that are equal to the second), and
+ * symbols and annotations are compared by symbol ID.
+ *
+ * A comparison is only satisfied by a non-null value of the predicate's type, so for example `!= 500` isn't satisfied
+ * by `null.int` or `"abc"`.
+ *
+ * Calling these functions will fail if the given path was not created using `ion_extractor_path_create`.
+ *
+ * @param path - A path which has already been registered to an extractor by calling `ion_extractor_path_create`.
+ * @return a non-zero error code in the case of failure, otherwise IERR_OK.
+ */
+
+/**
+ * Requires an integer that compares to the given one as specified.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_int(hPATH path, ION_EXTRACTOR_COMPARISON comparison, int64_t value);
+
+/**
+ * Requires a float that compares to the given one as specified. NaN satisfies only ION_EXTRACTOR_NOT_EQUALS.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_float(hPATH path, ION_EXTRACTOR_COMPARISON comparison, double value);
+
+/**
+ * Requires a string or a symbol whose text compares to the given text as specified. Text is ordered by its UTF-8 bytes.
+ * Symbols with unknown text satisfy only ION_EXTRACTOR_NOT_EQUALS.
+ *
+ * Ownership: the caller owns the value, but is not required to keep it accessible after this call.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_text(hPATH path, ION_EXTRACTOR_COMPARISON comparison,
+                                                    ION_STRING *value);
+
+/**
+ * Requires a timestamp that compares to the given one as specified. Timestamps are compared as points in time, so
+ * `2020T` equals `2020-01-01T00:00Z`, and timestamps with an unknown local offset are treated as UTC.
+ *
+ * Ownership: the caller owns the value, but is not required to keep it accessible after this call.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_timestamp(hPATH path, ION_EXTRACTOR_COMPARISON comparison,
+                                                         ION_TIMESTAMP *value);
+
+/**
+ * Requires a value with the given annotation, of any type.
+ *
+ * Ownership: the caller owns the annotation, but is not required to keep it accessible after this call.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_annotation(hPATH path, ION_STRING *annotation);
+
+/**
+ * Requires a value that isn't null, of any type.
+ */
+ION_API_EXPORT iERR ion_extractor_path_require_non_null(hPATH path);
+
 /**
  * Registers a path from text or binary Ion data. The data must contain exactly one top-level value: an ordered sequence
  * (list or sexp) containing a number of elements less than or equal to the extractor's `max_path_length`. The elements
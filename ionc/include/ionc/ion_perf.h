@@ -0,0 +1,165 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**@file */
+
+/**
+ * Performance counters, for measuring where Ion spends its time and memory on a given workload.
+ *
+ * While counting is enabled, readers and writers mark the phase of their work the calling thread is in: reading input
+ * from a stream's source, decoding values, resolving symbols, or writing values. Marking a phase only stores it, so
+ * that it's cheap enough to do for every value; the time spent in each phase is measured by sampling. A profiling
+ * timer (for example setitimer's ITIMER_PROF for CPU time, and ITIMER_REAL for wall time) calls `ion_perf_sample`
+ * from its signal handler, which counts a sample against the phase the thread was interrupted in. Each phase's share
+ * of the samples is its share of the time.
+ *
+ * Readers and writers also count the values they read and write by type, and the bytes that pass through their
+ * streams. The allocator counts what it allocates, and how often the page pool has a page to hand out.
+ *
+ * The counters are kept per thread, and each thread reads and resets its own. While counting is disabled the hooks
+ * cost a branch each, and only the memory held in blocks (and its peak) is kept up to date.
+ */
+
+#ifndef ION_PERF_H
+#define ION_PERF_H
+
+#include "ion_types.h"
+#include "ion_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _ion_perf_phase {
+    /**
+     * Outside of Ion, in the caller's own code.
+     */
+    ION_PERF_PHASE_NONE = 0,
+
+    /**
+     * Reading from the file, descriptor or handler behind a stream, to fill its buffer.
+     */
+    ION_PERF_PHASE_READ,
+
+    /**
+     * Moving a reader between values, and decoding them.
+     */
+    ION_PERF_PHASE_DECODE,
+
+    /**
+     * Loading local symbol tables, and looking symbols up by ID or by text, for readers and writers.
+     */
+    ION_PERF_PHASE_SYMBOLS,
+
+    /**
+     * Encoding values in a writer, and flushing them to the stream's destination.
+     */
+    ION_PERF_PHASE_WRITE,
+
+    ION_PERF_PHASE_COUNT
+} ION_PERF_PHASE;
+
+typedef enum _ion_perf_clock {
+    ION_PERF_CLOCK_WALL = 0,
+    ION_PERF_CLOCK_CPU,
+    ION_PERF_CLOCK_COUNT
+} ION_PERF_CLOCK;
+
+/**
+ * The number of value types counted, and the index of a type (tid_NULL through tid_DATAGRAM) among them.
+ */
+#define ION_PERF_TYPE_COUNT         16
+#define ION_PERF_TYPE_INDEX(type)   ((int)(ION_TYPE_INT(type) >> 8))
+
+typedef struct _ion_perf_phase_stats {
+    /**
+     * The number of times the thread entered the phase from another one.
+     */
+    int64_t calls;
+
+    /**
+     * The samples taken with each clock while the thread was in the phase.
+     */
+    int64_t samples[ION_PERF_CLOCK_COUNT];
+
+} ION_PERF_PHASE_STATS;
+
+typedef struct _ion_perf_stats {
+    ION_PERF_PHASE_STATS phases[ION_PERF_PHASE_COUNT];
+
+    /**
+     * Values readers moved to, and values writers wrote, by ION_PERF_TYPE_INDEX of their type. A container counts
+     * once, as does each value in it, except that a binary container ion_writer_write_one_value copies as it is counts
+     * only once.
+     */
+    int64_t values_read[ION_PERF_TYPE_COUNT];
+    int64_t values_written[ION_PERF_TYPE_COUNT];
+
+    /**
+     * Bytes readers consumed from their streams, counted when a reader seeks or is closed, and bytes written to
+     * streams' files, descriptors and handlers.
+     */
+    int64_t bytes_read;
+    int64_t bytes_written;
+
+    /**
+     * Calls to malloc and free, or to the allocator given to ion_initialize_allocator.
+     */
+    int64_t allocations;
+    int64_t frees;
+
+    /**
+     * The blocks readers, writers and catalogs allocated in, and the memory held in blocks now and at most. Memory a
+     * thread frees is subtracted from that thread's counters, even if another thread allocated it.
+     */
+    int64_t blocks_allocated;
+    int64_t block_bytes;
+    int64_t peak_block_bytes;
+
+    /**
+     * Blocks taken from the page pools (the thread's own, or the shared one), and blocks that had to be allocated
+     * because the pools had none.
+     */
+    int64_t page_pool_hits;
+    int64_t page_pool_misses;
+
+} ION_PERF_STATS;
+
+/**
+ * Starts or stops counting, on every thread. Counting should be started before the readers and writers to be
+ * measured are opened, so that their symbol tables and first pages are counted.
+ */
+ION_API_EXPORT void ion_perf_enable(BOOL enabled);
+
+/**
+ * Zeroes the calling thread's counters, except for the memory held in blocks, which becomes the new peak.
+ */
+ION_API_EXPORT void ion_perf_reset(void);
+
+/**
+ * Gets the calling thread's counters.
+ */
+ION_API_EXPORT void ion_perf_get_stats(ION_PERF_STATS *stats);
+
+/**
+ * Counts a sample against the phase the calling thread is in, if counting is enabled. Safe to call from a signal
+ * handler.
+ */
+ION_API_EXPORT void ion_perf_sample(ION_PERF_CLOCK clock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_PERF_H
@@ -21,6 +21,7 @@
 #define ION_READER_H_
 #include "ion_types.h"
 #include "ion_stream.h"
+#include "ion_timestamp.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -149,6 +150,21 @@ typedef struct _ion_reader_options
      */
     ION_READER_CONTEXT_CHANGE_NOTIFIER context_change_notifier;
 
+    /** The allocator for all of the reader's memory: the reader, its symbol tables and the values it returns. It must
+     *  outlive the reader. If NULL, the memory comes from the page pool. See ion_allocator.h.
+     *
+     */
+    ION_ALLOCATOR *allocator;
+
+    /** If non-zero, the memory the reader uses for the values it returns (strings, symbols, lobs, field names and
+     *  annotations that are copied out of the input) is a scratch arena of at least this many bytes that's rewound at
+     *  every top-level ion_reader_next, rather than a pool that's freed and allocated again for every top-level
+     *  value. A top-level value that doesn't fit is still read, and the arena grows to fit it the next time it's
+     *  rewound, so a long-lived reader settles on a fixed footprint and stops allocating. As with the pool, what was
+     *  returned for one top-level value is only valid until the reader moves to the next.
+     */
+    SIZE scratch_arena_size;
+
 } ION_READER_OPTIONS;
 
 //
@@ -223,6 +239,41 @@ ION_API_EXPORT iERR ion_reader_open_stream(hREADER *p_hreader
                                           ,ION_STREAM_HANDLER fn_input_handler
                                           ,ION_READER_OPTIONS *p_options);
 
+/**
+ * Allocates a new reader whose input is pushed to it by the application
+ * with ion_reader_push as it arrives, instead of being pulled from a buffer or a
+ * stream handler. When the next top level value hasn't been pushed in full,
+ * ion_reader_next returns IERR_NEED_MORE_DATA and leaves the reader where it was,
+ * so the application can push more bytes and call ion_reader_next again without
+ * anything being rescanned. A value is only returned once all of its bytes are
+ * available, so stepping into and reading it never waits.
+ *
+ * The input is binary if it starts with the binary version marker, and text
+ * otherwise. Until the first call to ion_reader_next that has bytes to look at,
+ * the reader acts as a binary reader. A top level text symbol, number or long
+ * string is returned once the token after it has been pushed too (as that may
+ * make it an annotation or continue it), or once the input has ended.
+ *
+ * @param p_hreader will receive a pointer to the new reader.
+ *   It must be freed via ion_reader_close().
+ * @param p_options may be null, in that case, default value will be used.
+ */
+ION_API_EXPORT iERR ion_reader_open_push(hREADER *p_hreader, ION_READER_OPTIONS *p_options);
+
+/**
+ * Gives a reader opened with ion_reader_open_push the next length bytes of its input.
+ * The bytes are copied. Strings and lobs read as views (see ion_reader_read_string_view)
+ * are only valid until the next push.
+ */
+ION_API_EXPORT iERR ion_reader_push(hREADER hreader, BYTE *buffer, SIZE length);
+
+/**
+ * Tells a reader opened with ion_reader_open_push that all of its input has been pushed.
+ * After this ion_reader_next returns tid_EOF (or fails, if the input ends part way
+ * through a value) rather than IERR_NEED_MORE_DATA.
+ */
+ION_API_EXPORT iERR ion_reader_push_eof(hREADER hreader);
+
 /** Resets input stream for given reader.
  *
  * readers' current stream would be closed and would be initialized with given stream.
@@ -397,6 +448,34 @@ ION_API_EXPORT iERR ion_reader_read_ion_decimal    (hREADER hreader, ION_DECIMAL
  */
 ION_API_EXPORT iERR ion_reader_read_timestamp      (hREADER hreader, iTIMESTAMP p_value);
 
+/**
+ * Reads the values that follow in the current list or s-expression into p_values, up to max_count of them, as
+ * ion_reader_next and ion_reader_read_int64 would one at a time. Fewer than max_count are read only if the container
+ * ends, in which case the reader is left at its end. Otherwise it's left on the last value, which has been read. The
+ * binary reader decodes plain values straight out of its buffer, which is much faster than calling next for each one.
+ *
+ * @param p_count - The number of values read, including when a value fails.
+ * @return IERR_INVALID_STATE if the reader isn't in a list or s-expression, or a value isn't an int. Other errors,
+ *  like IERR_NULL_VALUE and IERR_NUMERIC_OVERFLOW, are those of ion_reader_read_int64.
+ */
+ION_API_EXPORT iERR ion_reader_read_int64_array    (hREADER hreader, int64_t *p_values, SIZE max_count, SIZE *p_count);
+
+/**
+ * As ion_reader_read_int64_array, for floats, as read by ion_reader_read_double.
+ */
+ION_API_EXPORT iERR ion_reader_read_double_array   (hREADER hreader, double *p_values, SIZE max_count, SIZE *p_count);
+
+/**
+ * As ion_reader_read_int64_array, for bools, as read by ion_reader_read_bool.
+ */
+ION_API_EXPORT iERR ion_reader_read_bool_array     (hREADER hreader, BOOL *p_values, SIZE max_count, SIZE *p_count);
+
+/**
+ * As ion_reader_read_int64_array, for timestamps, as seconds since the epoch from ion_timestamp_to_time_t. Fractional
+ * seconds are dropped.
+ */
+ION_API_EXPORT iERR ion_reader_read_timestamp_epoch_array(hREADER hreader, time_t *p_values, SIZE max_count, SIZE *p_count);
+
 /** Read the current symbol value as an ION_SYMBOL.
  */
 ION_API_EXPORT iERR ion_reader_read_ion_symbol(hREADER hreader, ION_SYMBOL *p_symbol);
@@ -415,12 +494,32 @@ ION_API_EXPORT iERR ion_reader_get_string_length   (hREADER hreader, SIZE *p_len
 ION_API_EXPORT iERR ion_reader_read_string         (hREADER hreader, iSTRING p_value);
 ION_API_EXPORT iERR ion_reader_read_partial_string (hREADER hreader, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
 
+/**
+ * Like ion_reader_read_string, but for binary input the returned string
+ * points directly into the input stream's buffer whenever the value's bytes
+ * are contiguous there (always the case for buffers opened with
+ * ion_reader_open_buffer and for memory mapped streams). Only a value that
+ * straddles a page boundary of a paged stream is copied. Symbol text is
+ * returned from the symbol table without copying.
+ *
+ * The view is borrowed: it is only valid until the reader is next moved
+ * (ion_reader_next, step in/out, seek) and must not be modified.
+ */
+ION_API_EXPORT iERR ion_reader_read_string_view    (hREADER hreader, iSTRING p_value);
+
 // TODO: move this to get_value_size, get_value_bytes, get_value_chuck that can read
 //       string, long int, decimal and timestamp values in addition to blob and clob
 ION_API_EXPORT iERR ion_reader_get_lob_size          (hREADER hreader, SIZE *p_length); // this may require the lob value to be loaded in memroy
 ION_API_EXPORT iERR ion_reader_read_lob_bytes        (hREADER hreader, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
 ION_API_EXPORT iERR ion_reader_read_lob_partial_bytes(hREADER hreader, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
 
+/**
+ * Returns the whole contents of the current blob or clob as a borrowed view,
+ * with the same lifetime and copy rules as ion_reader_read_string_view.
+ * p_value->length is the number of bytes in the lob.
+ */
+ION_API_EXPORT iERR ion_reader_read_lob_view         (hREADER hreader, iSTRING p_value);
+
 ION_API_EXPORT iERR ion_reader_get_position          (hREADER hreader, int64_t *p_bytes, int32_t *p_line, int32_t *p_offset);
 
 /**
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**@file */
+
+/**
+ * A sidecar offset index over the top-level values ("records") of an Ion stream.
+ *
+ * Building the index is a single pass with a reader. For each record it writes the record's offset and length, an
+ * optional user supplied key, and the symbol table context the record was written in. Records are stored in fixed
+ * width slots, so positioning a reader at record N takes no scanning. Finding a key is a binary search. Before the
+ * reader is positioned, the symbol table that was in effect for the record is restored, so symbols read correctly
+ * without reading the symbol tables that come before the record in the data.
+ */
+
+#ifndef ION_READER_INDEX_H
+#define ION_READER_INDEX_H
+
+#include "ion.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _ion_reader_index ION_READER_INDEX;
+typedef ION_READER_INDEX *hREADER_INDEX;
+
+/**
+ * Computes the key of the record the reader is positioned on. The reader is positioned on the record but has not
+ * read it, and the callback may read it (including stepping in, as long as it steps back out). Keys must not
+ * decrease from one record to the next.
+ *
+ * @param reader - The reader building the index, positioned on a top-level value.
+ * @param user_context - The key_context from the index options.
+ * @param p_key - The record's key (output parameter).
+ */
+typedef iERR (*ION_READER_INDEX_KEY_FN)(hREADER reader, void *user_context, int64_t *p_key);
+
+/**
+ * Index configuration to be supplied by the user when building an index.
+ */
+typedef struct _ion_reader_index_options {
+    /**
+     * Computes the key of each record. May be null, in which case each record's key is its record number.
+     */
+    ION_READER_INDEX_KEY_FN key_fn;
+
+    /**
+     * Passed to key_fn. Opaque to the index, and may be null.
+     */
+    void *key_context;
+
+} ION_READER_INDEX_OPTIONS;
+
+/**
+ * Reads every top-level value from the reader and writes an index over them to index_stream.
+ *
+ * @param reader - A reader which has been opened but not yet advanced. Its offsets must be the offsets of the data the
+ *  index will later be opened with (i.e. the reader should be reading from the beginning of that data).
+ * @param index_stream - A writable stream that receives the index.
+ * @param options - Configuration options. May be null, in which case record numbers are used as keys.
+ * @param p_record_count - The number of records indexed (output parameter). May be null.
+ * @return IERR_INVALID_ARG if a key is less than the key of the record before it, otherwise any reader, writer or
+ *  stream error, or IERR_OK.
+ */
+ION_API_EXPORT iERR ion_reader_index_build(hREADER reader, ION_STREAM *index_stream, ION_READER_INDEX_OPTIONS *options,
+                                           int64_t *p_record_count);
+
+/**
+ * Opens an index over the data being read by reader.
+ *
+ * @param p_index - A non-null pointer to the resulting index. The caller must free it using `ion_reader_index_close`.
+ * @param reader - A reader over the data the index was built from. Its stream must support seeking.
+ * @param index - The bytes of the index, as written by `ion_reader_index_build`.
+ * @param index_length - The length of index in bytes.
+ *
+ * Ownership: the caller owns the reader and the index bytes, and must keep both until the index is closed. Symbol
+ * tables restored by the index are allocated on the reader.
+ */
+ION_API_EXPORT iERR ion_reader_index_open(hREADER_INDEX *p_index, hREADER reader, BYTE *index, SIZE index_length);
+
+/**
+ * Memory maps the data file and its index file and opens a reader and an index over them. Use
+ * `ion_reader_index_get_reader` to get the reader. Closing the index closes the reader and both files.
+ *
+ * @param p_index - A non-null pointer to the resulting index. The caller must free it using `ion_reader_index_close`.
+ * @param data_path - The path of the Ion data file.
+ * @param index_path - The path of the index built from that file.
+ * @param options - Options for the reader. May be null.
+ */
+ION_API_EXPORT iERR ion_reader_index_open_path(hREADER_INDEX *p_index, const char *data_path, const char *index_path,
+                                               ION_READER_OPTIONS *options);
+
+ION_API_EXPORT iERR ion_reader_index_get_reader(hREADER_INDEX index, hREADER *p_reader);
+ION_API_EXPORT iERR ion_reader_index_get_record_count(hREADER_INDEX index, int64_t *p_count);
+
+/**
+ * Returns the offset, length and key of a record without moving the reader. Any of the output parameters may be null.
+ * The length is -1 for records whose length the reader couldn't report while indexing, such as text containers.
+ */
+ION_API_EXPORT iERR ion_reader_index_get_record(hREADER_INDEX index, int64_t record, POSITION *p_offset,
+                                                SIZE *p_length, int64_t *p_key);
+
+/**
+ * Positions the reader just before the given record and restores the symbol table in effect for it, so that the next
+ * call to `ion_reader_next` returns the record. Reading may continue past the record into the ones after it.
+ *
+ * @return IERR_INVALID_ARG if record is negative or not less than the record count.
+ */
+ION_API_EXPORT iERR ion_reader_index_seek_record(hREADER_INDEX index, int64_t record);
+
+/**
+ * Positions the reader just before the first record whose key is greater than or equal to key, as
+ * `ion_reader_index_seek_record` does.
+ *
+ * @param p_record - The record that was found (output parameter). May be null. When every key is less than key, this
+ *  is the record count and the reader is positioned so that the next call to `ion_reader_next` returns tid_EOF.
+ */
+ION_API_EXPORT iERR ion_reader_index_seek_key(hREADER_INDEX index, int64_t key, int64_t *p_record);
+
+ION_API_EXPORT iERR ion_reader_index_close(hREADER_INDEX index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_READER_INDEX_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**@file */
+
+/**
+ * Splits a buffer of Ion into work units that independent readers can read in parallel.
+ *
+ * Opening a split pre-scans the buffer. For binary Ion the pre-scan looks only at type descriptors and lengths, so it
+ * skips over value bodies without reading them. It finds the top-level values and the symbol tables between them.
+ * Consecutive top-level values that were written with the same symbol table are grouped into units of roughly the
+ * requested size. Only the symbol tables themselves are read during the pre-scan.
+ *
+ * Text Ion is pre-scanned in parallel, in chunks that each thread lexes for quotes, comments and brackets only. Since
+ * a chunk may start inside a long string or a comment, each chunk is lexed for every state it might start in, and the
+ * chunks are chained together afterwards. Text is split only after top-level containers and around system values, so
+ * top-level scalars stay in the unit of the container before them.
+ *
+ * A unit is an offset range and the symbol table that is in effect for it. Positioning a reader on a unit restores the
+ * table, so a reader can start reading at any unit without reading the data before it. `ion_reader_split_run` does
+ * this with a pool of threads, each with a reader of its own over the same buffer.
+ */
+
+#ifndef ION_READER_SPLIT_H
+#define ION_READER_SPLIT_H
+
+#include "ion.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _ion_reader_split ION_READER_SPLIT;
+typedef ION_READER_SPLIT *hREADER_SPLIT;
+
+/**
+ * Processes one unit. It is called concurrently from several threads, each time with a reader of the calling
+ * thread's own. The reader is positioned so that `ion_reader_next` returns the unit's first value, and then tid_EOF
+ * after the unit's last value.
+ *
+ * @param reader - A reader positioned on the unit.
+ * @param unit - The unit's number. Units are in the order of the data, but they may be processed in any order.
+ * @param user_context - The user_context given to `ion_reader_split_run`.
+ * @return IERR_OK to continue. Any other value stops the run, and the run returns it.
+ */
+typedef iERR (*ION_READER_SPLIT_FN)(hREADER reader, int64_t unit, void *user_context);
+
+/**
+ * Pre-scans a buffer of Ion and splits it into units.
+ *
+ * @param p_split - A non-null pointer to the resulting split. The caller must free it using `ion_reader_split_close`.
+ * @param buffer - The binary or text Ion to split. Binary Ion must start with the Ion version marker.
+ * @param buffer_length - The length of buffer in bytes.
+ * @param unit_size - The approximate size of a unit in bytes. A unit ends with the first value (in text, the first
+ *  top-level container) that takes it past unit_size, or before a symbol table. If 0, a default of 256KB is used.
+ * @param options - The options every reader over the buffer is opened with. May be null. When a catalog is given it
+ *  is used to resolve the imports of the symbol tables during the pre-scan.
+ * @return IERR_INVALID_ARG if options ask for system values to be returned, IERR_INVALID_BINARY if binary Ion is
+ *  malformed, IERR_INVALID_SYNTAX, IERR_NEW_LINE_IN_STRING or IERR_UNEXPECTED_EOF if the brackets, quotes or comments
+ *  of text Ion don't match up, otherwise any reader error, or IERR_OK.
+ *
+ * Ownership: the caller owns the buffer, and must keep it until the split is closed.
+ */
+ION_API_EXPORT iERR ion_reader_split_open_buffer(hREADER_SPLIT *p_split, BYTE *buffer, SIZE buffer_length,
+                                                 SIZE unit_size, ION_READER_OPTIONS *options);
+
+/**
+ * Memory maps a file of Ion and splits it, as `ion_reader_split_open_buffer` does. Closing the split unmaps
+ * the file.
+ */
+ION_API_EXPORT iERR ion_reader_split_open_path(hREADER_SPLIT *p_split, const char *path, SIZE unit_size,
+                                               ION_READER_OPTIONS *options);
+
+ION_API_EXPORT iERR ion_reader_split_get_unit_count(hREADER_SPLIT split, int64_t *p_count);
+
+/**
+ * Returns where a unit is in the buffer and which top-level values it holds. Any of the output parameters may be
+ * null. Top-level values are numbered from 0 in the order of the data, not counting symbol tables. The text pre-scan
+ * doesn't count values, so for text the first value and the value count are -1.
+ */
+ION_API_EXPORT iERR ion_reader_split_get_unit(hREADER_SPLIT split, int64_t unit, POSITION *p_offset, SIZE *p_length,
+                                              int64_t *p_first_value, int64_t *p_value_count);
+
+/**
+ * Opens a reader over the split's buffer, with the split's reader options, for use with `ion_reader_split_seek_unit`.
+ * The caller must close it using `ion_reader_close` before closing the split.
+ */
+ION_API_EXPORT iERR ion_reader_split_open_reader(hREADER_SPLIT split, hREADER *p_reader);
+
+/**
+ * Restores the symbol table in effect for a unit and positions the reader on it, so that `ion_reader_next` returns
+ * the unit's first value, and then tid_EOF after the unit's last value.
+ *
+ * @param reader - A reader opened with `ion_reader_split_open_reader` on this split.
+ * @return IERR_INVALID_ARG if unit is negative or not less than the unit count.
+ */
+ION_API_EXPORT iERR ion_reader_split_seek_unit(hREADER_SPLIT split, hREADER reader, int64_t unit);
+
+/**
+ * Calls fn once for every unit, from thread_count threads. The calling thread is one of them. Each thread opens
+ * a reader of its own and takes the next unit nobody has taken until they run out.
+ *
+ * The readers only read the symbol tables the split loaded during the pre-scan, which are immutable. Anything else
+ * fn shares between threads is up to fn to synchronize. Threads are started with pthreads, or on Windows with
+ * _beginthreadex. A thread that can't be started leaves its share of the units to the others, so at worst every unit
+ * is processed on the calling thread.
+ *
+ * @param thread_count - The number of threads to use. If 0 or less, one per online processor is used.
+ * @return The first error returned by fn or a reader, or IERR_OK when every unit was processed.
+ */
+ION_API_EXPORT iERR ion_reader_split_run(hREADER_SPLIT split, int thread_count, ION_READER_SPLIT_FN fn,
+                                         void *user_context);
+
+ION_API_EXPORT iERR ion_reader_split_close(hREADER_SPLIT split);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_READER_SPLIT_H
@@ -168,10 +168,24 @@ struct _ion_user_stream
 
 typedef struct _ion_stream_user_paged ION_STREAM_USER_PAGED;
 typedef struct _ion_stream_paged  ION_STREAM_PAGED;
+typedef struct _ion_stream_mmap   ION_STREAM_MMAP;
+typedef struct _ion_stream_push   ION_STREAM_PUSH;
 typedef struct _ion_page          ION_PAGE;
 typedef int32_t                   PAGE_ID;
 typedef int64_t                   POSITION;
 
+/** Access pattern hints for memory mapped input streams. These are passed
+ *  through to the operating system (via posix_madvise) and only affect how
+ *  aggressively the mapped file is read ahead, never the stream contents.
+ *  Windows has no equivalent for a mapped view, so they're ignored there.
+ */
+typedef enum _ion_stream_mmap_advice {
+    ION_STREAM_MMAP_ADVICE_NORMAL     = 0,
+    ION_STREAM_MMAP_ADVICE_SEQUENTIAL = 1,   // values will be read front to back (e.g. ion_reader_next loops)
+    ION_STREAM_MMAP_ADVICE_RANDOM     = 2,   // values will be visited through ion_reader_seek
+    ION_STREAM_MMAP_ADVICE_WILLNEED   = 3    // the whole file is expected to be read soon
+} ION_STREAM_MMAP_ADVICE;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 //                     public constructors
@@ -202,6 +216,49 @@ ION_API_EXPORT iERR ion_stream_open_fd_in(int fd_in, ION_STREAM **pp_stream);
 ION_API_EXPORT iERR ion_stream_open_fd_out(int fd_out, ION_STREAM **pp_stream);
 ION_API_EXPORT iERR ion_stream_open_fd_rw(int fd, BOOL cache_all, ION_STREAM **pp_stream);
 
+/** Opens a read only stream over a memory mapping of the file open on fd.
+ *  The whole file is exposed as a single buffer, the same way a user
+ *  buffer is (see ion_stream_open_buffer), so reads, skips and seeks
+ *  are pointer arithmetic over the mapping with no page allocation and
+ *  no copying. The caller retains ownership of fd, which may be closed
+ *  once this returns. The file must not be truncated while the stream
+ *  is open. The file is mapped with mmap, or on Windows with
+ *  CreateFileMapping and MapViewOfFile. Returns IERR_INVALID_ARG if fd
+ *  isn't a regular file (a pipe, socket or terminal), which should be
+ *  read with ion_stream_open_fd_in instead.
+ */
+ION_API_EXPORT iERR ion_stream_open_mmap(int fd, ION_STREAM_MMAP_ADVICE advice, ION_STREAM **pp_stream);
+
+/** Same as ion_stream_open_mmap, but opens (and closes) the file at path itself.
+ */
+ION_API_EXPORT iERR ion_stream_open_mmap_path(const char *path, ION_STREAM_MMAP_ADVICE advice, ION_STREAM **pp_stream);
+
+/** Changes the access pattern hint on a stream opened with ion_stream_open_mmap,
+ *  for example to switch from a sequential scan to random access via seek.
+ */
+ION_API_EXPORT iERR ion_stream_mmap_advise(ION_STREAM *stream, ION_STREAM_MMAP_ADVICE advice);
+
+/** Opens an empty read only stream that the application fills by pushing
+ *  chunks of input with ion_stream_push as they arrive (for example from a
+ *  non-blocking socket). Reads never block or call back, running out of
+ *  pushed bytes looks like the end of the input. ion_stream_push_eof marks
+ *  the real end of the input. See ion_reader_open_push.
+ */
+ION_API_EXPORT iERR ion_stream_open_push(ION_STREAM **pp_stream);
+
+/** Appends a copy of length bytes from buffer to a stream opened with
+ *  ion_stream_open_push. Bytes that have already been read (and aren't
+ *  held by a mark) are discarded to make room, so pointers into the
+ *  stream's buffer are only valid until the next push. Positions are
+ *  unchanged by a push.
+ */
+ION_API_EXPORT iERR ion_stream_push(ION_STREAM *stream, BYTE *buffer, SIZE length);
+
+/** Marks the end of the input on a stream opened with ion_stream_open_push.
+ *  No more bytes may be pushed after this.
+ */
+ION_API_EXPORT iERR ion_stream_push_eof(ION_STREAM *stream);
+
 ION_API_EXPORT iERR ion_stream_flush(ION_STREAM *stream);
 ION_API_EXPORT iERR ion_stream_close(ION_STREAM *stream);
 
@@ -215,6 +272,8 @@ ION_API_EXPORT BOOL      ion_stream_can_read          (ION_STREAM *stream);
 ION_API_EXPORT BOOL      ion_stream_can_write         (ION_STREAM *stream);
 ION_API_EXPORT BOOL      ion_stream_can_seek          (ION_STREAM *stream);
 ION_API_EXPORT BOOL      ion_stream_can_mark          (ION_STREAM *stream);
+ION_API_EXPORT BOOL      ion_stream_is_mmap           (ION_STREAM *stream);
+ION_API_EXPORT BOOL      ion_stream_is_push           (ION_STREAM *stream);
 ION_API_EXPORT BOOL      ion_stream_is_dirty          (ION_STREAM *stream);
 ION_API_EXPORT BOOL      ion_stream_is_mark_open      (ION_STREAM *stream);
 ION_API_EXPORT POSITION  ion_stream_get_position      (ION_STREAM *stream);
@@ -143,6 +143,7 @@ typedef struct _ion_int                 ION_INT;
 typedef struct _ion_decimal             ION_DECIMAL;
 typedef struct _ion_timestamp           ION_TIMESTAMP;
 typedef struct _ion_collection          ION_COLLECTION;
+typedef struct _ion_allocator           ION_ALLOCATOR;
 
 #ifndef ION_STREAM_DECL
 #define ION_STREAM_DECL
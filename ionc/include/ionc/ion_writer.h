@@ -115,6 +115,21 @@ typedef struct _ion_writer_options
      */
     BOOL compact_floats;
 
+    /** Binary only. Normally the length of each container (and of annotation wrappers and lobs whose length isn't
+     *  known up front) is kept on a patch list and merged with the values when they are flushed to the output.
+     *  When enabled, the writer instead reserves a fixed width, zero padded length in place when the container is
+     *  started and fills it in when the container is finished, so flushing is a straight copy. This costs up to
+     *  four extra bytes per container, and such values may not be longer than 2^28-1 bytes.
+     *
+     */
+    BOOL pad_container_lengths;
+
+    /** The allocator for all of the writer's memory: the writer, its symbol tables and its buffered values. It must
+     *  outlive the writer. If NULL, the memory comes from the page pool. See ion_allocator.h.
+     *
+     */
+    ION_ALLOCATOR *allocator;
+
 } ION_WRITER_OPTIONS;
 
 
@@ -241,6 +256,27 @@ ION_API_EXPORT iERR ion_writer_write_ion_int        (hWRITER hwriter, ION_INT *v
 ION_API_EXPORT iERR ion_writer_write_double         (hWRITER hwriter, double value);
 ION_API_EXPORT iERR ion_writer_write_float          (hWRITER hwriter, float value);
 
+/**
+ * Writes a whole list or s-expression of ints, as ion_writer_start_container, an ion_writer_write_int64 for each
+ * value and ion_writer_finish_container would, with any field name and annotations that have been set. The binary
+ * writer works out the container's length first, so it writes the header once and encodes the values straight into
+ * its buffer, which is much faster than writing them one at a time.
+ *
+ * @param container_type - tid_LIST or tid_SEXP.
+ * @return IERR_INVALID_ARG if container_type isn't a list or s-expression.
+ */
+ION_API_EXPORT iERR ion_writer_write_int64_array    (hWRITER hwriter, ION_TYPE container_type, int64_t *p_values, SIZE count);
+
+/**
+ * As ion_writer_write_int64_array, for floats, as written by ion_writer_write_double.
+ */
+ION_API_EXPORT iERR ion_writer_write_double_array   (hWRITER hwriter, ION_TYPE container_type, double *p_values, SIZE count);
+
+/**
+ * As ion_writer_write_int64_array, for bools, as written by ion_writer_write_bool.
+ */
+ION_API_EXPORT iERR ion_writer_write_bool_array     (hWRITER hwriter, ION_TYPE container_type, BOOL *p_values, SIZE count);
+
 /**
  * @deprecated use of decQuads directly is deprecated. ION_DECIMAL should be used. See `ion_writer_write_ion_decimal`.
  */
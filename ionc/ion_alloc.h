@@ -17,6 +17,8 @@
 
 #include <ionc/ion_types.h>
 #include <ionc/ion_platform_config.h>
+#include <ionc/ion_allocator.h>
+#include "ion_atomic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,11 +71,21 @@ ION_API_EXPORT void        ion_alloc_free      (void *ptr);
 
     #include <stdlib.h>
 
-    #define ion_xalloc(sz)  malloc(sz)
-    #define ion_xfree(ptr)  free(ptr)
+    #define ion_xalloc(sz)  _ion_xalloc(sz)
+    #define ion_xfree(ptr)  _ion_xfree(ptr)
 
 #endif
 
+// the allocator set by ion_initialize_allocator, malloc and free while alloc is NULL
+GLOBAL ION_ALLOCATOR g_ion_allocator
+#ifdef INIT_STATICS
+= { NULL, NULL, NULL }
+#endif
+;
+
+void *_ion_xalloc(SIZE size);
+void  _ion_xfree (void *ptr);
+
 //#ifndef ION_ALLOCATION_BLOCK_SIZE
 //#define ION_ALLOCATION_BLOCK_SIZE DEFAULT_BLOCK_SIZE
 //#endif
@@ -106,6 +118,7 @@ struct _ion_allocation_chain
     SIZE                  size;
     ION_ALLOCATION_CHAIN *next;
     ION_ALLOCATION_CHAIN *head;
+    ION_ALLOCATOR        *allocator;    // the block came from, or NULL for ion_xalloc and the page pool
 
     BYTE                 *position;
     BYTE                 *limit;
@@ -119,17 +132,22 @@ struct _ion_allocation_chain
 #ifdef MEM_DEBUG
 typedef struct _ion_allocation_chain DBG_ION_ALLOCATION_CHAIN;
 
-#define ion_alloc_owner(len)                _dbg_ion_alloc_owner(len, __FILE__, __LINE__)
+#define ion_alloc_owner(len)                _dbg_ion_alloc_owner(len, NULL, __FILE__, __LINE__)
+#define ion_alloc_owner_with_allocator(len, allocator) _dbg_ion_alloc_owner(len, allocator, __FILE__, __LINE__)
 #define ion_alloc_with_owner(owner, length) _dbg_ion_alloc_with_owner(owner, length, __FILE__, __LINE__)
 #define ion_free_owner(owner)               _dbg_ion_free_owner(owner, __FILE__, __LINE__)
 #define ion_strdup(owner, dst, src)         _dbg_ion_strdup(owner, dst, src, __FILE__, __LINE__)
 #else
-#define ion_alloc_owner(len)                _ion_alloc_owner(len) 
+#define ion_alloc_owner(len)                _ion_alloc_owner(len, NULL)
+#define ion_alloc_owner_with_allocator(len, allocator) _ion_alloc_owner(len, allocator)
 #define ion_alloc_with_owner(owner, length) _ion_alloc_with_owner(owner, length)
 #define ion_free_owner(owner)               _ion_free_owner(owner)
 #define ion_strdup(owner, dst, src)         _ion_strdup(owner, dst, src)
 #endif
 
+// a new owner that allocates with the same allocator as an existing one, for the pools a reader or writer keeps
+#define ion_alloc_owner_like(len, owner)    ion_alloc_owner_with_allocator(len, _ion_alloc_get_allocator(owner))
+
 
 //
 //  structures and functions for the ion allocation page pool
@@ -168,21 +186,75 @@ GLOBAL THREAD_LOCAL_STORAGE ION_ALLOC_PAGE_LIST g_ion_alloc_page_list
 #endif
 ;
 
-ION_API_EXPORT void             ion_initialize_page_pool    (SIZE page_size, int free_page_limit);
-ION_API_EXPORT void             ion_release_page_pool       (void);
-
 ION_ALLOC_PAGE *_ion_alloc_page              (void);
 void            _ion_release_page            (ION_ALLOC_PAGE *page);
 
-void *_ion_alloc_owner     (SIZE len);
+//
+//  the shared page pool behind the thread local ones (see ion_allocator.h).
+//  each size class is a stack of batches of free blocks that are all
+//  (page_size << class) bytes long. a batch is its first block, which
+//  holds the links, and the rest of its blocks are linked like a page list.
+//  a stack is guarded by a spin lock of its own, held just long enough to
+//  link or unlink one batch. unlike a compare and swap on the head, that
+//  can't be fooled by the top batch being taken and given back while a pop
+//  is reading its link (ABA), and it works the same on any platform.
+//
+
+typedef struct _ion_shared_batch     ION_SHARED_BATCH;
+typedef struct _ion_shared_page_pool ION_SHARED_PAGE_POOL;
+
+struct _ion_shared_batch
+{
+    ION_ALLOC_PAGE   *next;             // overlays ION_ALLOC_PAGE.next
+    ION_SHARED_BATCH *next_batch;
+    int               page_count;
+};
+
+#define ION_SHARED_PAGE_POOL_MAX_CLASSES       (16)
+#define ION_SHARED_PAGE_POOL_DEFAULT_BATCH     (8)
+#define ION_SHARED_PAGE_POOL_DEFAULT_CLASSES   (4)
+#define ION_SHARED_PAGE_POOL_DEFAULT_PAGES     (256)
+
+struct _ion_shared_page_pool
+{
+    ION_ATOMIC_INT    active;           // set, with a release, once the rest is
+    SIZE              page_size;
+    int               batch_size;
+    int               thread_page_limit;
+    int               class_count;
+    int64_t           max_retained_bytes;
+    ION_SHARED_BATCH *classes[ION_SHARED_PAGE_POOL_MAX_CLASSES];      // only touched under its lock
+    ION_ATOMIC_INT    class_locks[ION_SHARED_PAGE_POOL_MAX_CLASSES];
+    ION_ATOMIC_INT64  hits;
+    ION_ATOMIC_INT64  misses;
+    ION_ATOMIC_INT64  bytes_retained;
+};
+
+GLOBAL ION_SHARED_PAGE_POOL g_ion_shared_page_pool
+#ifdef INIT_STATICS
+= { 0 }
+#endif
+;
+
+BOOL              _ion_shared_page_pool_serves_thread(void);
+int               _ion_shared_page_class             (SIZE block_size);
+ION_SHARED_BATCH *_ion_shared_page_pool_pop          (int class_index);
+void              _ion_shared_page_pool_push         (int class_index, ION_SHARED_BATCH *batch);
+void              _ion_shared_page_pool_drain_thread (int max_pages);
+void              _ion_shared_page_pool_lock         (int class_index);
+void              _ion_shared_page_pool_unlock       (int class_index);
+
+void *_ion_alloc_owner     (SIZE len, ION_ALLOCATOR *allocator);
 void *_ion_alloc_with_owner(hOWNER owner, SIZE length);
+ION_ALLOCATOR *_ion_alloc_get_allocator(hOWNER owner);
 void  _ion_free_owner      (hOWNER owner);
+BOOL  _ion_rewind_owner    (hOWNER owner, SIZE owner_length, SIZE *p_used);
 iERR  _ion_strdup          (hOWNER owner, iSTRING dst, iSTRING src);
 
 
 
 #ifdef MEM_DEBUG 
-void *_dbg_ion_alloc_owner     (SIZE len, const char *file, int line);
+void *_dbg_ion_alloc_owner     (SIZE len, ION_ALLOCATOR *allocator, const char *file, int line);
 void *_dbg_ion_alloc_with_owner(hOWNER owner, SIZE length, const char *file, int line);
 void  _dbg_ion_free_owner      (hOWNER owner, const char *file, int line);
 iERR  _dbg_ion_strdup          (hOWNER owner, iSTRING dst, iSTRING src, const char *file, int line);
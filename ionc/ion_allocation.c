@@ -28,7 +28,7 @@ void _dbg_ion_message_validate(const char *fn_name, void *addr, SIZE len, int va
 
 void                 *_ion_alloc_with_owner_helper  (ION_ALLOCATION_CHAIN *phead, SIZE length, BOOL force_new_block);
 void                 *_ion_alloc_on_chain           (ION_ALLOCATION_CHAIN *phead, SIZE length);
-ION_ALLOCATION_CHAIN *_ion_alloc_block              (SIZE min_needed);
+ION_ALLOCATION_CHAIN *_ion_alloc_block              (SIZE min_needed, ION_ALLOCATOR *allocator);
 void                  _ion_free_block               (ION_ALLOCATION_CHAIN *pblock);
 
 
@@ -36,12 +36,13 @@ void                  _ion_free_block               (ION_ALLOCATION_CHAIN *pbloc
 //  public functions 
 //
 
-void *_ion_alloc_owner(SIZE len)
+void *_ion_alloc_owner(SIZE len, ION_ALLOCATOR *allocator)
 {
     void                 *owner;
     ION_ALLOCATION_CHAIN *new_chain;
 
-    new_chain = _ion_alloc_block(len);
+    // the owner has to fit in its own block, which it only does once it's aligned
+    new_chain = _ion_alloc_block(ALIGN_SIZE(len), allocator);
     if (!new_chain) return NULL;
 
     owner = _ion_alloc_with_owner_helper(new_chain, len, FALSE);
@@ -62,6 +63,13 @@ void *_ion_alloc_with_owner(hOWNER owner, SIZE length)
     return ptr;
 }
 
+ION_ALLOCATOR *_ion_alloc_get_allocator(hOWNER owner)
+{
+    ASSERT(owner);
+
+    return ION_ALLOC_USER_PTR_TO_BLOCK(owner)->allocator;
+}
+
 void _ion_free_owner(hOWNER owner)
 {
     ION_ALLOCATION_CHAIN *powner = ION_ALLOC_USER_PTR_TO_BLOCK(owner);
@@ -80,6 +88,35 @@ void _ion_free_owner(hOWNER owner)
     return;
 }
 
+// releases everything allocated with the owner since the owner itself (which
+// was owner_length bytes) so the owner block can be filled again. Returns FALSE
+// if the allocations didn't all fit in the owner block, in which case the
+// blocks they spilled into are freed, and *p_used gets the total either way
+BOOL _ion_rewind_owner(hOWNER owner, SIZE owner_length, SIZE *p_used)
+{
+    ION_ALLOCATION_CHAIN *powner = ION_ALLOC_USER_PTR_TO_BLOCK(owner);
+    ION_ALLOCATION_CHAIN *pblk, *pnext;
+    BYTE                 *start = (BYTE *)owner + ALIGN_SIZE(owner_length);
+    BOOL                  fit = (powner->head == NULL);
+    SIZE                  used;
+
+    ASSERT(start <= powner->position);
+
+    // count what's been allocated since the owner, and give back any
+    // blocks the allocations spilled into, keeping only the owner block
+    used = (SIZE)(powner->position - start);
+    for (pblk = powner->head; pblk; pblk = pnext) {
+        pnext = pblk->next;
+        used += (SIZE)(pblk->position - (BYTE *)ION_ALLOC_BLOCK_TO_USER_PTR(pblk));
+        _ion_free_block(pblk);
+    }
+    powner->head = NULL;
+    powner->position = start;
+
+    if (p_used) *p_used = used;
+    return fit;
+}
+
 iERR _ion_strdup(hOWNER owner, iSTRING dst, iSTRING src)
 {
     iENTER;
@@ -138,7 +175,7 @@ void *_ion_alloc_with_owner_helper(ION_ALLOCATION_CHAIN *powner, SIZE request_le
     // create a new block we might need to just to make room
     if ( force_new_block ) {
         // otherwise we add a new block
-        pblock = _ion_alloc_block(length);
+        pblock = _ion_alloc_block(length, powner->allocator);
         if (!pblock) return NULL;
 
         if (pblock->size > g_ion_alloc_page_list.page_size && powner->head != NULL) {
@@ -173,15 +210,45 @@ void *_ion_alloc_with_owner_helper(ION_ALLOCATION_CHAIN *powner, SIZE request_le
     return ptr;
 }
 
-ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed)
+ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed, ION_ALLOCATOR *allocator)
 {
     ION_ALLOCATION_CHAIN *new_block;
     SIZE                  alloc_size = min_needed + ALIGN_SIZE(sizeof(ION_ALLOCATION_CHAIN)); // subtract out the block[1]
+    int                   class_index;
 
-    if (alloc_size > g_ion_alloc_page_list.page_size) {
-        // it's an oversize block - we'll ask the system for this one
-        new_block = (ION_ALLOCATION_CHAIN *)ion_xalloc(alloc_size);    
-        new_block->size = alloc_size;
+    if (allocator) {
+        // the page pool only holds pages from ion_xalloc, so these are always
+        // the caller's, though they're sized like pages
+        if (alloc_size < g_ion_alloc_page_list.page_size) {
+            alloc_size = g_ion_alloc_page_list.page_size;
+        }
+        new_block = (ION_ALLOCATION_CHAIN *)allocator->alloc(allocator->context, alloc_size);
+        if (new_block) {
+            new_block->size = alloc_size;
+        }
+    }
+    else if (alloc_size > g_ion_alloc_page_list.page_size) {
+        // it's an oversize block - we'll ask the system for this one, unless
+        // the shared pool keeps blocks this long, in which case it's rounded up
+        class_index = _ion_shared_page_pool_serves_thread() ? _ion_shared_page_class(alloc_size) : -1;
+        if (class_index > 0) {
+            alloc_size = g_ion_shared_page_pool.page_size << class_index;
+            new_block = (ION_ALLOCATION_CHAIN *)_ion_shared_page_pool_pop(class_index);
+            if (!new_block) {
+                ION_ATOMIC_ADD64(&g_ion_shared_page_pool.misses, 1);
+                ION_PERF_COUNT(page_pool_misses, 1);
+                new_block = (ION_ALLOCATION_CHAIN *)ion_xalloc(alloc_size);
+            }
+            else {
+                ION_PERF_COUNT(page_pool_hits, 1);
+            }
+        }
+        else {
+            new_block = (ION_ALLOCATION_CHAIN *)ion_xalloc(alloc_size);
+        }
+        if (new_block) {
+            new_block->size = alloc_size;
+        }
     }
     else {
         // it's a normal size block - go out to the block pool for it
@@ -194,22 +261,41 @@ ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed)
     // see if we suceeded
     if (!new_block) return NULL;
     
-    new_block->next     = NULL;
-    new_block->head     = NULL;
+    new_block->next      = NULL;
+    new_block->head      = NULL;
+    new_block->allocator = allocator;
+
+    new_block->position  = ION_ALLOC_BLOCK_TO_USER_PTR(new_block);
+    new_block->limit     = ((BYTE*)new_block) + new_block->size;
 
-    new_block->position = ION_ALLOC_BLOCK_TO_USER_PTR(new_block);
-    new_block->limit    = ((BYTE*)new_block) + new_block->size;
+    assert(new_block->position >= (BYTE *)(&new_block->limit + 1));
 
-    assert(new_block->position == ((BYTE *)(&new_block->limit) + ALIGN_SIZE(sizeof(new_block->limit))));
+    ION_PERF_BLOCK_ALLOCATED(new_block->size);
 
     return new_block;
 }
 
 void _ion_free_block(ION_ALLOCATION_CHAIN *pblock)
 {
+    ION_SHARED_BATCH *batch;
+    int               class_index;
+
     if (!pblock) return;
-    if (pblock->size > g_ion_alloc_page_list.page_size) {
-        ion_xfree(pblock);
+    ION_PERF_BLOCK_FREED(pblock->size);
+    if (pblock->allocator) {
+        pblock->allocator->free(pblock->allocator->context, pblock);
+    }
+    else if (pblock->size > g_ion_alloc_page_list.page_size) {
+        class_index = _ion_shared_page_pool_serves_thread() ? _ion_shared_page_class(pblock->size) : -1;
+        if (class_index > 0 && pblock->size == (g_ion_shared_page_pool.page_size << class_index)) {
+            batch = (ION_SHARED_BATCH *)pblock;
+            batch->next = NULL;
+            batch->page_count = 1;
+            _ion_shared_page_pool_push(class_index, batch);
+        }
+        else {
+            ion_xfree(pblock);
+        }
     }
     else {
         _ion_release_page((ION_ALLOC_PAGE *)pblock);
@@ -217,6 +303,38 @@ void _ion_free_block(ION_ALLOCATION_CHAIN *pblock)
     return;
 }
 
+void ion_initialize_allocator(ION_ALLOCATOR *allocator)
+{
+    if (allocator) {
+        g_ion_allocator = *allocator;
+    }
+    else {
+        memset(&g_ion_allocator, 0, sizeof(g_ion_allocator));
+    }
+    return;
+}
+
+void *_ion_xalloc(SIZE size)
+{
+    ION_PERF_COUNT(allocations, 1);
+    if (g_ion_allocator.alloc) {
+        return g_ion_allocator.alloc(g_ion_allocator.context, size);
+    }
+    return malloc((size_t)size);
+}
+
+void _ion_xfree(void *ptr)
+{
+    if (ptr) ION_PERF_COUNT(frees, 1);
+    if (!g_ion_allocator.alloc) {
+        free(ptr);
+    }
+    else if (ptr) {
+        g_ion_allocator.free(g_ion_allocator.context, ptr);
+    }
+    return;
+}
+
 void ion_initialize_page_pool(SIZE page_size, int free_page_limit)
 {
     // TODO This is always true, causing this function to do nothing, because g_ion_alloc_page_list.page_size
@@ -245,7 +363,14 @@ void ion_initialize_page_pool(SIZE page_size, int free_page_limit)
 void ion_release_page_pool(void)
 {
     ION_ALLOC_PAGE *page;
-    
+
+    // the shared pool, if it takes this thread's pages, gets them all
+    if (_ion_shared_page_pool_serves_thread()) {
+        while (g_ion_alloc_page_list.head != NULL) {
+            _ion_shared_page_pool_drain_thread(g_ion_shared_page_pool.batch_size);
+        }
+    }
+
     while ((page = g_ion_alloc_page_list.head) != NULL) {
         g_ion_alloc_page_list.head = page->next;
         ion_xfree(page);
@@ -261,14 +386,31 @@ void ion_release_page_pool(void)
 
 ION_ALLOC_PAGE *_ion_alloc_page(void)
 {
-    ION_ALLOC_PAGE *page;
+    ION_ALLOC_PAGE   *page;
+    ION_SHARED_BATCH *batch;
+    BOOL              shared;
     
     if ((page = g_ion_alloc_page_list.head) != NULL) {
         g_ion_alloc_page_list.head = page->next;
         g_ion_alloc_page_list.page_count--;
+        ION_PERF_COUNT(page_pool_hits, 1);
+    }
+    else if ((shared = _ion_shared_page_pool_serves_thread())
+          && (batch = _ion_shared_page_pool_pop(0)) != NULL
+    ) {
+        // the first page of the batch is the one we return, the rest
+        // refill this thread's (empty) pool
+        page = (ION_ALLOC_PAGE *)batch;
+        g_ion_alloc_page_list.head = batch->next;
+        g_ion_alloc_page_list.page_count = batch->page_count - 1;
+        ION_PERF_COUNT(page_pool_hits, 1);
     }
     else {
         ASSERT(g_ion_alloc_page_list.page_size != ION_ALLOC_PAGE_POOL_PAGE_SIZE_NONE);
+        if (shared) {
+            ION_ATOMIC_ADD64(&g_ion_shared_page_pool.misses, 1);
+        }
+        ION_PERF_COUNT(page_pool_misses, 1);
         page = ion_xalloc(g_ion_alloc_page_list.page_size);
     }
     return page;
@@ -278,7 +420,17 @@ void _ion_release_page(ION_ALLOC_PAGE *page)
 {
     if (page == NULL) return;
 
-    if (g_ion_alloc_page_list.free_page_limit != ION_ALLOC_PAGE_POOL_NO_LIMIT
+    if (_ion_shared_page_pool_serves_thread()) {
+        // rather than freeing pages past the limit, a batch of them goes to
+        // the shared pool, where other threads can use them
+        if (g_ion_alloc_page_list.page_count >= g_ion_shared_page_pool.thread_page_limit) {
+            _ion_shared_page_pool_drain_thread(g_ion_shared_page_pool.batch_size);
+        }
+        page->next = g_ion_alloc_page_list.head;
+        g_ion_alloc_page_list.head = page;
+        g_ion_alloc_page_list.page_count++;
+    }
+    else if (g_ion_alloc_page_list.free_page_limit != ION_ALLOC_PAGE_POOL_NO_LIMIT
      && g_ion_alloc_page_list.page_count >= g_ion_alloc_page_list.free_page_limit
     ) {
         ion_xfree(page);
@@ -293,6 +445,191 @@ void _ion_release_page(ION_ALLOC_PAGE *page)
 
 
 
+iERR ion_initialize_shared_page_pool(ION_SHARED_PAGE_POOL_OPTIONS *options)
+{
+    iENTER;
+    ION_SHARED_PAGE_POOL_OPTIONS defaults;
+    ION_SHARED_PAGE_POOL        *pool = &g_ion_shared_page_pool;
+    SIZE                         page_size = g_ion_alloc_page_list.page_size;
+    int                          class_count;
+
+    if (ION_ATOMIC_LOAD(&pool->active)) FAILWITH(IERR_INVALID_STATE);
+    if (page_size == ION_ALLOC_PAGE_POOL_PAGE_SIZE_NONE) FAILWITH(IERR_INVALID_STATE);
+
+    if (options == NULL) {
+        memset(&defaults, 0, sizeof(defaults));
+        options = &defaults;
+    }
+    if (options->batch_size < 0 || options->thread_page_limit < 0 || options->max_retained_bytes < 0) {
+        FAILWITHMSG(IERR_INVALID_ARG, "shared page pool options can't be negative");
+    }
+    class_count = options->size_class_count ? options->size_class_count : ION_SHARED_PAGE_POOL_DEFAULT_CLASSES;
+    if (class_count < 0 || class_count > ION_SHARED_PAGE_POOL_MAX_CLASSES
+     || ((int64_t)page_size << (class_count - 1)) > INT32_MAX
+    ) {
+        FAILWITHMSG(IERR_INVALID_ARG, "too many shared page pool size classes");
+    }
+
+    pool->page_size          = page_size;
+    pool->batch_size         = options->batch_size ? options->batch_size : ION_SHARED_PAGE_POOL_DEFAULT_BATCH;
+    pool->thread_page_limit  = options->thread_page_limit ? options->thread_page_limit : 2 * pool->batch_size;
+    pool->class_count        = class_count;
+    pool->max_retained_bytes = options->max_retained_bytes
+                             ? options->max_retained_bytes
+                             : (int64_t)ION_SHARED_PAGE_POOL_DEFAULT_PAGES * page_size;
+    memset(pool->classes, 0, sizeof(pool->classes));
+    memset((void *)pool->class_locks, 0, sizeof(pool->class_locks));
+    pool->hits = pool->misses = pool->bytes_retained = 0;
+
+    ION_ATOMIC_STORE(&pool->active, 1);
+
+    iRETURN;
+}
+
+void ion_shared_page_pool_stats(ION_SHARED_PAGE_POOL_STATS *stats)
+{
+    ION_SHARED_PAGE_POOL *pool = &g_ion_shared_page_pool;
+
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!ION_ATOMIC_LOAD(&pool->active)) return;
+
+    stats->hits           = ION_ATOMIC_LOAD64(&pool->hits);
+    stats->misses         = ION_ATOMIC_LOAD64(&pool->misses);
+    stats->bytes_retained = ION_ATOMIC_LOAD64(&pool->bytes_retained);
+
+    return;
+}
+
+void ion_release_shared_page_pool(void)
+{
+    ION_SHARED_PAGE_POOL *pool = &g_ion_shared_page_pool;
+    ION_SHARED_BATCH     *batch, *next_batch;
+    ION_ALLOC_PAGE       *page, *next;
+    int                   ii;
+
+    if (!ION_ATOMIC_LOAD(&pool->active)) return;
+    ION_ATOMIC_STORE(&pool->active, 0);
+
+    for (ii = 0; ii < pool->class_count; ii++) {
+        _ion_shared_page_pool_lock(ii);
+        batch = pool->classes[ii];
+        pool->classes[ii] = NULL;
+        _ion_shared_page_pool_unlock(ii);
+        for (; batch; batch = next_batch) {
+            next_batch = batch->next_batch;
+            for (page = (ION_ALLOC_PAGE *)batch; page; page = next) {
+                next = page->next;
+                ion_xfree(page);
+            }
+        }
+    }
+    pool->hits = pool->misses = pool->bytes_retained = 0;
+
+    return;
+}
+
+BOOL _ion_shared_page_pool_serves_thread(void)
+{
+    // the pool only holds one thread's idea of a page, so a thread with
+    // different pages (or none) keeps to itself
+    return ION_ATOMIC_LOAD(&g_ion_shared_page_pool.active)
+        && g_ion_shared_page_pool.page_size == g_ion_alloc_page_list.page_size;
+}
+
+int _ion_shared_page_class(SIZE block_size)
+{
+    int ii;
+
+    for (ii = 0; ii < g_ion_shared_page_pool.class_count; ii++) {
+        if (block_size <= (g_ion_shared_page_pool.page_size << ii)) return ii;
+    }
+    return -1;
+}
+
+void _ion_shared_page_pool_lock(int class_index)
+{
+    ION_ATOMIC_INT *lock = &g_ion_shared_page_pool.class_locks[class_index];
+
+    while (!ION_ATOMIC_CAS(lock, 0, 1)) {
+        // someone's linking or unlinking a batch, which takes a few instructions
+        while (ION_ATOMIC_LOAD(lock)) {
+            ION_ATOMIC_PAUSE();
+        }
+    }
+}
+
+void _ion_shared_page_pool_unlock(int class_index)
+{
+    ION_ATOMIC_STORE(&g_ion_shared_page_pool.class_locks[class_index], 0);
+}
+
+ION_SHARED_BATCH *_ion_shared_page_pool_pop(int class_index)
+{
+    ION_SHARED_PAGE_POOL *pool = &g_ion_shared_page_pool;
+    ION_SHARED_BATCH     *batch;
+
+    _ion_shared_page_pool_lock(class_index);
+    batch = pool->classes[class_index];
+    if (batch != NULL) {
+        pool->classes[class_index] = batch->next_batch;
+    }
+    _ion_shared_page_pool_unlock(class_index);
+    if (batch == NULL) return NULL;
+
+    batch->next_batch = NULL;
+    ION_ATOMIC_ADD64(&pool->hits, batch->page_count);
+    ION_ATOMIC_ADD64(&pool->bytes_retained, -((int64_t)batch->page_count * (pool->page_size << class_index)));
+    return batch;
+}
+
+void _ion_shared_page_pool_push(int class_index, ION_SHARED_BATCH *batch)
+{
+    ION_SHARED_PAGE_POOL *pool = &g_ion_shared_page_pool;
+    ION_ALLOC_PAGE       *page, *next;
+    int64_t               bytes = (int64_t)batch->page_count * (pool->page_size << class_index);
+
+    if (ION_ATOMIC_ADD64(&pool->bytes_retained, bytes) > pool->max_retained_bytes) {
+        // the pool is full, these go back to the system
+        ION_ATOMIC_ADD64(&pool->bytes_retained, -bytes);
+        for (page = (ION_ALLOC_PAGE *)batch; page; page = next) {
+            next = page->next;
+            ion_xfree(page);
+        }
+        return;
+    }
+
+    _ion_shared_page_pool_lock(class_index);
+    batch->next_batch = pool->classes[class_index];
+    pool->classes[class_index] = batch;
+    _ion_shared_page_pool_unlock(class_index);
+
+    return;
+}
+
+void _ion_shared_page_pool_drain_thread(int max_pages)
+{
+    ION_SHARED_BATCH *batch;
+    ION_ALLOC_PAGE   *tail;
+    int               count;
+
+    // the batch is the pages at the front of this thread's pool
+    batch = (ION_SHARED_BATCH *)g_ion_alloc_page_list.head;
+    if (batch == NULL) return;
+    for (count = 1, tail = (ION_ALLOC_PAGE *)batch; count < max_pages && tail->next != NULL; count++) {
+        tail = tail->next;
+    }
+    g_ion_alloc_page_list.head = tail->next;
+    g_ion_alloc_page_list.page_count -= count;
+
+    tail->next = NULL;
+    batch->page_count = count;
+    _ion_shared_page_pool_push(0, batch);
+
+    return;
+}
+
+
 #ifdef MEM_DEBUG
 
 long malloc_inuse = 0;
@@ -400,13 +737,14 @@ void debug_free(const void *addr, const char *file, int line)
     free(ptr);
 }
 
-void *_dbg_ion_alloc_owner(SIZE len, const char *file, int line)
+void *_dbg_ion_alloc_owner(SIZE len, ION_ALLOCATOR *allocator, const char *file, int line)
 {
     long                  cmd  = debug_cmd_counter();
     void                 *owner;
     ION_ALLOCATION_CHAIN *new_chain;
 
-    new_chain = _ion_alloc_block(len);
+    // the owner has to fit in its own block, which it only does once it's aligned
+    new_chain = _ion_alloc_block(ALIGN_SIZE(len), allocator);
     if (!new_chain) return NULL;
 
     owner = _ion_alloc_with_owner_helper(new_chain, len, FALSE);
@@ -440,12 +778,22 @@ void _dbg_ion_free_owner(hOWNER owner, const char *file, int line)
 
     _dbg_ion_message("___FREE_OWNER", pcurr, -1);
 
-    ion_xfree(pcurr);
+    if (pcurr->allocator) {
+        _ion_free_block(pcurr);
+    }
+    else {
+        ion_xfree(pcurr);
+    }
 
     while (pnext) {
         pcurr = pnext;
         pnext = pcurr->next;
-        ion_xfree(pcurr);
+        if (pcurr->allocator) {
+            _ion_free_block(pcurr);
+        }
+        else {
+            ion_xfree(pcurr);
+        }
     }
 }
 
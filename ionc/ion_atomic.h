@@ -0,0 +1,82 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+//
+// the few atomic operations the library needs for the state it shares
+// between threads (everything else is either owned by one reader or
+// writer, or is thread local). These are 32 bit ints; loads acquire,
+// stores release and the compare and swap is a full barrier. The 64 bit
+// adds are for counters that only need to be exact eventually, so they
+// don't order anything.
+//
+
+#ifndef ION_ATOMIC_H_
+#define ION_ATOMIC_H_
+
+#include <ionc/ion_types.h>
+#include <ionc/ion_platform_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+
+#include <intrin.h>
+
+typedef volatile long ION_ATOMIC_INT;
+
+#define ION_ATOMIC_LOAD(p)              (_ReadWriteBarrier(), *(p))
+#define ION_ATOMIC_STORE(p, v)          (_ReadWriteBarrier(), (void)_InterlockedExchange((p), (long)(v)))
+#define ION_ATOMIC_CAS(p, expected, v)  (_InterlockedCompareExchange((p), (long)(v), (long)(expected)) == (long)(expected))
+#define ION_ATOMIC_PAUSE()              _mm_pause()
+
+typedef volatile __int64 ION_ATOMIC_INT64;
+
+#define ION_ATOMIC_ADD64(p, v)                  (_InterlockedExchangeAdd64((p), (__int64)(v)) + (__int64)(v))
+#define ION_ATOMIC_LOAD64(p)                    _InterlockedOr64((p), 0)
+
+#elif defined(__GNUC__)
+
+typedef int32_t ION_ATOMIC_INT;
+
+#define ION_ATOMIC_LOAD(p)              __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ION_ATOMIC_STORE(p, v)          __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ION_ATOMIC_CAS(p, expected, v)  _ion_atomic_cas((p), (expected), (v))
+
+static inline BOOL _ion_atomic_cas(ION_ATOMIC_INT *p, int32_t expected, int32_t desired)
+{
+    return __atomic_compare_exchange_n(p, &expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+typedef int64_t ION_ATOMIC_INT64;
+
+#define ION_ATOMIC_ADD64(p, v)                  __atomic_add_fetch((p), (int64_t)(v), __ATOMIC_RELAXED)
+#define ION_ATOMIC_LOAD64(p)                    __atomic_load_n((p), __ATOMIC_RELAXED)
+
+#if defined(__i386__) || defined(__x86_64__)
+#define ION_ATOMIC_PAUSE()              __builtin_ia32_pause()
+#else
+#define ION_ATOMIC_PAUSE()              ((void)0)
+#endif
+
+#else
+#error "Compiler does not support atomic operations"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ION_ATOMIC_H_ */
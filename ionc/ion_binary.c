@@ -13,6 +13,7 @@
  */
 
 #include <limits.h>
+#include <string.h>
 #include "ion_internal.h"
 #include "ion_decimal_impl.h"
 
@@ -115,6 +116,84 @@ int ion_binary_len_ion_float_64(double value )
     return len;
 }
 
+// When 8 bytes of the stream's buffer are left, the var ints and uints that
+// fit in them (every length, sid and exponent in practice) are decoded from a
+// single load: the stop bit is found with a bit scan and the 7 bit groups are
+// packed together with masks, instead of a branch per byte. Near the end of
+// the buffer, and for longer values, the byte at a time loops are used.
+#if !defined(ION_BINARY_SCALAR) \
+ && (defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+#define ION_BINARY_SWAR
+#endif
+
+#ifdef ION_BINARY_SWAR
+
+#define ION_BINARY_SWAR_WORD_LENGTH ((SIZE)sizeof(uint64_t))
+#define ION_BINARY_SWAR_STOP_BITS   0x8080808080808080ULL
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static __inline uint64_t _ion_binary_swar_load(BYTE *p)
+{
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return _byteswap_uint64(word);
+}
+static __inline int _ion_binary_swar_stop_length(uint64_t stop_bits)
+{
+    unsigned long index;
+    _BitScanForward64(&index, stop_bits);
+    return (int)(index >> 3) + 1;
+}
+#else
+static inline uint64_t _ion_binary_swar_load(BYTE *p)
+{
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return __builtin_bswap64(word);
+}
+static inline int _ion_binary_swar_stop_length(uint64_t stop_bits)
+{
+    return (__builtin_ctzll(stop_bits) >> 3) + 1;
+}
+#endif
+
+// decodes the var uint at p, which is followed by at least 8 bytes in the
+// buffer. Returns its length, or 0 if it's longer than 8 bytes.
+static inline int _ion_binary_swar_var_uint(BYTE *p, uint64_t *p_value)
+{
+    uint64_t word, stop_bits, value;
+    int      len;
+
+    // one byte values, the most common by far, don't need any of this
+    if (p[0] & 0x80) {
+        *p_value = p[0] & 0x7F;
+        return 1;
+    }
+
+    memcpy(&word, p, sizeof(word)); // the first byte is the low byte
+    stop_bits = word & ION_BINARY_SWAR_STOP_BITS;
+    if (stop_bits == 0) return 0;
+    len = _ion_binary_swar_stop_length(stop_bits);
+
+    // the value's bytes, most significant first, in the low len bytes
+    value = _ion_binary_swar_load(p);
+    if (len < ION_BINARY_SWAR_WORD_LENGTH) {
+        value >>= (ION_BINARY_SWAR_WORD_LENGTH - len) * 8;
+    }
+    value &= 0x7F7F7F7F7F7F7F7FULL;
+
+    // pack the 7 bit groups: pairs into 14 bits, then 28, then 56
+    value = ((value & 0x7F007F007F007F00ULL) >> 1) | (value & 0x007F007F007F007FULL);
+    value = ((value & 0x3FFF00003FFF0000ULL) >> 2) | (value & 0x00003FFF00003FFFULL);
+    value = ((value & 0x0FFFFFFF00000000ULL) >> 4) | (value & 0x000000000FFFFFFFULL);
+
+    *p_value = value;
+    return len;
+}
+
+#endif // ION_BINARY_SWAR
+
 iERR ion_binary_read_var_int_32(ION_STREAM *pstream, int32_t *p_value)
 {
     iENTER;
@@ -136,6 +215,21 @@ iERR ion_binary_read_var_int_64(ION_STREAM *pstream, int64_t *p_value)
     uint64_t unsignedValue = 0;
     BOOL     is_negative = FALSE;
     int      b;
+#ifdef ION_BINARY_SWAR
+    int      len;
+
+    if (pstream->_limit - pstream->_curr >= ION_BINARY_SWAR_WORD_LENGTH) {
+        len = _ion_binary_swar_var_uint(pstream->_curr, &unsignedValue);
+        if (len > 0) {
+            // the sign is the high bit of the first byte's 7
+            is_negative = ((pstream->_curr[0] & 0x40) != 0);
+            unsignedValue &= ~(((uint64_t)0x40) << ((len - 1) * 7));
+            pstream->_curr += len;
+            IONCHECK(cast_to_int64(unsignedValue, is_negative, p_value));
+            SUCCEED();
+        }
+    }
+#endif
 
     // read the first byte
     // first byte doesn't need to shift and has two bits
@@ -183,6 +277,18 @@ iERR ion_binary_read_var_uint_64(ION_STREAM *pstream, uint64_t *p_value)
     iENTER;
     uint64_t retvalue = 0;
     int      b;
+#ifdef ION_BINARY_SWAR
+    int      len;
+
+    if (pstream->_limit - pstream->_curr >= ION_BINARY_SWAR_WORD_LENGTH) {
+        len = _ion_binary_swar_var_uint(pstream->_curr, &retvalue);
+        if (len > 0) {
+            pstream->_curr += len;
+            *p_value = retvalue;
+            SUCCEED();
+        }
+    }
+#endif
 
     // read the first byte
     ION_GET(pstream, b);
@@ -229,6 +335,18 @@ iERR ion_binary_read_uint_64(ION_STREAM *pstream, int32_t len, uint64_t *p_value
         FAILWITH(IERR_NUMERIC_OVERFLOW);
     }
 
+#ifdef ION_BINARY_SWAR
+    if (len > 0 && pstream->_limit - pstream->_curr >= ION_BINARY_SWAR_WORD_LENGTH) {
+        retvalue = _ion_binary_swar_load(pstream->_curr);
+        if (len < ION_BINARY_SWAR_WORD_LENGTH) {
+            retvalue >>= (ION_BINARY_SWAR_WORD_LENGTH - len) * 8;
+        }
+        pstream->_curr += len;
+        *p_value = retvalue;
+        SUCCEED();
+    }
+#endif
+
     while (len > 0) {
         ION_GET(pstream, b);
         retvalue = (retvalue << 8) | b;
@@ -28,7 +28,23 @@ iERR ion_catalog_open(hCATALOG *p_hcatalog)
         FAILWITH(IERR_INVALID_ARG);
     }
 
-    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, NULL));
+    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, NULL, NULL));
+
+    *p_hcatalog = PTR_TO_HANDLE(catalog);
+
+    iRETURN;
+}
+
+iERR ion_catalog_open_with_allocator(hCATALOG *p_hcatalog, ION_ALLOCATOR *allocator)
+{
+    iENTER;
+    ION_CATALOG *catalog;
+
+    if (p_hcatalog == NULL) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+
+    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, NULL, allocator));
 
     *p_hcatalog = PTR_TO_HANDLE(catalog);
 
@@ -44,14 +60,14 @@ iERR ion_catalog_open_with_owner(hCATALOG *p_hcatalog, hOWNER owner)
         FAILWITH(IERR_INVALID_ARG);
     }
 
-    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, owner));
+    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, owner, NULL));
 
     *p_hcatalog = PTR_TO_HANDLE(catalog);
 
     iRETURN;
 }
 
-iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner)
+iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner, ION_ALLOCATOR *allocator)
 {
     iENTER;
     ION_CATALOG *catalog;
@@ -60,7 +76,7 @@ iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner)
     ASSERT(p_pcatalog);
 
     if (owner == NULL) {
-        catalog = (ION_CATALOG *)ion_alloc_owner(sizeof(*catalog));    
+        catalog = (ION_CATALOG *)ion_alloc_owner_with_allocator(sizeof(*catalog), allocator);
         owner = catalog;
     }
     else {
@@ -139,6 +155,8 @@ iERR _ion_catalog_add_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABL
     ASSERT(pcatalog != NULL);
     ASSERT(psymtab != NULL);
 
+    if (pcatalog->is_frozen) FAILWITH(IERR_IS_IMMUTABLE);
+
     IONCHECK(ion_symbol_table_get_name(psymtab, &name));
     IONCHECK(ion_symbol_table_get_version(psymtab, &version));
 
@@ -348,6 +366,8 @@ iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_
     ASSERT(pcatalog != NULL);
     ASSERT(psymtab != NULL);
 
+    if (pcatalog->is_frozen) FAILWITH(IERR_IS_IMMUTABLE);
+
     IONCHECK(_ion_symbol_table_get_owner(psymtab, &owner));
 
     // if this symbol table is "foreign" get "our copy" of the table
@@ -368,6 +388,59 @@ iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_
     iRETURN;
 }
 
+iERR ion_catalog_freeze(hCATALOG hcatalog)
+{
+    iENTER;
+    ION_CATALOG *catalog;
+
+    if (hcatalog == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    catalog = HANDLE_TO_PTR(hcatalog, ION_CATALOG);
+
+    IONCHECK(_ion_catalog_freeze_helper(catalog));
+
+    iRETURN;
+}
+
+iERR _ion_catalog_freeze_helper(ION_CATALOG *pcatalog)
+{
+    iENTER;
+    ION_SYMBOL_TABLE       **ppsymtab;
+    ION_COLLECTION_CURSOR    symtab_cursor;
+
+    ASSERT(pcatalog != NULL);
+
+    if (pcatalog->is_frozen) SUCCEED();
+
+    // the tables are all owned by this catalog (see _ion_catalog_add_symbol_table_helper)
+    // and the system table they refer to is frozen already, so once these are locked
+    // down nothing that reads them will write to them
+    ION_COLLECTION_OPEN(&pcatalog->table_list, symtab_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
+        if (!ppsymtab) break;
+        IONCHECK(_ion_symbol_table_freeze_helper(*ppsymtab));
+    }
+    ION_COLLECTION_CLOSE(symtab_cursor);
+
+    pcatalog->is_frozen = TRUE;
+
+    iRETURN;
+}
+
+iERR ion_catalog_is_frozen(hCATALOG hcatalog, BOOL *p_is_frozen)
+{
+    iENTER;
+    ION_CATALOG *catalog;
+
+    if (hcatalog == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (p_is_frozen == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    catalog = HANDLE_TO_PTR(hcatalog, ION_CATALOG);
+    *p_is_frozen = catalog->is_frozen;
+
+    iRETURN;
+}
 
 iERR ion_catalog_close(hCATALOG hcatalog)
 {
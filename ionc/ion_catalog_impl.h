@@ -24,16 +24,18 @@ struct _ion_catalog
     void                *owner;
     ION_SYMBOL_TABLE    *system_symbol_table;
     ION_COLLECTION       table_list;    // collection of ION_SYMBOL_TABLE *
+    BOOL                 is_frozen;     // no more tables come or go, and the tables are shared between threads
 
 };
 
 // internal (pointer based helpers) functions for catalog (in ion_catalog.c)
-iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner);
+iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner, ION_ALLOCATOR *allocator);
 iERR _ion_catalog_get_symbol_table_count_helper(ION_CATALOG *pcatalog, int32_t *p_count);
 iERR _ion_catalog_add_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab);
 iERR _ion_catalog_find_symbol_table_helper(ION_CATALOG *pcatalog, ION_STRING *name, int32_t version, ION_SYMBOL_TABLE **p_psymtab);
 iERR _ion_catalog_find_best_match_helper(ION_CATALOG *pcatalog, ION_STRING *name, int32_t version, int32_t max_id, ION_SYMBOL_TABLE **p_psymtab);
 iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab);
+iERR _ion_catalog_freeze_helper(ION_CATALOG *pcatalog);
 iERR _ion_catalog_close_helper(ION_CATALOG *pcatalog);
 
 #ifdef __cplusplus
@@ -114,12 +114,77 @@ iERR ion_decimal_free(ION_DECIMAL *value) {
 
 /* Conversions */
 
+/**
+ * Builds the decQuad for a plain [-]digits[.digits][(d|e)[+-]digits] image directly from its
+ * digits and exponent, which is what decQuadFromString does in general but without its
+ * handling of rounding, specials and syntax errors. Returns FALSE, leaving p_quad alone, if the
+ * image isn't in that form, has more than DECQUAD_Pmax significant digits, or has an exponent
+ * that would need to be clamped; those go through decQuadFromString.
+ */
+static BOOL _ion_decimal_quad_from_digits(const char *str, decQuad *p_quad) {
+    const char *cp = str;
+    uint8_t     digits[DECQUAD_Pmax], bcd[DECQUAD_Pmax];
+    int         count = 0, exponent = 0, exponent_value = 0;
+    BOOL        negative = FALSE, seen_digit = FALSE, exponent_negative = FALSE;
+
+    if (*cp == '-') {
+        negative = TRUE;
+        cp++;
+    }
+    for (; *cp >= '0' && *cp <= '9'; cp++) {
+        seen_digit = TRUE;
+        if (count == 0 && *cp == '0') continue; // leading zeros aren't part of the coefficient
+        if (count == DECQUAD_Pmax) return FALSE;
+        digits[count++] = (uint8_t)(*cp - '0');
+    }
+    if (*cp == '.') {
+        for (cp++; *cp >= '0' && *cp <= '9'; cp++) {
+            seen_digit = TRUE;
+            exponent--;
+            if (count == 0 && *cp == '0') continue;
+            if (count == DECQUAD_Pmax) return FALSE;
+            digits[count++] = (uint8_t)(*cp - '0');
+        }
+    }
+    if (!seen_digit) return FALSE;
+    if (*cp == 'd' || *cp == 'D' || *cp == 'e' || *cp == 'E') {
+        cp++;
+        if (*cp == '-') {
+            exponent_negative = TRUE;
+            cp++;
+        }
+        else if (*cp == '+') {
+            cp++;
+        }
+        if (*cp < '0' || *cp > '9') return FALSE;
+        for (; *cp >= '0' && *cp <= '9'; cp++) {
+            exponent_value = exponent_value * 10 + (*cp - '0');
+            if (exponent_value > 2 * DECQUAD_Emax) return FALSE;
+        }
+        exponent += exponent_negative ? -exponent_value : exponent_value;
+    }
+    if (*cp != '\0') return FALSE;
+    // the range of exponents decQuadFromBCD can encode as they are
+    if (exponent < DECQUAD_Emin - (DECQUAD_Pmax - 1) || exponent > DECQUAD_Emax - (DECQUAD_Pmax - 1)) {
+        return FALSE;
+    }
+
+    memset(bcd, 0, DECQUAD_Pmax - count);
+    memcpy(bcd + DECQUAD_Pmax - count, digits, count);
+    decQuadFromBCD(p_quad, exponent, bcd, negative ? DECFLOAT_Sign : 0);
+    return TRUE;
+}
+
 iERR _ion_decimal_from_string_helper(const char *str, decContext *context, hOWNER owner, decQuad *p_quad, decNumber **p_num) {
     iENTER;
     const char *cp;
     uint32_t   saved_status;
     SIZE       decimal_digits = 0;
 
+    if (_ion_decimal_quad_from_digits(str, p_quad)) {
+        SUCCEED();
+    }
+
     // NOTE: decFloatFromString and decNumberFromString have been modified to accept both 'e' and 'd'. If the decNumber
     // implementation is updated or swapped out, arrangements need to be made here (or there) to ensure this function
     // can parse exponents denoted by either 'e' or 'd'.
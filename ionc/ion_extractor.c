@@ -14,6 +14,7 @@
 
 #include <ionc/ion_extractor.h>
 #include "ion_extractor_impl.h"
+#include <math.h>
 
 #if ION_EXTRACTOR_MAX_NUM_PATHS > ION_EXTRACTOR_MAX_NUM_PATHS_THRESHOLD
     #define ION_EXTRACTOR_ACTIVATE_ALL_PATHS(map) memset(map, 0xFF, ION_EXTRACTOR_PATH_BITMAP_BYTE_SIZE)
@@ -39,12 +40,85 @@
 #define ION_EXTRACTOR_GET_COMPONENT(extractor, path_depth, path_index) \
     &(extractor)->_path_components[(path_depth) * (extractor)->_options.max_num_paths + (path_index)]
 
+#define ION_EXTRACTOR_GET_PREDICATES(extractor, depth, path_index) \
+    &(extractor)->_predicates[(depth) * (extractor)->_options.max_num_paths + (path_index)]
+
+/**
+ * The last candidate of a container whose children may all match.
+ */
+#define ION_EXTRACTOR_ALL_CHILDREN INT64_MAX
+
 #define ION_EXTRACTOR_FIELD_ANNOTATION "$ion_extractor_field"
 #define ION_EXTRACTOR_WILDCARD "*"
 
+// a binary reader's field symbol IDs are remembered as standing for this when no registered path has their text
+static ION_EXTRACTOR_FIELD _ion_extractor_no_field;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static __inline int _ion_extractor_first_path(uint64_t bits) {
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+}
+#else
+#define _ion_extractor_first_path(bits) __builtin_ctzll(bits)
+#endif
+
+bool _ion_extractor_string_equals_nocase(ION_STRING *lhs, ION_STRING *rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
+    if (lhs->length != rhs->length) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs->length; i++) {
+        if (tolower((char)lhs->value[i]) != tolower((char)rhs->value[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int_fast8_t _ion_extractor_field_compare_fn(void *key1, void *key2, void *context) {
+    ION_EXTRACTOR *extractor = (ION_EXTRACTOR *)context;
+
+    if (extractor->_options.match_case_insensitive) {
+        return _ion_extractor_string_equals_nocase((ION_STRING *)key1, (ION_STRING *)key2) ? 0 : 1;
+    }
+    return ION_STRING_EQUALS((ION_STRING *)key1, (ION_STRING *)key2) ? 0 : 1;
+}
+
+int_fast32_t _ion_extractor_field_hash_fn(void *key, void *context) {
+    ION_EXTRACTOR *extractor = (ION_EXTRACTOR *)context;
+    ION_STRING *text = (ION_STRING *)key;
+    uint32_t hash;
+
+    if (!extractor->_options.match_case_insensitive) {
+        return _ion_index_hash_bytes(text->value, text->length);
+    }
+    // names that differ only in case must land in the same slot
+    hash = (uint32_t)text->length;
+    for (int32_t i = 0; i < text->length; i++) {
+        hash = hash * 31 + (uint32_t)tolower((char)text->value[i]);
+    }
+    return (int_fast32_t)hash;
+}
+
+int_fast8_t _ion_extractor_ordinal_compare_fn(void *key1, void *key2, void *context) {
+    ION_EXTRACTOR_ORDINAL *lhs = (ION_EXTRACTOR_ORDINAL *)key1, *rhs = (ION_EXTRACTOR_ORDINAL *)key2;
+    return (lhs->_depth == rhs->_depth && lhs->_ordinal == rhs->_ordinal) ? 0 : 1;
+}
+
+int_fast32_t _ion_extractor_ordinal_hash_fn(void *key, void *context) {
+    ION_EXTRACTOR_ORDINAL *ordinal = (ION_EXTRACTOR_ORDINAL *)key;
+    return (int_fast32_t)(ordinal->_ordinal * 31 + ordinal->_depth);
+}
+
 iERR ion_extractor_open(hEXTRACTOR *extractor, ION_EXTRACTOR_OPTIONS *options) {
     iENTER;
     ION_EXTRACTOR *pextractor = NULL;
+    ION_INDEX_OPTIONS index_options;
     SIZE len;
     ASSERT(extractor);
 
@@ -57,6 +131,7 @@ iERR ion_extractor_open(hEXTRACTOR *extractor, ION_EXTRACTOR_OPTIONS *options) {
         }
     }
 
+    memset(&index_options, 0, sizeof(index_options));
     len = sizeof(ION_EXTRACTOR);
     pextractor = (ION_EXTRACTOR *)ion_alloc_owner(len);
     *extractor = pextractor;
@@ -69,6 +144,15 @@ iERR ion_extractor_open(hEXTRACTOR *extractor, ION_EXTRACTOR_OPTIONS *options) {
     pextractor->_options.match_relative_paths = (options) ? options->match_relative_paths : false;
     pextractor->_options.match_case_insensitive = (options) ? options->match_case_insensitive : false;
 
+    index_options._memory_owner = pextractor;
+    index_options._fn_context = pextractor;
+    index_options._compare_fn = _ion_extractor_field_compare_fn;
+    index_options._hash_fn = _ion_extractor_field_hash_fn;
+    IONCHECK(_ion_index_initialize(&pextractor->_fields, &index_options));
+    index_options._compare_fn = _ion_extractor_ordinal_compare_fn;
+    index_options._hash_fn = _ion_extractor_ordinal_hash_fn;
+    IONCHECK(_ion_index_initialize(&pextractor->_ordinals, &index_options));
+
     iRETURN;
 }
 
@@ -147,11 +231,60 @@ iERR _ion_extractor_path_append_helper(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_
     component->_is_terminal = (++path->_current_length == path->_path_length);
     if (component->_is_terminal) {
         ION_EXTRACTOR_DEACTIVATE_PATH(extractor->_path_in_progress, path->_path_id);
+        ION_EXTRACTOR_ACTIVATE_PATH(extractor->_terminal_paths[path->_current_length - 1], path->_path_id);
     }
     *p_component = component;
     iRETURN;
 }
 
+iERR _ion_extractor_add_field(ION_EXTRACTOR *extractor, ION_STRING *text, ION_EXTRACTOR_SIZE depth,
+                              ION_EXTRACTOR_SIZE path_id) {
+    iENTER;
+    ION_EXTRACTOR_FIELD *field;
+    SIZE len;
+
+    field = (ION_EXTRACTOR_FIELD *)_ion_index_find(&extractor->_fields, text);
+    if (!field) {
+        // These are freed by ion_free_owner during ion_extractor_close, like the copied field strings.
+        field = ion_alloc_with_owner(extractor, sizeof(ION_EXTRACTOR_FIELD));
+        if (!field) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        len = extractor->_options.max_path_length * sizeof(ION_EXTRACTOR_ACTIVE_PATH_MAP);
+        field->_paths = ion_alloc_with_owner(extractor, len);
+        if (!field->_paths) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        memset(field->_paths, 0, len);
+        field->_text = *text;
+        IONCHECK(_ion_index_insert(&extractor->_fields, &field->_text, field));
+    }
+    ION_EXTRACTOR_ACTIVATE_PATH(field->_paths[depth], path_id);
+    iRETURN;
+}
+
+iERR _ion_extractor_add_ordinal(ION_EXTRACTOR *extractor, POSITION value, ION_EXTRACTOR_SIZE depth,
+                                ION_EXTRACTOR_SIZE path_id) {
+    iENTER;
+    ION_EXTRACTOR_ORDINAL key, *ordinal;
+
+    key._depth = depth;
+    key._ordinal = value;
+    ordinal = (ION_EXTRACTOR_ORDINAL *)_ion_index_find(&extractor->_ordinals, &key);
+    if (!ordinal) {
+        ordinal = ion_alloc_with_owner(extractor, sizeof(ION_EXTRACTOR_ORDINAL));
+        if (!ordinal) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        memset(ordinal, 0, sizeof(ION_EXTRACTOR_ORDINAL));
+        ordinal->_depth = depth;
+        ordinal->_ordinal = value;
+        IONCHECK(_ion_index_insert(&extractor->_ordinals, ordinal, ordinal));
+    }
+    ION_EXTRACTOR_ACTIVATE_PATH(ordinal->_paths, path_id);
+    iRETURN;
+}
+
 iERR ion_extractor_path_append_field(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_STRING *value) {
     iENTER;
     ION_EXTRACTOR_PATH_COMPONENT *component;
@@ -164,6 +297,9 @@ iERR ion_extractor_path_append_field(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_ST
     // to the extractor.
     IONCHECK(ion_string_copy_to_owner(path->_extractor, &component->_value.text, value));
     component->_type = FIELD;
+    ION_EXTRACTOR_ACTIVATE_PATH(path->_extractor->_field_paths[path->_current_length - 1], path->_path_id);
+    IONCHECK(_ion_extractor_add_field(path->_extractor, &component->_value.text, path->_current_length - 1,
+                                      path->_path_id));
     iRETURN;
 }
 
@@ -176,6 +312,7 @@ iERR ion_extractor_path_append_ordinal(ION_EXTRACTOR_PATH_DESCRIPTOR *path, POSI
     IONCHECK(_ion_extractor_path_append_helper(path, &component));
     component->_value.ordinal = value;
     component->_type = ORDINAL;
+    IONCHECK(_ion_extractor_add_ordinal(path->_extractor, value, path->_current_length - 1, path->_path_id));
     iRETURN;
 }
 
@@ -184,6 +321,104 @@ iERR ion_extractor_path_append_wildcard(ION_EXTRACTOR_PATH_DESCRIPTOR *path) {
     ION_EXTRACTOR_PATH_COMPONENT *component;
     IONCHECK(_ion_extractor_path_append_helper(path, &component));
     component->_type = WILDCARD;
+    ION_EXTRACTOR_ACTIVATE_PATH(path->_extractor->_wildcard_paths[path->_current_length - 1], path->_path_id);
+    iRETURN;
+}
+
+iERR _ion_extractor_path_add_predicate(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_EXTRACTOR_PREDICATE_TYPE type,
+                                       ION_EXTRACTOR_COMPARISON comparison, ION_EXTRACTOR_PREDICATE **p_predicate) {
+    iENTER;
+    ION_EXTRACTOR *extractor;
+    ION_EXTRACTOR_PREDICATE *predicate, **p_next;
+
+    if (!path) {
+        FAILWITHMSG(IERR_INVALID_ARG, "Path must be non-null.");
+    }
+    if (comparison < ION_EXTRACTOR_EQUALS || comparison > ION_EXTRACTOR_GREATER_THAN_OR_EQUALS) {
+        FAILWITHMSG(IERR_INVALID_ARG, "Unknown comparison.");
+    }
+    extractor = path->_extractor;
+    ASSERT(extractor);
+    ASSERT(p_predicate);
+
+    // Freed by ion_free_owner during ion_extractor_close.
+    predicate = ion_alloc_with_owner(extractor, sizeof(ION_EXTRACTOR_PREDICATE));
+    if (!predicate) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    memset(predicate, 0, sizeof(ION_EXTRACTOR_PREDICATE));
+    predicate->_type = type;
+    predicate->_comparison = comparison;
+    predicate->_sid = UNKNOWN_SID;
+
+    // The predicates are tested in the order they were added.
+    p_next = ION_EXTRACTOR_GET_PREDICATES(extractor, path->_current_length, path->_path_id);
+    while (*p_next) {
+        p_next = &(*p_next)->_next;
+    }
+    *p_next = predicate;
+    ION_EXTRACTOR_ACTIVATE_PATH(extractor->_predicate_paths[path->_current_length], path->_path_id);
+    *p_predicate = predicate;
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_int(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_EXTRACTOR_COMPARISON comparison,
+                                    int64_t value) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    IONCHECK(_ion_extractor_path_add_predicate(path, INT_COMPARISON, comparison, &predicate));
+    predicate->_value.integer = value;
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_float(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_EXTRACTOR_COMPARISON comparison,
+                                      double value) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    IONCHECK(_ion_extractor_path_add_predicate(path, FLOAT_COMPARISON, comparison, &predicate));
+    predicate->_value.real = value;
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_text(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_EXTRACTOR_COMPARISON comparison,
+                                     ION_STRING *value) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    if (!value || ION_STRING_IS_NULL(value)) {
+        FAILWITHMSG(IERR_INVALID_ARG, "Text must not be null.");
+    }
+    IONCHECK(_ion_extractor_path_add_predicate(path, TEXT_COMPARISON, comparison, &predicate));
+    IONCHECK(ion_string_copy_to_owner(path->_extractor, &predicate->_value.text, value));
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_timestamp(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_EXTRACTOR_COMPARISON comparison,
+                                          ION_TIMESTAMP *value) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    if (!value) {
+        FAILWITHMSG(IERR_INVALID_ARG, "Timestamp must not be null.");
+    }
+    IONCHECK(_ion_extractor_path_add_predicate(path, TIMESTAMP_COMPARISON, comparison, &predicate));
+    IONCHECK(_ion_timestamp_to_utc(value, &predicate->_value.timestamp));
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_annotation(ION_EXTRACTOR_PATH_DESCRIPTOR *path, ION_STRING *annotation) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    if (!annotation || ION_STRING_IS_NULL(annotation)) {
+        FAILWITHMSG(IERR_INVALID_ARG, "Annotation must not be null.");
+    }
+    IONCHECK(_ion_extractor_path_add_predicate(path, HAS_ANNOTATION, ION_EXTRACTOR_EQUALS, &predicate));
+    IONCHECK(ion_string_copy_to_owner(path->_extractor, &predicate->_value.text, annotation));
+    iRETURN;
+}
+
+iERR ion_extractor_path_require_non_null(ION_EXTRACTOR_PATH_DESCRIPTOR *path) {
+    iENTER;
+    ION_EXTRACTOR_PREDICATE *predicate;
+    IONCHECK(_ion_extractor_path_add_predicate(path, NON_NULL, ION_EXTRACTOR_EQUALS, &predicate));
     iRETURN;
 }
 
@@ -283,79 +518,465 @@ iERR ion_extractor_path_create_from_ion(ION_EXTRACTOR *extractor, ION_EXTRACTOR_
     iRETURN;
 }
 
-bool _ion_extractor_string_equals_nocase(ION_STRING *lhs, ION_STRING *rhs) {
-    if (lhs == rhs) {
-        return true;
+iERR _ion_extractor_find_field(ION_EXTRACTOR *extractor, ION_READER *reader, ION_EXTRACTOR_FIELD **p_field) {
+    iENTER;
+    ION_EXTRACTOR_FIELD *field = NULL;
+    ION_STRING field_name;
+    SID sid = UNKNOWN_SID;
+    int32_t capacity;
+
+    ASSERT(p_field);
+
+    *p_field = NULL;
+    if (reader->type == ion_type_binary_reader) {
+        if (!reader->typed_reader.binary._in_struct) {
+            SUCCEED();
+        }
+        // A field's symbol ID is resolved to text, and looked up, once per symbol table.
+        IONCHECK(_ion_reader_get_field_sid_helper(reader, &sid));
+        if (sid > 0 && sid <= ION_EXTRACTOR_MAX_CACHED_SID) {
+            if (extractor->_sid_reader != reader || extractor->_sid_generation != reader->_symtab_generation) {
+                if (extractor->_sid_fields) {
+                    memset(extractor->_sid_fields, 0, (extractor->_sid_fields_max + 1) * sizeof(ION_EXTRACTOR_FIELD *));
+                }
+                extractor->_sid_fields_max = 0;
+                extractor->_sid_reader = reader;
+                extractor->_sid_generation = reader->_symtab_generation;
+            }
+            if (sid < extractor->_sid_fields_capacity && extractor->_sid_fields[sid]) {
+                field = extractor->_sid_fields[sid];
+                *p_field = (field == &_ion_extractor_no_field) ? NULL : field;
+                SUCCEED();
+            }
+        }
     }
-    if (lhs->length != rhs->length) {
-        return false;
+
+    else if (reader->typed_reader.text._current_container != tid_STRUCT) {
+        SUCCEED();
     }
-    for (size_t i = 0; i < lhs->length; i++) {
-        if (tolower((char)lhs->value[i]) != tolower((char)rhs->value[i])) {
-            return false;
+
+    IONCHECK(ion_reader_get_field_name(reader, &field_name));
+    if (!ION_STRING_IS_NULL(&field_name)) {
+        field = (ION_EXTRACTOR_FIELD *)_ion_index_find(&extractor->_fields, &field_name);
+    }
+
+    if (sid > 0 && sid <= ION_EXTRACTOR_MAX_CACHED_SID) {
+        if (sid >= extractor->_sid_fields_capacity) {
+            capacity = (extractor->_sid_fields_capacity) ? extractor->_sid_fields_capacity : DEFAULT_SYMBOL_TABLE_SIZE;
+            while (capacity <= sid) {
+                capacity *= 2;
+            }
+            // the old array stays with the extractor until it's closed
+            IONCHECK(_ion_index_grow_array((void **)&extractor->_sid_fields, extractor->_sid_fields_capacity, capacity,
+                                           sizeof(ION_EXTRACTOR_FIELD *), TRUE, extractor));
+            extractor->_sid_fields_capacity = capacity;
+        }
+        extractor->_sid_fields[sid] = (field) ? field : &_ion_extractor_no_field;
+        if (sid > extractor->_sid_fields_max) {
+            extractor->_sid_fields_max = sid;
         }
     }
-    return true;
+    *p_field = field;
+    iRETURN;
 }
 
-iERR _ion_extractor_evaluate_field_predicate(ION_READER *reader, ION_EXTRACTOR_PATH_COMPONENT *path_component,
-                                             bool is_case_insensitive, bool *matches) {
+iERR _ion_extractor_dispatch_match(ION_EXTRACTOR *extractor, ION_READER *reader, ION_EXTRACTOR_SIZE matcher_index,
+                                   ION_EXTRACTOR_CONTROL *control) {
     iENTER;
-    ION_STRING field_name;
+    ION_EXTRACTOR_MATCHER *matcher;
+    SIZE old_depth, new_depth;
 
-    ASSERT(path_component->_type == FIELD);
+    matcher = &extractor->_matchers[matcher_index];
+    IONCHECK(ion_reader_get_depth(reader, &old_depth));
+    IONCHECK(matcher->_callback(reader, matcher->_path, matcher->_user_context, control));
+    IONCHECK(ion_reader_get_depth(reader, &new_depth));
+    if (old_depth != new_depth) {
+        FAILWITHMSG(IERR_INVALID_STATE, "Reader must be positioned at same depth after callback returns.");
+    }
 
-    IONCHECK(ion_reader_get_field_name(reader, &field_name));
-    if (is_case_insensitive) {
-        *matches = _ion_extractor_string_equals_nocase(&field_name, &path_component->_value.text);
+    iRETURN;
+}
+
+/**
+ * Whether a value that compared to an operand as `order` (negative, zero or positive) satisfies the comparison.
+ */
+static BOOL _ion_extractor_satisfies(ION_EXTRACTOR_COMPARISON comparison, int order) {
+    switch (comparison) {
+        case ION_EXTRACTOR_EQUALS:                  return order == 0;
+        case ION_EXTRACTOR_NOT_EQUALS:              return order != 0;
+        case ION_EXTRACTOR_LESS_THAN:               return order < 0;
+        case ION_EXTRACTOR_LESS_THAN_OR_EQUALS:     return order <= 0;
+        case ION_EXTRACTOR_GREATER_THAN:            return order > 0;
+        case ION_EXTRACTOR_GREATER_THAN_OR_EQUALS:  return order >= 0;
+        default:                                    return FALSE;
+    }
+}
+
+/**
+ * Finds the symbol ID of the predicate's text in the reader's current symbol table, once per symbol table.
+ */
+iERR _ion_extractor_predicate_sid(ION_EXTRACTOR_PREDICATE *predicate, ION_READER *reader, SID *p_sid) {
+    iENTER;
+    if (predicate->_sid_reader != reader || predicate->_sid_generation != reader->_symtab_generation) {
+        IONCHECK(_ion_symbol_table_find_by_name_helper(reader->_current_symtab, &predicate->_value.text,
+                                                       &predicate->_sid, NULL, FALSE));
+        predicate->_sid_reader = reader;
+        predicate->_sid_generation = reader->_symtab_generation;
+    }
+    *p_sid = predicate->_sid;
+    iRETURN;
+}
+
+iERR _ion_extractor_compare_int(ION_READER *reader, int64_t operand, int *p_order) {
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_INT *big;
+    BYTE *bytes;
+    SIZE len, i;
+    uint64_t magnitude = 0;
+    int64_t value;
+    BOOL is_negative;
+    int sign;
+
+    if (reader->type == ion_type_binary_reader) {
+        // The magnitude is the value's contents, big-endian, and the sign is in its type code.
+        binary = &reader->typed_reader.binary;
+        IONCHECK(_ion_reader_binary_peek_contents(reader, &bytes, &len));
+        is_negative = (getTypeCode(binary->_value_tid) == TID_NEG_INT);
+        for (i = 0; i < len && bytes[i] == 0; i++) {
+            // leading zeros don't count toward the magnitude's length
+        }
+        if (len - i > (SIZE)sizeof(uint64_t)) {
+            *p_order = is_negative ? -1 : 1;
+            SUCCEED();
+        }
+        for (; i < len; i++) {
+            magnitude = (magnitude << 8) | bytes[i];
+        }
+        if (is_negative) {
+            if (magnitude > (uint64_t)INT64_MAX + 1) {
+                *p_order = -1;
+                SUCCEED();
+            }
+            // the negation is done on the unsigned magnitude so that INT64_MIN doesn't overflow
+            value = (int64_t)(0 - magnitude);
+        }
+        else {
+            if (magnitude > (uint64_t)INT64_MAX) {
+                *p_order = 1;
+                SUCCEED();
+            }
+            value = (int64_t)magnitude;
+        }
     }
     else {
-        *matches = ION_STRING_EQUALS(&field_name, &path_component->_value.text);
+        err = ion_reader_read_int64(reader, &value);
+        if (err == IERR_NUMERIC_OVERFLOW) {
+            // Too big for any int64_t operand, in one direction or the other.
+            IONCHECK(ion_int_alloc(NULL, &big));
+            err = ion_reader_read_ion_int(reader, big);
+            if (err == IERR_OK) {
+                err = ion_int_signum(big, &sign);
+            }
+            ion_int_free(big);
+            IONCHECK(err);
+            *p_order = sign;
+            SUCCEED();
+        }
+        IONCHECK(err);
     }
+    *p_order = (value < operand) ? -1 : (value > operand) ? 1 : 0;
     iRETURN;
 }
 
-iERR _ion_extractor_evaluate_predicate(ION_READER *reader, ION_EXTRACTOR_PATH_COMPONENT *path_component,
-                                       POSITION ordinal, bool is_case_insensitive, bool *matches) {
+iERR _ion_extractor_compare_float(ION_READER *reader, double operand, int *p_order, BOOL *p_is_ordered) {
     iENTER;
+    BYTE *bytes;
+    SIZE len, i;
+    uint64_t image = 0;
+    uint32_t image_32;
+    float value_32;
+    double value;
 
-    ASSERT(reader);
-    ASSERT(path_component);
-    ASSERT(matches);
+    if (reader->type == ion_type_binary_reader) {
+        // 0, 4 or 8 bytes of big-endian IEEE 754.
+        IONCHECK(_ion_reader_binary_peek_contents(reader, &bytes, &len));
+        for (i = 0; i < len; i++) {
+            image = (image << 8) | bytes[i];
+        }
+        if (len == 0) {
+            value = 0;
+        }
+        else if (len == sizeof(float)) {
+            image_32 = (uint32_t)image;
+            memcpy(&value_32, &image_32, sizeof(float));
+            value = value_32;
+        }
+        else if (len == sizeof(double)) {
+            memcpy(&value, &image, sizeof(double));
+        }
+        else {
+            FAILWITH(IERR_INVALID_BINARY);
+        }
+    }
+    else {
+        IONCHECK(ion_reader_read_double(reader, &value));
+    }
+    *p_is_ordered = !(isnan(value) || isnan(operand));
+    *p_order = (value < operand) ? -1 : (value > operand) ? 1 : 0;
+    iRETURN;
+}
 
-    *matches = false;
+iERR _ion_extractor_compare_text(ION_READER *reader, ION_EXTRACTOR_PREDICATE *predicate, int *p_order,
+                                 BOOL *p_is_known) {
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_STRING text, *ptext = NULL;
+    SID sid, operand_sid;
+    int order;
 
-    switch (path_component->_type) {
-        case FIELD:
-            IONCHECK(_ion_extractor_evaluate_field_predicate(reader, path_component, is_case_insensitive, matches));
-            break;
-        case ORDINAL:
-            *matches = ordinal == path_component->_value.ordinal;
-            break;
-        case WILDCARD:
-            // TODO different types of wildcards?
-            *matches = true;
-            break;
-        default:
-            FAILWITH(IERR_INVALID_STATE);
+    *p_is_known = TRUE;
+    if (reader->type == ion_type_binary_reader) {
+        binary = &reader->typed_reader.binary;
+        if (getTypeCode(binary->_value_tid) == TID_SYMBOL) {
+            // Symbols have already been read as far as their symbol ID, which is the operand's when they're equal.
+            sid = binary->_value_symbol_id;
+            IONCHECK(_ion_extractor_predicate_sid(predicate, reader, &operand_sid));
+            if (sid == operand_sid && sid > 0) {
+                *p_order = 0;
+                SUCCEED();
+            }
+            // A symbol table can give the same text more than one symbol ID, so that's not the last word.
+            if (sid > 0) {
+                IONCHECK(_ion_symbol_table_find_by_sid_helper(reader->_current_symtab, sid, &ptext));
+            }
+            if (!ptext || ION_STRING_IS_NULL(ptext)) {
+                *p_is_known = FALSE;
+                SUCCEED();
+            }
+            text = *ptext;
+        }
+        else {
+            IONCHECK(_ion_reader_binary_peek_contents(reader, &text.value, &text.length));
+        }
+    }
+    else {
+        IONCHECK(ion_reader_read_string(reader, &text));
+        if (ION_STRING_IS_NULL(&text)) {
+            *p_is_known = FALSE;
+            SUCCEED();
+        }
+    }
+    order = memcmp(text.value, predicate->_value.text.value,
+                   (size_t)((text.length < predicate->_value.text.length) ? text.length : predicate->_value.text.length));
+    if (order == 0) {
+        order = text.length - predicate->_value.text.length;
     }
+    *p_order = order;
     iRETURN;
 }
 
-iERR _ion_extractor_dispatch_match(ION_EXTRACTOR *extractor, ION_READER *reader, ION_EXTRACTOR_SIZE matcher_index,
-                                   ION_EXTRACTOR_CONTROL *control) {
+/**
+ * Gets the fields of a UTC timestamp down to the second, with those beyond its precision at their lowest value, so
+ * that timestamps of any precision compare as points in time.
+ */
+static void _ion_extractor_timestamp_fields(ION_TIMESTAMP *utc, int fields[6]) {
+    fields[0] = utc->year;
+    fields[1] = IS_FLAG_ON(utc->precision, ION_TT_BIT_MONTH) ? utc->month : 1;
+    fields[2] = IS_FLAG_ON(utc->precision, ION_TT_BIT_DAY) ? utc->day : 1;
+    fields[3] = IS_FLAG_ON(utc->precision, ION_TT_BIT_MIN) ? utc->hours : 0;
+    fields[4] = IS_FLAG_ON(utc->precision, ION_TT_BIT_MIN) ? utc->minutes : 0;
+    fields[5] = IS_FLAG_ON(utc->precision, ION_TT_BIT_SEC) ? utc->seconds : 0;
+}
+
+static int _ion_extractor_compare_timestamp_fields(int lhs[6], int rhs[6]) {
+    int i;
+    for (i = 0; i < 6; i++) {
+        if (lhs[i] != rhs[i]) {
+            return (lhs[i] < rhs[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+iERR _ion_extractor_compare_utc_timestamps(ION_READER *reader, ION_TIMESTAMP *lhs, ION_TIMESTAMP *rhs, int *p_order) {
     iENTER;
-    ION_EXTRACTOR_MATCHER *matcher;
-    SIZE old_depth, new_depth;
+    int lhs_fields[6], rhs_fields[6];
+    decQuad zero, result;
+    decQuad *lhs_fraction = &zero, *rhs_fraction = &zero;
 
-    matcher = &extractor->_matchers[matcher_index];
-    IONCHECK(ion_reader_get_depth(reader, &old_depth));
-    IONCHECK(matcher->_callback(reader, matcher->_path, matcher->_user_context, control));
-    IONCHECK(ion_reader_get_depth(reader, &new_depth));
-    if (old_depth != new_depth) {
-        FAILWITHMSG(IERR_INVALID_STATE, "Reader must be positioned at same depth after callback returns.");
+    _ion_extractor_timestamp_fields(lhs, lhs_fields);
+    _ion_extractor_timestamp_fields(rhs, rhs_fields);
+    *p_order = _ion_extractor_compare_timestamp_fields(lhs_fields, rhs_fields);
+    if (*p_order != 0) {
+        SUCCEED();
     }
+    decQuadZero(&zero);
+    if (IS_FLAG_ON(lhs->precision, ION_TT_BIT_FRAC)) lhs_fraction = &lhs->fraction;
+    if (IS_FLAG_ON(rhs->precision, ION_TT_BIT_FRAC)) rhs_fraction = &rhs->fraction;
+    decQuadCompare(&result, lhs_fraction, rhs_fraction, &reader->_deccontext);
+    *p_order = decQuadIsZero(&result) ? 0 : decQuadIsSigned(&result) ? -1 : 1;
+    iRETURN;
+}
 
+iERR _ion_extractor_compare_timestamp(ION_READER *reader, ION_TIMESTAMP *operand, int *p_order) {
+    iENTER;
+    ION_STREAM *stream = NULL;
+    ION_TIMESTAMP value, utc;
+    BYTE *bytes;
+    SIZE len, pos = 0;
+    int fields[6], operand_fields[6], i;
+    BOOL has_fraction = FALSE;
+
+    if (reader->type == ion_type_binary_reader) {
+        // The contents are the local offset, then the UTC year (one or two bytes), month, day, hour, minute and second
+        // (a byte each), as far as the precision goes, and then the fraction's exponent and coefficient.
+        IONCHECK(_ion_reader_binary_peek_contents(reader, &bytes, &len));
+        while (pos < len && !(bytes[pos++] & 0x80)) {
+            // the local offset doesn't matter, since the fields are in UTC
+        }
+        if (pos >= len) FAILWITH(IERR_INVALID_BINARY);
+        fields[0] = bytes[pos] & 0x7F;
+        if (!(bytes[pos++] & 0x80)) {
+            if (pos >= len) FAILWITH(IERR_INVALID_BINARY);
+            fields[0] = (fields[0] << 7) | (bytes[pos++] & 0x7F);
+        }
+        fields[1] = fields[2] = 1;
+        fields[3] = fields[4] = fields[5] = 0;
+        for (i = 1; i < 6 && pos < len; i++) {
+            fields[i] = bytes[pos++] & 0x7F;
+        }
+        if (pos < len) {
+            while (pos < len && !(bytes[pos++] & 0x80)) {
+                // the fraction's exponent
+            }
+            for (i = 0; pos < len; pos++, i++) {
+                if (bytes[pos] & ((i == 0) ? 0x7F : 0xFF)) {
+                    has_fraction = TRUE;
+                }
+            }
+        }
+        _ion_extractor_timestamp_fields(operand, operand_fields);
+        *p_order = _ion_extractor_compare_timestamp_fields(fields, operand_fields);
+        if (*p_order != 0 || (!has_fraction && !IS_FLAG_ON(operand->precision, ION_TT_BIT_FRAC))) {
+            SUCCEED();
+        }
+        // They're equal to the second, so the fractions decide, which takes decoding the whole timestamp.
+        IONCHECK(ion_stream_open_buffer(bytes, len, len, TRUE, &stream));
+        err = ion_binary_read_timestamp(stream, len, &reader->_deccontext, &value);
+        ion_stream_close(stream);
+        IONCHECK(err);
+    }
+    else {
+        IONCHECK(ion_reader_read_timestamp(reader, &value));
+    }
+    IONCHECK(_ion_timestamp_to_utc(&value, &utc));
+    IONCHECK(_ion_extractor_compare_utc_timestamps(reader, &utc, operand, p_order));
+    iRETURN;
+}
+
+iERR _ion_extractor_has_annotation(ION_READER *reader, ION_EXTRACTOR_PREDICATE *predicate, BOOL *p_found) {
+    iENTER;
+    ION_BINARY_READER *binary;
+    SID sid;
+    int i;
+
+    *p_found = FALSE;
+    if (reader->type == ion_type_binary_reader) {
+        binary = &reader->typed_reader.binary;
+        IONCHECK(_ion_extractor_predicate_sid(predicate, reader, &sid));
+        if (sid > 0) {
+            for (i = 0; i < binary->_annotation_count; i++) {
+                if (binary->_annotation_sids[i] == sid) {
+                    *p_found = TRUE;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        IONCHECK(ion_reader_has_annotation(reader, &predicate->_value.text, p_found));
+    }
+    iRETURN;
+}
+
+/**
+ * Tests whether the value the reader is positioned on satisfies all of the given predicates, without moving off it.
+ */
+iERR _ion_extractor_test_predicates(ION_READER *reader, ION_EXTRACTOR_PREDICATE *predicate, BOOL *p_satisfied) {
+    iENTER;
+    ION_TYPE type;
+    BOOL is_null, found, is_comparable;
+    int order = 0;
+
+    IONCHECK(ion_reader_get_type(reader, &type));
+    IONCHECK(ion_reader_is_null(reader, &is_null));
+    *p_satisfied = FALSE;
+    for (; predicate; predicate = predicate->_next) {
+        is_comparable = TRUE;
+        switch (predicate->_type) {
+            case NON_NULL:
+                if (is_null) SUCCEED();
+                continue;
+            case HAS_ANNOTATION:
+                IONCHECK(_ion_extractor_has_annotation(reader, predicate, &found));
+                if (!found) SUCCEED();
+                continue;
+            case INT_COMPARISON:
+                if (is_null || type != tid_INT) SUCCEED();
+                IONCHECK(_ion_extractor_compare_int(reader, predicate->_value.integer, &order));
+                break;
+            case FLOAT_COMPARISON:
+                if (is_null || type != tid_FLOAT) SUCCEED();
+                IONCHECK(_ion_extractor_compare_float(reader, predicate->_value.real, &order, &is_comparable));
+                break;
+            case TEXT_COMPARISON:
+                if (is_null || (type != tid_STRING && type != tid_SYMBOL)) SUCCEED();
+                IONCHECK(_ion_extractor_compare_text(reader, predicate, &order, &is_comparable));
+                break;
+            case TIMESTAMP_COMPARISON:
+                if (is_null || type != tid_TIMESTAMP) SUCCEED();
+                IONCHECK(_ion_extractor_compare_timestamp(reader, &predicate->_value.timestamp, &order));
+                break;
+            default:
+                FAILWITH(IERR_INVALID_STATE);
+        }
+        // Values that can't be ordered against the operand (NaN, unknown symbols) are only unequal to it.
+        if (is_comparable ? !_ion_extractor_satisfies(predicate->_comparison, order)
+                          : predicate->_comparison != ION_EXTRACTOR_NOT_EQUALS) {
+            SUCCEED();
+        }
+    }
+    *p_satisfied = TRUE;
+    iRETURN;
+}
+
+/**
+ * Removes the paths whose predicates at this depth the current value doesn't satisfy from `words`, and from
+ * `also_words` if it's given.
+ */
+iERR _ion_extractor_filter_predicates(ION_EXTRACTOR *extractor, ION_READER *reader, SIZE depth, uint_fast64_t *words,
+                                      uint_fast64_t *also_words) {
+    iENTER;
+    uint_fast64_t bits;
+    ION_EXTRACTOR_SIZE i;
+    BOOL satisfied;
+    int w;
+
+    for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+        bits = words[w] & ION_EXTRACTOR_PATH_MAP_WORDS_OF(extractor->_predicate_paths[depth])[w];
+        for (; bits; bits &= bits - 1) {
+            i = (ION_EXTRACTOR_SIZE)(w * ION_EXTRACTOR_MAX_NUM_PATHS_THRESHOLD + _ion_extractor_first_path(bits));
+            IONCHECK(_ion_extractor_test_predicates(reader, *ION_EXTRACTOR_GET_PREDICATES(extractor, depth, i),
+                                                    &satisfied));
+            if (!satisfied) {
+                words[w] &= ~(bits & (0 - bits));
+                if (also_words) {
+                    also_words[w] &= ~(bits & (0 - bits));
+                }
+            }
+        }
+    }
     iRETURN;
 }
 
@@ -364,44 +985,80 @@ iERR _ion_extractor_evaluate_predicates(ION_EXTRACTOR *extractor, ION_READER *re
                                         ION_EXTRACTOR_ACTIVE_PATH_MAP previous_depth_actives,
                                         ION_EXTRACTOR_ACTIVE_PATH_MAP *current_depth_actives) {
     iENTER;
+    ION_EXTRACTOR_ACTIVE_PATH_MAP matches, terminals;
+    ION_EXTRACTOR_FIELD *field = NULL;
+    ION_EXTRACTOR_ORDINAL key, *ordinal_paths = NULL;
+    uint_fast64_t *match_words, *terminal_words, *words, bits;
     ION_EXTRACTOR_SIZE i;
-    bool matches;
-    ION_EXTRACTOR_PATH_COMPONENT *path_component = NULL;
+    int w;
     ASSERT(current_depth_actives);
     ASSERT(depth >= 0);
     // This depth should not have been stepped into if nothing matched at the previous depth.
-    ASSERT(depth > 0 ? previous_depth_actives != 0 : TRUE);
+    ASSERT(depth > 0 ? ION_EXTRACTOR_ANY_PATHS_ACTIVE(previous_depth_actives) : TRUE);
     // NOTE: The following is not a user error because reaching this point requires an active path at this depth and
     // depths above the max path length are rejected at construction.
     ASSERT(depth <= extractor->_options.max_path_length);
 
     *control = ion_extractor_control_next();
-    for (i = 0; i < extractor->_matchers_length; i++) {
-        if (ION_EXTRACTOR_IS_PATH_ACTIVE(previous_depth_actives, i)) {
-            if (depth == 0) {
-                matches = true;
+    match_words = ION_EXTRACTOR_PATH_MAP_WORDS_OF(matches);
+    terminal_words = ION_EXTRACTOR_PATH_MAP_WORDS_OF(terminals);
+    words = ION_EXTRACTOR_PATH_MAP_WORDS_OF(previous_depth_actives);
+
+    if (depth == 0) {
+        // Matches at depth == 0 require a length-zero path, which ends here. Length zero paths are not stored in the
+        // extractor's path components array, to keep it as dense as possible.
+        for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+            match_words[w] = terminal_words[w] = words[w];
+        }
+        // Any path may have predicates on the value it starts from, which the longer ones need before stepping in.
+        if (ION_EXTRACTOR_ANY_PATHS_ACTIVE(extractor->_predicate_paths[0])) {
+            IONCHECK(_ion_extractor_filter_predicates(extractor, reader, 0,
+                                                      ION_EXTRACTOR_PATH_MAP_WORDS_OF(*current_depth_actives),
+                                                      terminal_words));
+        }
+    }
+    else {
+        // The paths whose component at this depth matches the value: the wildcards, plus those with the value's field
+        // name or ordinal, which are one lookup each however many paths are registered.
+        if (!ION_INDEX_IS_EMPTY(&extractor->_fields)) {
+            IONCHECK(_ion_extractor_find_field(extractor, reader, &field));
+        }
+        if (!ION_INDEX_IS_EMPTY(&extractor->_ordinals)) {
+            key._depth = (ION_EXTRACTOR_SIZE)(depth - 1);
+            key._ordinal = ordinal;
+            ordinal_paths = (ION_EXTRACTOR_ORDINAL *)_ion_index_find(&extractor->_ordinals, &key);
+        }
+        for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+            match_words[w] = ION_EXTRACTOR_PATH_MAP_WORDS_OF(extractor->_wildcard_paths[depth - 1])[w];
+            if (field) {
+                match_words[w] |= ION_EXTRACTOR_PATH_MAP_WORDS_OF(field->_paths[depth - 1])[w];
             }
-            else {
-                path_component = ION_EXTRACTOR_GET_COMPONENT(extractor, depth - 1, i);
-                ASSERT(path_component);
-                IONCHECK(_ion_extractor_evaluate_predicate(reader, path_component, ordinal,
-                                                           extractor->_options.match_case_insensitive, &matches));
+            if (ordinal_paths) {
+                match_words[w] |= ION_EXTRACTOR_PATH_MAP_WORDS_OF(ordinal_paths->_paths)[w];
             }
-            if (matches) {
-                if (!path_component || path_component->_is_terminal) {
-                    // Matches at depth == 0 require a length-zero path. This is treated as a special case to keep the
-                    // extractor's path components array as dense as possible -- length zero paths are not stored, and
-                    // are instead treated as NULL here.
-                    ASSERT((!path_component) ? depth == 0 : TRUE);
-                    IONCHECK(_ion_extractor_dispatch_match(extractor, reader, i, control));
-                    if (*control) {
-                        if (*control > depth) {
-                            FAILWITHMSG(IERR_INVALID_STATE, "Received a control instruction to step out past current depth.")
-                        }
-                        SUCCEED();
-                    }
+            // Only the paths that were still active at the previous depth can match.
+            match_words[w] &= words[w];
+        }
+        if (ION_EXTRACTOR_ANY_PATHS_ACTIVE(extractor->_predicate_paths[depth])) {
+            IONCHECK(_ion_extractor_filter_predicates(extractor, reader, depth, match_words, NULL));
+        }
+        for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+            terminal_words[w] = match_words[w] & ION_EXTRACTOR_PATH_MAP_WORDS_OF(extractor->_terminal_paths[depth - 1])[w];
+            // Paths that end here have nothing to match below the value.
+            ION_EXTRACTOR_PATH_MAP_WORDS_OF(*current_depth_actives)[w] |= match_words[w] & ~terminal_words[w];
+        }
+    }
+
+    // Callbacks are invoked in the order the paths were registered.
+    for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+        for (bits = terminal_words[w]; bits; bits &= bits - 1) {
+            i = (ION_EXTRACTOR_SIZE)(w * ION_EXTRACTOR_MAX_NUM_PATHS_THRESHOLD + _ion_extractor_first_path(bits));
+            IONCHECK(_ion_extractor_dispatch_match(extractor, reader, i, control));
+            if (*control) {
+                if (*control > depth) {
+                    FAILWITHMSG(IERR_INVALID_STATE, "Received a control instruction to step out past current depth.")
                 }
-                ION_EXTRACTOR_ACTIVATE_PATH(*current_depth_actives, i);
+                SUCCEED();
             }
         }
     }
@@ -409,12 +1066,57 @@ iERR _ion_extractor_evaluate_predicates(ION_EXTRACTOR *extractor, ION_READER *re
     iRETURN;
 }
 
+/**
+ * Finds the children of a container at the given depth that the active paths could match: none, when they only have
+ * field names to match and the container isn't a struct; every child, when one of them has a wildcard or a field name
+ * it could match; and otherwise the children between the lowest and highest of their ordinals. The rest are skipped
+ * without being evaluated, and a binary reader skips them by their lengths, without decoding them.
+ */
+void _ion_extractor_find_candidates(ION_EXTRACTOR *extractor, SIZE depth, ION_TYPE container_type,
+                                    ION_EXTRACTOR_ACTIVE_PATH_MAP actives, POSITION *p_first, POSITION *p_last) {
+    ION_EXTRACTOR_PATH_COMPONENT *component;
+    uint_fast64_t *words, bits;
+    ION_EXTRACTOR_SIZE i;
+    POSITION first = -1, last = -1;
+    int w;
+
+    words = ION_EXTRACTOR_PATH_MAP_WORDS_OF(actives);
+    for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+        bits = ION_EXTRACTOR_PATH_MAP_WORDS_OF(extractor->_wildcard_paths[depth - 1])[w];
+        if (container_type == tid_STRUCT) {
+            bits |= ION_EXTRACTOR_PATH_MAP_WORDS_OF(extractor->_field_paths[depth - 1])[w];
+        }
+        if (words[w] & bits) {
+            *p_first = 0;
+            *p_last = ION_EXTRACTOR_ALL_CHILDREN;
+            return;
+        }
+    }
+    for (w = 0; w < ION_EXTRACTOR_PATH_MAP_WORDS; w++) {
+        for (bits = words[w]; bits; bits &= bits - 1) {
+            i = (ION_EXTRACTOR_SIZE)(w * ION_EXTRACTOR_MAX_NUM_PATHS_THRESHOLD + _ion_extractor_first_path(bits));
+            component = ION_EXTRACTOR_GET_COMPONENT(extractor, depth - 1, i);
+            if (component->_type != ORDINAL) {
+                continue;
+            }
+            if (first < 0 || component->_value.ordinal < first) {
+                first = component->_value.ordinal;
+            }
+            if (component->_value.ordinal > last) {
+                last = component->_value.ordinal;
+            }
+        }
+    }
+    *p_first = first;
+    *p_last = last;
+}
+
 iERR _ion_extractor_match_helper(hEXTRACTOR extractor, ION_READER *reader, SIZE depth,
-                                 ION_EXTRACTOR_ACTIVE_PATH_MAP previous_depth_actives,
-                                 ION_EXTRACTOR_CONTROL *control) {
+                                 ION_EXTRACTOR_ACTIVE_PATH_MAP previous_depth_actives, POSITION first_candidate,
+                                 POSITION last_candidate, ION_EXTRACTOR_CONTROL *control) {
     iENTER;
     ION_TYPE t;
-    POSITION ordinal = 0;
+    POSITION ordinal = 0, first, last;
     ION_EXTRACTOR_ACTIVE_PATH_MAP current_depth_actives;
 
     for (;;) {
@@ -422,6 +1124,10 @@ iERR _ion_extractor_match_helper(hEXTRACTOR extractor, ION_READER *reader, SIZE
         if (t == tid_EOF) {
             break;
         }
+        if (ordinal < first_candidate) {
+            ordinal++;
+            continue;
+        }
         // Each value at depth N can match any active partial path from depth N - 1.
         ION_EXTRACTOR_DEACTIVATE_ALL_PATHS(current_depth_actives);
         if (depth == 0) {
@@ -434,7 +1140,6 @@ iERR _ion_extractor_match_helper(hEXTRACTOR extractor, ION_READER *reader, SIZE
             *control -= 1;
             SUCCEED();
         }
-        ordinal++;
         switch(ION_TYPE_INT(t)) {
             case tid_NULL_INT:
             case tid_BOOL_INT:
@@ -446,23 +1151,33 @@ iERR _ion_extractor_match_helper(hEXTRACTOR extractor, ION_READER *reader, SIZE
             case tid_STRING_INT:
             case tid_CLOB_INT:
             case tid_BLOB_INT:
-                continue;
+                break;
             case tid_LIST_INT:
             case tid_SEXP_INT:
             case tid_STRUCT_INT:
-                if (ION_EXTRACTOR_ANY_PATHS_ACTIVE(current_depth_actives)) {
-                    IONCHECK(ion_reader_step_in(reader));
-                    IONCHECK(_ion_extractor_match_helper(extractor, reader, depth + 1, current_depth_actives, control));
-                    IONCHECK(ion_reader_step_out(reader));
-                    if (*control) {
-                        *control -= 1;
-                        SUCCEED();
-                    }
+                if (!ION_EXTRACTOR_ANY_PATHS_ACTIVE(current_depth_actives)) {
+                    break;
                 }
-                continue;
+                _ion_extractor_find_candidates(extractor, depth + 1, t, current_depth_actives, &first, &last);
+                if (last < 0) {
+                    break;
+                }
+                IONCHECK(ion_reader_step_in(reader));
+                IONCHECK(_ion_extractor_match_helper(extractor, reader, depth + 1, current_depth_actives, first, last,
+                                                     control));
+                IONCHECK(ion_reader_step_out(reader));
+                if (*control) {
+                    *control -= 1;
+                    SUCCEED();
+                }
+                break;
             default:
                 FAILWITH(IERR_INVALID_STATE);
         }
+        if (ordinal++ == last_candidate) {
+            // Nothing after this can match; stepping out skips the rest of the container.
+            break;
+        }
     }
     iRETURN;
 }
@@ -485,7 +1200,8 @@ iERR ion_extractor_match(ION_EXTRACTOR *extractor, ION_READER *reader) {
         FAILWITHMSG(IERR_INVALID_STATE, "Reader must be at depth 0 to start matching.");
     }
     if (extractor->_matchers_length) {
-        IONCHECK(_ion_extractor_match_helper(extractor, reader, 0, extractor->_depth_zero_active_paths, &control));
+        IONCHECK(_ion_extractor_match_helper(extractor, reader, 0, extractor->_depth_zero_active_paths, 0,
+                                              ION_EXTRACTOR_ALL_CHILDREN, &control));
     }
     iRETURN;
 }
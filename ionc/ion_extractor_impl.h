@@ -48,6 +48,23 @@ extern "C" {
     typedef uint_fast64_t ION_EXTRACTOR_ACTIVE_PATH_MAP;
 #endif
 
+/**
+ * The number of words in a path map, and a pointer to the first of them, so that maps can be combined a word at a time
+ * whichever of the two representations they have.
+ */
+#if ION_EXTRACTOR_MAX_NUM_PATHS > ION_EXTRACTOR_MAX_NUM_PATHS_THRESHOLD
+    #define ION_EXTRACTOR_PATH_MAP_WORDS ION_EXTRACTOR_PATH_BITMAP_SIZE
+    #define ION_EXTRACTOR_PATH_MAP_WORDS_OF(map) (map)
+#else
+    #define ION_EXTRACTOR_PATH_MAP_WORDS 1
+    #define ION_EXTRACTOR_PATH_MAP_WORDS_OF(map) (&(map))
+#endif
+
+/**
+ * Limit on the symbol IDs whose fields the extractor remembers. Fields with higher symbol IDs are looked up by text.
+ */
+#define ION_EXTRACTOR_MAX_CACHED_SID 0xFFFF
+
 /**
  * A descriptor for a path for the extractor to match.
  */
@@ -130,6 +147,99 @@ typedef struct _ion_extractor_path_component {
 
 } ION_EXTRACTOR_PATH_COMPONENT;
 
+/**
+ * The paths which have a particular field name as a component. The paths registered to an extractor are compiled into
+ * one of these per distinct field name, plus the per-depth wildcard and ordinal maps, so finding every path a value
+ * matches takes a lookup or two no matter how many paths there are.
+ */
+typedef struct _ion_extractor_field {
+    /**
+     * The field name, which is the key of this field in the extractor's `_fields`.
+     */
+    ION_STRING _text;
+
+    /**
+     * The paths with this field name as their component at each depth, indexed by depth - 1. There are
+     * `max_path_length` of them.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP *_paths;
+
+} ION_EXTRACTOR_FIELD;
+
+/**
+ * The paths which have a particular ordinal as their component at a particular depth.
+ */
+typedef struct _ion_extractor_ordinal {
+    /**
+     * The depth of the component, minus 1.
+     */
+    ION_EXTRACTOR_SIZE _depth;
+
+    /**
+     * The ordinal.
+     */
+    POSITION _ordinal;
+
+    /**
+     * The paths with this ordinal as their component at this depth.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP _paths;
+
+} ION_EXTRACTOR_ORDINAL;
+
+/**
+ * The kind of a predicate, which determines its operand.
+ */
+typedef enum _ion_extractor_predicate_type {
+    INT_COMPARISON          = 0,
+    FLOAT_COMPARISON        = 1,
+    TEXT_COMPARISON         = 2,
+    TIMESTAMP_COMPARISON    = 3,
+    HAS_ANNOTATION          = 4,
+    NON_NULL                = 5,
+} ION_EXTRACTOR_PREDICATE_TYPE;
+
+typedef struct _ion_extractor_predicate ION_EXTRACTOR_PREDICATE;
+
+/**
+ * A condition on the value matched by a path component. A component's predicates are a list, all of which must be
+ * satisfied.
+ */
+struct _ion_extractor_predicate {
+    ION_EXTRACTOR_PREDICATE_TYPE _type;
+
+    /**
+     * How the value compares to the operand. Unused by HAS_ANNOTATION and NON_NULL.
+     */
+    ION_EXTRACTOR_COMPARISON _comparison;
+
+    /**
+     * The operand. `text` is the text of a TEXT_COMPARISON or the annotation of a HAS_ANNOTATION, and `timestamp` is
+     * in UTC.
+     */
+    union {
+        int64_t         integer;
+        double          real;
+        ION_STRING      text;
+        ION_TIMESTAMP   timestamp;
+    } _value;
+
+    /**
+     * The symbol ID of `text` in `_sid_reader`'s symbol table at generation `_sid_generation`, so that binary symbols
+     * and annotations can be compared to it without resolving their text. UNKNOWN_SID if the symbol table doesn't have
+     * the text.
+     */
+    SID _sid;
+    ION_READER *_sid_reader;
+    int64_t _sid_generation;
+
+    /**
+     * The next predicate of the same component, or NULL.
+     */
+    ION_EXTRACTOR_PREDICATE *_next;
+
+};
+
 /**
  * Stores the data needed to convey a match to the user. One ION_EXTRACTOR_MATCHER is created per path.
  *
@@ -193,6 +303,67 @@ struct _ion_extractor {
      */
     ION_EXTRACTOR_MATCHER _matchers[ION_EXTRACTOR_MAX_NUM_PATHS];
 
+    /**
+     * The paths with a wildcard as their component at each depth, indexed by depth - 1.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP _wildcard_paths[ION_EXTRACTOR_MAX_PATH_LENGTH];
+
+    /**
+     * The paths with a field name as their component at each depth, indexed by depth - 1. These can only match the
+     * children of structs.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP _field_paths[ION_EXTRACTOR_MAX_PATH_LENGTH];
+
+    /**
+     * The predicates of all registered paths, organized by depth like `_path_components`, except that the predicates
+     * on depth zero (the values the paths start from) come first. Each is NULL, or the first of a list.
+     */
+    ION_EXTRACTOR_PREDICATE *_predicates[(ION_EXTRACTOR_MAX_PATH_LENGTH + 1) * ION_EXTRACTOR_MAX_NUM_PATHS];
+
+    /**
+     * The paths with predicates at each depth, indexed by depth.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP _predicate_paths[ION_EXTRACTOR_MAX_PATH_LENGTH + 1];
+
+    /**
+     * The paths whose last component is at each depth, indexed by depth - 1.
+     */
+    ION_EXTRACTOR_ACTIVE_PATH_MAP _terminal_paths[ION_EXTRACTOR_MAX_PATH_LENGTH];
+
+    /**
+     * The field name components of all registered paths, from field name to ION_EXTRACTOR_FIELD. If
+     * `_options.match_case_insensitive=true`, field names that differ only in case share one entry.
+     */
+    ION_INDEX _fields;
+
+    /**
+     * The ordinal components of all registered paths, from ION_EXTRACTOR_ORDINAL (by depth and ordinal) to itself.
+     */
+    ION_INDEX _ordinals;
+
+    /**
+     * The field each symbol ID of `_sid_reader`'s current symbol table stands for, NULL if that symbol ID hasn't been
+     * seen yet, or `_ion_extractor_no_field` if no path has its text. This is what lets a binary reader's fields be
+     * matched without resolving their text. It's cleared whenever the reader's symbol table changes.
+     */
+    ION_EXTRACTOR_FIELD **_sid_fields;
+
+    /**
+     * The number of elements in `_sid_fields`.
+     */
+    int32_t _sid_fields_capacity;
+
+    /**
+     * The highest symbol ID set in `_sid_fields`.
+     */
+    SID _sid_fields_max;
+
+    /**
+     * The reader and the generation of its symbol table that `_sid_fields` is good for.
+     */
+    ION_READER *_sid_reader;
+    int64_t _sid_generation;
+
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#ifndef IONC_ION_FLOAT_IMPL_H
+#define IONC_ION_FLOAT_IMPL_H
+
+#include <ionc/ion_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the most significant digits needed to round trip a double
+#define ION_FLOAT64_MAX_DIGITS   17
+
+// room for the text image of any finite double: sign, 17 digits, the decimal
+// point, up to 4 leading zeros (see _ion_float_to_string), and "e-308"
+#define ION_FLOAT_STRING_MAX     32
+
+/**
+ * Generates the shortest run of decimal digits that reads back as the given
+ * (finite, positive, non zero) value, using the Grisu3 algorithm, or, for the
+ * inputs it can't be sure of, printf: digits * 10^(*p_exponent). Of the shortest
+ * digits, these are the closest to the value. The digits are not terminated, and
+ * the buffer must hold ION_FLOAT64_MAX_DIGITS + 1 of them. Returns the number of
+ * digits written, at most ION_FLOAT64_MAX_DIGITS.
+ */
+int  _ion_float_to_shortest_digits(double value, char *digits, int *p_exponent);
+
+/**
+ * Writes the Ion text image of a finite value into buf, which must hold
+ * ION_FLOAT_STRING_MAX bytes, and returns its length. The digits are the
+ * shortest that round trip (see _ion_float_to_shortest_digits). The layout is
+ * that of printf's %g, except the exponent has no leading zeros and is always
+ * there (as "e+0" if need be), so the image is a float and never a decimal.
+ * This doesn't depend on the locale.
+ */
+SIZE _ion_float_to_string(double value, char *buf);
+
+/**
+ * Reads the NUL terminated text image of a float, as the text scanner leaves it
+ * ([-]digits[.digits][e[+-]digits], without underscores), into the nearest double.
+ * This is the Eisel-Lemire algorithm, which falls back on strtod for the rare
+ * inputs it can't decide and for anything that isn't in that form.
+ */
+double _ion_float_from_string(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //IONC_ION_FLOAT_IMPL_H
@@ -11,16 +11,10 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
  * language governing permissions and limitations under the License.
  */
-
 /*
  * these function provide indexed collections used for symbol support
- * in Ion.c.  These follow the collection pattern and use the base
- * collection heavily.  And, like ion_index, the memory used 
- * for the nodes is allocated on the parent, which is passed in when 
- * the user initializes an index.
- *
- * each collections holds a high water mark free list of nodes that
- * were previously used but aren't currently being used
+ * in Ion.c and the page lookup in paged streams, see ion_index.h
+ * for the layout of the table.
  *
  * index supports:
  *    iERR  initialize(ION_INDEX *idx, CMP_FN cmp, HASH_FN hash)
@@ -30,30 +24,24 @@
  *    BOOL  upsert    (void *key, void *data)
  *    void  delete    (void *key)
  *    void  reset     ()
- *    void  release   ()
  *
  * unlike collection index expects the caller to own the key and
  * the data objects and index itself only maintains the additional
  * data to manage these functions.
- *
- * there are also cursor macros that mirror the collection cursors
- *
- * to define the index comparison behavior the user supplies a
- * compare function and a hash function
  */
 
 #include "ion_internal.h"
 
-static inline size_t _ion_index_hash_to_bucket_index(ION_INDEX* index, ION_INDEX_NODE* node) {
-    return ((size_t) node->_hash) % index->_bucket_count;
-}
+#define II_TAG(hash)            ((uint8_t)(0x80 | ((hash) >> 25)))
+#define II_SLOT(index, hash)    ((int32_t)((hash) & (uint32_t)((index)->_slot_count - 1)))
+#define II_NEXT(index, slot)    (((slot) + 1) & ((index)->_slot_count - 1))
 
 // local functions forward declarations
-iERR  _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_options);
+iERR     _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_options);
 
-ION_INDEX_NODE **_ion_index_get_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *key);
-BOOL             _ion_index_scan_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *head, ION_INDEX_NODE *node, ION_INDEX_NODE **p_found, ION_INDEX_NODE **p_prev);
-iERR             _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_NODE **p_new_node);
+uint32_t _ion_index_hash_helper(ION_INDEX *index, void *key);
+int32_t  _ion_index_probe_helper(ION_INDEX *index, void *key, uint32_t hash);
+iERR     _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_NODE **p_new_node);
 
 
 // actual index functions
@@ -70,8 +58,6 @@ iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options)
         IONCHECK(_ion_index_set_options_helper(index, p_options));
     }
 
-    _ion_collection_initialize(index->_memory_owner, &index->_nodes, sizeof(ION_INDEX_NODE));
-
     if (p_options && p_options->_initial_size) {
         IONCHECK(_ion_index_make_room(index, p_options->_initial_size));
     }
@@ -82,102 +68,65 @@ iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options)
 iERR _ion_index_make_room(ION_INDEX *index, int32_t expected_new)
 {
     iENTER;
-    int32_t          new_key_threshold, new_bucket_count, old_bucket_count;
-    ION_INDEX_NODE **new_table, **old_table;
-    ION_INDEX_NODE  *node, *next;
-    int32_t          ii, in_use;
-    size_t           jj;
+    int32_t         new_key_threshold, new_slot_count, old_slot_count, ii, slot;
+    uint8_t        *old_tags;
+    ION_INDEX_NODE *old_slots;
+    void           *table;
 
     if (!index) FAILWITH(IERR_INVALID_ARG);
 
-    if (expected_new  + index->_key_count < index->_grow_at) {
+    if (expected_new + index->_key_count < index->_grow_at) {
         SUCCEED();
     }
 
-    // key count <= bucket * (_grow_density_percent/100)
-    // bucket count = ( key count * 100 ) / _grow_density_percent
-    new_key_threshold  = index->_key_count + expected_new;
-    new_key_threshold *= 128; // _grow_density_percent really is whole percent
-    new_key_threshold /= index->_density_target_percent_128x;
-
-    // turn this into the desired bucket size
-    new_bucket_count = index->_grow_at;
-    if (new_bucket_count < II_DEFAULT_MINIMUM) new_bucket_count = II_DEFAULT_MINIMUM;
-    while(new_bucket_count < new_key_threshold) {
-        II_GROW(new_bucket_count);
-        ASSERT(new_bucket_count);
-    }
+    // key count < slot count * (_density_target_percent_128x / 128)
+    new_key_threshold = index->_key_count + expected_new;
 
-    // grow the bucket
-    old_table = index->_bucket_table;
-    IONCHECK(_ion_index_grow_array(
-                 (void**)&index->_bucket_table
-                 ,index->_bucket_count
-                 ,new_bucket_count
-                 ,sizeof(ION_INDEX_NODE)
-                 ,FALSE
-                 ,index->_memory_owner
-    ));
-    
-    // now resplit the buckets
-    new_table = index->_bucket_table;
-    old_bucket_count = index->_bucket_count;
-    index->_bucket_count = new_bucket_count;
+    new_slot_count = index->_slot_count;
+    if (new_slot_count < II_DEFAULT_MINIMUM) new_slot_count = II_DEFAULT_MINIMUM;
+    while ((int64_t)new_slot_count * index->_density_target_percent_128x / 128 <= new_key_threshold) {
+        new_slot_count *= 2;
+        if (new_slot_count <= 0) FAILWITH(IERR_NO_MEMORY);
+    }
 
-    in_use = 0;
-    for (ii=0; ii<old_bucket_count; ii++) {
-        node = old_table[ii];
-        while(node) {
-            next = node->_next;
-            jj = _ion_index_hash_to_bucket_index( index, node );
-            if (new_table[jj] == NULL) {
-                in_use++;
-            }
-            node->_next = new_table[jj];
-            new_table[jj] = node;
-            node = next;
+    // the slots and their tags share one allocation, the tags go at the end so the slots stay aligned.
+    // Like the collections' pages, the old table belongs to the owner and goes when it does.
+    IONCHECK(_ion_index_grow_array(&table, 0, new_slot_count, sizeof(ION_INDEX_NODE) + sizeof(uint8_t), FALSE, index->_memory_owner));
+
+    old_tags = index->_slot_tags;
+    old_slots = index->_slots;
+    old_slot_count = index->_slot_count;
+
+    index->_slots = (ION_INDEX_NODE *)table;
+    index->_slot_tags = (uint8_t *)(index->_slots + new_slot_count);
+    index->_slot_count = new_slot_count;
+    index->_grow_at = (int32_t)((int64_t)new_slot_count * index->_density_target_percent_128x / 128);
+
+    // now rehash into the new table, the keys are all distinct so this only has to find empty slots
+    for (ii = 0; ii < old_slot_count; ii++) {
+        if (old_tags[ii] == II_EMPTY_TAG) continue;
+        slot = II_SLOT(index, old_slots[ii]._hash);
+        while (index->_slot_tags[slot] != II_EMPTY_TAG) {
+            slot = II_NEXT(index, slot);
         }
+        index->_slot_tags[slot] = old_tags[ii];
+        index->_slots[slot] = old_slots[ii];
     }
-    index->_bucket_in_use_count = in_use;
-    index->_bucket_count = new_bucket_count;
-
-    // next threshold
-    II_GROW(new_bucket_count);
-    index->_grow_at = new_bucket_count;
 
     iRETURN;
 }
 
 BOOL  _ion_index_exists(ION_INDEX *index, void *key)
 {
-    BOOL exists;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
-
-    memset(&node, 0, sizeof(node));
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-    if (!bucket || !(*bucket)) return FALSE;
-    
-    exists = _ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev);
-    return exists;
+    return _ion_index_probe_helper(index, key, _ion_index_hash_helper(index, key)) >= 0;
 }
 
 void *_ion_index_find(ION_INDEX *index, void *key)
 {
-    BOOL exists;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
-
-    memset(&node, 0, sizeof(node));
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-    if (!bucket || !(*bucket)) return NULL;
-
-    exists = _ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev);
-    return exists ? entry->_data : NULL;
+    int32_t slot;
+
+    slot = _ion_index_probe_helper(index, key, _ion_index_hash_helper(index, key));
+    return (slot >= 0) ? index->_slots[slot]._data : NULL;
 }
 
 iERR _ion_index_insert(ION_INDEX *index, void *key, void *data)
@@ -210,54 +159,39 @@ iERR _ion_index_upsert(ION_INDEX *index, void *key, void *data)
 void _ion_index_delete(ION_INDEX *index, void *key, void **p_data)
 {
 //  iENTER;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
+    int32_t slot, next, home;
 
+    *p_data = NULL;
     if (index->_key_count < 1) return;
 
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-
-    ASSERT(bucket); // there are some keys, there should be bucket table at least
-    if (!_ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev)) {
-        *p_data = NULL;
-        return;
-    }
-    ASSERT(entry);
-    *p_data = entry->_data; // while we still have it around
-
-    // remove this from the list
-    if (prev) {
-        prev->_next = entry->_next;
-        entry->_next = NULL; // just because this might get reused
-    }
-    else {
-        *bucket = entry->_next;
-        if (!entry->_next) index->_bucket_in_use_count--;
+    slot = _ion_index_probe_helper(index, key, _ion_index_hash_helper(index, key));
+    if (slot < 0) return;
+    *p_data = index->_slots[slot]._data; // while we still have it around
+
+    // pull the entries after this one back into the hole while that keeps them
+    // reachable from their home slot, so the probes never need tombstones
+    for (next = II_NEXT(index, slot); index->_slot_tags[next] != II_EMPTY_TAG; next = II_NEXT(index, next)) {
+        home = II_SLOT(index, index->_slots[next]._hash);
+        if (((next - home) & (index->_slot_count - 1)) >= ((next - slot) & (index->_slot_count - 1))) {
+            index->_slot_tags[slot] = index->_slot_tags[next];
+            index->_slots[slot] = index->_slots[next];
+            slot = next;
+        }
     }
+    index->_slot_tags[slot] = II_EMPTY_TAG;
     index->_key_count--;
 
-    _ion_collection_remove(&index->_nodes, entry);
-
     return;
 }
 
 void _ion_index_reset(ION_INDEX *index)
 {
-    int32_t table_size;
-
     ASSERT(index);
 
     if (index->_key_count < 1) return;
 
-    _ion_collection_reset(&index->_nodes);
-    table_size = index->_bucket_count * sizeof(ION_INDEX_NODE *);
-    if (table_size > 0) {
-        memset(index->_bucket_table, 0, table_size);
-    }
+    memset(index->_slot_tags, II_EMPTY_TAG, index->_slot_count * sizeof(uint8_t));
     index->_key_count = 0;
-    index->_bucket_in_use_count = 0;
     return;
 }
 
@@ -289,6 +223,30 @@ iERR _ion_index_grow_array(void **p_array, int32_t old_count, int32_t new_count,
     iRETURN;
 }
 
+int_fast32_t _ion_index_hash_bytes(BYTE *bytes, SIZE length)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)length;
+    uint64_t word;
+
+    // a multiply and a shift per word, the shift brings the high bits the multiply
+    // produces back down so every input bit ends up affecting the low 32 bits
+    while (length >= (SIZE)sizeof(word)) {
+        memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+        bytes += sizeof(word);
+        length -= (SIZE)sizeof(word);
+    }
+    if (length > 0) {
+        word = 0;
+        memcpy(&word, bytes, length);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+    hash ^= hash >> 32;
+    return (int_fast32_t)(uint32_t)hash;
+}
+
  
 // local function impl's
 
@@ -306,8 +264,8 @@ iERR _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_option
     index->_fn_context = p_options->_fn_context;
 
     if (p_options->_density_target_percent) {
-        index->_density_target_percent_128x  = p_options->_density_target_percent * 100;
-        index->_density_target_percent_128x /= 128;
+        if (p_options->_density_target_percent >= 100) FAILWITH(IERR_INVALID_ARG);
+        index->_density_target_percent_128x = (uint8_t)(p_options->_density_target_percent * 128 / 100);
     }
     else {
         index->_density_target_percent_128x = II_DEFAULT_128X_PERCENT;
@@ -316,83 +274,68 @@ iERR _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_option
     iRETURN;
 }
 
-// gets the initial bucket pointer and fills in the hash
-ION_INDEX_NODE **_ion_index_get_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *node)
+// the user's hash, mixed (murmur3's finalizer) so the low bits that pick the
+// slot and the high bits that make the tag both depend on all of it
+uint32_t _ion_index_hash_helper(ION_INDEX *index, void *key)
 {
-    node->_hash = (*index->_hash_fn)(node->_key, index->_fn_context);
-
-    if (!index->_bucket_count) return NULL;
-    size_t bucket_index = _ion_index_hash_to_bucket_index( index, node );
-
-    return index->_bucket_table + bucket_index;
+    uint32_t hash = (uint32_t)(*index->_hash_fn)(key, index->_fn_context);
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
 }
 
-BOOL _ion_index_scan_bucket_helper(
-     ION_INDEX *index
-    ,ION_INDEX_NODE *head
-    ,ION_INDEX_NODE *node
-    ,ION_INDEX_NODE **p_found
-    ,ION_INDEX_NODE **p_prev
-)
+// returns the slot holding key, or -1
+int32_t _ion_index_probe_helper(ION_INDEX *index, void *key, uint32_t hash)
 {
-    int_fast8_t cmp;
-    ION_INDEX_NODE *entry = NULL;
-    ION_INDEX_NODE *prev = NULL;
+    int32_t slot;
+    uint8_t tag = II_TAG(hash), slot_tag;
 
+    if (!index->_slot_count) return -1;
 
-    ASSERT(p_found);
-    ASSERT(p_prev);
-
-    if (!head) goto return_values;  
-
-    for (entry = head; entry; prev = entry, entry = entry->_next) {
-        if (entry->_hash != node->_hash) continue;
-        cmp = (*index->_compare_fn)(entry->_key, node->_key, index->_fn_context);
-        if (cmp == 0) break;
+    for (slot = II_SLOT(index, hash); (slot_tag = index->_slot_tags[slot]) != II_EMPTY_TAG; slot = II_NEXT(index, slot)) {
+        if (slot_tag != tag || index->_slots[slot]._hash != hash) continue;
+        if ((*index->_compare_fn)(index->_slots[slot]._key, key, index->_fn_context) == 0) {
+            return slot;
+        }
     }
-    goto return_values;
-
-return_values:
-    *p_found = entry;
-    *p_prev = prev;
-    return (entry != NULL);
+    return -1;
 }
 
 iERR _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_NODE **p_new_node)
 {
     iENTER;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *found, *prev;
-    ION_INDEX_NODE **bucket;
+    ION_INDEX_NODE *entry;
+    uint32_t        hash;
+    int32_t         slot;
+    uint8_t         tag, slot_tag;
 
-    // we pre-grow the bucket table so we can't avoid
-    // the "no table" edge cases - including the bucket table moving
+    // we pre-grow the table so the probe below always ends at an empty slot
     if (index->_key_count + 1 >= index->_grow_at) {
-        // if this is an EMTPY index we make room for default
+        // if this is an EMPTY index we make room for default
         // otherwise we just need room for the 1 key
-        IONCHECK(_ion_index_make_room(index, index->_bucket_count ? 1 : II_DEFAULT_MINIMUM));
+        IONCHECK(_ion_index_make_room(index, index->_slot_count ? 1 : II_DEFAULT_MINIMUM));
     }
 
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-
-    ASSERT(bucket); // since we forced buckets to exist
-    if (_ion_index_scan_bucket_helper(index, *bucket, &node, &found, &prev)) {
-        *p_new_node = found;
-        DONTFAILWITH(IERR_KEY_ALREADY_EXISTS);
+    hash = _ion_index_hash_helper(index, key);
+    tag = II_TAG(hash);
+    for (slot = II_SLOT(index, hash); (slot_tag = index->_slot_tags[slot]) != II_EMPTY_TAG; slot = II_NEXT(index, slot)) {
+        if (slot_tag != tag || index->_slots[slot]._hash != hash) continue;
+        if ((*index->_compare_fn)(index->_slots[slot]._key, key, index->_fn_context) == 0) {
+            *p_new_node = &index->_slots[slot];
+            DONTFAILWITH(IERR_KEY_ALREADY_EXISTS);
+        }
     }
 
-    // it's not there so we can add this key to the bucket
-    entry = (ION_INDEX_NODE *)_ion_collection_append(&index->_nodes);
-    if (!entry) FAILWITH(IERR_NO_MEMORY);
-    entry->_hash = node._hash;
+    // it's not there so the empty slot that ended the probe is the new key's
+    entry = &index->_slots[slot];
+    entry->_hash = hash;
     entry->_key  = key;
     entry->_data = data;
-    if (!*bucket) {
-        index->_bucket_in_use_count++;
-    }
-    entry->_next = *bucket;
-    *bucket = entry;
+    index->_slot_tags[slot] = tag;
     index->_key_count++;
     *p_new_node = entry;
 
@@ -14,13 +14,18 @@
 
 /*
  * this helps define indexed collections used for symbol support
- * in Ion.c.  These follow the collection pattern and use the base
- * collection heavily.  And, like ion_index, the memory used 
- * for the nodes is allocated on the parent, which is passed in when 
- * the user initializes an index.
+ * in Ion.c, and for the page lookup in paged streams.  Like the
+ * collections, the memory used for the table is allocated on the
+ * parent, which is passed in when the user initializes an index.
  *
- * each collections holds a high water mark free list of nodes that
- * were previously used but aren't currently being used
+ * the index is an open addressing hash table with linear probing.
+ * Next to the slots, which hold the key, the data and the full hash,
+ * there's a byte per slot holding the top bits of the hash (or 0 if
+ * the slot is empty) so a probe mostly runs along a cache line of
+ * these tags and only looks at a slot, and calls the compare
+ * function, when the tag matches. Deletes shift the following
+ * entries back rather than leaving tombstones, so a probe always
+ * ends at the first empty slot.
  *
  * index supports:
  *    iERR  initialize(ION_INDEX *idx, CMP_FN cmp, HASH_FN hash)
@@ -30,16 +35,16 @@
  *    BOOL  upsert    (void *key, void *data)
  *    void  delete    (void *key)
  *    void  reset     ()
- *    void  release   ()
  *
  * unlike collection index expects the caller to own the key and
  * the data objects and index itself only maintains the additional
  * data to manage these functions.
  *
- * there are also cursor macros that mirror the collection cursors
- *
  * to define the index comparison behavior the user supplies a
- * compare function and a hash function
+ * compare function and a hash function. The index mixes the hash
+ * it's given, so the hash function doesn't have to spread its bits
+ * (the page id itself is fine), but it does need to use all of
+ * them: _ion_index_hash_bytes is a good one for byte strings.
  */
 
 #ifndef ION_INDEX_H_
@@ -52,8 +57,11 @@ extern "C" {
 typedef int_fast8_t  (*II_COMPARE_FN)(void *key1, void *key2, void *context);
 typedef int_fast32_t (*II_HASH_FN)   (void *key, void *context);
 
-#define II_DEFAULT_128X_PERCENT 104 /* 80% pre-converted to "base 128 percent" */
-#define II_DEFAULT_MINIMUM       16 /* net desired buckets */
+#define II_DEFAULT_128X_PERCENT  90 /* 70% pre-converted to "base 128 percent" */
+#define II_DEFAULT_MINIMUM       16 /* net desired slots, a power of 2 */
+
+// the slot tag of an empty slot, any other tag has the top bit set
+#define II_EMPTY_TAG              0
 
 typedef struct _ion_index_options ION_INDEX_OPTIONS;
 struct _ion_index_options
@@ -63,21 +71,16 @@ struct _ion_index_options
     II_HASH_FN     _hash_fn;
     void          *_fn_context;
     int32_t        _initial_size;  /* number of actual keys */
-    uint8_t        _density_target_percent; /* whole percent for table size increases 200% is usual (and default) */
+    uint8_t        _density_target_percent; /* whole percent of the slots in use before the table grows, 70% is the default */
 
 };
 
-// the node allocation scheme depends on this
-// layout - currently that there are only 2 members
-// so it uses the size of the ptr as the base to 
-// allocate
 typedef struct _ion_index_node ION_INDEX_NODE;
 struct _ion_index_node
 {
-    int_fast32_t    _hash;
+    uint32_t        _hash;
     void           *_key;
     void           *_data;
-    ION_INDEX_NODE *_next;
 };
 
 typedef struct _ion_index ION_INDEX;
@@ -90,38 +93,18 @@ struct _ion_index
     uint8_t         _density_target_percent_128x;
 
     int32_t         _key_count;
-    int32_t         _bucket_count;
-    int32_t         _bucket_in_use_count;  // watch for bad distribution
-    int32_t         _grow_at;
-    ION_INDEX_NODE**_bucket_table;
-    ION_COLLECTION  _nodes;
+    int32_t         _slot_count;    // always a power of 2 (or 0 before the first insert)
+    int32_t         _grow_at;       // the key count that makes the table grow
+    uint8_t        *_slot_tags;     // II_EMPTY_TAG, or 0x80 | the top 7 bits of the slot's hash
+    ION_INDEX_NODE *_slots;
 
 };
 
-GLOBAL int32_t g_ion_index_multiplier_x128 INITTO(2*128);
-
-#define II_GROW(x)                          \
-    do {                                    \
-        (x) *= g_ion_index_multiplier_x128; \
-        (x) /= 128;                         \
-   } while (0)
-
 // BOOL ion_index_is_empty(ION_INDEX *index)
 #define ION_INDEX_IS_EMPTY(index)       (ION_INDEX_SIZE(index) == 0)
 
 // SIZE count = ion_index_size(ION_INDEX *index)
-#define ION_INDEX_SIZE(index)           ((index)->_count)
-
-typedef struct _ion_index_node *ION_INDEX_CURSOR;
-
-// ION_INDEX_CURSOR pcursor = ion_index_open(ION_INDEX *collection)
-#define ION_INDEX_OPEN(index, pcursor)  ION_COLLECTION_OPEN(&(index)->_nodes, pcursor)
-
-// void *pbuf = ion_index_next(ION_INDEX_CURSOR *pcursor)
-#define ION_INDEX_NEXT(index, pbuf)     ION_COLECTION_NEXT( &(index)->_nodes, pbuf )
-
-// ION_INDEX_CURSOR *pcursor = ion_index_close();
-#define ION_INDEX_CLOSE(pcursor)        ION_COLLECTION_CLOSE( pcursor )
+#define ION_INDEX_SIZE(index)           ((index)->_key_count)
 
 iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options);
 iERR  _ion_index_make_room(ION_INDEX *index, int32_t expected_new);
@@ -132,10 +115,14 @@ iERR  _ion_index_insert    (ION_INDEX *index, void *key, void *data);
 iERR  _ion_index_upsert    (ION_INDEX *index, void *key, void *data);
 void  _ion_index_delete    (ION_INDEX *index, void *key, void **p_data);
 void  _ion_index_reset     (ION_INDEX *index);
-void  _ion_index_release   (ION_INDEX *index);
 
 iERR _ion_index_grow_array(void **p_array, int32_t old_count, int32_t new_count, int32_t entry_size, BOOL with_copy, void *owner);
 
+/**
+ * A hash of length bytes, which reads them a 64 bit word at a time.
+ */
+int_fast32_t _ion_index_hash_bytes(BYTE *bytes, SIZE length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,7 @@ extern "C" {
 
 // ion_alloc uses the size of the object type enum
 #include "ion_alloc.h"
+#include "ion_perf_impl.h"
 
 // ION OBJECT TYPES
 typedef enum {
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "ion_internal.h"
+
+void ion_perf_enable(BOOL enabled)
+{
+    g_ion_perf_enabled = enabled;
+    if (!enabled) {
+        g_ion_perf.phase = ION_PERF_PHASE_NONE;
+    }
+    return;
+}
+
+void ion_perf_reset(void)
+{
+    int64_t block_bytes = g_ion_perf.stats.block_bytes;
+
+    memset(&g_ion_perf.stats, 0, sizeof(g_ion_perf.stats));
+    g_ion_perf.stats.block_bytes      = block_bytes;
+    g_ion_perf.stats.peak_block_bytes = block_bytes;
+    return;
+}
+
+void ion_perf_get_stats(ION_PERF_STATS *stats)
+{
+    if (!stats) return;
+    memcpy(stats, &g_ion_perf.stats, sizeof(*stats));
+    return;
+}
+
+void ion_perf_sample(ION_PERF_CLOCK clock)
+{
+    ION_PERF_PHASE phase = g_ion_perf.phase;
+
+    if (!g_ion_perf_enabled) return;
+    if ((int)clock < 0 || clock >= ION_PERF_CLOCK_COUNT) return;
+    if ((int)phase < 0 || phase >= ION_PERF_PHASE_COUNT) return;
+    g_ion_perf.stats.phases[phase].samples[clock]++;
+    return;
+}
+
+ION_PERF_PHASE _ion_perf_enter(ION_PERF_PHASE phase)
+{
+    ION_PERF_PHASE previous = g_ion_perf.phase;
+
+    if (previous != phase) {
+        g_ion_perf.stats.phases[phase].calls++;
+        g_ion_perf.phase = phase;
+    }
+    return previous;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+//
+// the hooks behind ion_perf.h. a phase is marked around each call that
+// does that kind of work: ION_PERF_CHECK is IONCHECK, in a phase. the
+// thread goes back to the phase it was in when the call returns, so the
+// innermost phase is the one that's sampled.
+//
+// the phase is volatile since a signal handler on the same thread reads
+// it, and nothing here is touched while counting is disabled except the
+// memory held in blocks, which has to stay right across enabling it.
+//
+
+#ifndef ION_PERF_IMPL_H_
+#define ION_PERF_IMPL_H_
+
+#include <ionc/ion_types.h>
+#include <ionc/ion_platform_config.h>
+#include <ionc/ion_perf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _ion_perf_counters {
+    volatile ION_PERF_PHASE phase;
+    ION_PERF_STATS          stats;
+} ION_PERF_COUNTERS;
+
+GLOBAL BOOL g_ion_perf_enabled INITTO(FALSE);
+
+GLOBAL THREAD_LOCAL_STORAGE ION_PERF_COUNTERS g_ion_perf;
+
+ION_PERF_PHASE _ion_perf_enter(ION_PERF_PHASE phase);
+
+#define ION_PERF_ENTER(phase)       (g_ion_perf_enabled ? _ion_perf_enter(phase) : ION_PERF_PHASE_NONE)
+#define ION_PERF_EXIT(previous)     { if (g_ion_perf_enabled) g_ion_perf.phase = (previous); }
+
+#define ION_PERF_CHECK(phase, x)    { ION_PERF_PHASE perf_previous_ = ION_PERF_ENTER(phase); \
+                                      err = (x); \
+                                      ION_PERF_EXIT(perf_previous_); \
+                                      if (err) goto fail; }
+
+#define ION_PERF_COUNT(counter, n)  { if (g_ion_perf_enabled) g_ion_perf.stats.counter += (n); }
+
+// counts values of the given type in values_read or values_written
+#define ION_PERF_COUNT_VALUES(counts, type, n) { \
+            if (g_ion_perf_enabled && ION_TYPE_INT(type) >= tid_NULL_INT && ION_TYPE_INT(type) <= tid_DATAGRAM_INT) { \
+                g_ion_perf.stats.counts[ION_PERF_TYPE_INDEX(type)] += (n); \
+            } \
+        }
+
+#define ION_PERF_COUNT_VALUE(counts, type)  ION_PERF_COUNT_VALUES(counts, type, 1)
+
+#define ION_PERF_BLOCK_ALLOCATED(size) { \
+            g_ion_perf.stats.block_bytes += (size); \
+            if (g_ion_perf.stats.block_bytes > g_ion_perf.stats.peak_block_bytes) { \
+                g_ion_perf.stats.peak_block_bytes = g_ion_perf.stats.block_bytes; \
+            } \
+            ION_PERF_COUNT(blocks_allocated, 1); \
+        }
+
+#define ION_PERF_BLOCK_FREED(size)  { g_ion_perf.stats.block_bytes -= (size); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_PERF_IMPL_H_
@@ -203,6 +203,65 @@ iERR ion_reader_open_stream(hREADER *p_hreader
     iRETURN;
 }
 
+iERR ion_reader_open_push(hREADER *p_hreader, ION_READER_OPTIONS *p_options)
+{
+    iENTER;
+    ION_READER    *preader = NULL;
+    ION_STREAM    *pstream = NULL;
+
+    if (!p_hreader) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(ion_stream_open_push(&pstream));
+    err = _ion_reader_make_new_reader(p_options, &preader);
+    if (err) {
+        ion_stream_close(pstream);
+        FAILWITH(err);
+    }
+    preader->istream = pstream;
+    preader->_reader_owns_stream = TRUE;
+
+    // there's nothing to look at yet, so we start out binary, the first
+    // call to next switches to text if the first byte pushed isn't the
+    // start of the binary version marker
+    err = _ion_reader_initialize(preader, (BYTE *)ION_VERSION_MARKER, ION_VERSION_MARKER_LENGTH);
+    if (err) {
+        IONCLOSEpREADER(preader);
+        FAILWITH(err);
+    }
+
+    *p_hreader = PTR_TO_HANDLE(preader);
+
+    iRETURN;
+}
+
+iERR ion_reader_push(hREADER hreader, BYTE *buffer, SIZE length)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_BAD_HANDLE);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!ion_stream_is_push(preader->istream)) FAILWITH(IERR_INVALID_STATE);
+
+    IONCHECK(ion_stream_push(preader->istream, buffer, length));
+
+    iRETURN;
+}
+
+iERR ion_reader_push_eof(hREADER hreader)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_BAD_HANDLE);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!ion_stream_is_push(preader->istream)) FAILWITH(IERR_INVALID_STATE);
+
+    IONCHECK(ion_stream_push_eof(preader->istream));
+
+    iRETURN;
+}
+
 iERR ion_reader_open(
          hREADER            *p_hreader
         ,ION_STREAM         *stream
@@ -288,7 +347,7 @@ iERR _ion_reader_make_new_reader(ION_READER_OPTIONS *p_options, ION_READER **p_r
     // the stream.  Later we'll initialize typed portion of the reader
     // once we know what format we're going to be processing
     len = sizeof(ION_READER);
-    preader = (ION_READER *)ion_alloc_owner(len);
+    preader = (ION_READER *)ion_alloc_owner_with_allocator(len, p_options ? p_options->allocator : NULL);
     *p_reader = preader;
     if (!preader) {
         FAILWITH(IERR_NO_MEMORY);
@@ -435,6 +494,43 @@ iERR _ion_reader_validate_options(ION_READER_OPTIONS* p_options)
         FAILWITHMSG(IERR_INVALID_ARG, msg);
     }
 
+    if (p_options->scratch_arena_size < 0) {
+        msg = "scratch arena size can't be negative";
+        FAILWITHMSG(IERR_INVALID_ARG, msg);
+    }
+
+    if (p_options->scratch_arena_size > MAX_SIZE - (SIZE)ALIGN_SIZE(sizeof(int))) {
+        msg = "scratch arena size is too large";
+        FAILWITHMSG(IERR_INVALID_ARG, msg);
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_grow_stack(ION_READER *preader, void **p_stack, SIZE count, SIZE *p_capacity, SIZE element_size)
+{
+    iENTER;
+    void *stack;
+    SIZE  capacity;
+
+    ASSERT(preader != NULL);
+    ASSERT(p_stack != NULL && p_capacity != NULL);
+    ASSERT(count <= *p_capacity);
+
+    // the old array stays with the reader's owner until the reader is
+    // closed, doubling keeps that bounded to the size of the new array
+    capacity = *p_capacity ? *p_capacity * 2 : MIN_WRITER_STACK_DEPTH;
+    if (capacity < *p_capacity) FAILWITH(IERR_NO_MEMORY);
+
+    stack = ion_alloc_with_owner(preader, capacity * element_size);
+    if (!stack) FAILWITH(IERR_NO_MEMORY);
+    if (count) {
+        memcpy(stack, *p_stack, count * element_size);
+    }
+
+    *p_stack    = stack;
+    *p_capacity = capacity;
+
     iRETURN;
 }
 
@@ -478,6 +574,9 @@ iERR _ion_reader_initialize(ION_READER *preader, BYTE *version_buffer, SIZE vers
     // keep the readers copy of depth up to date
     preader->_depth = 0;
 
+    // bytes_read counts from wherever the stream was handed to us
+    preader->_perf_position = ion_stream_get_position(preader->istream);
+
     // now we can check the binary Ion Version Marker
     // we'll have to "unread" these bytes 
     if (ion_helper_is_ion_version_marker(version_buffer, version_length)) {
@@ -493,6 +592,22 @@ iERR _ion_reader_initialize(ION_READER *preader, BYTE *version_buffer, SIZE vers
     iRETURN;
 }
 
+// readers opened with ion_reader_open_push start out binary, as nothing
+// has been pushed when they're opened. Text can't start with the first byte
+// of the binary version marker, so that's enough to tell
+iERR _ion_reader_push_check_format(ION_READER *preader)
+{
+    iENTER;
+    ION_STREAM *istream = preader->istream;
+
+    if (istream->_curr < istream->_limit && istream->_curr[0] != ION_VERSION_MARKER[0]) {
+        preader->type = ion_type_text_reader;
+        IONCHECK(_ion_reader_text_open(preader));
+    }
+
+    iRETURN;
+}
+
 iERR ion_reader_get_catalog(hREADER hreader, hCATALOG *p_hcatalog)
 {
     iENTER;
@@ -552,6 +667,12 @@ iERR _ion_reader_next_helper(ION_READER *preader, ION_TYPE *p_value_type)
     
     ASSERT(preader);
     ASSERT(p_value_type);
+
+    if (preader->type == ion_type_binary_reader && ion_stream_is_push(preader->istream)
+        && ion_stream_get_position(preader->istream) == 0
+    ) {
+        IONCHECK(_ion_reader_push_check_format(preader));
+    }
     
     // we reset the temp value pool at the beginning of each top level value
     if ( preader->_depth == 0 ) {
@@ -560,15 +681,16 @@ iERR _ion_reader_next_helper(ION_READER *preader, ION_TYPE *p_value_type)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_next(preader, p_value_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_next(preader, p_value_type));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_next(preader, p_value_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_next(preader, p_value_type));
         break;
     case ion_type_unknown_reader:
     default:
         FAILWITH(IERR_INVALID_STATE);
     }
+    ION_PERF_COUNT_VALUE(values_read, *p_value_type);
 
     iRETURN;
 }
@@ -595,10 +717,10 @@ iERR _ion_reader_step_in_helper(ION_READER *preader)
     switch(preader->type) {
     case ion_type_text_reader:
         // IONCHECK(_ion_reader_text_step_in(preader));
-        IONCHECK(_ion_reader_text_step_in(preader));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_step_in(preader));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_step_in(preader));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_step_in(preader));
         break;
     case ion_type_unknown_reader:
     default:
@@ -634,10 +756,10 @@ iERR _ion_reader_step_out_helper(ION_READER *preader)
     switch(preader->type) {
     case ion_type_text_reader:
         // IONCHECK(_ion_reader_text_step_out((ION_READER_TEXT *)preader));
-        IONCHECK(_ion_reader_text_step_out(preader));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_step_out(preader));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_step_out(preader));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_step_out(preader));
         break;
     case ion_type_unknown_reader:
     default:
@@ -745,10 +867,10 @@ iERR _ion_reader_has_any_annotations_helper(ION_READER *preader, BOOL *p_has_ann
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_has_any_annotations(preader, p_has_annotations));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_has_any_annotations(preader, p_has_annotations));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_has_any_annotations(preader, p_has_annotations));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_has_any_annotations(preader, p_has_annotations));
         break;
     case ion_type_unknown_reader:
     default:
@@ -785,10 +907,10 @@ iERR _ion_reader_has_annotation_helper(ION_READER *preader, ION_STRING *annotati
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_has_annotation(preader, annotation, p_annotation_found));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_has_annotation(preader, annotation, p_annotation_found));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_has_annotation(preader, annotation, p_annotation_found));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_has_annotation(preader, annotation, p_annotation_found));
         break;
     case ion_type_unknown_reader:
     default:
@@ -822,10 +944,10 @@ iERR _ion_reader_get_annotation_count_helper(ION_READER *preader, int32_t *p_cou
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_annotation_count(preader, p_count));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_annotation_count(preader, p_count));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_annotation_count(preader, p_count));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_annotation_count(preader, p_count));
         break;
     case ion_type_unknown_reader:
     default:
@@ -859,10 +981,10 @@ iERR _ion_reader_get_an_annotation_helper(ION_READER *preader, int32_t idx, ION_
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_an_annotation(preader, idx, p_str));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_an_annotation(preader, idx, p_str));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_an_annotation(preader, idx, p_str));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_an_annotation(preader, idx, p_str));
         break;
     case ion_type_unknown_reader:
     default:
@@ -895,10 +1017,10 @@ iERR _ion_reader_get_an_annotation_symbol_helper(ION_READER *preader, int32_t id
 
     switch(preader->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_get_an_annotation_symbol(preader, idx, p_symbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_an_annotation_symbol(preader, idx, p_symbol));
             break;
         case ion_type_binary_reader:
-            IONCHECK(_ion_reader_binary_get_an_annotation_symbol(preader, idx, p_symbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_an_annotation_symbol(preader, idx, p_symbol));
             break;
         case ion_type_unknown_reader:
         default:
@@ -931,10 +1053,10 @@ iERR _ion_reader_is_null_helper(ION_READER *preader, BOOL *p_is_null)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_is_null(preader, p_is_null));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_is_null(preader, p_is_null));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_is_null(preader, p_is_null));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_is_null(preader, p_is_null));
         break;
     }
 
@@ -998,10 +1120,10 @@ iERR _ion_reader_get_field_name_helper(ION_READER *preader, ION_STRING **p_pstr)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_field_name(preader, p_pstr));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_field_name(preader, p_pstr));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_field_name(preader, p_pstr));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_field_name(preader, p_pstr));
         break;
     default:
         FAILWITH(IERR_INVALID_STATE);
@@ -1019,10 +1141,10 @@ iERR _ion_reader_get_field_sid_helper(ION_READER *preader, SID *p_sid)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_field_sid(preader, p_sid));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_field_sid(preader, p_sid));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_field_sid(preader, p_sid));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_field_sid(preader, p_sid));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1055,10 +1177,10 @@ iERR _ion_reader_get_field_name_symbol_helper(ION_READER *preader, ION_SYMBOL **
 
     switch(preader->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_get_field_name_symbol(preader, p_psymbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_field_name_symbol(preader, p_psymbol));
             break;
         case ion_type_binary_reader:
-            IONCHECK(_ion_reader_binary_get_field_name_symbol(preader, p_psymbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_field_name_symbol(preader, p_psymbol));
             break;
         case ion_type_unknown_reader:
         default:
@@ -1093,10 +1215,10 @@ iERR _ion_reader_get_annotations_helper(ION_READER *preader, ION_STRING *p_strs,
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_annotations(preader, p_strs, max_count, p_count));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_annotations(preader, p_strs, max_count, p_count));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_annotations(preader, p_strs, max_count, p_count));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_annotations(preader, p_strs, max_count, p_count));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1118,10 +1240,10 @@ iERR ion_reader_get_annotation_symbols(hREADER hreader, ION_SYMBOL *p_symbols, S
 
     switch(preader->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_get_annotation_symbols(preader, p_symbols, max_count, p_count));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_annotation_symbols(preader, p_symbols, max_count, p_count));
             break;
         case ion_type_binary_reader:
-            IONCHECK(_ion_reader_binary_get_annotation_symbols(preader, p_symbols, max_count, p_count));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_annotation_symbols(preader, p_symbols, max_count, p_count));
             break;
         case ion_type_unknown_reader:
         default:
@@ -1154,10 +1276,10 @@ iERR _ion_reader_read_null_helper(ION_READER *preader, ION_TYPE *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_null(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_null(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_null(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_null(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1190,10 +1312,10 @@ iERR _ion_reader_read_bool_helper(ION_READER *preader, BOOL *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_bool(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_bool(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_bool(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_bool(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1239,10 +1361,10 @@ iERR _ion_reader_read_int32_helper(ION_READER *preader, int32_t *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_int32(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_int32(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_int32(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_int32(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1275,10 +1397,10 @@ iERR _ion_reader_read_int64_helper(ION_READER *preader, int64_t *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_int64(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_int64(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_int64(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_int64(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1296,7 +1418,7 @@ iERR _ion_reader_read_mixed_int_helper(ION_READER *preader)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_mixed_int_helper(preader));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_mixed_int_helper(preader));
         break;
     case ion_type_binary_reader:
         IONCHECK(_ion_binary_read_mixed_int_helper(preader));
@@ -1345,10 +1467,10 @@ iERR _ion_reader_read_ion_int_helper(ION_READER *preader, ION_INT *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_ion_int_helper(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_ion_int_helper(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_ion_int(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_ion_int(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1381,10 +1503,10 @@ iERR _ion_reader_read_double_helper(ION_READER *preader, double *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_double(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_double(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_double(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_double(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1417,10 +1539,10 @@ iERR _ion_reader_read_decimal_helper(ION_READER *preader, decQuad *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_decimal(preader, p_value, NULL));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_decimal(preader, p_value, NULL));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_decimal(preader, p_value, NULL));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_decimal(preader, p_value, NULL));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1454,10 +1576,10 @@ iERR _ion_reader_read_ion_decimal_helper(ION_READER *preader, ION_DECIMAL *p_val
 
     switch(preader->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_read_decimal(preader, &p_value->value.quad_value, &num_value));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_decimal(preader, &p_value->value.quad_value, &num_value));
             break;
         case ion_type_binary_reader:
-            IONCHECK(_ion_reader_binary_read_decimal(preader, &p_value->value.quad_value, &num_value));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_decimal(preader, &p_value->value.quad_value, &num_value));
             break;
         case ion_type_unknown_reader:
         default:
@@ -1505,10 +1627,10 @@ iERR _ion_reader_read_timestamp_helper(ION_READER *preader, ION_TIMESTAMP *p_val
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_timestamp(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_timestamp(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_timestamp(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_timestamp(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1518,6 +1640,129 @@ iERR _ion_reader_read_timestamp_helper(ION_READER *preader, ION_TIMESTAMP *p_val
     iRETURN;
 }
 
+iERR ion_reader_read_int64_array(hREADER hreader, int64_t *p_values, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_values || max_count < 0 || !p_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_array_helper(preader, tid_INT, p_values, max_count, p_count));
+
+    iRETURN;
+}
+
+iERR ion_reader_read_double_array(hREADER hreader, double *p_values, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_values || max_count < 0 || !p_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_array_helper(preader, tid_FLOAT, p_values, max_count, p_count));
+
+    iRETURN;
+}
+
+iERR ion_reader_read_bool_array(hREADER hreader, BOOL *p_values, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_values || max_count < 0 || !p_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_array_helper(preader, tid_BOOL, p_values, max_count, p_count));
+
+    iRETURN;
+}
+
+iERR ion_reader_read_timestamp_epoch_array(hREADER hreader, time_t *p_values, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_values || max_count < 0 || !p_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_array_helper(preader, tid_TIMESTAMP, p_values, max_count, p_count));
+
+    iRETURN;
+}
+
+iERR _ion_reader_read_array_helper(ION_READER *preader, ION_TYPE element_type, void *p_values, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_TYPE      value_type;
+    ION_TIMESTAMP timestamp;
+    SIZE          count = 0, decoded;
+    BOOL          in_struct;
+
+    ASSERT(preader);
+    ASSERT(p_values);
+    ASSERT(p_count);
+
+    *p_count = 0;
+
+    switch(preader->type) {
+    case ion_type_text_reader:
+        in_struct = (preader->typed_reader.text._current_container == tid_STRUCT);
+        break;
+    case ion_type_binary_reader:
+        in_struct = preader->typed_reader.binary._in_struct;
+        break;
+    case ion_type_unknown_reader:
+    default:
+        FAILWITH(IERR_INVALID_STATE);
+    }
+    if (preader->_depth == 0 || in_struct) FAILWITH(IERR_INVALID_STATE);
+
+    while (count < max_count) {
+        // the binary reader decodes the plain values it has in its buffer
+        // directly, all but the last, which is read as usual so the reader
+        // is left on it
+        if (preader->type == ion_type_binary_reader && max_count - count > 1) {
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_array(preader, element_type, p_values, count,
+                                                                                max_count - count - 1, &decoded));
+            ION_PERF_COUNT_VALUES(values_read, element_type, decoded);
+            count += decoded;
+            *p_count = count;
+        }
+
+        IONCHECK(_ion_reader_next_helper(preader, &value_type));
+        if (value_type == tid_EOF) break;
+        if (value_type != element_type) FAILWITH(IERR_INVALID_STATE);
+
+        switch (ION_TYPE_INT(element_type)) {
+        case tid_INT_INT:
+            IONCHECK(_ion_reader_read_int64_helper(preader, (int64_t *)p_values + count));
+            break;
+        case tid_FLOAT_INT:
+            IONCHECK(_ion_reader_read_double_helper(preader, (double *)p_values + count));
+            break;
+        case tid_BOOL_INT:
+            IONCHECK(_ion_reader_read_bool_helper(preader, (BOOL *)p_values + count));
+            break;
+        case tid_TIMESTAMP_INT:
+            IONCHECK(_ion_reader_read_timestamp_helper(preader, &timestamp));
+            IONCHECK(ion_timestamp_to_time_t(&timestamp, (time_t *)p_values + count));
+            break;
+        default:
+            FAILWITH(IERR_INVALID_ARG);
+        }
+        count++;
+        *p_count = count;
+    }
+
+    iRETURN;
+}
+
 iERR ion_reader_read_ion_symbol(hREADER hreader, ION_SYMBOL *p_symbol)
 {
     iENTER;
@@ -1541,10 +1786,10 @@ iERR _ion_reader_read_symbol_helper(ION_READER *preader, ION_SYMBOL *p_symbol)
 
     switch(preader->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_read_symbol(preader, p_symbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_symbol(preader, p_symbol));
             break;
         case ion_type_binary_reader:
-            IONCHECK(_ion_reader_binary_read_symbol(preader, p_symbol));
+            ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_symbol(preader, p_symbol));
             break;
         case ion_type_unknown_reader:
         default:
@@ -1577,10 +1822,10 @@ iERR _ion_reader_get_string_length_helper(ION_READER *preader, SIZE *p_length)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_string_length(preader, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_string_length(preader, p_length));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_string_length(preader, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_string_length(preader, p_length));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1616,10 +1861,50 @@ iERR _ion_reader_read_string_helper(ION_READER *preader, ION_STRING *p_value)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_string(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_string(preader, p_value));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_string(preader, p_value));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_string(preader, p_value));
+        break;
+    case ion_type_unknown_reader:
+    default:
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    iRETURN;
+}
+
+iERR ion_reader_read_string_view(hREADER hreader, iSTRING p_value)
+{
+    iENTER;
+    ION_READER *preader;
+    ION_STRING  str;
+
+    ION_STRING_INIT(&str);
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_value) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_string_view_helper(preader, &str));
+    ION_STRING_ASSIGN(p_value, &str);
+    iRETURN;
+}
+
+iERR _ion_reader_read_string_view_helper(ION_READER *preader, ION_STRING *p_value)
+{
+    iENTER;
+
+    ASSERT(preader);
+    ASSERT(p_value);
+
+    switch(preader->type) {
+    case ion_type_text_reader:
+        // the text reader already hands out strings from its own value buffer
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_string(preader, p_value));
+        break;
+    case ion_type_binary_reader:
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_string_view(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1657,10 +1942,10 @@ iERR _ion_reader_read_partial_string_helper(ION_READER *preader, BOOL accept_par
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_string_bytes(preader, accept_partial, p_buf, buf_max, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_string_bytes(preader, accept_partial, p_buf, buf_max, p_length));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_string_bytes(preader, accept_partial, p_buf, buf_max, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_string_bytes(preader, accept_partial, p_buf, buf_max, p_length));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1692,10 +1977,10 @@ iERR _ion_reader_get_lob_size_helper(ION_READER *preader, SIZE *p_length)
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_get_lob_size(preader, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_get_lob_size(preader, p_length));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_get_lob_size(preader, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_get_lob_size(preader, p_length));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1749,10 +2034,48 @@ iERR _ion_reader_read_lob_bytes_helper(ION_READER *preader, BOOL accept_partial,
 
     switch(preader->type) {
     case ion_type_text_reader:
-        IONCHECK(_ion_reader_text_read_lob_bytes(preader, accept_partial, p_buf, buf_max, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_lob_bytes(preader, accept_partial, p_buf, buf_max, p_length));
         break;
     case ion_type_binary_reader:
-        IONCHECK(_ion_reader_binary_read_lob_bytes(preader, accept_partial, p_buf, buf_max, p_length));
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_lob_bytes(preader, accept_partial, p_buf, buf_max, p_length));
+        break;
+    case ion_type_unknown_reader:
+    default:
+        FAILWITH(IERR_INVALID_STATE);
+    }
+    iRETURN;
+}
+
+iERR ion_reader_read_lob_view(hREADER hreader, iSTRING p_value)
+{
+    iENTER;
+    ION_READER *preader;
+    ION_STRING  str;
+
+    ION_STRING_INIT(&str);
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_value) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_read_lob_view_helper(preader, &str));
+    ION_STRING_ASSIGN(p_value, &str);
+    iRETURN;
+}
+
+iERR _ion_reader_read_lob_view_helper(ION_READER *preader, ION_STRING *p_value)
+{
+    iENTER;
+
+    ASSERT(preader);
+    ASSERT(p_value);
+
+    switch(preader->type) {
+    case ion_type_text_reader:
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_text_read_lob_view(preader, p_value));
+        break;
+    case ion_type_binary_reader:
+        ION_PERF_CHECK(ION_PERF_PHASE_DECODE, _ion_reader_binary_read_lob_view(preader, p_value));
         break;
     case ion_type_unknown_reader:
     default:
@@ -1780,6 +2103,8 @@ iERR _ion_reader_close_helper(ION_READER *preader)
 
     ASSERT(preader);
 
+    _ion_reader_count_bytes_read(preader);
+
     // Release the stream, then free any memory attached to the reader.
     if (preader->_reader_owns_stream) {
         ion_stream_close(preader->istream);
@@ -1799,26 +2124,72 @@ iERR _ion_reader_close_helper(ION_READER *preader)
     iRETURN;
 }
 
+void _ion_reader_count_bytes_read(ION_READER *preader)
+{
+    POSITION position;
+
+    // the bytes between where the reader started (or last seeked to) and
+    // where it is now, rather than what the stream buffered ahead of it
+    if (!g_ion_perf_enabled || !preader->istream) return;
+    position = ion_stream_get_position(preader->istream);
+    if (position > preader->_perf_position) {
+        ION_PERF_COUNT(bytes_read, position - preader->_perf_position);
+        preader->_perf_position = position;
+    }
+}
+
 iERR _ion_reader_reset_temp_pool( ION_READER *preader )
 {
     iENTER;
     void *owner;
+    SIZE  used, capacity;
+
+    if (preader->options.scratch_arena_size > 0) {
+        if (preader->_temp_entity_pool != NULL) {
+            // everything fit, so the arena just starts over
+            if (_ion_rewind_owner(preader->_temp_entity_pool, sizeof(int), &used)) SUCCEED();
+            ion_free_owner(preader->_temp_entity_pool);
+            preader->_temp_entity_pool = NULL;
+            capacity = preader->_temp_pool_capacity;
+            // doubled until it fits, short of the most one allocation (with the fake one in front) can hold
+            while (capacity < used) {
+                if (capacity > (MAX_SIZE - (SIZE)ALIGN_SIZE(sizeof(int))) / 2) {
+                    capacity = MAX_SIZE - (SIZE)ALIGN_SIZE(sizeof(int));
+                    break;
+                }
+                capacity *= 2;
+            }
+        }
+        else {
+            capacity = preader->options.scratch_arena_size;
+        }
+        // the arena is allocated in one piece and then rewound down to the fake allocation that holds it
+        owner = ion_alloc_owner_like(ALIGN_SIZE(sizeof(int)) + capacity, preader);
+        if (owner == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        _ion_rewind_owner(owner, sizeof(int), NULL);
+        preader->_temp_entity_pool = owner;
+        preader->_temp_pool_capacity = capacity;
+        SUCCEED();
+    }
+
     if ((preader->_temp_entity_pool != NULL)) {
         ion_free_owner( preader->_temp_entity_pool );
         preader->_temp_entity_pool = NULL;
     }
 
-    IONCHECK(_ion_reader_allocate_pool_owner(&owner));
+    IONCHECK(_ion_reader_allocate_pool_owner(preader, &owner));
     preader->_temp_entity_pool = owner;
 
     iRETURN;
 }
 
-iERR _ion_reader_allocate_pool_owner(void **p_owner)
+iERR _ion_reader_allocate_pool_owner(ION_READER *preader, void **p_owner)
 {
     iENTER;
     void *owner;
-    owner = ion_alloc_owner(sizeof(int));  // this is a fake allocation to hold the pool
+    owner = ion_alloc_owner_like(sizeof(int), preader);  // this is a fake allocation to hold the pool
     if (owner == NULL) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -1840,6 +2211,15 @@ iERR _ion_reader_free_local_symbol_table(ION_READER *preader )
     iRETURN;
 }
 
+// the generations come from one counter, so they never repeat, not even
+// for a new reader that's been given the address of a closed one
+static ION_ATOMIC_INT64 g_ion_reader_symtab_generation = 0;
+
+void _ion_reader_symbol_table_changed(ION_READER *preader)
+{
+    preader->_symtab_generation = ION_ATOMIC_ADD64(&g_ion_reader_symtab_generation, 1);
+}
+
 iERR _ion_reader_reset_local_symbol_table(ION_READER *preader )
 {
     iENTER;
@@ -1848,6 +2228,7 @@ iERR _ion_reader_reset_local_symbol_table(ION_READER *preader )
     IONCHECK(_ion_reader_free_local_symbol_table(preader));
     IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
     preader->_current_symtab = system;
+    _ion_reader_symbol_table_changed(preader);
 
     iRETURN;
 }
@@ -1901,7 +2282,7 @@ iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_sym
     if (*is_symbol_table && preader->options.return_system_values != TRUE) {
         // this is a local symbol table and the user has not *insisted* we return system values, so we process it
         IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
-        IONCHECK(_ion_reader_allocate_pool_owner(&owner));
+        IONCHECK(_ion_reader_allocate_pool_owner(preader, &owner));
         if (!preader->_local_symtab_pool) {
             has_previous_local_symbol_table = FALSE;
         }
@@ -1910,7 +2291,7 @@ iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_sym
             preader->typed_reader.text._state = IPS_BEFORE_CONTAINER;
             preader->typed_reader.text._value_type = tid_STRUCT;
         }
-        IONCHECK(_ion_symbol_table_load_helper(preader, owner, system, &local));
+        ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_load_helper(preader, owner, system, &local));
         if (local == NULL) {
             FAILWITH(IERR_NOT_A_SYMBOL_TABLE);
         }
@@ -1920,6 +2301,7 @@ iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_sym
         }
         preader->_local_symtab_pool = owner;
         preader->_current_symtab = local;
+        _ion_reader_symbol_table_changed(preader);
     }
     return IERR_OK;
 fail:
@@ -2029,7 +2411,9 @@ iERR ion_reader_seek(hREADER hreader, POSITION offset, SIZE length)
 
     // we'll let the steam_seek API decide if it can seek or not
     pstream = preader->istream;
+    _ion_reader_count_bytes_read(preader);
     IONCHECK(ion_stream_seek(pstream, offset));
+    preader->_perf_position = offset;
     if (length >= 0) {
         local_end = offset + length;
     }
@@ -2118,6 +2502,7 @@ iERR _ion_reader_set_symbol_table_helper(ION_READER *preader, ION_SYMBOL_TABLE *
     }
 
     preader->_current_symtab = symtab;
+    _ion_reader_symbol_table_changed(preader);
     SUCCEED();
 
     iRETURN;
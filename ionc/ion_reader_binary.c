@@ -37,8 +37,15 @@ iERR _ion_reader_binary_open(ION_READER *preader)
 
     binary = &preader->typed_reader.binary;
 
-    _ion_collection_initialize(preader, &binary->_parent_stack, sizeof(BINARY_PARENT_STATE)); // array of BINARY_PARENT_STATE
-    _ion_collection_initialize(preader, &binary->_annotation_sids, sizeof(SID)); // array of SID's
+    binary->_parent_capacity = preader->options.max_container_depth;
+    binary->_parent_stack = (BINARY_PARENT_STATE *)ion_alloc_with_owner(preader, binary->_parent_capacity * sizeof(BINARY_PARENT_STATE));
+    if (!binary->_parent_stack) FAILWITH(IERR_NO_MEMORY);
+    binary->_parent_count = 0;
+
+    binary->_annotation_capacity = preader->options.max_annotation_count;
+    binary->_annotation_sids = (SID *)ion_alloc_with_owner(preader, binary->_annotation_capacity * sizeof(SID));
+    if (!binary->_annotation_sids) FAILWITH(IERR_NO_MEMORY);
+    binary->_annotation_count = 0;
 
     binary->_local_end = ION_STREAM_MAX_LENGTH;
     binary->_state = S_BEFORE_TID;
@@ -64,8 +71,8 @@ iERR _ion_reader_binary_reset(ION_READER *preader, ION_TYPE parent_tid, POSITION
 
     binary = &preader->typed_reader.binary;
 
-    _ion_collection_reset(&binary->_parent_stack); // array of BINARY_PARENT_STATE
-    _ion_collection_reset(&binary->_annotation_sids); // array of SID's
+    binary->_parent_count = 0;
+    binary->_annotation_count = 0;
 
     binary->_state = S_BEFORE_TID;
 
@@ -122,6 +129,7 @@ begin:
     if (binary->_state == S_BEFORE_CONTENTS && binary->_value_len) {
         IONCHECK(ion_stream_skip(preader->istream, binary->_value_len, &skipped));
         if (binary->_value_len != skipped) FAILWITH(IERR_UNEXPECTED_EOF);
+        binary->_state = S_BEFORE_TID; // in case we come back after IERR_NEED_MORE_DATA
     }
 
     value_start = ion_stream_get_position(preader->istream);
@@ -131,7 +139,7 @@ begin:
 
     // reset the value fields
     type_desc_byte = -1;
-    _ion_collection_reset(&binary->_annotation_sids);
+    binary->_annotation_count = 0;
 
     // read the field sid if we are in a structure
     if (binary->_in_struct) {
@@ -146,7 +154,15 @@ begin:
     // found, and consumed, interesting data. And
     // if they did we need to read the next tid byte
     for (;;) {
+        if (preader->_depth == 0 && _ion_stream_is_push(preader->istream)) {
+            // don't start on a top level value until all of it has been pushed
+            IONCHECK(_ion_reader_binary_push_check_value(preader));
+        }
         value_start = ion_stream_get_position(preader->istream); // the field name isn't part of the value
+        if (preader->_depth == 0 && value_start >= binary->_local_end) {
+            // a seek's length can end right after system values, which come back around here
+            goto at_eof;
+        }
         ION_GET(preader->istream, type_desc_byte);               // read the TID byte
         if (type_desc_byte == EOF) {
             goto at_eof;
@@ -191,8 +207,8 @@ begin:
             for (;;) {
                 pos = ion_stream_get_position(preader->istream);
                 if (pos >= annotation_end) break;
-                psid = (SID *)_ion_collection_append(&binary->_annotation_sids);
-                if (!psid) FAILWITH(IERR_NO_MEMORY);
+                IONCHECK(ION_READER_STACK_RESERVE(preader, binary->_annotation_sids, binary->_annotation_count, binary->_annotation_capacity));
+                psid = &binary->_annotation_sids[binary->_annotation_count++];
                 IONCHECK(ion_binary_read_var_uint_32(preader->istream, (uint32_t*)psid));
             }
 
@@ -285,6 +301,52 @@ at_eof:
 }
 
 
+// for readers opened with ion_reader_open_push: fails with IERR_NEED_MORE_DATA,
+// without consuming anything, unless the whole value starting at the current
+// position has been pushed (or the input has ended, in which case the regular
+// path reports the EOF or the truncated value). Only the type descriptor and
+// length are looked at, so a value that's still arriving isn't rescanned.
+iERR _ion_reader_binary_push_check_value(ION_READER *preader)
+{
+    iENTER;
+    ION_STREAM *istream = preader->istream;
+    BYTE       *start = istream->_curr, *p = start, *limit = istream->_limit;
+    int         type_desc_byte, tid, ln, b;
+    uint64_t    length;
+
+    if (_ion_stream_push_input_ended(istream)) SUCCEED();
+    if (p >= limit) DONTFAILWITH(IERR_NEED_MORE_DATA);
+
+    type_desc_byte = *p++;
+    tid = getTypeCode(type_desc_byte);
+    ln  = getLowNibble(type_desc_byte);
+
+    if (type_desc_byte == ION_VERSION_MARKER[0]) {
+        length = ION_VERSION_MARKER_LENGTH - 1;
+    }
+    else if (tid == TID_BOOL || ln == ION_lnIsNull) {
+        length = 0;
+    }
+    else if (ln == ION_lnIsVarLen || (tid == TID_STRUCT && ln == ION_lnIsOrderedStruct)) {
+        length = 0;
+        do {
+            if (p >= limit) DONTFAILWITH(IERR_NEED_MORE_DATA);
+            // anything too long for a length is bad data, which the regular path reports
+            if (p - start > VAR_UINT_64_IMAGE_LENGTH) SUCCEED();
+            b = *p++;
+            length = (length << 7) | (b & 0x7F);
+        } while ((b & 0x80) == 0);
+    }
+    else {
+        length = ln;
+    }
+
+    if ((uint64_t)(limit - p) < length) DONTFAILWITH(IERR_NEED_MORE_DATA);
+    SUCCEED();
+
+    iRETURN;
+}
+
 iERR _ion_reader_binary_step_in(ION_READER *preader)
 {
     iENTER;
@@ -326,7 +388,8 @@ iERR _ion_reader_binary_step_in(ION_READER *preader)
     next_start =  ion_stream_get_position(preader->istream);
     next_start += binary->_value_len;
 
-    pparent_state = (BINARY_PARENT_STATE *)_ion_collection_push(&binary->_parent_stack );
+    IONCHECK(ION_READER_STACK_RESERVE(preader, binary->_parent_stack, binary->_parent_count, binary->_parent_capacity));
+    pparent_state = &binary->_parent_stack[binary->_parent_count++];
     pparent_state->_next_position = next_start;
     pparent_state->_tid           = binary->_parent_tid;
     pparent_state->_local_end     = binary->_local_end;
@@ -352,20 +415,18 @@ iERR _ion_reader_binary_step_out(ION_READER *preader)
 
     binary = &preader->typed_reader.binary;
 
-    if (ION_COLLECTION_SIZE(&binary->_parent_stack) < 1) {
+    if (binary->_parent_count < 1) {
         // if we didn't step in, we can't step out
         FAILWITH(IERR_STACK_UNDERFLOW);
     }
 
-    pparent_state = (BINARY_PARENT_STATE *)_ion_collection_head(&binary->_parent_stack);
+    pparent_state = &binary->_parent_stack[--binary->_parent_count];
 
     next_start          = pparent_state->_next_position;
     binary->_parent_tid = pparent_state->_tid;
     binary->_local_end  = pparent_state->_local_end;
     binary->_in_struct  = (binary->_parent_tid == TID_STRUCT);
 
-    _ion_collection_pop_head(&binary->_parent_stack);
-
     curr_pos = ion_stream_get_position(preader->istream);
 
     if (curr_pos <= next_start) {
@@ -385,7 +446,7 @@ iERR _ion_reader_binary_step_out(ION_READER *preader)
         }
     }
     else {
-        ASSERT(ION_COLLECTION_IS_EMPTY(&binary->_parent_stack));
+        ASSERT(binary->_parent_count == 0);
     }
     binary->_state = S_BEFORE_TID;
     preader->_eof = FALSE;
@@ -397,7 +458,7 @@ iERR _ion_reader_binary_get_depth(ION_READER *preader, SIZE *p_depth)
 {
     ASSERT(preader && preader->type == ion_type_binary_reader);
 
-    *p_depth = ION_COLLECTION_SIZE(&preader->typed_reader.binary._parent_stack);
+    *p_depth = preader->typed_reader.binary._parent_count;
 
     return IERR_OK;
 }
@@ -513,8 +574,8 @@ iERR _ion_reader_binary_has_annotation(ION_READER *preader, ION_STRING *annotati
     iENTER;
     ION_BINARY_READER    *binary;
     BOOL                  found = FALSE;
-    SID                  *psid, user_sid;
-    ION_COLLECTION_CURSOR cursor;
+    SID                   user_sid;
+    SIZE                  ii;
 
     ASSERT(preader && preader->type == ion_type_binary_reader);
 
@@ -528,16 +589,12 @@ iERR _ion_reader_binary_has_annotation(ION_READER *preader, ION_STRING *annotati
     }
 
     // and now check the annotation list for the sid of the user's string
-    ION_COLLECTION_OPEN(&binary->_annotation_sids, cursor);
-    for (;;) {
-        ION_COLLECTION_NEXT(cursor, psid);
-        if (!psid) break;
-        if (*psid == user_sid) {
+    for (ii = 0; ii < binary->_annotation_count; ii++) {
+        if (binary->_annotation_sids[ii] == user_sid) {
             found = TRUE;
             break;
         }
     }
-    ION_COLLECTION_CLOSE(cursor);
     goto return_value; 
 
 return_value:
@@ -555,7 +612,7 @@ iERR _ion_reader_binary_get_annotation_count(ION_READER *preader, int32_t *p_cou
 
     binary = &preader->typed_reader.binary;
 
-    *p_count = ION_COLLECTION_SIZE(&binary->_annotation_sids);
+    *p_count = binary->_annotation_count;
     SUCCEED();
 
     iRETURN;
@@ -584,9 +641,7 @@ iERR _ion_reader_binary_get_an_annotation_sid(ION_READER *preader, int32_t idx,
 {
     iENTER;
     ION_BINARY_READER    *binary;
-    int                   ii;
-    SID                  *psid = NULL;
-    ION_COLLECTION_CURSOR cursor;
+    SID                   sid;
 
     ASSERT(preader && preader->type == ion_type_binary_reader);
     ASSERT(idx >= 0);
@@ -594,25 +649,15 @@ iERR _ion_reader_binary_get_an_annotation_sid(ION_READER *preader, int32_t idx,
 
     binary = &preader->typed_reader.binary;
 
-    if (idx >= ION_COLLECTION_SIZE(&binary->_annotation_sids)) 
+    if (idx >= binary->_annotation_count) 
     {
         FAILWITH(IERR_INVALID_ARG);
     }
 
-    ION_COLLECTION_OPEN(&binary->_annotation_sids, cursor);
-    for (ii=0; ii<=idx; ii++)
-    {
-        ION_COLLECTION_NEXT(cursor, psid);
-        if (!psid) break;
-    }
-    ION_COLLECTION_CLOSE(cursor);
-    if (!psid || ii != idx + 1) {
-        FAILWITH(IERR_INVALID_STATE);
-    }
-
-    IONCHECK(_ion_reader_binary_validate_symbol_token(preader, *psid));
+    sid = binary->_annotation_sids[idx];
+    IONCHECK(_ion_reader_binary_validate_symbol_token(preader, sid));
 
-    *p_sid = *psid;
+    *p_sid = sid;
 
     iRETURN;
 }
@@ -669,7 +714,7 @@ iERR _ion_reader_binary_get_an_annotation_symbol(ION_READER *preader, int32_t id
         p_symbol->add_count = 0;
     }
     else {
-        IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, sid, &psymbol));
+        IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, sid, preader->_temp_entity_pool, &psymbol));
         ASSERT(psymbol != NULL);
         IONCHECK(ion_symbol_copy_to_owner(preader->_temp_entity_pool, p_symbol, psymbol));
     }
@@ -684,7 +729,6 @@ iERR _ion_reader_binary_get_annotations(ION_READER *preader, ION_STRING *p_annot
     ION_STRING           *pstr;
     int                   ii, count;
     SID                  *psid;
-    ION_COLLECTION_CURSOR cursor;
 
     ASSERT(preader && preader->type == ion_type_binary_reader);
     ASSERT(p_annotations != NULL);
@@ -692,22 +736,18 @@ iERR _ion_reader_binary_get_annotations(ION_READER *preader, ION_STRING *p_annot
 
     binary = &preader->typed_reader.binary;
 
-    count = ION_COLLECTION_SIZE(&binary->_annotation_sids);
+    count = binary->_annotation_count;
     if (count > max_count) {
         FAILWITH(IERR_BUFFER_TOO_SMALL);
     }
 
-    ION_COLLECTION_OPEN(&binary->_annotation_sids, cursor);
-    for (ii=0; ;ii++) {
-        ION_COLLECTION_NEXT(cursor, psid);
-        if (!psid) break;
+    for (ii=0; ii < count; ii++) {
+        psid = &binary->_annotation_sids[ii];
 
         IONCHECK(_ion_reader_binary_validate_symbol_token(preader, *psid));
         IONCHECK(_ion_symbol_table_find_by_sid_helper(preader->_current_symtab, *psid, &pstr));
         IONCHECK(_ion_reader_binary_string_copy_or_null(preader, &p_annotations[ii], pstr));
     }
-
-    ION_COLLECTION_CLOSE(cursor);
     goto return_value;
 
 return_value:
@@ -724,7 +764,6 @@ iERR _ion_reader_binary_get_annotation_symbols(ION_READER *preader, ION_SYMBOL *
     ION_SYMBOL           *pstr;
     int                   ii, count;
     SID                  *psid;
-    ION_COLLECTION_CURSOR cursor;
 
     ASSERT(preader && preader->type == ion_type_binary_reader);
     ASSERT(p_annotations != NULL);
@@ -732,19 +771,17 @@ iERR _ion_reader_binary_get_annotation_symbols(ION_READER *preader, ION_SYMBOL *
 
     binary = &preader->typed_reader.binary;
 
-    count = ION_COLLECTION_SIZE(&binary->_annotation_sids);
+    count = binary->_annotation_count;
     if (count > max_count) {
         FAILWITH(IERR_BUFFER_TOO_SMALL);
     }
 
-    ION_COLLECTION_OPEN(&binary->_annotation_sids, cursor);
-    for (ii=0; ;ii++) {
-        ION_COLLECTION_NEXT(cursor, psid);
-        if (!psid) break;
+    for (ii=0; ii < count; ii++) {
+        psid = &binary->_annotation_sids[ii];
         if ((*psid) <= UNKNOWN_SID) FAILWITH(IERR_INVALID_SYMBOL);
 
         IONCHECK(_ion_reader_binary_validate_symbol_token(preader, *psid));
-        IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, *psid, &pstr));
+        IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, *psid, preader->_temp_entity_pool, &pstr));
         if (pstr == NULL) {
             ASSERT(*psid == 0);
             ION_STRING_INIT(&p_annotations[ii].value);
@@ -756,7 +793,6 @@ iERR _ion_reader_binary_get_annotation_symbols(ION_READER *preader, ION_SYMBOL *
             p_annotations[ii].sid = *psid;
         }
     }
-    ION_COLLECTION_CLOSE(cursor);
 
     *p_count = count;
 
@@ -817,7 +853,7 @@ iERR _ion_reader_binary_get_field_name_symbol(ION_READER *preader, ION_SYMBOL **
     binary = &preader->typed_reader.binary;
 
     IONCHECK(_ion_reader_binary_validate_symbol_token(preader, binary->_value_field_id));
-    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, binary->_value_field_id, &field_symbol));
+    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, binary->_value_field_id, preader->_temp_entity_pool, &field_symbol));
     if (field_symbol == NULL) {
         field_symbol = ion_alloc_with_owner(preader->_temp_entity_pool, sizeof (ION_SYMBOL));
         ION_STRING_INIT(&field_symbol->value);
@@ -1151,6 +1187,128 @@ iERR _ion_reader_binary_read_double(ION_READER *preader, double *p_value)
     iRETURN;
 }
 
+// decodes the bools, ints that fit in an int64 and floats that are right
+// in front of the reader, in its list or sexp, without stepping through
+// next(), into p_values from index offset, up to max_count of them. Only
+// unannotated values in the stream's current page are decoded; it stops at
+// anything else (including the container's end), which next() then reads.
+// The reader stays before a type descriptor, but its value fields aren't
+// updated, so next() has to be called before anything else.
+iERR _ion_reader_binary_read_array(ION_READER *preader, ION_TYPE element_type, void *p_values, SIZE offset, SIZE max_count, SIZE *p_count)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_STREAM        *stream;
+    BYTE              *p, *limit;
+    POSITION           remaining;
+    SIZE               count = 0;
+    int                td, len, ii;
+    uint64_t           bits;
+    uint32_t           bits32;
+    float              float_value;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_values != NULL);
+    ASSERT(p_count != NULL);
+
+    binary = &preader->typed_reader.binary;
+    stream = preader->istream;
+
+    if (preader->_eof || binary->_state != S_BEFORE_TID || binary->_in_struct || stream->_curr == NULL) {
+        *p_count = 0;
+        SUCCEED();
+    }
+
+    p = stream->_curr;
+    limit = stream->_limit;
+    remaining = binary->_local_end - ion_stream_get_position(stream);
+    if (remaining < limit - p) {
+        limit = p + remaining;
+    }
+
+    switch (ION_TYPE_INT(element_type)) {
+    case tid_INT_INT:
+        {
+            int64_t *values = (int64_t *)p_values + offset;
+            while (count < max_count && p < limit) {
+                td = *p;
+                len = getLowNibble(td);
+                if (len > (int)sizeof(int64_t) || len >= limit - p) break;
+                for (bits = 0, ii = 1; ii <= len; ii++) {
+                    bits = (bits << 8) | p[ii];
+                }
+                if (getTypeCode(td) == TID_POS_INT && bits <= INT64_MAX) {
+                    values[count] = (int64_t)bits;
+                }
+                else if (getTypeCode(td) == TID_NEG_INT && bits != 0 && bits <= (uint64_t)INT64_MAX + 1) {
+                    values[count] = (bits == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)bits;
+                }
+                else {
+                    // not an int64, or not an int at all, next() sorts it out
+                    break;
+                }
+                count++;
+                p += 1 + len;
+            }
+        }
+        break;
+    case tid_FLOAT_INT:
+        {
+            double *values = (double *)p_values + offset;
+            while (count < max_count && p < limit) {
+                td = *p;
+                if (td == makeTypeDescriptor(TID_FLOAT, sizeof(double)) && limit - p > (int)sizeof(double)) {
+                    // the compilers make this one load and a byte swap
+                    bits = ((uint64_t)p[1] << 56) | ((uint64_t)p[2] << 48) | ((uint64_t)p[3] << 40) | ((uint64_t)p[4] << 32)
+                         | ((uint64_t)p[5] << 24) | ((uint64_t)p[6] << 16) | ((uint64_t)p[7] << 8) | (uint64_t)p[8];
+                    memcpy(&values[count++], &bits, sizeof(double));
+                    p += 1 + sizeof(double);
+                }
+                else if (td == makeTypeDescriptor(TID_FLOAT, sizeof(float)) && limit - p > (int)sizeof(float)) {
+                    bits32 = ((uint32_t)p[1] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 8) | (uint32_t)p[4];
+                    memcpy(&float_value, &bits32, sizeof(float));
+                    values[count++] = float_value;
+                    p += 1 + sizeof(float);
+                }
+                else if (td == makeTypeDescriptor(TID_FLOAT, 0)) {
+                    values[count++] = 0;
+                    p++;
+                }
+                else {
+                    break;
+                }
+            }
+        }
+        break;
+    case tid_BOOL_INT:
+        {
+            BOOL *values = (BOOL *)p_values + offset;
+            while (count < max_count && p < limit) {
+                td = *p;
+                if (td == IonFalse) {
+                    values[count++] = FALSE;
+                }
+                else if (td == IonTrue) {
+                    values[count++] = TRUE;
+                }
+                else {
+                    break;
+                }
+                p++;
+            }
+        }
+        break;
+    default:
+        // timestamps are too irregular to be worth it, they go through next()
+        break;
+    }
+
+    stream->_curr = p;
+    *p_count = count;
+
+    iRETURN;
+}
+
 iERR _ion_reader_binary_read_decimal(ION_READER *preader, decQuad *p_quad, decNumber **p_num)
 {
     iENTER;
@@ -1279,7 +1437,7 @@ iERR _ion_reader_binary_read_symbol(ION_READER *preader, ION_SYMBOL *p_symbol)
     IONCHECK(_ion_reader_binary_read_symbol_sid(preader, &sid));
     if (sid <= UNKNOWN_SID) FAILWITH(IERR_INVALID_SYMBOL);
 
-    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, sid, &symbol));
+    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(preader->_current_symtab, sid, preader->_temp_entity_pool, &symbol));
     ION_STRING_INIT(&p_symbol->value);
     ION_STRING_INIT(&p_symbol->import_location.name);
     p_symbol->sid = sid;
@@ -1387,6 +1545,71 @@ iERR _ion_reader_binary_read_string(ION_READER *preader, ION_STRING *p_str)
     iRETURN;
 }
 
+// Same as _ion_reader_binary_read_string except the returned string borrows
+// its bytes (see _ion_reader_binary_borrow_bytes) and symbol text is taken
+// straight from the current symbol table rather than copied.
+iERR _ion_reader_binary_read_string_view(ION_READER *preader, ION_STRING *p_str)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_STRING        *pstr;
+    BYTE              *bytes;
+    int                tid;
+    SIZE               expected_remaining;
+    SID                sid;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_str != NULL);
+
+    binary = &preader->typed_reader.binary;
+    tid = getTypeCode(binary->_value_tid);
+
+    if (tid == TID_STRING) {
+        if (binary->_state != S_BEFORE_CONTENTS) {
+            FAILWITH(IERR_INVALID_STATE);
+        }
+    }
+    else if (tid == TID_SYMBOL) {
+        // symbols are peeked during next(), see _ion_reader_binary_read_string
+        if (binary->_state != S_BEFORE_TID) {
+            FAILWITH(IERR_INVALID_STATE);
+        }
+    }
+    else {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    if (getLowNibble(binary->_value_tid) == ION_lnIsNull) {
+        FAILWITH(IERR_NULL_VALUE);
+    }
+
+    if (tid == TID_STRING) {
+        IONCHECK(_ion_reader_binary_borrow_bytes(preader, binary->_value_len, &bytes));
+        if (preader->options.skip_character_validation == FALSE) {
+            // this is the whole value, so a partial character at the end is an error too
+            IONCHECK(_ion_reader_binary_validate_utf8(bytes, binary->_value_len, 0, &expected_remaining));
+            if (expected_remaining != 0) FAILWITH(IERR_INVALID_UTF8);
+        }
+        p_str->value  = bytes;
+        p_str->length = binary->_value_len;
+    }
+    else {
+        IONCHECK(_ion_reader_binary_read_symbol_sid(preader, &sid));
+        if (sid <= UNKNOWN_SID) FAILWITH(IERR_INVALID_SYMBOL);
+        IONCHECK(_ion_symbol_table_find_by_sid_helper(preader->_current_symtab, sid, &pstr));
+        if (pstr) {
+            ION_STRING_ASSIGN(p_str, pstr);
+        }
+        else {
+            ION_STRING_INIT(p_str);
+        }
+    }
+
+    binary->_state = S_BEFORE_TID; // now we (should be) just in front of the next value
+
+    iRETURN;
+}
+
 // reads up to buf_max bytes from a string (not a symbol) this fails if the flag
 // accept_partial is *not* true and there isn't enough room in the passed in buffer.
 // if accept_partial is true it reads enough  bytes to fill the buffer or all 
@@ -1615,6 +1838,190 @@ iERR _ion_reader_binary_read_lob_bytes(ION_READER *preader, BOOL accept_partial,
     iRETURN;
 }
 
+iERR _ion_reader_binary_read_lob_view(ION_READER *preader, ION_STRING *p_value)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    BYTE              *bytes;
+    int                tid;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_value != NULL);
+
+    binary = &preader->typed_reader.binary;
+
+    if (binary->_state != S_BEFORE_CONTENTS) {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    tid = getTypeCode(binary->_value_tid);
+    if (tid != TID_BLOB && tid != TID_CLOB) {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    if (getLowNibble(binary->_value_tid) == ION_lnIsNull) {
+        FAILWITH(IERR_NULL_VALUE);
+    }
+
+    IONCHECK(_ion_reader_binary_borrow_bytes(preader, binary->_value_len, &bytes));
+    p_value->value  = bytes;
+    p_value->length = binary->_value_len;
+
+    binary->_value_len = 0;
+    binary->_state = S_BEFORE_TID; // now we (should be) just in front of the next value
+
+    iRETURN;
+}
+
+// returns a pointer to the next length bytes of the input and moves the stream
+// past them. When the bytes are contiguous in the stream's current buffer (user
+// buffers and memory mapped streams are a single buffer) the pointer is into that
+// buffer, otherwise the value straddles pages and the bytes are copied into the
+// temp pool. Either way they are good until the reader moves.
+iERR _ion_reader_binary_borrow_bytes(ION_READER *preader, SIZE length, BYTE **p_bytes)
+{
+    iENTER;
+    ION_STREAM *stream;
+    BYTE       *bytes;
+    SIZE        read_len;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(length >= 0);
+    ASSERT(p_bytes != NULL);
+
+    stream = preader->istream;
+    IONCHECK(_ion_binary_reader_fits_container(preader, length));
+
+    if (stream->_curr != NULL && (stream->_limit - stream->_curr) >= length) {
+        bytes = stream->_curr;
+        stream->_curr += length;
+    }
+    else {
+        bytes = (BYTE *)ion_alloc_with_owner(preader->_temp_entity_pool, length);
+        if (!bytes) FAILWITH(IERR_NO_MEMORY);
+        IONCHECK(ion_stream_read(stream, bytes, length, &read_len));
+        if (read_len != length) FAILWITH(IERR_UNEXPECTED_EOF);
+    }
+
+    *p_bytes = bytes;
+
+    iRETURN;
+}
+
+// points p_bytes at the contents of the current value without moving past
+// them, so the value can still be read. When the contents straddle pages they
+// are copied into the temp pool and the stream is rewound to them, which the
+// stream's mark makes possible. Either way they are good until the reader moves.
+iERR _ion_reader_binary_peek_contents(ION_READER *preader, BYTE **p_bytes, SIZE *p_length)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_STREAM        *stream;
+    BYTE              *bytes;
+    SIZE               length, read_len;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_bytes != NULL);
+    ASSERT(p_length != NULL);
+
+    binary = &preader->typed_reader.binary;
+    if (binary->_state != S_BEFORE_CONTENTS) {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    stream = preader->istream;
+    length = binary->_value_len;
+    IONCHECK(_ion_binary_reader_fits_container(preader, length));
+
+    if (stream->_curr != NULL && (stream->_limit - stream->_curr) >= length) {
+        bytes = stream->_curr;
+    }
+    else {
+        if (ion_stream_is_mark_open(stream)) FAILWITH(IERR_INVALID_STATE);
+        bytes = (BYTE *)ion_alloc_with_owner(preader->_temp_entity_pool, length);
+        if (!bytes) FAILWITH(IERR_NO_MEMORY);
+        IONCHECK(ion_stream_mark(stream));
+        IONCHECK(ion_stream_read(stream, bytes, length, &read_len));
+        IONCHECK(ion_stream_mark_rewind(stream));
+        IONCHECK(ion_stream_mark_clear(stream));
+        if (read_len != length) FAILWITH(IERR_UNEXPECTED_EOF);
+    }
+
+    *p_bytes = bytes;
+    *p_length = length;
+
+    iRETURN;
+}
+
+// writes the current value to pstream as a top level value, with its
+// annotations but not its field name, without moving the reader. The
+// contents are copied as they're encoded and keep their symbol IDs. The
+// annotation wrapper and type descriptor are written again from what was
+// read, since they may be on an earlier page than the contents, and so is a
+// symbol value, which next has already read.
+iERR _ion_reader_binary_copy_value(ION_READER *preader, ION_STREAM *pstream)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    BYTE              *contents;
+    SIZE               length, written, ii;
+    int                type, value_len, annotation_len;
+    BOOL               is_null_or_bool, has_length_field;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(pstream != NULL);
+
+    binary = &preader->typed_reader.binary;
+    type = getTypeCode(binary->_value_tid);
+    if (type == TID_SYMBOL && binary->_state == S_BEFORE_TID) {
+        // next has already read the symbol ID, so it's written again
+        contents = NULL;
+        length = ion_binary_len_uint_64(binary->_value_symbol_id);
+    }
+    else {
+        IONCHECK(_ion_reader_binary_peek_contents(preader, &contents, &length));
+    }
+
+    // a null's or a bool's low nibble isn't a length, and a struct's low
+    // nibble of 1 means it's sorted and has a length field
+    is_null_or_bool = (getLowNibble(binary->_value_tid) == ION_lnIsNull || type == TID_BOOL);
+    has_length_field = !is_null_or_bool && (length >= ION_lnIsVarLen || (type == TID_STRUCT && length == 1));
+    value_len = 1 + (has_length_field ? ion_binary_len_var_uint_64(length) : 0) + length;
+
+    if (binary->_annotation_count > 0) {
+        annotation_len = 0;
+        for (ii = 0; ii < binary->_annotation_count; ii++) {
+            annotation_len += ion_binary_len_var_uint_64(binary->_annotation_sids[ii]);
+        }
+        IONCHECK(ion_binary_write_type_desc_with_length(pstream, TID_UTA,
+                 ion_binary_len_var_uint_64(annotation_len) + annotation_len + value_len));
+        IONCHECK(ion_binary_write_var_uint_64(pstream, annotation_len));
+        for (ii = 0; ii < binary->_annotation_count; ii++) {
+            IONCHECK(ion_binary_write_var_uint_64(pstream, binary->_annotation_sids[ii]));
+        }
+    }
+
+    if (is_null_or_bool) {
+        ION_PUT(pstream, binary->_value_tid);
+    }
+    else if (has_length_field) {
+        ION_PUT(pstream, makeTypeDescriptor(type, ION_lnIsVarLen));
+        IONCHECK(ion_binary_write_var_uint_64(pstream, length));
+    }
+    else {
+        ION_PUT(pstream, makeTypeDescriptor(type, length));
+    }
+    if (contents != NULL) {
+        IONCHECK(ion_stream_write(pstream, contents, length, &written));
+        if (written != length) FAILWITH(IERR_WRITE_ERROR);
+    }
+    else if (length > 0) {
+        IONCHECK(ion_binary_write_uint_64(pstream, binary->_value_symbol_id));
+    }
+
+    iRETURN;
+}
+
 // these are local routines that shouldn't need to be called
 // from anywhere else - they are declared at the top of this file
 
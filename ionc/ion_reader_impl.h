@@ -19,6 +19,70 @@
 extern "C" {
 #endif
 
+/** the states of the lexer readers opened with ion_reader_open_push run ahead of the
+ *  scanner, between two bytes of input
+ *
+ */
+typedef enum _ion_text_push_mode {
+    TPM_CODE = 0,           // between tokens, or anywhere in a container that isn't quoted
+    TPM_TOKEN,              // in a top level number, keyword or plain symbol
+    TPM_AFTER,              // after a top level token that can only end at the next one (a symbol or a long string)
+    TPM_AFTER_COLON,
+    TPM_AFTER_QUOTE1,       // one and two quotes that might start another part of a long string
+    TPM_AFTER_QUOTE2,
+    TPM_SLASH,
+    TPM_LINE_COMMENT,
+    TPM_BLOCK_COMMENT,
+    TPM_BLOCK_COMMENT_STAR,
+    TPM_QUOTE1,             // one and two quotes that might start a long string
+    TPM_QUOTE2,
+    TPM_SYMBOL,
+    TPM_SYMBOL_ESCAPE,
+    TPM_STRING,
+    TPM_STRING_ESCAPE,
+    TPM_LONG_STRING,
+    TPM_LONG_STRING_ESCAPE,
+    TPM_LONG_STRING_QUOTE1,
+    TPM_LONG_STRING_QUOTE2,
+    TPM_BRACE,
+    TPM_LOB,
+    TPM_LOB_BRACE,
+    TPM_LOB_QUOTE1,
+    TPM_LOB_QUOTE2
+} ION_TEXT_PUSH_MODE;
+
+typedef enum _ion_text_push_token {
+    TPT_NONE = 0,
+    TPT_PLAIN,
+    TPT_QUOTED,
+    TPT_LONG_STRING,
+    TPT_STRUCT,
+    TPT_OTHER
+} ION_TEXT_PUSH_TOKEN;
+
+#define ION_TEXT_PUSH_TOKEN_MAX 24  /* enough for $ion_symbol_table and version markers */
+
+/** readers opened with ion_reader_open_push hold a top level text value back until all of it,
+ *  and whatever the scanner peeks at after it, has been pushed. The lexer that finds where the
+ *  values end goes a byte at a time and keeps its state here between pushes, so the bytes of a
+ *  value that's still arriving are only looked at once.
+ *
+ */
+typedef struct _ion_text_push_lexer
+{
+    POSITION             scanned;       // stream position of the next byte to lex
+    POSITION             mark;          // where the lookahead after a token started, it's given back if it isn't an annotation
+    ION_TEXT_PUSH_MODE   mode;
+    ION_TEXT_PUSH_MODE   resume;        // the mode a comment or a string returns to
+    int64_t              depth;         // of the containers the lexer is in
+    ION_TEXT_PUSH_TOKEN  token;         // the kind of the top level token being lexed
+    BOOL                 digits;        // the token started with a digit, so it may be a timestamp with colons in it
+    BOOL                 annotated;     // the top level value has annotations
+    BOOL                 symbol_table;  // and the first one is $ion_symbol_table
+    SIZE                 token_length;  // only the first ION_TEXT_PUSH_TOKEN_MAX bytes are kept
+    BYTE                 token_text[ION_TEXT_PUSH_TOKEN_MAX];
+} ION_TEXT_PUSH_LEXER;
+
 /** This is the struct that hold state for the ion text reader when parsing
  *  Ion from UTF8.
  *
@@ -102,10 +166,18 @@ typedef struct _ion_reader_text
      *   this contains the stack of ION_TYPEs of the containers the caller
      *   has stepped into. These types are always a container type, never null.
      *   This stack is empty when we are at the top level (aka at the datagram
-     *   level).
+     *   level). It is a flat array sized from max_container_depth, grown
+     *   only when a document nests deeper than that.
      *
      */
-    ION_COLLECTION        _container_state_stack; 
+    ION_TYPE             *_container_state_stack;
+    SIZE                  _container_state_count;
+    SIZE                  _container_state_capacity;
+
+    /** for readers opened with ion_reader_open_push, see ION_TEXT_PUSH_LEXER
+     *
+     */
+    ION_TEXT_PUSH_LEXER   _push;
 
 } ION_TEXT_READER;
 
@@ -143,10 +215,14 @@ typedef struct _ion_reader_binary
     int             _value_tid;
     int32_t         _value_len;
 
-    ION_COLLECTION _annotation_sids; // ~ 6 ints array of ION_STRING+
+    SID            *_annotation_sids;      // flat array, sized from max_annotation_count
+    SIZE            _annotation_count;
+    SIZE            _annotation_capacity;
 
-    // local stack for stepInto() and stepOut()
-    ION_COLLECTION _parent_stack;
+    // local stack for stepInto() and stepOut(), sized from max_container_depth
+    BINARY_PARENT_STATE *_parent_stack;
+    SIZE            _parent_count;
+    SIZE            _parent_capacity;
 
 } ION_BINARY_READER;
 
@@ -173,8 +249,11 @@ struct _ion_reader
     BOOL                _return_system_values;
 
     ION_SYMBOL_TABLE   *_current_symtab;
+    int64_t             _symtab_generation;         // changes whenever _current_symtab is replaced (the table's address may be reused), never repeats across readers
     ION_SYMBOL_TABLE   *_local_symtab_pool;         // memory pool for local symbol table we recycle
     void               *_temp_entity_pool;          // memory pool for top level objects that we'll throw away
+    SIZE                _temp_pool_capacity;        // bytes the pool holds before spilling, when it's a scratch arena
+    POSITION            _perf_position;             // stream position up to which bytes_read has counted what the reader consumed
 
     ION_READER_CONTEXT_CHANGE_NOTIFIER context_change_notifier;
     
@@ -198,9 +277,19 @@ iERR _ion_reader_open_buffer_helper(ION_READER **p_preader, BYTE *buffer, SIZE b
 iERR _ion_reader_open_stream_helper(ION_READER **p_preader, ION_STREAM *p_stream, ION_READER_OPTIONS *p_options);
 iERR _ion_reader_make_new_reader(ION_READER_OPTIONS *p_options, ION_READER **p_reader);
 iERR _ion_reader_set_options(ION_READER *preader, ION_READER_OPTIONS* p_options);
+iERR _ion_reader_grow_stack(ION_READER *preader, void **p_stack, SIZE count, SIZE *p_capacity, SIZE element_size);
+
+/** Makes room for one more element on a reader owned flat stack. The
+ *  stacks are sized from the reader options up front so this only calls
+ *  out to _ion_reader_grow_stack when a document exceeds them.
+ */
+#define ION_READER_STACK_RESERVE(preader, stack, count, capacity) \
+    (((count) < (capacity)) ? IERR_OK \
+        : _ion_reader_grow_stack((preader), (void **)&(stack), (count), &(capacity), sizeof(*(stack))))
 void _ion_reader_initialize_option_defaults(ION_READER_OPTIONS *p_options);
 iERR _ion_reader_validate_options(ION_READER_OPTIONS* p_options);
 iERR _ion_reader_initialize(ION_READER *preader, BYTE *version_buffer, SIZE version_length);
+iERR _ion_reader_push_check_format(ION_READER *preader);
 
 iERR _ion_reader_get_catalog_helper(ION_READER *preader, ION_CATALOG **p_pcatalog);
 iERR _ion_reader_get_symbol_table_helper(ION_READER *preader, ION_SYMBOL_TABLE **p_psymtab);
@@ -232,6 +321,7 @@ iERR _ion_reader_read_double_helper(ION_READER *preader, double *p_value);
 iERR _ion_reader_read_decimal_helper(ION_READER *preader, decQuad *p_value);
 iERR _ion_reader_read_ion_decimal_helper(ION_READER *preader, ION_DECIMAL *p_value);
 iERR _ion_reader_read_timestamp_helper(ION_READER *preader, ION_TIMESTAMP *p_value);
+iERR _ion_reader_read_array_helper(ION_READER *preader, ION_TYPE element_type, void *p_values, SIZE max_count, SIZE *p_count);
 iERR _ion_reader_read_symbol_helper(ION_READER *preader, ION_SYMBOL *p_symbol);
 
 iERR _ion_reader_get_string_length_helper(ION_READER *preader, SIZE *p_length);
@@ -241,14 +331,18 @@ iERR _ion_reader_get_string_size_helper(ION_READER *preader, SIZE *p_length);
 
 iERR _ion_reader_read_lob_bytes_helper     (ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
 iERR _ion_reader_read_partial_string_helper(ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
+iERR _ion_reader_read_string_view_helper   (ION_READER *preader, ION_STRING *p_value);
+iERR _ion_reader_read_lob_view_helper      (ION_READER *preader, ION_STRING *p_value);
 
 iERR _ion_reader_close_helper(ION_READER *preader);
 
 iERR _ion_reader_allocate_temp_pool                 (ION_READER *preader);
 iERR _ion_reader_reset_temp_pool                    (ION_READER *preader);
-iERR _ion_reader_allocate_pool_owner                (void **p_owner);
+void _ion_reader_count_bytes_read                   (ION_READER *preader);
+iERR _ion_reader_allocate_pool_owner                (ION_READER *preader, void **p_owner);
 iERR _ion_reader_free_local_symbol_table            (ION_READER *preader);
 iERR _ion_reader_reset_local_symbol_table           (ION_READER *preader);
+void _ion_reader_symbol_table_changed               (ION_READER *preader);
 iERR _ion_reader_process_possible_symbol_table      (ION_READER *preader, BOOL *is_symbol_table);
 
 iERR _ion_reader_get_position_helper(ION_READER *preader, int64_t *p_bytes, int32_t *p_line, int32_t *p_offset);
@@ -259,6 +353,7 @@ iERR _ion_reader_get_position_helper(ION_READER *preader, int64_t *p_bytes, int3
 
         iERR ion_reader_text_close(hREADER *p_hreader);
         iERR ion_reader_text_initialize(hREADER *p_hreader);
+        BOOL _ion_reader_text_push_end_value(ION_TEXT_PUSH_LEXER *lexer, ION_TEXT_PUSH_TOKEN token);
 
 
 
@@ -271,6 +366,7 @@ iERR _ion_reader_binary_open                (ION_READER *preader);
 iERR _ion_reader_binary_reset               (ION_READER *preader, ION_TYPE parent_tid, POSITION value_start, POSITION local_end);
 
 iERR _ion_reader_binary_next                (ION_READER *preader, ION_TYPE *p_value_type);
+iERR _ion_reader_binary_push_check_value    (ION_READER *preader);
 iERR _ion_reader_binary_get_local_symbol_table_helper(ION_READER *preader, ION_SYMBOL_TABLE **pplocal );
 iERR _ion_reader_binary_step_in             (ION_READER *preader);
 iERR _ion_reader_binary_step_out            (ION_READER *preader);
@@ -299,6 +395,7 @@ iERR _ion_reader_binary_read_int32          (ION_READER *preader, int32_t *p_val
 iERR _ion_reader_binary_read_int64          (ION_READER *preader, int64_t *p_value);
 iERR _ion_reader_binary_read_ion_int        (ION_READER *preader, ION_INT *p_value);
 iERR _ion_reader_binary_read_double         (ION_READER *preader, double *p_value);
+iERR _ion_reader_binary_read_array          (ION_READER *preader, ION_TYPE element_type, void *p_values, SIZE offset, SIZE max_count, SIZE *p_count);
 iERR _ion_reader_binary_read_decimal        (ION_READER *preader, decQuad *p_value, decNumber **p_num);
 iERR _ion_reader_binary_read_timestamp      (ION_READER *preader, iTIMESTAMP p_value);
 iERR _ion_reader_binary_read_symbol_sid     (ION_READER *preader, SID *p_value);
@@ -308,9 +405,14 @@ iERR _ion_reader_binary_read_symbol         (ION_READER *preader, ION_SYMBOL *p_
 iERR _ion_reader_binary_get_string_length   (ION_READER *preader, SIZE *p_length);
 iERR _ion_reader_binary_read_string_bytes   (ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
 iERR _ion_reader_binary_read_string         (ION_READER *preader, ION_STRING *pstr);
+iERR _ion_reader_binary_read_string_view    (ION_READER *preader, ION_STRING *pstr);
 
 iERR _ion_reader_binary_get_lob_size        (ION_READER *preader, SIZE *p_length);
 iERR _ion_reader_binary_read_lob_bytes      (ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length);
+iERR _ion_reader_binary_read_lob_view       (ION_READER *preader, ION_STRING *p_value);
+iERR _ion_reader_binary_borrow_bytes        (ION_READER *preader, SIZE length, BYTE **p_bytes);
+iERR _ion_reader_binary_peek_contents       (ION_READER *preader, BYTE **p_bytes, SIZE *p_length);
+iERR _ion_reader_binary_copy_value          (ION_READER *preader, ION_STREAM *pstream);
 
 iERR _ion_reader_binary_validate_utf8       (BYTE *buf, SIZE len, SIZE expected_remaining, SIZE *p_expected_remaining);
 
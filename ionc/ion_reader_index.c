@@ -0,0 +1,505 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <ionc/ion_reader_index.h>
+#include "ion_reader_index_impl.h"
+#include "ion_reader_impl.h"
+#include "ion_stream_impl.h"
+#include "ion_symbol_table_impl.h"
+
+#define ION_READER_INDEX_COPY_BUFFER_SIZE 4096
+
+iERR _ion_reader_index_write_context(ION_SYMBOL_TABLE *symtab, ION_STREAM *contexts);
+iERR _ion_reader_index_copy_stream(ION_STREAM *src, POSITION length, ION_STREAM *dst);
+iERR _ion_reader_index_restore_context(ION_READER_INDEX *index, uint32_t context);
+iERR _ion_reader_index_seek_helper(ION_READER_INDEX *index, int64_t record);
+
+static inline void _ion_reader_index_put_uint32(BYTE *dst, uint32_t value)
+{
+    int ii;
+    for (ii = 0; ii < 4; ii++) {
+        dst[ii] = (BYTE)(value >> (8 * ii));
+    }
+}
+
+static inline void _ion_reader_index_put_int64(BYTE *dst, int64_t value)
+{
+    int ii;
+    for (ii = 0; ii < 8; ii++) {
+        dst[ii] = (BYTE)((uint64_t)value >> (8 * ii));
+    }
+}
+
+static inline uint32_t _ion_reader_index_get_uint32(BYTE *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline int64_t _ion_reader_index_get_int64(BYTE *src)
+{
+    uint64_t value = 0;
+    int      ii;
+    for (ii = 7; ii >= 0; ii--) {
+        value = (value << 8) | src[ii];
+    }
+    return (int64_t)value;
+}
+
+#define ION_READER_INDEX_RECORD(index, record) ((index)->_records + (record) * ION_READER_INDEX_RECORD_SIZE)
+#define ION_READER_INDEX_RECORD_OFFSET(slot)   _ion_reader_index_get_int64((slot))
+#define ION_READER_INDEX_RECORD_LENGTH(slot)   _ion_reader_index_get_int64((slot) + 8)
+#define ION_READER_INDEX_RECORD_KEY(slot)      _ion_reader_index_get_int64((slot) + 16)
+#define ION_READER_INDEX_RECORD_CONTEXT(slot)  _ion_reader_index_get_uint32((slot) + 24)
+
+iERR ion_reader_index_build(hREADER hreader, ION_STREAM *index_stream, ION_READER_INDEX_OPTIONS *p_options,
+                            int64_t *p_record_count)
+{
+    iENTER;
+    ION_READER *preader;
+    ION_STREAM *contexts = NULL;
+    ION_TYPE    type;
+    POSITION    offset, contexts_offset;
+    SIZE        length, written;
+    int64_t     record_count = 0, context_count = 0, generation = -1, key, last_key = 0;
+    BOOL        context_is_system = FALSE;
+    ION_SYMBOL_TABLE_TYPE symtab_type;
+    BYTE        slot[ION_READER_INDEX_TRAILER_SIZE];
+
+    if (!hreader)      FAILWITH(IERR_INVALID_ARG);
+    if (!index_stream) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    // symbol tables have to be processed by the reader for the contexts to be right
+    if (preader->options.return_system_values) FAILWITH(IERR_INVALID_ARG);
+
+    memset(slot, 0, sizeof(slot));
+    memcpy(slot, ION_READER_INDEX_MAGIC, ION_READER_INDEX_MAGIC_LENGTH);
+    _ion_reader_index_put_uint32(slot + 4, ION_READER_INDEX_VERSION);
+    _ion_reader_index_put_uint32(slot + 8, ION_READER_INDEX_RECORD_SIZE);
+    IONCHECK(ion_stream_write(index_stream, slot, ION_READER_INDEX_HEADER_SIZE, &written));
+    if (written != ION_READER_INDEX_HEADER_SIZE) FAILWITH(IERR_WRITE_ERROR);
+
+    // the contexts are only known once all the records have gone out
+    IONCHECK(ion_stream_open_memory_only(&contexts));
+
+    for (;;) {
+        IONCHECK(ion_reader_next(hreader, &type));
+        if (type == tid_EOF) break;
+
+        if (preader->_symtab_generation != generation) {
+            generation = preader->_symtab_generation;
+            IONCHECK(_ion_symbol_table_get_type_helper(preader->_current_symtab, &symtab_type));
+            // a version marker between two records without local symbols changes nothing
+            if (symtab_type != ist_SYSTEM || !context_is_system || context_count == 0) {
+                IONCHECK(_ion_reader_index_write_context(preader->_current_symtab, contexts));
+                context_count++;
+            }
+            context_is_system = (symtab_type == ist_SYSTEM);
+        }
+
+        IONCHECK(ion_reader_get_value_offset(hreader, &offset));
+        IONCHECK(ion_reader_get_value_length(hreader, &length));
+        if (p_options && p_options->key_fn) {
+            IONCHECK(p_options->key_fn(hreader, p_options->key_context, &key));
+            if (record_count > 0 && key < last_key) {
+                FAILWITHMSG(IERR_INVALID_ARG, "index keys must not decrease");
+            }
+            last_key = key;
+        }
+        else {
+            key = record_count;
+        }
+
+        memset(slot, 0, ION_READER_INDEX_RECORD_SIZE);
+        _ion_reader_index_put_int64(slot, offset);
+        _ion_reader_index_put_int64(slot + 8, length);
+        _ion_reader_index_put_int64(slot + 16, key);
+        _ion_reader_index_put_uint32(slot + 24, (uint32_t)(context_count - 1));
+        IONCHECK(ion_stream_write(index_stream, slot, ION_READER_INDEX_RECORD_SIZE, &written));
+        if (written != ION_READER_INDEX_RECORD_SIZE) FAILWITH(IERR_WRITE_ERROR);
+        record_count++;
+    }
+
+    contexts_offset = ION_READER_INDEX_HEADER_SIZE + record_count * ION_READER_INDEX_RECORD_SIZE;
+    length = (SIZE)ion_stream_get_position(contexts);
+    IONCHECK(ion_stream_seek(contexts, 0));
+    IONCHECK(_ion_reader_index_copy_stream(contexts, length, index_stream));
+
+    memset(slot, 0, sizeof(slot));
+    _ion_reader_index_put_int64(slot, record_count);
+    _ion_reader_index_put_int64(slot + 8, context_count);
+    _ion_reader_index_put_int64(slot + 16, contexts_offset);
+    memcpy(slot + 24, ION_READER_INDEX_MAGIC, ION_READER_INDEX_MAGIC_LENGTH);
+    IONCHECK(ion_stream_write(index_stream, slot, ION_READER_INDEX_TRAILER_SIZE, &written));
+    if (written != ION_READER_INDEX_TRAILER_SIZE) FAILWITH(IERR_WRITE_ERROR);
+    IONCHECK(ion_stream_flush(index_stream));
+
+    if (p_record_count) {
+        *p_record_count = record_count;
+    }
+
+fail:
+    if (contexts) {
+        ion_stream_close(contexts);
+    }
+    return err;
+}
+
+iERR _ion_reader_index_write_context(ION_SYMBOL_TABLE *symtab, ION_STREAM *contexts)
+{
+    iENTER;
+    ION_STREAM           *stream = NULL;
+    hWRITER               writer = NULL;
+    ION_WRITER_OPTIONS    options;
+    ION_SYMBOL_TABLE_TYPE type;
+    BYTE                  length_bytes[4];
+    POSITION              length = 0;
+    SIZE                  written;
+
+    ASSERT(symtab != NULL);
+    ASSERT(contexts != NULL);
+
+    IONCHECK(_ion_symbol_table_get_type_helper(symtab, &type));
+    if (type != ist_SYSTEM) {
+        // written as a stream of its own, so restoring the context is just reading it
+        memset(&options, 0, sizeof(options));
+        options.output_as_binary = TRUE;
+        IONCHECK(ion_stream_open_memory_only(&stream));
+        IONCHECK(ion_writer_open(&writer, stream, &options));
+        IONCHECK(ion_symbol_table_unload(PTR_TO_HANDLE(symtab), writer));
+        err = ion_writer_close(writer);
+        writer = NULL;
+        IONCHECK(err);
+        length = ion_stream_get_position(stream);
+        if (length > UINT32_MAX) FAILWITH(IERR_NUMERIC_OVERFLOW);
+    }
+
+    _ion_reader_index_put_uint32(length_bytes, (uint32_t)length);
+    IONCHECK(ion_stream_write(contexts, length_bytes, sizeof(length_bytes), &written));
+    if (written != sizeof(length_bytes)) FAILWITH(IERR_WRITE_ERROR);
+    if (stream) {
+        IONCHECK(ion_stream_seek(stream, 0));
+        IONCHECK(_ion_reader_index_copy_stream(stream, length, contexts));
+    }
+
+fail:
+    if (writer) {
+        ion_writer_close(writer);
+    }
+    if (stream) {
+        ion_stream_close(stream);
+    }
+    return err;
+}
+
+iERR _ion_reader_index_copy_stream(ION_STREAM *src, POSITION length, ION_STREAM *dst)
+{
+    iENTER;
+    BYTE buffer[ION_READER_INDEX_COPY_BUFFER_SIZE];
+    SIZE chunk, read, written;
+
+    while (length > 0) {
+        chunk = (length > ION_READER_INDEX_COPY_BUFFER_SIZE) ? ION_READER_INDEX_COPY_BUFFER_SIZE : (SIZE)length;
+        IONCHECK(ion_stream_read(src, buffer, chunk, &read));
+        if (read != chunk) FAILWITH(IERR_UNEXPECTED_EOF);
+        IONCHECK(ion_stream_write(dst, buffer, chunk, &written));
+        if (written != chunk) FAILWITH(IERR_WRITE_ERROR);
+        length -= chunk;
+    }
+
+    iRETURN;
+}
+
+iERR ion_reader_index_open(hREADER_INDEX *p_index, hREADER hreader, BYTE *index_bytes, SIZE index_length)
+{
+    iENTER;
+    ION_READER_INDEX *index = NULL;
+    BYTE             *trailer, *context, *end;
+    int64_t           record_count, context_count, contexts_offset, ii;
+
+    if (!p_index)     FAILWITH(IERR_INVALID_ARG);
+    if (!hreader)     FAILWITH(IERR_INVALID_ARG);
+    if (!index_bytes) FAILWITH(IERR_INVALID_ARG);
+
+    if (index_length < ION_READER_INDEX_HEADER_SIZE + ION_READER_INDEX_TRAILER_SIZE
+        || memcmp(index_bytes, ION_READER_INDEX_MAGIC, ION_READER_INDEX_MAGIC_LENGTH)
+    ) {
+        FAILWITHMSG(IERR_INVALID_BINARY, "not a reader index");
+    }
+    if (_ion_reader_index_get_uint32(index_bytes + 4) != ION_READER_INDEX_VERSION
+        || _ion_reader_index_get_uint32(index_bytes + 8) != ION_READER_INDEX_RECORD_SIZE
+    ) {
+        FAILWITHMSG(IERR_INVALID_BINARY, "unsupported reader index version");
+    }
+
+    trailer = index_bytes + index_length - ION_READER_INDEX_TRAILER_SIZE;
+    record_count    = _ion_reader_index_get_int64(trailer);
+    context_count   = _ion_reader_index_get_int64(trailer + 8);
+    contexts_offset = _ion_reader_index_get_int64(trailer + 16);
+    // the counts are bounded by what the index has room for before they're multiplied, so
+    // a crafted trailer can't wrap the offsets (or the allocations) around
+    if (memcmp(trailer + 24, ION_READER_INDEX_MAGIC, ION_READER_INDEX_MAGIC_LENGTH)
+        || record_count < 0 || context_count < 0
+        || record_count > (index_length - ION_READER_INDEX_HEADER_SIZE - ION_READER_INDEX_TRAILER_SIZE)
+                          / ION_READER_INDEX_RECORD_SIZE
+        || contexts_offset != ION_READER_INDEX_HEADER_SIZE + record_count * ION_READER_INDEX_RECORD_SIZE
+        || context_count > (index_length - ION_READER_INDEX_TRAILER_SIZE - contexts_offset) / 4
+        || context_count > (int64_t)(MAX_SIZE / sizeof(BYTE *))
+        || (record_count > 0 && context_count == 0)
+    ) {
+        FAILWITHMSG(IERR_INVALID_BINARY, "corrupt reader index");
+    }
+
+    index = (ION_READER_INDEX *)ion_alloc_owner(sizeof(ION_READER_INDEX));
+    if (!index) FAILWITH(IERR_NO_MEMORY);
+    memset(index, 0, sizeof(ION_READER_INDEX));
+
+    index->_reader        = HANDLE_TO_PTR(hreader, ION_READER);
+    index->_records       = index_bytes + ION_READER_INDEX_HEADER_SIZE;
+    index->_record_count  = record_count;
+    index->_context_count = context_count;
+
+    if (context_count > 0) {
+        index->_contexts        = (BYTE **)ion_alloc_with_owner(index, (SIZE)(context_count * sizeof(BYTE *)));
+        index->_context_lengths = (uint32_t *)ion_alloc_with_owner(index, (SIZE)(context_count * sizeof(uint32_t)));
+        index->_context_symtabs = (ION_SYMBOL_TABLE **)ion_alloc_with_owner(index, (SIZE)(context_count * sizeof(ION_SYMBOL_TABLE *)));
+        if (!index->_contexts || !index->_context_lengths || !index->_context_symtabs) FAILWITH(IERR_NO_MEMORY);
+        memset(index->_context_symtabs, 0, (size_t)context_count * sizeof(ION_SYMBOL_TABLE *));
+    }
+
+    // there are only as many contexts as there are symbol tables in the data, so
+    // they're located up front and loaded the first time a record needs one
+    context = index_bytes + contexts_offset;
+    end     = trailer;
+    for (ii = 0; ii < context_count; ii++) {
+        if (end - context < 4) FAILWITHMSG(IERR_INVALID_BINARY, "corrupt reader index");
+        index->_context_lengths[ii] = _ion_reader_index_get_uint32(context);
+        context += 4;
+        if ((uint64_t)(end - context) < index->_context_lengths[ii]) FAILWITHMSG(IERR_INVALID_BINARY, "corrupt reader index");
+        index->_contexts[ii] = context;
+        context += index->_context_lengths[ii];
+    }
+
+    *p_index = index;
+    index = NULL;
+
+fail:
+    if (index) {
+        ion_free_owner(index);
+    }
+    return err;
+}
+
+iERR ion_reader_index_open_path(hREADER_INDEX *p_index, const char *data_path, const char *index_path,
+                                ION_READER_OPTIONS *p_options)
+{
+    iENTER;
+    ION_STREAM *data_stream = NULL, *index_stream = NULL;
+    ION_READER *preader = NULL;
+    hREADER_INDEX index;
+
+    if (!p_index)    FAILWITH(IERR_INVALID_ARG);
+    if (!data_path)  FAILWITH(IERR_INVALID_ARG);
+    if (!index_path) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(ion_stream_open_mmap_path(data_path, ION_STREAM_MMAP_ADVICE_RANDOM, &data_stream));
+    IONCHECK(_ion_reader_open_stream_helper(&preader, data_stream, p_options));
+    preader->_reader_owns_stream = TRUE;
+    data_stream = NULL;
+
+    IONCHECK(ion_stream_open_mmap_path(index_path, ION_STREAM_MMAP_ADVICE_RANDOM, &index_stream));
+    IONCHECK(ion_reader_index_open(&index, PTR_TO_HANDLE(preader), index_stream->_buffer,
+                                   (SIZE)(index_stream->_limit - index_stream->_buffer)));
+    index->_owns_reader  = TRUE;
+    index->_index_stream = index_stream;
+
+    *p_index = index;
+    return IERR_OK;
+
+fail:
+    if (index_stream) ion_stream_close(index_stream);
+    if (preader)      ion_reader_close(PTR_TO_HANDLE(preader));
+    if (data_stream)  ion_stream_close(data_stream);
+    return err;
+}
+
+iERR ion_reader_index_get_reader(hREADER_INDEX index, hREADER *p_reader)
+{
+    iENTER;
+
+    if (!index)    FAILWITH(IERR_INVALID_ARG);
+    if (!p_reader) FAILWITH(IERR_INVALID_ARG);
+
+    *p_reader = PTR_TO_HANDLE(index->_reader);
+
+    iRETURN;
+}
+
+iERR ion_reader_index_get_record_count(hREADER_INDEX index, int64_t *p_count)
+{
+    iENTER;
+
+    if (!index)   FAILWITH(IERR_INVALID_ARG);
+    if (!p_count) FAILWITH(IERR_INVALID_ARG);
+
+    *p_count = index->_record_count;
+
+    iRETURN;
+}
+
+iERR ion_reader_index_get_record(hREADER_INDEX index, int64_t record, POSITION *p_offset, SIZE *p_length,
+                                 int64_t *p_key)
+{
+    iENTER;
+    BYTE *slot;
+
+    if (!index) FAILWITH(IERR_INVALID_ARG);
+    if (record < 0 || record >= index->_record_count) FAILWITH(IERR_INVALID_ARG);
+
+    slot = ION_READER_INDEX_RECORD(index, record);
+    if (p_offset) *p_offset = ION_READER_INDEX_RECORD_OFFSET(slot);
+    if (p_length) *p_length = (SIZE)ION_READER_INDEX_RECORD_LENGTH(slot);
+    if (p_key)    *p_key    = ION_READER_INDEX_RECORD_KEY(slot);
+
+    iRETURN;
+}
+
+iERR ion_reader_index_seek_record(hREADER_INDEX index, int64_t record)
+{
+    iENTER;
+
+    if (!index) FAILWITH(IERR_INVALID_ARG);
+    if (record < 0 || record >= index->_record_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_index_seek_helper(index, record));
+
+    iRETURN;
+}
+
+iERR ion_reader_index_seek_key(hREADER_INDEX index, int64_t key, int64_t *p_record)
+{
+    iENTER;
+    int64_t low, high, mid;
+
+    if (!index) FAILWITH(IERR_INVALID_ARG);
+
+    // the first record whose key isn't less than key
+    low  = 0;
+    high = index->_record_count;
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (ION_READER_INDEX_RECORD_KEY(ION_READER_INDEX_RECORD(index, mid)) < key) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    IONCHECK(_ion_reader_index_seek_helper(index, low));
+    if (p_record) {
+        *p_record = low;
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_index_seek_helper(ION_READER_INDEX *index, int64_t record)
+{
+    iENTER;
+    BYTE     *slot;
+    POSITION  end;
+
+    ASSERT(index != NULL);
+    ASSERT(record >= 0 && record <= index->_record_count);
+
+    if (record == index->_record_count) {
+        // past the last record, a zero length seek to the last one leaves the reader at EOF
+        end = 0;
+        if (record > 0) {
+            end = ION_READER_INDEX_RECORD_OFFSET(ION_READER_INDEX_RECORD(index, record - 1));
+        }
+        IONCHECK(ion_reader_seek(PTR_TO_HANDLE(index->_reader), end, 0));
+        SUCCEED();
+    }
+
+    slot = ION_READER_INDEX_RECORD(index, record);
+    IONCHECK(_ion_reader_index_restore_context(index, ION_READER_INDEX_RECORD_CONTEXT(slot)));
+    IONCHECK(ion_reader_seek(PTR_TO_HANDLE(index->_reader), ION_READER_INDEX_RECORD_OFFSET(slot), -1));
+
+    iRETURN;
+}
+
+iERR _ion_reader_index_restore_context(ION_READER_INDEX *index, uint32_t context)
+{
+    iENTER;
+    ION_READER        *preader, *context_reader = NULL;
+    ION_READER_OPTIONS options;
+    ION_SYMBOL_TABLE  *symtab;
+    ION_TYPE           type;
+
+    ASSERT(index != NULL);
+
+    if (context >= index->_context_count) FAILWITHMSG(IERR_INVALID_BINARY, "corrupt reader index");
+
+    preader = index->_reader;
+    symtab  = index->_context_symtabs[context];
+    if (!symtab) {
+        if (index->_context_lengths[context] == 0) {
+            IONCHECK(_ion_symbol_table_get_system_symbol_helper(&symtab, ION_SYSTEM_VERSION));
+        }
+        else {
+            // reading the context loads its symbol table, imports are resolved
+            // against the catalog of the reader we're restoring it to
+            memcpy(&options, &preader->options, sizeof(options));
+            options.pcatalog = preader->_catalog;
+            options.return_system_values = FALSE;
+            memset(&options.context_change_notifier, 0, sizeof(options.context_change_notifier));
+            IONCHECK(_ion_reader_open_buffer_helper(&context_reader, index->_contexts[context],
+                                                    (SIZE)index->_context_lengths[context], &options));
+            IONCHECK(_ion_reader_next_helper(context_reader, &type));
+            if (type != tid_EOF) FAILWITHMSG(IERR_INVALID_BINARY, "corrupt reader index");
+            // this copies the table onto the reader, where it stays until the reader is closed
+            IONCHECK(_ion_reader_set_symbol_table_helper(preader, context_reader->_current_symtab));
+            symtab = preader->_current_symtab;
+        }
+        index->_context_symtabs[context] = symtab;
+    }
+
+    if (preader->_current_symtab != symtab) {
+        IONCHECK(_ion_reader_set_symbol_table_helper(preader, symtab));
+    }
+
+fail:
+    if (context_reader) {
+        ion_reader_close(PTR_TO_HANDLE(context_reader));
+    }
+    return err;
+}
+
+iERR ion_reader_index_close(hREADER_INDEX index)
+{
+    iENTER;
+
+    if (!index) FAILWITH(IERR_INVALID_ARG);
+
+    if (index->_owns_reader) {
+        UPDATEERROR(ion_reader_close(PTR_TO_HANDLE(index->_reader)));
+    }
+    if (index->_index_stream) {
+        UPDATEERROR(ion_stream_close(index->_index_stream));
+    }
+    ion_free_owner(index);
+
+    iRETURN;
+}
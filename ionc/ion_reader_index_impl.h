@@ -0,0 +1,64 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#ifndef ION_READER_INDEX_IMPL_H
+#define ION_READER_INDEX_IMPL_H
+
+#include "ion_internal.h"
+#include <ionc/ion_reader_index.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Index layout, all integers little endian:
+ *
+ *   header   magic[4] version:u32 record_size:u32 reserved:u32
+ *   records  record_count * { offset:i64 length:i64 key:i64 context:u32 reserved:u32 }
+ *   contexts context_count * { length:u32 bytes[length] }
+ *   trailer  record_count:i64 context_count:i64 contexts_offset:i64 magic[4] reserved:u32
+ *
+ * A context is the Ion binary a reader loads the record's local symbol table from (its
+ * version marker followed by the unloaded table), or empty for the system symbol table.
+ * A record's length is -1 when the reader couldn't tell it (text containers aren't
+ * scanned to their end just to index them).
+ * The trailer goes last so the builder can stream records out as it reads them.
+ */
+#define ION_READER_INDEX_MAGIC          "\xE0ION"
+#define ION_READER_INDEX_MAGIC_LENGTH   4
+#define ION_READER_INDEX_VERSION        1
+#define ION_READER_INDEX_HEADER_SIZE    16
+#define ION_READER_INDEX_RECORD_SIZE    32
+#define ION_READER_INDEX_TRAILER_SIZE   32
+
+struct _ion_reader_index {
+    ION_READER        *_reader;
+    BOOL               _owns_reader;    // opened by ion_reader_index_open_path, along with _index_stream
+    ION_STREAM        *_index_stream;
+
+    BYTE              *_records;        // the first record slot
+    int64_t            _record_count;
+
+    int64_t            _context_count;
+    BYTE             **_contexts;       // start of each context's Ion binary
+    uint32_t          *_context_lengths;
+    ION_SYMBOL_TABLE **_context_symtabs;// each context's table once restored, allocated on the reader
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_READER_INDEX_IMPL_H
@@ -0,0 +1,669 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <ionc/ion_reader_split.h>
+#include "ion_reader_split_impl.h"
+#include "ion_reader_impl.h"
+#include "ion_stream_impl.h"
+#include "ion_symbol_table_impl.h"
+
+#ifdef ION_PLATFORM_WINDOWS
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// what the pre-scan found at the top level
+typedef enum _ion_reader_split_kind {
+    ION_READER_SPLIT_USER_VALUE,
+    ION_READER_SPLIT_SYSTEM_VALUE,  // a version marker or a local symbol table
+    ION_READER_SPLIT_PAD            // nop padding or a symbol 2, which readers skip
+} ION_READER_SPLIT_KIND;
+
+iERR _ion_reader_split_scan(ION_READER_SPLIT *split);
+iERR _ion_reader_split_scan_binary(ION_READER_SPLIT *split);
+iERR _ion_reader_split_skip_value(BYTE **p_pos, BYTE *end, ION_READER_SPLIT_KIND *p_kind);
+iERR _ion_reader_split_read_length(BYTE **p_pos, BYTE *end, int td, SIZE *p_length);
+iERR _ion_reader_split_add_value(ION_READER_SPLIT *split, BYTE *value, BYTE *value_end);
+iERR _ion_reader_split_seek_helper(ION_READER_SPLIT *split, ION_READER *preader, int64_t unit);
+void *_ion_reader_split_work(void *context);
+
+static inline iERR _ion_reader_split_read_var_uint(BYTE **p_pos, BYTE *end, SIZE *p_value)
+{
+    iENTER;
+    BYTE *pos   = *p_pos;
+    SIZE  value = 0;
+    int   b;
+
+    do {
+        if (pos >= end) FAILWITH(IERR_UNEXPECTED_EOF);
+        if (value > (MAX_SIZE >> 7)) FAILWITH(IERR_INVALID_BINARY);
+        b = *pos++;
+        value = (value << 7) | (b & 0x7F);
+    } while ((b & 0x80) == 0);
+
+    *p_pos   = pos;
+    *p_value = value;
+
+    iRETURN;
+}
+
+iERR ion_reader_split_open_buffer(hREADER_SPLIT *p_split, BYTE *buffer, SIZE buffer_length, SIZE unit_size,
+                                  ION_READER_OPTIONS *p_options)
+{
+    iENTER;
+    ION_READER_SPLIT *split = NULL;
+
+    if (!p_split)          FAILWITH(IERR_INVALID_ARG);
+    if (!buffer)           FAILWITH(IERR_INVALID_ARG);
+    if (buffer_length < 0) FAILWITH(IERR_INVALID_ARG);
+    if (unit_size < 0)     FAILWITH(IERR_INVALID_ARG);
+    // symbol tables have to be processed by the readers for the units to be right
+    if (p_options && p_options->return_system_values) FAILWITH(IERR_INVALID_ARG);
+
+    split = (ION_READER_SPLIT *)ion_alloc_owner_with_allocator(sizeof(ION_READER_SPLIT),
+                                                               p_options ? p_options->allocator : NULL);
+    if (!split) FAILWITH(IERR_NO_MEMORY);
+    memset(split, 0, sizeof(ION_READER_SPLIT));
+
+    split->_buffer    = buffer;
+    split->_length    = buffer_length;
+    split->_unit_size = unit_size ? unit_size : ION_READER_SPLIT_DEFAULT_UNIT_SIZE;
+    if (p_options) {
+        memcpy(&split->_options, p_options, sizeof(split->_options));
+    }
+
+    IONCHECK(_ion_reader_split_scan(split));
+
+    *p_split = split;
+    split = NULL;
+
+fail:
+    if (split) {
+        ion_reader_split_close(split);
+    }
+    return err;
+}
+
+iERR ion_reader_split_open_path(hREADER_SPLIT *p_split, const char *path, SIZE unit_size,
+                                ION_READER_OPTIONS *p_options)
+{
+    iENTER;
+    ION_STREAM   *stream = NULL;
+    hREADER_SPLIT split;
+
+    if (!p_split) FAILWITH(IERR_INVALID_ARG);
+    if (!path)    FAILWITH(IERR_INVALID_ARG);
+
+    // the pre-scan reads the file front to back, the threads then each read a part of it
+    IONCHECK(ion_stream_open_mmap_path(path, ION_STREAM_MMAP_ADVICE_SEQUENTIAL, &stream));
+    IONCHECK(ion_reader_split_open_buffer(&split, stream->_buffer, (SIZE)(stream->_limit - stream->_buffer),
+                                          unit_size, p_options));
+    split->_stream = stream;
+
+    *p_split = split;
+    return IERR_OK;
+
+fail:
+    if (stream) ion_stream_close(stream);
+    return err;
+}
+
+iERR _ion_reader_split_scan(ION_READER_SPLIT *split)
+{
+    iENTER;
+
+    ASSERT(split != NULL);
+
+    if (split->_length == 0) SUCCEED();
+
+    IONCHECK(_ion_reader_open_buffer_helper(&split->_scan_reader, split->_buffer, split->_length, &split->_options));
+    if (split->_scan_reader->type == ion_type_binary_reader) {
+        IONCHECK(_ion_reader_split_scan_binary(split));
+    }
+    else {
+        IONCHECK(_ion_reader_split_scan_text(split));
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_scan_binary(ION_READER_SPLIT *split)
+{
+    iENTER;
+    BYTE                 *pos, *end, *value, *system_start = NULL;
+    ION_READER_SPLIT_KIND kind;
+
+    ASSERT(split != NULL);
+
+    pos = split->_buffer;
+    end = split->_buffer + split->_length;
+    while (pos < end) {
+        value = pos;
+        IONCHECK(_ion_reader_split_skip_value(&pos, end, &kind));
+        switch (kind) {
+        case ION_READER_SPLIT_SYSTEM_VALUE:
+            // consecutive system values are loaded together, when the next user value shows up
+            if (!system_start) system_start = value;
+            break;
+        case ION_READER_SPLIT_USER_VALUE:
+            if (system_start) {
+                IONCHECK(_ion_reader_split_add_context(split, system_start, value));
+                system_start = NULL;
+            }
+            IONCHECK(_ion_reader_split_add_value(split, value, pos));
+            break;
+        case ION_READER_SPLIT_PAD:
+        default:
+            break;
+        }
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_skip_value(BYTE **p_pos, BYTE *end, ION_READER_SPLIT_KIND *p_kind)
+{
+    iENTER;
+    BYTE *pos = *p_pos, *content, *annotations;
+    int   td, tid;
+    SIZE  length, annotation_length, sid;
+
+    ASSERT(pos < end);
+
+    *p_kind = ION_READER_SPLIT_USER_VALUE;
+    td  = *pos++;
+    tid = getTypeCode(td);
+
+    if (td == ION_VERSION_MARKER[0]) {
+        if (end - pos < ION_VERSION_MARKER_LENGTH - 1
+            || memcmp(pos, ION_VERSION_MARKER + 1, ION_VERSION_MARKER_LENGTH - 1)
+        ) {
+            FAILWITH(IERR_INVALID_BINARY); // E0 is not a TID
+        }
+        *p_pos  = pos + ION_VERSION_MARKER_LENGTH - 1;
+        *p_kind = ION_READER_SPLIT_SYSTEM_VALUE;
+        SUCCEED();
+    }
+
+    IONCHECK(_ion_reader_split_read_length(&pos, end, td, &length));
+    if (length > end - pos) FAILWITH(IERR_UNEXPECTED_EOF);
+    content = pos;
+    *p_pos  = pos + length;
+
+    switch (tid) {
+    case TID_NULL:
+        if (getLowNibble(td) != ION_lnIsNull) {
+            *p_kind = ION_READER_SPLIT_PAD;
+        }
+        break;
+    case TID_SYMBOL:
+        // a top level symbol 2 is the same as no value at all
+        sid = 0;
+        for (pos = content; pos < *p_pos && sid <= ION_SYS_SID_IVM; pos++) {
+            sid = (sid << 8) | *pos;
+        }
+        if (getLowNibble(td) != ION_lnIsNull && sid == ION_SYS_SID_IVM) {
+            *p_kind = ION_READER_SPLIT_PAD;
+        }
+        break;
+    case TID_UTA:
+        // a struct whose first annotation is $ion_symbol_table is a local symbol table
+        pos = content;
+        IONCHECK(_ion_reader_split_read_var_uint(&pos, *p_pos, &annotation_length));
+        if (annotation_length < 1 || annotation_length >= *p_pos - pos) FAILWITH(IERR_INVALID_BINARY);
+        annotations = pos;
+        IONCHECK(_ion_reader_split_read_var_uint(&pos, annotations + annotation_length, &sid));
+        if (sid == ION_SYS_SID_SYMBOL_TABLE && getTypeCode(annotations[annotation_length]) == TID_STRUCT) {
+            *p_kind = ION_READER_SPLIT_SYSTEM_VALUE;
+        }
+        break;
+    default:
+        break;
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_read_length(BYTE **p_pos, BYTE *end, int td, SIZE *p_length)
+{
+    iENTER;
+    int tid = getTypeCode(td), ln = getLowNibble(td);
+
+    switch (tid) {
+    case TID_BOOL:
+        // the low nibble is the value
+        if (ln > ION_lnBooleanTrue && ln != ION_lnIsNull) FAILWITH(IERR_INVALID_BINARY);
+        *p_length = 0;
+        SUCCEED();
+    case TID_UTA:
+        if (ln < 3 || ln == ION_lnIsNull) FAILWITH(IERR_INVALID_BINARY);
+        break;
+    case TID_STRUCT:
+        if (ln == ION_lnIsOrderedStruct) {
+            IONCHECK(_ion_reader_split_read_var_uint(p_pos, end, p_length));
+            SUCCEED();
+        }
+        break;
+    case TID_UNUSED:
+        FAILWITH(IERR_INVALID_BINARY);
+    default:
+        break;
+    }
+
+    if (ln == ION_lnIsVarLen) {
+        IONCHECK(_ion_reader_split_read_var_uint(p_pos, end, p_length));
+    }
+    else {
+        *p_length = (ln == ION_lnIsNull) ? 0 : ln;
+    }
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_add_context(ION_READER_SPLIT *split, BYTE *start, BYTE *end)
+{
+    iENTER;
+    ION_READER           *preader;
+    ION_TYPE              type;
+    ION_SYMBOL_TABLE     *symtab, *system;
+    ION_SYMBOL_TABLE_TYPE symtab_type;
+
+    ASSERT(split != NULL);
+    ASSERT(split->_scan_reader != NULL);
+    ASSERT(start < end);
+
+    // the reader loads the tables on top of the ones before them, since
+    // a table may import (append to) the table it replaces
+    preader = split->_scan_reader;
+    IONCHECK(ion_reader_seek(PTR_TO_HANDLE(preader), (POSITION)(start - split->_buffer), (SIZE)(end - start)));
+    IONCHECK(_ion_reader_next_helper(preader, &type));
+    if (type != tid_EOF) {
+        FAILWITHMSG((preader->type == ion_type_binary_reader) ? IERR_INVALID_BINARY : IERR_INVALID_SYNTAX,
+                    "expected only system values");
+    }
+
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    IONCHECK(_ion_symbol_table_get_type_helper(preader->_current_symtab, &symtab_type));
+    if (symtab_type == ist_SYSTEM) {
+        symtab = system;
+    }
+    else {
+        // the reader recycles its table at the next one, and the threads
+        // read this copy concurrently, so it's immutable from here on
+        IONCHECK(_ion_symbol_table_clone_with_owner_helper(&symtab, preader->_current_symtab, split, system));
+        IONCHECK(_ion_symbol_table_freeze_helper(symtab));
+    }
+    IONCHECK(_ion_reader_split_push_context(split, symtab));
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_push_context(ION_READER_SPLIT *split, ION_SYMBOL_TABLE *symtab)
+{
+    iENTER;
+
+    ASSERT(split != NULL);
+    ASSERT(symtab != NULL);
+
+    // a version marker between two values without local symbols changes nothing
+    if (split->_context_count > 0 && split->_contexts[split->_context_count - 1] == symtab) SUCCEED();
+
+    if (split->_context_count == split->_context_capacity) {
+        IONCHECK(_ion_reader_split_grow(split, (void **)&split->_contexts, split->_context_count,
+                                        &split->_context_capacity, (SIZE)sizeof(ION_SYMBOL_TABLE *)));
+    }
+    split->_contexts[split->_context_count++] = symtab;
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_add_value(ION_READER_SPLIT *split, BYTE *value, BYTE *value_end)
+{
+    iENTER;
+    ION_READER_SPLIT_UNIT *unit = NULL;
+
+    ASSERT(split != NULL);
+    ASSERT(split->_context_count > 0); // binary Ion starts with a version marker
+
+    if (split->_unit_count > 0) {
+        unit = &split->_units[split->_unit_count - 1];
+        if (unit->context != split->_context_count - 1 || unit->length >= split->_unit_size) {
+            unit = NULL;
+        }
+    }
+    if (!unit) {
+        if (split->_unit_count == split->_unit_capacity) {
+            IONCHECK(_ion_reader_split_grow(split, (void **)&split->_units, split->_unit_count,
+                                            &split->_unit_capacity, (SIZE)sizeof(ION_READER_SPLIT_UNIT)));
+        }
+        unit = &split->_units[split->_unit_count++];
+        unit->offset      = (POSITION)(value - split->_buffer);
+        unit->first_value = split->_value_count;
+        unit->value_count = 0;
+        unit->context     = (int32_t)(split->_context_count - 1);
+    }
+
+    // padding between the unit's values is part of the unit, the readers skip it
+    unit->length = (SIZE)((value_end - split->_buffer) - unit->offset);
+    unit->value_count++;
+    split->_value_count++;
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_add_unit(ION_READER_SPLIT *split, BYTE *start, BYTE *end)
+{
+    iENTER;
+    ION_READER_SPLIT_UNIT *unit;
+
+    ASSERT(split != NULL);
+    ASSERT(split->_context_count > 0);
+    ASSERT(start < end);
+
+    if (split->_unit_count == split->_unit_capacity) {
+        IONCHECK(_ion_reader_split_grow(split, (void **)&split->_units, split->_unit_count,
+                                        &split->_unit_capacity, (SIZE)sizeof(ION_READER_SPLIT_UNIT)));
+    }
+    unit = &split->_units[split->_unit_count++];
+    unit->offset      = (POSITION)(start - split->_buffer);
+    unit->length      = (SIZE)(end - start);
+    unit->first_value = -1; // the text pre-scan doesn't find scalars, so it can't count values
+    unit->value_count = -1;
+    unit->context     = (int32_t)(split->_context_count - 1);
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_grow(void *owner, void **p_array, int64_t count, int64_t *p_capacity, SIZE element_size)
+{
+    iENTER;
+    int64_t capacity;
+    void   *array;
+
+    capacity = (*p_capacity < ION_READER_SPLIT_MIN_CAPACITY) ? ION_READER_SPLIT_MIN_CAPACITY : *p_capacity * 2;
+    if (capacity * element_size > MAX_SIZE) FAILWITH(IERR_NO_MEMORY);
+
+    // the old array stays on the owner until it's freed, doubling keeps that to as much again
+    array = ion_alloc_with_owner(owner, (SIZE)(capacity * element_size));
+    if (!array) FAILWITH(IERR_NO_MEMORY);
+    if (count > 0) {
+        memcpy(array, *p_array, (size_t)(count * element_size));
+    }
+    *p_array    = array;
+    *p_capacity = capacity;
+
+    iRETURN;
+}
+
+iERR ion_reader_split_get_unit_count(hREADER_SPLIT split, int64_t *p_count)
+{
+    iENTER;
+
+    if (!split)   FAILWITH(IERR_INVALID_ARG);
+    if (!p_count) FAILWITH(IERR_INVALID_ARG);
+
+    *p_count = split->_unit_count;
+
+    iRETURN;
+}
+
+iERR ion_reader_split_get_unit(hREADER_SPLIT split, int64_t unit, POSITION *p_offset, SIZE *p_length,
+                               int64_t *p_first_value, int64_t *p_value_count)
+{
+    iENTER;
+    ION_READER_SPLIT_UNIT *punit;
+
+    if (!split) FAILWITH(IERR_INVALID_ARG);
+    if (unit < 0 || unit >= split->_unit_count) FAILWITH(IERR_INVALID_ARG);
+
+    punit = &split->_units[unit];
+    if (p_offset)      *p_offset      = punit->offset;
+    if (p_length)      *p_length      = punit->length;
+    if (p_first_value) *p_first_value = punit->first_value;
+    if (p_value_count) *p_value_count = punit->value_count;
+
+    iRETURN;
+}
+
+iERR ion_reader_split_open_reader(hREADER_SPLIT split, hREADER *p_reader)
+{
+    iENTER;
+    ION_READER *preader = NULL;
+
+    if (!split)    FAILWITH(IERR_INVALID_ARG);
+    if (!p_reader) FAILWITH(IERR_INVALID_ARG);
+    if (split->_length == 0) FAILWITH(IERR_INVALID_STATE);
+
+    IONCHECK(_ion_reader_open_buffer_helper(&preader, split->_buffer, split->_length, &split->_options));
+    *p_reader = PTR_TO_HANDLE(preader);
+
+    iRETURN;
+}
+
+iERR ion_reader_split_seek_unit(hREADER_SPLIT split, hREADER hreader, int64_t unit)
+{
+    iENTER;
+
+    if (!split)   FAILWITH(IERR_INVALID_ARG);
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    if (unit < 0 || unit >= split->_unit_count) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_split_seek_helper(split, HANDLE_TO_PTR(hreader, ION_READER), unit));
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_seek_helper(ION_READER_SPLIT *split, ION_READER *preader, int64_t unit)
+{
+    iENTER;
+    ION_READER_SPLIT_UNIT *punit;
+    ION_SYMBOL_TABLE      *symtab;
+
+    ASSERT(split != NULL);
+    ASSERT(preader != NULL);
+
+    punit  = &split->_units[unit];
+    symtab = split->_contexts[punit->context];
+    if (preader->_current_symtab != symtab) {
+        // frozen, so the reader uses it in place rather than copying it (units hold
+        // no symbol tables, so the reader won't try to replace it either)
+        preader->_current_symtab = symtab;
+        _ion_reader_symbol_table_changed(preader);
+    }
+    IONCHECK(ion_reader_seek(PTR_TO_HANDLE(preader), punit->offset, punit->length));
+
+    iRETURN;
+}
+
+iERR ion_reader_split_run(hREADER_SPLIT split, int thread_count, ION_READER_SPLIT_FN fn, void *user_context)
+{
+    iENTER;
+    ION_READER_SPLIT_RUN run;
+
+    if (!split) FAILWITH(IERR_INVALID_ARG);
+    if (!fn)    FAILWITH(IERR_INVALID_ARG);
+    if (split->_unit_count > INT32_MAX) FAILWITH(IERR_NUMERIC_OVERFLOW);
+    if (split->_unit_count == 0) SUCCEED();
+
+    memset(&run, 0, sizeof(run));
+    run.split        = split;
+    run.fn           = fn;
+    run.user_context = user_context;
+
+    if (thread_count <= 0) {
+        thread_count = _ion_reader_split_processor_count();
+    }
+    if (thread_count > split->_unit_count) {
+        thread_count = (int)split->_unit_count;
+    }
+
+    IONCHECK(_ion_reader_split_spawn(thread_count, _ion_reader_split_work, &run));
+    err = (iERR)ION_ATOMIC_LOAD(&run.err);
+
+    iRETURN;
+}
+
+void *_ion_reader_split_work(void *context)
+{
+    iENTER;
+    ION_READER_SPLIT_RUN *run = (ION_READER_SPLIT_RUN *)context;
+    ION_READER           *preader = NULL;
+    int32_t               unit;
+
+    ASSERT(run != NULL);
+
+    IONCHECK(_ion_reader_open_buffer_helper(&preader, run->split->_buffer, run->split->_length,
+                                            &run->split->_options));
+    while (ION_ATOMIC_LOAD(&run->err) == IERR_OK) {
+        unit = _ion_reader_split_claim(&run->next_unit);
+        if (unit >= run->split->_unit_count) break;
+
+        IONCHECK(_ion_reader_split_seek_helper(run->split, preader, unit));
+        IONCHECK(run->fn(PTR_TO_HANDLE(preader), unit, run->user_context));
+    }
+
+fail:
+    if (err != IERR_OK) {
+        // only the first error is kept
+        (void)ION_ATOMIC_CAS(&run->err, IERR_OK, err);
+    }
+    if (preader) {
+        ion_reader_close(PTR_TO_HANDLE(preader));
+    }
+    return NULL;
+}
+
+#ifdef ION_PLATFORM_WINDOWS
+
+// _beginthreadex wants a __stdcall entry point returning unsigned
+typedef struct _ion_reader_split_thread_start {
+    void *(*entry)(void *);
+    void   *context;
+} ION_READER_SPLIT_THREAD_START;
+
+static unsigned __stdcall _ion_reader_split_thread_main(void *start)
+{
+    ION_READER_SPLIT_THREAD_START *thread_start = (ION_READER_SPLIT_THREAD_START *)start;
+
+    (void)thread_start->entry(thread_start->context);
+    return 0;
+}
+
+#endif
+
+iERR _ion_reader_split_spawn(int thread_count, void *(*entry)(void *), void *context)
+{
+    iENTER;
+#ifdef ION_PLATFORM_WINDOWS
+    ION_READER_SPLIT_THREAD_START start;
+    HANDLE    *threads = NULL;
+    uintptr_t  thread;
+    int        started = 0, waited, ii;
+
+    start.entry   = entry;
+    start.context = context;
+    if (thread_count > 1) {
+        threads = (HANDLE *)ion_alloc_owner((SIZE)((thread_count - 1) * sizeof(HANDLE)));
+        if (!threads) FAILWITH(IERR_NO_MEMORY);
+        // a thread that can't be started just means more work for the others
+        for (ii = 0; ii < thread_count - 1; ii++) {
+            thread = _beginthreadex(NULL, 0, _ion_reader_split_thread_main, &start, 0, NULL);
+            if (thread != 0) {
+                threads[started++] = (HANDLE)thread;
+            }
+        }
+    }
+#else
+    pthread_t *threads = NULL;
+    int        started = 0, ii;
+
+    if (thread_count > 1) {
+        threads = (pthread_t *)ion_alloc_owner((SIZE)((thread_count - 1) * sizeof(pthread_t)));
+        if (!threads) FAILWITH(IERR_NO_MEMORY);
+        // a thread that can't be started just means more work for the others
+        for (ii = 0; ii < thread_count - 1; ii++) {
+            if (pthread_create(&threads[started], NULL, entry, context) == 0) {
+                started++;
+            }
+        }
+    }
+#endif
+
+    // the calling thread is one of the workers
+    (void)entry(context);
+
+#ifdef ION_PLATFORM_WINDOWS
+    // a single wait takes at most MAXIMUM_WAIT_OBJECTS handles
+    for (ii = 0; ii < started; ii += waited) {
+        waited = (started - ii < MAXIMUM_WAIT_OBJECTS) ? started - ii : MAXIMUM_WAIT_OBJECTS;
+        (void)WaitForMultipleObjects((DWORD)waited, &threads[ii], TRUE, INFINITE);
+    }
+    for (ii = 0; ii < started; ii++) {
+        CloseHandle(threads[ii]);
+    }
+#else
+    for (ii = 0; ii < started; ii++) {
+        pthread_join(threads[ii], NULL);
+    }
+#endif
+    if (threads) {
+        ion_free_owner(threads);
+    }
+
+    iRETURN;
+}
+
+int32_t _ion_reader_split_claim(ION_ATOMIC_INT *p_next)
+{
+    int32_t next;
+
+    do {
+        next = ION_ATOMIC_LOAD(p_next);
+    } while (!ION_ATOMIC_CAS(p_next, next, next + 1));
+
+    return next;
+}
+
+int _ion_reader_split_processor_count(void)
+{
+#ifdef ION_PLATFORM_WINDOWS
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors < 1) ? 1 : (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count < 1) ? 1 : (int)count;
+#endif
+}
+
+iERR ion_reader_split_close(hREADER_SPLIT split)
+{
+    iENTER;
+
+    if (!split) FAILWITH(IERR_INVALID_ARG);
+
+    if (split->_scan_reader) {
+        UPDATEERROR(ion_reader_close(PTR_TO_HANDLE(split->_scan_reader)));
+    }
+    if (split->_stream) {
+        UPDATEERROR(ion_stream_close(split->_stream));
+    }
+    ion_free_owner(split);
+
+    iRETURN;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#ifndef ION_READER_SPLIT_IMPL_H
+#define ION_READER_SPLIT_IMPL_H
+
+#include "ion_internal.h"
+#include "ion_atomic.h"
+#include <ionc/ion_reader_split.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ION_READER_SPLIT_DEFAULT_UNIT_SIZE  (256 * 1024)
+#define ION_READER_SPLIT_MIN_CAPACITY       16
+#define ION_READER_SPLIT_TEXT_CHUNK_SIZE    (1024 * 1024)   // what one thread lexes at a time in the text pre-scan
+
+typedef struct _ion_reader_split_unit {
+    POSITION  offset;       // of the unit's first value
+    SIZE      length;       // up to the end of its last value
+    int64_t   first_value;
+    int64_t   value_count;
+    int32_t   context;      // the symbol table the unit's values were written with
+} ION_READER_SPLIT_UNIT;
+
+struct _ion_reader_split {
+    BYTE                  *_buffer;
+    SIZE                   _length;
+    ION_STREAM            *_stream;         // the mapping, when opened by ion_reader_split_open_path
+    ION_READER_OPTIONS     _options;        // every reader over the buffer is opened with these
+    ION_READER            *_scan_reader;    // loads the symbol tables the pre-scan finds, in order
+    SIZE                   _unit_size;
+
+    ION_READER_SPLIT_UNIT *_units;
+    int64_t                _unit_count;
+    int64_t                _unit_capacity;
+    int64_t                _value_count;
+
+    ION_SYMBOL_TABLE     **_contexts;       // frozen copies allocated on the split, or the system table
+    int64_t                _context_count;
+    int64_t                _context_capacity;
+};
+
+/**
+ * The state the threads of one ion_reader_split_run share.
+ */
+typedef struct _ion_reader_split_run {
+    ION_READER_SPLIT      *split;
+    ION_READER_SPLIT_FN    fn;
+    void                  *user_context;
+    ION_ATOMIC_INT         next_unit;
+    ION_ATOMIC_INT         err;             // the first error, which stops every thread
+} ION_READER_SPLIT_RUN;
+
+iERR    _ion_reader_split_scan_text(ION_READER_SPLIT *split);
+iERR    _ion_reader_split_add_context(ION_READER_SPLIT *split, BYTE *start, BYTE *end);
+iERR    _ion_reader_split_push_context(ION_READER_SPLIT *split, ION_SYMBOL_TABLE *symtab);
+iERR    _ion_reader_split_add_unit(ION_READER_SPLIT *split, BYTE *start, BYTE *end);
+iERR    _ion_reader_split_grow(void *owner, void **p_array, int64_t count, int64_t *p_capacity, SIZE element_size);
+iERR    _ion_reader_split_spawn(int thread_count, void *(*entry)(void *), void *context);
+int32_t _ion_reader_split_claim(ION_ATOMIC_INT *p_next);
+int     _ion_reader_split_processor_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ION_READER_SPLIT_IMPL_H
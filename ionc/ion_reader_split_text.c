@@ -0,0 +1,572 @@
+/*
+ * Copyright 2012-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+//
+// The text pre-scan. Where a value ends in text depends on everything before it, since a bracket or a quote
+// means something else inside a string or a comment. So the buffer is cut into chunks at line ends, and each chunk
+// is lexed in parallel once for every state a line can end in: outside of anything, in a long string, in a block
+// comment or in a blob. The chunks' actual starting states are then chained together from the front, which is cheap,
+// and the chunks that didn't start outside of anything are lexed again in that state. The lexer only follows quotes,
+// comments and brackets, and notes where top-level containers end and where system values start. Those are the
+// places the buffer is split at.
+//
+
+#include <ionc/ion_reader_split.h>
+#include "ion_reader_split_impl.h"
+#include "ion_reader_impl.h"
+
+// the state of the lexer between two bytes. The first ION_READER_SPLIT_TEXT_HYPOTHESES are
+// the states a line can end in (a short string can't have a new line in it, and a comment
+// that starts with // ends at one), so they're the only ones a chunk can start in
+typedef enum _ion_reader_split_text_mode {
+    ION_READER_SPLIT_TEXT_CODE,
+    ION_READER_SPLIT_TEXT_LONG_STRING,
+    ION_READER_SPLIT_TEXT_BLOCK_COMMENT,
+    ION_READER_SPLIT_TEXT_LOB,
+    ION_READER_SPLIT_TEXT_STRING,
+    ION_READER_SPLIT_TEXT_SYMBOL,
+    ION_READER_SPLIT_TEXT_LINE_COMMENT
+} ION_READER_SPLIT_TEXT_MODE;
+
+#define ION_READER_SPLIT_TEXT_HYPOTHESES    4
+
+typedef enum _ion_reader_split_text_event_kind {
+    ION_READER_SPLIT_TEXT_CLOSE,            // the end of a container or a lob
+    ION_READER_SPLIT_TEXT_SYMBOL_TABLE,     // the start of a local symbol table
+    ION_READER_SPLIT_TEXT_VERSION_MARKER
+} ION_READER_SPLIT_TEXT_EVENT_KIND;
+
+typedef struct _ion_reader_split_text_event {
+    BYTE    *start;
+    BYTE    *end;
+    int64_t  depth;     // relative to the chunk's start, only events at 0 or less are kept
+    int32_t  kind;
+} ION_READER_SPLIT_TEXT_EVENT;
+
+typedef struct _ion_reader_split_text_chunk {
+    BYTE                        *start;
+    BYTE                        *end;           // just after a new line, except for the last chunk
+
+    // what lexing the chunk leads to, for each state it might start in
+    int32_t                      end_mode[ION_READER_SPLIT_TEXT_HYPOTHESES];
+    int64_t                      depth[ION_READER_SPLIT_TEXT_HYPOTHESES];
+    int64_t                      min_depth[ION_READER_SPLIT_TEXT_HYPOTHESES];
+
+    int32_t                      entry_mode;    // the state it actually starts in, once that's known
+    int64_t                      entry_depth;
+
+    ION_READER_SPLIT_TEXT_EVENT *events;        // for entry_mode, allocated on the chunk
+    int64_t                      event_count;
+    int64_t                      event_capacity;
+} ION_READER_SPLIT_TEXT_CHUNK;
+
+/**
+ * The state the threads lexing the chunks share.
+ */
+typedef struct _ion_reader_split_text_run {
+    ION_READER_SPLIT            *split;
+    ION_READER_SPLIT_TEXT_CHUNK **chunks;
+    int32_t                      chunk_count;
+    BOOL                         speculate;     // the first pass, when the entry modes aren't known yet
+    ION_ATOMIC_INT               next_chunk;
+    ION_ATOMIC_INT               err;
+} ION_READER_SPLIT_TEXT_RUN;
+
+iERR  _ion_reader_split_text_open_chunks(ION_READER_SPLIT *split, ION_READER_SPLIT_TEXT_RUN *run);
+void *_ion_reader_split_text_work(void *context);
+iERR  _ion_reader_split_text_lex(ION_READER_SPLIT_TEXT_RUN *run, ION_READER_SPLIT_TEXT_CHUNK *chunk, int32_t mode,
+                                 BOOL record);
+iERR  _ion_reader_split_text_add_event(ION_READER_SPLIT_TEXT_CHUNK *chunk, int32_t kind, BYTE *start, BYTE *end,
+                                       int64_t depth);
+iERR  _ion_reader_split_text_resolve(ION_READER_SPLIT_TEXT_RUN *run, int32_t *p_relex_count);
+iERR  _ion_reader_split_text_merge(ION_READER_SPLIT *split, ION_READER_SPLIT_TEXT_RUN *run);
+BOOL  _ion_reader_split_text_is_system_symbol(BYTE *pos, BYTE *buffer, BYTE *limit, BOOL quoted, int32_t *p_kind,
+                                              BYTE **p_end);
+
+static inline BOOL _ion_reader_split_text_is_space(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline BOOL _ion_reader_split_text_is_identifier(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
+
+iERR _ion_reader_split_scan_text(ION_READER_SPLIT *split)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_RUN run;
+    ION_SYMBOL_TABLE         *system;
+    int32_t                   relex_count, ii;
+    int                       thread_count;
+
+    ASSERT(split != NULL);
+
+    memset(&run, 0, sizeof(run));
+    run.split = split;
+
+    // text doesn't have to start with a version marker
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    IONCHECK(_ion_reader_split_push_context(split, system));
+
+    IONCHECK(_ion_reader_split_text_open_chunks(split, &run));
+    thread_count = _ion_reader_split_processor_count();
+    if (thread_count > run.chunk_count) {
+        thread_count = run.chunk_count;
+    }
+
+    run.speculate = TRUE;
+    IONCHECK(_ion_reader_split_spawn(thread_count, _ion_reader_split_text_work, &run));
+    IONCHECK((iERR)ION_ATOMIC_LOAD(&run.err));
+
+    IONCHECK(_ion_reader_split_text_resolve(&run, &relex_count));
+    if (relex_count > 0) {
+        run.speculate = FALSE;
+        ION_ATOMIC_STORE(&run.next_chunk, 0);
+        IONCHECK(_ion_reader_split_spawn((thread_count < relex_count) ? thread_count : relex_count,
+                                         _ion_reader_split_text_work, &run));
+        IONCHECK((iERR)ION_ATOMIC_LOAD(&run.err));
+    }
+
+    IONCHECK(_ion_reader_split_text_merge(split, &run));
+
+fail:
+    for (ii = 0; ii < run.chunk_count; ii++) {
+        if (run.chunks[ii]) ion_free_owner(run.chunks[ii]);
+    }
+    if (run.chunks) {
+        ion_free_owner(run.chunks);
+    }
+    return err;
+}
+
+iERR _ion_reader_split_text_open_chunks(ION_READER_SPLIT *split, ION_READER_SPLIT_TEXT_RUN *run)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_CHUNK *chunk;
+    BYTE                        *start, *pos, *end, *escape;
+    SIZE                         count;
+    int32_t                      ii;
+
+    ASSERT(split != NULL);
+    ASSERT(run != NULL);
+
+    end   = split->_buffer + split->_length;
+    count = split->_length / ION_READER_SPLIT_TEXT_CHUNK_SIZE + 1;
+    if (count > INT32_MAX) FAILWITH(IERR_NUMERIC_OVERFLOW);
+
+    run->chunks = (ION_READER_SPLIT_TEXT_CHUNK **)ion_alloc_owner((SIZE)(count * sizeof(ION_READER_SPLIT_TEXT_CHUNK *)));
+    if (!run->chunks) FAILWITH(IERR_NO_MEMORY);
+
+    start = split->_buffer;
+    for (ii = 0; ii < count && start < end; ii++) {
+        // every chunk is an owner, so the threads each allocate their events on their own
+        chunk = (ION_READER_SPLIT_TEXT_CHUNK *)ion_alloc_owner(sizeof(ION_READER_SPLIT_TEXT_CHUNK));
+        if (!chunk) FAILWITH(IERR_NO_MEMORY);
+        memset(chunk, 0, sizeof(ION_READER_SPLIT_TEXT_CHUNK));
+        run->chunks[run->chunk_count++] = chunk;
+
+        // a chunk ends at a new line, one that isn't escaped, so that it can't end in a short string
+        // or in an escape sequence. a line continuation is a backslash before either \n or \r\n
+        pos = (end - start > ION_READER_SPLIT_TEXT_CHUNK_SIZE) ? start + ION_READER_SPLIT_TEXT_CHUNK_SIZE : end;
+        while (pos < end) {
+            if (pos[-1] == '\n') {
+                escape = pos - 2;
+                if (escape >= start && *escape == '\r') escape--;
+                if (escape < start || *escape != '\\') break;
+            }
+            pos++;
+        }
+        chunk->start = start;
+        chunk->end   = pos;
+        start = pos;
+    }
+
+    iRETURN;
+}
+
+void *_ion_reader_split_text_work(void *context)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_RUN   *run = (ION_READER_SPLIT_TEXT_RUN *)context;
+    ION_READER_SPLIT_TEXT_CHUNK *chunk;
+    int32_t                      ii, mode;
+
+    ASSERT(run != NULL);
+
+    while (ION_ATOMIC_LOAD(&run->err) == IERR_OK) {
+        ii = _ion_reader_split_claim(&run->next_chunk);
+        if (ii >= run->chunk_count) break;
+
+        chunk = run->chunks[ii];
+        if (run->speculate) {
+            // only the events of the most likely start are kept, the others are redone if need be
+            for (mode = 0; mode < ION_READER_SPLIT_TEXT_HYPOTHESES; mode++) {
+                IONCHECK(_ion_reader_split_text_lex(run, chunk, mode, mode == ION_READER_SPLIT_TEXT_CODE));
+            }
+        }
+        else if (chunk->entry_mode != ION_READER_SPLIT_TEXT_CODE) {
+            chunk->event_count = 0;
+            IONCHECK(_ion_reader_split_text_lex(run, chunk, chunk->entry_mode, TRUE));
+        }
+    }
+
+fail:
+    if (err != IERR_OK) {
+        (void)ION_ATOMIC_CAS(&run->err, IERR_OK, err);
+    }
+    return NULL;
+}
+
+iERR _ion_reader_split_text_lex(ION_READER_SPLIT_TEXT_RUN *run, ION_READER_SPLIT_TEXT_CHUNK *chunk, int32_t mode,
+                                BOOL record)
+{
+    iENTER;
+    BYTE    *buffer, *limit, *pos, *end, *system_end, *next;
+    int32_t  hypothesis = mode, kind;
+    int64_t  depth = 0, min_depth = 0;
+
+    ASSERT(run != NULL);
+    ASSERT(chunk != NULL);
+    ASSERT(mode < ION_READER_SPLIT_TEXT_HYPOTHESES);
+
+    // lookahead may go past the chunk, but not past the buffer
+    buffer = run->split->_buffer;
+    limit  = buffer + run->split->_length;
+    pos    = chunk->start;
+    end    = chunk->end;
+
+    while (pos < end) {
+        switch (mode) {
+        case ION_READER_SPLIT_TEXT_CODE:
+            switch (*pos) {
+            case '"':
+                mode = ION_READER_SPLIT_TEXT_STRING;
+                pos++;
+                break;
+            case '\'':
+                if (limit - pos >= 3 && pos[1] == '\'' && pos[2] == '\'') {
+                    mode = ION_READER_SPLIT_TEXT_LONG_STRING;
+                    pos += 3;
+                    break;
+                }
+                if (record && depth <= 0
+                    && _ion_reader_split_text_is_system_symbol(pos, buffer, limit, TRUE, &kind, &system_end)
+                ) {
+                    IONCHECK(_ion_reader_split_text_add_event(chunk, kind, pos, system_end, depth));
+                }
+                mode = ION_READER_SPLIT_TEXT_SYMBOL;
+                pos++;
+                break;
+            case '/':
+                if (limit - pos >= 2 && pos[1] == '/') {
+                    mode = ION_READER_SPLIT_TEXT_LINE_COMMENT;
+                    pos += 2;
+                }
+                else if (limit - pos >= 2 && pos[1] == '*') {
+                    mode = ION_READER_SPLIT_TEXT_BLOCK_COMMENT;
+                    pos += 2;
+                }
+                else {
+                    pos++;
+                }
+                break;
+            case '{':
+                if (limit - pos >= 2 && pos[1] == '{') {
+                    // a blob can have // in it, a clob is strings and gets lexed as usual
+                    for (next = pos + 2; next < limit && _ion_reader_split_text_is_space(*next); next++);
+                    if (next >= limit || (*next != '"' && *next != '\'')) {
+                        mode = ION_READER_SPLIT_TEXT_LOB;
+                        pos += 2;
+                        break;
+                    }
+                }
+                // fall through
+            case '[':
+            case '(':
+                depth++;
+                pos++;
+                break;
+            case '}':
+            case ']':
+            case ')':
+                depth--;
+                pos++;
+                if (depth < min_depth) min_depth = depth;
+                if (record && depth <= 0) {
+                    IONCHECK(_ion_reader_split_text_add_event(chunk, ION_READER_SPLIT_TEXT_CLOSE, pos, pos, depth));
+                }
+                break;
+            case '$':
+                if (record && depth <= 0
+                    && _ion_reader_split_text_is_system_symbol(pos, buffer, limit, FALSE, &kind, &system_end)
+                ) {
+                    IONCHECK(_ion_reader_split_text_add_event(chunk, kind, pos, system_end, depth));
+                }
+                pos++;
+                break;
+            default:
+                pos++;
+                break;
+            }
+            break;
+        case ION_READER_SPLIT_TEXT_STRING:
+        case ION_READER_SPLIT_TEXT_SYMBOL:
+            if (*pos == '\\') {
+                pos += 2;
+            }
+            else if (*pos == ((mode == ION_READER_SPLIT_TEXT_STRING) ? '"' : '\'')) {
+                mode = ION_READER_SPLIT_TEXT_CODE;
+                pos++;
+            }
+            else {
+                pos++;
+            }
+            break;
+        case ION_READER_SPLIT_TEXT_LONG_STRING:
+            if (*pos == '\\') {
+                pos += 2;
+            }
+            else if (*pos == '\'' && limit - pos >= 3 && pos[1] == '\'' && pos[2] == '\'') {
+                mode = ION_READER_SPLIT_TEXT_CODE;
+                pos += 3;
+            }
+            else {
+                pos++;
+            }
+            break;
+        case ION_READER_SPLIT_TEXT_LINE_COMMENT:
+            if (*pos == '\n' || *pos == '\r') {
+                mode = ION_READER_SPLIT_TEXT_CODE;
+            }
+            pos++;
+            break;
+        case ION_READER_SPLIT_TEXT_BLOCK_COMMENT:
+            if (*pos == '*' && limit - pos >= 2 && pos[1] == '/') {
+                mode = ION_READER_SPLIT_TEXT_CODE;
+                pos += 2;
+            }
+            else {
+                pos++;
+            }
+            break;
+        case ION_READER_SPLIT_TEXT_LOB:
+            if (*pos == '}' && limit - pos >= 2 && pos[1] == '}') {
+                mode = ION_READER_SPLIT_TEXT_CODE;
+                pos += 2;
+                if (record && depth <= 0) {
+                    IONCHECK(_ion_reader_split_text_add_event(chunk, ION_READER_SPLIT_TEXT_CLOSE, pos, pos, depth));
+                }
+            }
+            else {
+                pos++;
+            }
+            break;
+        default:
+            FAILWITH(IERR_PARSER_INTERNAL);
+        }
+    }
+
+    chunk->end_mode[hypothesis]  = mode;
+    chunk->depth[hypothesis]     = depth;
+    chunk->min_depth[hypothesis] = min_depth;
+
+    iRETURN;
+}
+
+BOOL _ion_reader_split_text_is_system_symbol(BYTE *pos, BYTE *buffer, BYTE *limit, BOOL quoted, int32_t *p_kind,
+                                             BYTE **p_end)
+{
+    static const char symbol_table[] = "$ion_symbol_table";
+    static const char version_marker[] = "$ion_1_0";
+    BYTE  *name = quoted ? pos + 1 : pos, *next, *before;
+    SIZE   length;
+    BOOL   annotation;
+
+    // not part of a longer identifier
+    if (!quoted && pos > buffer && _ion_reader_split_text_is_identifier(pos[-1])) return FALSE;
+
+    length = (SIZE)(sizeof(symbol_table) - 1);
+    if (limit - name >= length && !memcmp(name, symbol_table, (size_t)length)) {
+        *p_kind = ION_READER_SPLIT_TEXT_SYMBOL_TABLE;
+    }
+    else if (!quoted && limit - name >= 2 && name[0] == '$' && name[1] == '0' + ION_SYS_SID_SYMBOL_TABLE) {
+        length = 2;
+        *p_kind = ION_READER_SPLIT_TEXT_SYMBOL_TABLE;
+    }
+    else if (!quoted && limit - name >= (SIZE)(sizeof(version_marker) - 1)
+             && !memcmp(name, version_marker, sizeof(version_marker) - 1)
+    ) {
+        // a quoted version marker is just a symbol
+        length = (SIZE)(sizeof(version_marker) - 1);
+        *p_kind = ION_READER_SPLIT_TEXT_VERSION_MARKER;
+    }
+    else {
+        return FALSE;
+    }
+
+    next = name + length;
+    if (quoted) {
+        if (next >= limit || *next != '\'') return FALSE;
+        next++;
+    }
+    else if (next < limit && _ion_reader_split_text_is_identifier(*next)) {
+        return FALSE;
+    }
+    *p_end = next;
+
+    // it has to be a top-level value, or the first annotation of one, so not an annotation after another
+    for (before = pos - 1; before >= buffer && _ion_reader_split_text_is_space(*before); before--);
+    if (before >= buffer && *before == ':') return FALSE;
+
+    while (next < limit && _ion_reader_split_text_is_space(*next)) next++;
+    annotation = (limit - next >= 2 && next[0] == ':' && next[1] == ':');
+    if (*p_kind == ION_READER_SPLIT_TEXT_VERSION_MARKER) {
+        return !annotation;
+    }
+
+    // and a symbol table is a struct
+    if (!annotation) return FALSE;
+    for (next += 2; next < limit && _ion_reader_split_text_is_space(*next); next++);
+    return next < limit && *next == '{';
+}
+
+iERR _ion_reader_split_text_add_event(ION_READER_SPLIT_TEXT_CHUNK *chunk, int32_t kind, BYTE *start, BYTE *end,
+                                      int64_t depth)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_EVENT *event;
+
+    if (chunk->event_count == chunk->event_capacity) {
+        IONCHECK(_ion_reader_split_grow(chunk, (void **)&chunk->events, chunk->event_count, &chunk->event_capacity,
+                                        (SIZE)sizeof(ION_READER_SPLIT_TEXT_EVENT)));
+    }
+    event = &chunk->events[chunk->event_count++];
+    event->start = start;
+    event->end   = end;
+    event->depth = depth;
+    event->kind  = kind;
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_text_resolve(ION_READER_SPLIT_TEXT_RUN *run, int32_t *p_relex_count)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_CHUNK *chunk;
+    int32_t                      ii, mode = ION_READER_SPLIT_TEXT_CODE, relex_count = 0;
+    int64_t                      depth = 0;
+
+    ASSERT(run != NULL);
+
+    // each chunk starts in the state the one before it ended in
+    for (ii = 0; ii < run->chunk_count; ii++) {
+        chunk = run->chunks[ii];
+        if (mode >= ION_READER_SPLIT_TEXT_HYPOTHESES) FAILWITH(IERR_NEW_LINE_IN_STRING);
+        if (depth + chunk->min_depth[mode] < 0) FAILWITH(IERR_INVALID_SYNTAX); // closes more than it opened
+
+        chunk->entry_mode  = mode;
+        chunk->entry_depth = depth;
+        if (mode != ION_READER_SPLIT_TEXT_CODE) relex_count++;
+
+        depth += chunk->depth[mode];
+        mode   = chunk->end_mode[mode];
+    }
+    if (depth != 0 || (mode != ION_READER_SPLIT_TEXT_CODE && mode != ION_READER_SPLIT_TEXT_LINE_COMMENT)) {
+        FAILWITH(IERR_UNEXPECTED_EOF);
+    }
+
+    *p_relex_count = relex_count;
+
+    iRETURN;
+}
+
+iERR _ion_reader_split_text_merge(ION_READER_SPLIT *split, ION_READER_SPLIT_TEXT_RUN *run)
+{
+    iENTER;
+    ION_READER_SPLIT_TEXT_CHUNK *chunk;
+    ION_READER_SPLIT_TEXT_EVENT *event;
+    BYTE                        *cursor, *pos, *end, *system_start = NULL, *system_end = NULL;
+    BOOL                         in_symbol_table = FALSE, has_values;
+    int32_t                      ii;
+    int64_t                      jj;
+
+    ASSERT(split != NULL);
+    ASSERT(run != NULL);
+
+    // the units run from one place the buffer can be split at to the next, a top-level container's end
+    // that's at least unit_size past the unit's start, or a system value. Consecutive system values
+    // are loaded together, when the next values show up.
+    cursor = split->_buffer;
+    end    = split->_buffer + split->_length;
+    for (ii = 0; ii < run->chunk_count; ii++) {
+        chunk = run->chunks[ii];
+        for (jj = 0; jj < chunk->event_count; jj++) {
+            event = &chunk->events[jj];
+            if (chunk->entry_depth + event->depth != 0) continue;
+
+            switch (event->kind) {
+            case ION_READER_SPLIT_TEXT_CLOSE:
+                if (in_symbol_table) {
+                    system_end = event->end;
+                    cursor = event->end;
+                    in_symbol_table = FALSE;
+                    break;
+                }
+                if (system_start) {
+                    IONCHECK(_ion_reader_split_add_context(split, system_start, system_end));
+                    system_start = NULL;
+                }
+                if (event->end - cursor >= split->_unit_size) {
+                    IONCHECK(_ion_reader_split_add_unit(split, cursor, event->end));
+                    cursor = event->end;
+                }
+                break;
+            case ION_READER_SPLIT_TEXT_SYMBOL_TABLE:
+            case ION_READER_SPLIT_TEXT_VERSION_MARKER:
+                for (pos = cursor; pos < event->start && _ion_reader_split_text_is_space(*pos); pos++);
+                has_values = (pos < event->start);
+                if (has_values) {
+                    if (system_start) {
+                        IONCHECK(_ion_reader_split_add_context(split, system_start, system_end));
+                        system_start = NULL;
+                    }
+                    IONCHECK(_ion_reader_split_add_unit(split, cursor, event->start));
+                }
+                if (!system_start) system_start = event->start;
+                if (event->kind == ION_READER_SPLIT_TEXT_VERSION_MARKER) {
+                    system_end = event->end;
+                    cursor = event->end;
+                }
+                else {
+                    in_symbol_table = TRUE;
+                }
+                break;
+            default:
+                FAILWITH(IERR_PARSER_INTERNAL);
+            }
+        }
+    }
+
+    for (pos = cursor; pos < end && _ion_reader_split_text_is_space(*pos); pos++);
+    if (pos < end) {
+        if (system_start) {
+            IONCHECK(_ion_reader_split_add_context(split, system_start, system_end));
+        }
+        IONCHECK(_ion_reader_split_add_unit(split, cursor, end));
+    }
+
+    iRETURN;
+}
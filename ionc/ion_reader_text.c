@@ -49,6 +49,7 @@ double _ION_FLOAT64_NAN() {
 #define IST_RECORD( NAME, TTT, STATE, FLAGS ) ION_SUB_TYPE NAME = & g_##NAME ;
 #include "ion_sub_type_records.h"
 #include "ion_decimal_impl.h"
+#include "ion_float_impl.h"
 
 /**
  *        open the reader, allocate supporting buffers for fieldname, annotations,
@@ -96,7 +97,15 @@ iERR _ion_reader_text_open(ION_READER *preader)
     text->_value_type         = tid_none;
     text->_value_sub_type     = IST_NONE;
 
-    _ion_collection_initialize(preader, &(text->_container_state_stack), sizeof(ION_TYPE));
+    text->_container_state_capacity = preader->options.max_container_depth;
+    text->_container_state_stack = (ION_TYPE *)ion_alloc_with_owner(preader, text->_container_state_capacity * sizeof(ION_TYPE));
+    if (!text->_container_state_stack) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    text->_container_state_count = 0;
+
+    memset(&text->_push, 0, sizeof(text->_push));
+    text->_push.scanned = ion_stream_get_position(preader->istream);
     
     IONCHECK(_ion_scanner_initialize(&(text->_scanner), preader));
 
@@ -143,7 +152,7 @@ iERR _ion_reader_text_reset(ION_READER *preader, ION_TYPE parent_tid, POSITION l
     text->_current_container = parent_tid;
     text->_value_end = local_end;
 
-    _ion_collection_reset(&(text->_container_state_stack));
+    text->_container_state_count = 0;
 
     IONCHECK(_ion_scanner_reset(&(text->_scanner)));
 
@@ -192,6 +201,11 @@ iERR _ion_reader_text_next(ION_READER *preader, ION_TYPE *p_value_type)
 
     ASSERT(preader);
 
+    if (preader->_depth == 0 && _ion_stream_is_push(preader->istream)) {
+        // don't start on a top level value until all of it has been pushed
+        IONCHECK(_ion_reader_text_push_check_value(preader));
+    }
+
     // first we check to see if we have some unfished business with
     // the previously recgonized value (we may not)
     switch (text->_state) {
@@ -311,7 +325,7 @@ iERR _ion_reader_text_intern_symbol(ION_READER *preader, ION_STRING *symbol_name
 
     if (parse_symbol_identifiers) {
         IONCHECK(_ion_reader_text_get_symbol_table(preader, &symbols));
-        IONCHECK(_ion_symbol_table_parse_possible_symbol_identifier(symbols, symbol_name, local_sid, &sym, &is_symbol_identifier));
+        IONCHECK(_ion_symbol_table_parse_possible_symbol_identifier(symbols, symbol_name, local_sid, &sym, &is_symbol_identifier, preader));
         ASSERT(!(is_symbol_identifier ^ (sym != NULL)));
     }
 
@@ -436,6 +450,13 @@ iERR _ion_reader_text_load_utas(ION_READER *preader, ION_SUB_TYPE *p_ist)
     for (;;) {
         for (;;) {
             IONCHECK(_ion_scanner_next(&text->_scanner, &ist));
+            // a seek's length ends the datagram before the first token that starts past it. The check in
+            // _ion_reader_text_next misses the ones after system values, comments and trailing whitespace.
+            if (text->_current_container == tid_DATAGRAM && text->_value_end > -1
+                && text->_scanner._value_start >= text->_value_end
+            ) {
+                ist = IST_EOF;
+            }
             // make sure we only let extended symbols in the context of sexp
             if (ist == IST_SYMBOL_EXTENDED && text->_current_container != tid_SEXP) {
                 FAILWITH(IERR_INVALID_SYNTAX);
@@ -568,7 +589,7 @@ iERR _ion_reader_text_check_for_system_values_to_skip_or_process(ION_READER *pre
 
     // we only look for system values at the top level,
     ASSERT(text->_current_container == tid_DATAGRAM);
-    ASSERT(ION_COLLECTION_IS_EMPTY(&text->_container_state_stack));
+    ASSERT(text->_container_state_count == 0);
 
     // the only system value we skip at the top is a local symbol table, 
     // but we process the version symbol, and shared symbol tables too
@@ -716,11 +737,389 @@ iERR _ion_reader_text_check_follow_token(ION_READER *preader)
     iRETURN;
 }   
 
+static inline BOOL _ion_reader_text_push_is_space(int c)
+{
+    // bytes past ASCII can only be a byte order mark between top level values
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f' || c == '\0' || c >= 0x80;
+}
+
+static inline BOOL _ion_reader_text_push_is_token_char(ION_TEXT_PUSH_LEXER *lexer, int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+        || c == '_' || c == '$' || c == '.' || c == '+' || c == '-' || (c == ':' && lexer->digits);
+}
+
+static inline void _ion_reader_text_push_keep(ION_TEXT_PUSH_LEXER *lexer, int c)
+{
+    if (lexer->token_length < ION_TEXT_PUSH_TOKEN_MAX) {
+        lexer->token_text[lexer->token_length] = (BYTE)c;
+    }
+    lexer->token_length++;
+}
+
+static inline BOOL _ion_reader_text_push_token_is(ION_TEXT_PUSH_LEXER *lexer, ION_STRING *str)
+{
+    return lexer->token_length == str->length && !memcmp(lexer->token_text, str->value, (size_t)str->length);
+}
+
+// for readers opened with ion_reader_open_push: fails with IERR_NEED_MORE_DATA,
+// without consuming anything, until the next top level value has been pushed
+// along with what the scanner peeks at after it (up to the next token, which
+// tells an annotation or the next part of a long string from the next value).
+// The local symbol tables and version markers the reader skips on the way are
+// lexed past too. Each call goes on from where the last one stopped, see
+// ION_TEXT_PUSH_LEXER. When the input has ended the regular path reports the
+// EOF or the truncated value.
+iERR _ion_reader_text_push_check_value(ION_READER *preader)
+{
+    iENTER;
+    ION_TEXT_PUSH_LEXER *lexer = &preader->typed_reader.text._push;
+    ION_STREAM          *istream = preader->istream;
+    POSITION             position = ion_stream_get_position(istream);
+    BYTE                *start = istream->_curr, *p, *limit = istream->_limit;
+    ION_TEXT_PUSH_TOKEN  end;
+    BOOL                 rewind;
+    int                  c;
+
+    if (_ion_stream_push_input_ended(istream)) SUCCEED();
+
+    // the scanner never reads past the lookahead the lexer waited for
+    ASSERT(lexer->scanned >= position);
+    p = start + (lexer->scanned - position);
+
+    while (p < limit) {
+        c = *p++;
+        end = TPT_NONE;
+        rewind = FALSE;
+
+        switch (lexer->mode) {
+        case TPM_CODE:
+            if (lexer->depth == 0 && _ion_reader_text_push_is_space(c)) break;
+            switch (c) {
+            case '"':
+                lexer->resume = TPM_CODE;
+                lexer->mode = TPM_STRING;
+                break;
+            case '\'':
+                lexer->mode = TPM_QUOTE1;
+                break;
+            case '/':
+                lexer->resume = TPM_CODE;
+                lexer->mode = TPM_SLASH;
+                break;
+            case '{':
+                lexer->mode = TPM_BRACE;
+                break;
+            case '[':
+            case '(':
+                lexer->depth++;
+                break;
+            case '}':
+            case ']':
+            case ')':
+                if (lexer->depth > 0) {
+                    if (--lexer->depth == 0) end = (c == '}') ? TPT_STRUCT : TPT_OTHER;
+                    break;
+                }
+                // fall through, nothing starts with these so the scanner will report them
+            case ',':
+            case ':':
+                if (lexer->depth == 0) end = TPT_OTHER;
+                break;
+            default:
+                if (lexer->depth == 0) {
+                    lexer->mode = TPM_TOKEN;
+                    lexer->token = TPT_PLAIN;
+                    lexer->digits = (c >= '0' && c <= '9');
+                    _ion_reader_text_push_keep(lexer, c);
+                }
+                break;
+            }
+            break;
+
+        case TPM_TOKEN:
+            if (_ion_reader_text_push_is_token_char(lexer, c)) {
+                _ion_reader_text_push_keep(lexer, c);
+                break;
+            }
+            p--;
+            lexer->mode = TPM_AFTER;
+            break;
+
+        case TPM_AFTER:
+            if (_ion_reader_text_push_is_space(c)) break;
+            lexer->mark = position + (POSITION)(p - 1 - start);
+            if (c == '/') {
+                lexer->resume = TPM_AFTER;
+                lexer->mode = TPM_SLASH;
+            }
+            else if (c == ':') {
+                lexer->mode = TPM_AFTER_COLON;
+            }
+            else if (c == '\'' && lexer->token == TPT_LONG_STRING) {
+                lexer->mode = TPM_AFTER_QUOTE1;
+            }
+            else {
+                rewind = TRUE;
+                end = lexer->token;
+            }
+            break;
+
+        case TPM_AFTER_COLON:
+            if (c != ':') {
+                rewind = TRUE;
+                end = lexer->token;
+                break;
+            }
+            // an annotation, the value goes on after it
+            if (!lexer->annotated) {
+                lexer->annotated = TRUE;
+                lexer->symbol_table = _ion_reader_text_push_token_is(lexer, &ION_SYMBOL_SYMBOL_TABLE_STRING)
+                    || (lexer->token == TPT_PLAIN && lexer->token_length == 2
+                        && lexer->token_text[0] == '$' && lexer->token_text[1] == '0' + ION_SYS_SID_SYMBOL_TABLE);
+            }
+            lexer->mode = TPM_CODE;
+            lexer->token = TPT_NONE;
+            lexer->token_length = 0;
+            break;
+
+        case TPM_AFTER_QUOTE1:
+        case TPM_AFTER_QUOTE2:
+            if (c != '\'') {
+                rewind = TRUE;
+                end = lexer->token;
+            }
+            else if (lexer->mode == TPM_AFTER_QUOTE1) {
+                lexer->mode = TPM_AFTER_QUOTE2;
+            }
+            else {
+                // the next part of the same long string
+                lexer->resume = TPM_CODE;
+                lexer->mode = TPM_LONG_STRING;
+            }
+            break;
+
+        case TPM_SLASH:
+            if (c == '/') {
+                lexer->mode = TPM_LINE_COMMENT;
+            }
+            else if (c == '*') {
+                lexer->mode = TPM_BLOCK_COMMENT;
+            }
+            else if (lexer->resume == TPM_AFTER) {
+                rewind = TRUE;
+                end = lexer->token;
+            }
+            else {
+                // an operator in an s-expression, at the top level the scanner will report it
+                p--;
+                lexer->mode = TPM_CODE;
+                if (lexer->depth == 0) end = TPT_OTHER;
+            }
+            break;
+
+        case TPM_LINE_COMMENT:
+            if (c == '\n' || c == '\r') lexer->mode = lexer->resume;
+            break;
+
+        case TPM_BLOCK_COMMENT:
+        case TPM_BLOCK_COMMENT_STAR:
+            if (c == '*') {
+                lexer->mode = TPM_BLOCK_COMMENT_STAR;
+            }
+            else if (c == '/' && lexer->mode == TPM_BLOCK_COMMENT_STAR) {
+                lexer->mode = lexer->resume;
+            }
+            else {
+                lexer->mode = TPM_BLOCK_COMMENT;
+            }
+            break;
+
+        case TPM_QUOTE1:
+            if (c == '\'') {
+                lexer->mode = TPM_QUOTE2;
+                break;
+            }
+            p--;
+            lexer->mode = TPM_SYMBOL;
+            lexer->token = TPT_QUOTED;
+            break;
+
+        case TPM_QUOTE2:
+            if (c == '\'') {
+                lexer->resume = TPM_CODE;
+                lexer->mode = TPM_LONG_STRING;
+                lexer->token = TPT_LONG_STRING;
+                break;
+            }
+            // the empty symbol
+            p--;
+            lexer->mode = (lexer->depth == 0) ? TPM_AFTER : TPM_CODE;
+            lexer->token = TPT_QUOTED;
+            break;
+
+        case TPM_SYMBOL:
+            if (c == '\'') {
+                lexer->mode = (lexer->depth == 0) ? TPM_AFTER : TPM_CODE;
+                break;
+            }
+            if (c == '\\') lexer->mode = TPM_SYMBOL_ESCAPE;
+            if (lexer->depth == 0) _ion_reader_text_push_keep(lexer, c);
+            break;
+
+        case TPM_SYMBOL_ESCAPE:
+            lexer->mode = TPM_SYMBOL;
+            if (lexer->depth == 0) _ion_reader_text_push_keep(lexer, c);
+            break;
+
+        case TPM_STRING:
+            if (c == '\\') {
+                lexer->mode = TPM_STRING_ESCAPE;
+            }
+            else if (c == '"') {
+                lexer->mode = lexer->resume;
+                if (lexer->resume == TPM_CODE && lexer->depth == 0) end = TPT_OTHER;
+            }
+            break;
+
+        case TPM_STRING_ESCAPE:
+            lexer->mode = TPM_STRING;
+            break;
+
+        case TPM_LONG_STRING:
+        case TPM_LONG_STRING_QUOTE1:
+        case TPM_LONG_STRING_QUOTE2:
+            if (c != '\'') {
+                lexer->mode = (c == '\\') ? TPM_LONG_STRING_ESCAPE : TPM_LONG_STRING;
+            }
+            else if (lexer->mode == TPM_LONG_STRING) {
+                lexer->mode = TPM_LONG_STRING_QUOTE1;
+            }
+            else if (lexer->mode == TPM_LONG_STRING_QUOTE1) {
+                lexer->mode = TPM_LONG_STRING_QUOTE2;
+            }
+            else if (lexer->resume == TPM_CODE && lexer->depth == 0) {
+                // another part may follow
+                lexer->mode = TPM_AFTER;
+            }
+            else {
+                lexer->mode = lexer->resume;
+            }
+            break;
+
+        case TPM_LONG_STRING_ESCAPE:
+            lexer->mode = TPM_LONG_STRING;
+            break;
+
+        case TPM_BRACE:
+            if (c == '{') {
+                lexer->mode = TPM_LOB;
+                break;
+            }
+            p--;
+            lexer->depth++;
+            lexer->mode = TPM_CODE;
+            break;
+
+        case TPM_LOB:
+            if (c == '}') {
+                lexer->mode = TPM_LOB_BRACE;
+            }
+            else if (c == '"') {
+                lexer->resume = TPM_LOB;
+                lexer->mode = TPM_STRING;
+            }
+            else if (c == '\'') {
+                lexer->mode = TPM_LOB_QUOTE1;
+            }
+            break;
+
+        case TPM_LOB_BRACE:
+            if (c != '}') {
+                p--;
+                lexer->mode = TPM_LOB;
+                break;
+            }
+            lexer->mode = TPM_CODE;
+            if (lexer->depth == 0) end = TPT_OTHER;
+            break;
+
+        case TPM_LOB_QUOTE1:
+        case TPM_LOB_QUOTE2:
+            if (c != '\'') {
+                p--;
+                lexer->mode = TPM_LOB;
+            }
+            else if (lexer->mode == TPM_LOB_QUOTE1) {
+                lexer->mode = TPM_LOB_QUOTE2;
+            }
+            else {
+                lexer->resume = TPM_LOB;
+                lexer->mode = TPM_LONG_STRING;
+            }
+            break;
+
+        default:
+            FAILWITH(IERR_PARSER_INTERNAL);
+        }
+
+        if (rewind) {
+            // the lookahead belongs to the next value
+            p = start + (lexer->mark - position);
+        }
+        if (end != TPT_NONE && _ion_reader_text_push_end_value(lexer, end)) {
+            lexer->scanned = position + (POSITION)(p - start);
+            SUCCEED();
+        }
+    }
+
+    lexer->scanned = position + (POSITION)(p - start);
+    DONTFAILWITH(IERR_NEED_MORE_DATA);
+
+    iRETURN;
+}
+
+// resets the lexer for the next top level value, and tells whether the
+// one that just ended is a value the reader returns rather than skips
+BOOL _ion_reader_text_push_end_value(ION_TEXT_PUSH_LEXER *lexer, ION_TEXT_PUSH_TOKEN token)
+{
+    ION_STRING text;
+    int        major_version, minor_version;
+    BOOL       is_system_value = FALSE;
+
+    text.value = lexer->token_text;
+    text.length = lexer->token_length;
+    if (lexer->annotated) {
+        // a local symbol table. When the reader returns system values this
+        // holds it back until the next value is in too, which is harmless
+        is_system_value = (token == TPT_STRUCT && lexer->symbol_table);
+    }
+    else if (lexer->token_length <= ION_TEXT_PUSH_TOKEN_MAX) {
+        if (token == TPT_PLAIN) {
+            // a version marker, or $2 which is its symbol id
+            is_system_value = _ion_symbol_table_parse_version_marker(&text, &major_version, &minor_version)
+                || (text.length == 2 && text.value[0] == '$' && text.value[1] == '0' + ION_SYS_SID_IVM);
+        }
+        else if (token == TPT_QUOTED) {
+            is_system_value = ION_STRING_EQUALS(&ION_SYMBOL_VTM_STRING, &text);
+        }
+    }
+
+    lexer->mode = TPM_CODE;
+    lexer->token = TPT_NONE;
+    lexer->digits = FALSE;
+    lexer->annotated = FALSE;
+    lexer->symbol_table = FALSE;
+    lexer->token_length = 0;
+
+    return !is_system_value;
+}
+
 iERR _ion_reader_text_step_in(ION_READER *preader)
 {
     iENTER;
     ION_TEXT_READER  *text = &preader->typed_reader.text;
-    ION_TYPE         *pparent, new_container_type, old_container_type;
+    ION_TYPE          new_container_type, old_container_type;
 
     ASSERT(preader && preader->type == ion_type_text_reader);
 
@@ -733,8 +1132,8 @@ iERR _ion_reader_text_step_in(ION_READER *preader)
     old_container_type = text->_current_container;
 
     // first, push the current container onto the parent container stack
-    pparent = (ION_TYPE *)_ion_collection_push(&text->_container_state_stack);
-    *pparent = old_container_type;
+    IONCHECK(ION_READER_STACK_RESERVE(preader, text->_container_state_stack, text->_container_state_count, text->_container_state_capacity));
+    text->_container_state_stack[text->_container_state_count++] = old_container_type;
 
     // now we set the current container type
     text->_current_container = new_container_type;
@@ -763,7 +1162,7 @@ iERR _ion_reader_text_step_out(ION_READER *preader)
 
     ASSERT(preader && preader->type == ion_type_text_reader);
 
-    container_depth = ION_COLLECTION_SIZE(&text->_container_state_stack);
+    container_depth = text->_container_state_count;
     if (container_depth < 1) {
         // if we didn't step in, we can't step out
         FAILWITH(IERR_STACK_UNDERFLOW);
@@ -802,13 +1201,8 @@ iERR _ion_reader_text_step_out(ION_READER *preader)
     text->_value_sub_type = sub_type;
     text->_state = IPS_AFTER_VALUE;
 
-    // remember we have to use the value BEFORE popping it off the stack (and, possibly,
-    // having it deallocated underneath us). so get the parent container type off the
-    // top of the stack first.
-    new_container_type = *((ION_TYPE *)_ion_collection_head(&text->_container_state_stack));
-    
-    // now we can safely pop the parent container off of the parent container stack
-    _ion_collection_pop_head(&text->_container_state_stack);
+    // pop the parent container type off of the parent container stack
+    new_container_type = text->_container_state_stack[--text->_container_state_count];
 
     // now we set the current container type
     text->_current_container = new_container_type;
@@ -831,7 +1225,7 @@ iERR _ion_reader_text_get_depth(ION_READER *preader, SIZE *p_depth)
         FAILWITH(IERR_INVALID_STATE);
     }
 
-    container_depth = ION_COLLECTION_SIZE(&text->_container_state_stack);
+    container_depth = text->_container_state_count;
     *p_depth = container_depth;
 
     iRETURN;
@@ -1491,7 +1885,7 @@ iERR _ion_reader_text_read_double(ION_READER *preader, double *p_value)
         ASSERT(text->_scanner._value_location == SVL_VALUE_IMAGE);
         ASSERT(text->_scanner._value_image.length > 0);
         ASSERT(text->_scanner._value_image.value[text->_scanner._value_image.length] == 0);
-        double_value = atof(text->_scanner._value_image.value);
+        double_value = _ion_float_from_string(text->_scanner._value_image.value);
     }
     else if (text->_value_sub_type == IST_PLUS_INF) {
         double_value = ION_FLOAT64_POS_INF;
@@ -1870,6 +2264,32 @@ iERR _ion_reader_text_get_lob_size(ION_READER *preader, SIZE *p_length)
     iRETURN;
 }
 
+// the text reader has to decode lobs (base64 or escaped clob text) so there is
+// nothing to borrow from the stream, instead this loads the value into the
+// scanner's value buffer (as get_lob_size does) and returns a view of that
+iERR _ion_reader_text_read_lob_view(ION_READER *preader, ION_STRING *p_value)
+{
+    iENTER;
+    ION_TEXT_READER  *text = &preader->typed_reader.text;
+    SIZE              length;
+
+    ASSERT(preader);
+    ASSERT(p_value);
+
+    if (text->_state == IPS_ERROR || text->_state == IPS_NONE) {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+    if (text->_value_sub_type->base_type != tid_BLOB && text->_value_sub_type->base_type != tid_CLOB) {
+        FAILWITH(IERR_INVALID_STATE);
+    }
+
+    IONCHECK(_ion_reader_text_get_lob_size(preader, &length));
+    ASSERT(length == text->_scanner._value_image.length);
+    ION_STRING_ASSIGN(p_value, &text->_scanner._value_image);
+
+    iRETURN;
+}
+
 iERR _ion_reader_text_read_lob_bytes(ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length) 
 {
     iENTER;
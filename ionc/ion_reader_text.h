@@ -289,6 +289,7 @@ iERR _ion_reader_text_load_fieldname            (ION_READER *preader, ION_SUB_TY
 iERR _ion_reader_text_load_utas                 (ION_READER *preader, ION_SUB_TYPE *p_ist);
 iERR _ion_reader_text_check_for_system_values_to_skip_or_process(ION_READER *preader, ION_SUB_TYPE ist, BOOL *p_is_system_value );
 iERR _ion_reader_text_check_follow_token        (ION_READER *preader);
+iERR _ion_reader_text_push_check_value          (ION_READER *preader);
 
 iERR _ion_reader_text_step_in                   (ION_READER *preader);
 iERR _ion_reader_text_step_out                  (ION_READER *preader);
@@ -336,6 +337,7 @@ iERR _ion_reader_text_read_string_bytes         (ION_READER *preader, BOOL accep
 // get lob size FORCES the value to read into the value_image buffer (which may not be desirable)
 iERR _ion_reader_text_get_lob_size              (ION_READER *preader, SIZE *p_length);
 iERR _ion_reader_text_read_lob_bytes            (ION_READER *preader, BOOL accept_partial, BYTE *p_buf, SIZE buf_max, SIZE *p_length) ;
+iERR _ion_reader_text_read_lob_view             (ION_READER *preader, ION_STRING *p_value);
 
 #ifdef __cplusplus
 }
@@ -522,12 +522,41 @@ iERR _ion_scanner_read_char_newline_helper(ION_SCANNER *scanner, int *p_char)
     iRETURN;
 }
 
+// moves the stream past the bytes in its current page that aren't in any
+// of the classes (or a new line), counting them the way _ion_scanner_read_char
+// would. The caller's byte at a time loop picks up from the next interesting
+// byte, or from the next page.
+void _ion_scanner_skip_to_class(ION_SCANNER *scanner, int classes)
+{
+    ION_STREAM *stream = scanner->_stream;
+    BYTE       *next;
+
+    // most of the time the next byte is the one we want, so don't bother
+    if (stream->_curr >= stream->_limit || (ION_SCANNER_CHAR_CLASS(*stream->_curr) & classes)) return;
+    next = _ion_scanner_index_find(stream->_curr, stream->_limit, classes);
+    scanner->_offset += (int)(next - stream->_curr);
+    stream->_curr = next;
+}
+
+// the same, for a run of whitespace other than new lines
+void _ion_scanner_skip_blanks(ION_SCANNER *scanner)
+{
+    ION_STREAM *stream = scanner->_stream;
+    BYTE       *next;
+
+    if (stream->_curr >= stream->_limit || !(ION_SCANNER_CHAR_CLASS(*stream->_curr) & ION_SCANNER_CC_WHITESPACE)) return;
+    next = _ion_scanner_index_span(stream->_curr, stream->_limit, ION_SCANNER_CC_WHITESPACE);
+    scanner->_offset += (int)(next - stream->_curr);
+    stream->_curr = next;
+}
+
 iERR _ion_scanner_read_past_whitespace(ION_SCANNER *scanner, int *p_char)
 {
     iENTER;
     int c;
 
     for (;;) {
+        _ion_scanner_skip_blanks(scanner);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         case ION_unicode_byte_order_mark_utf8_start:
@@ -645,6 +674,7 @@ iERR _ion_scanner_read_to_one_line_comment(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_NEWLINE);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         // these are escaped new lines, they act as nothing which
@@ -668,6 +698,7 @@ iERR _ion_scanner_read_to_end_of_long_comment(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_COMMENT);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         if (c == '*') {
             IONCHECK(_ion_scanner_read_char(scanner, &c));
@@ -1068,6 +1099,7 @@ iERR _ion_scanner_skip_plain_string(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_DOUBLE_QUOTE | ION_SCANNER_CC_ESCAPE);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         case '"':
@@ -1131,6 +1163,7 @@ iERR _ion_scanner_skip_one_long_string(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_SINGLE_QUOTE | ION_SCANNER_CC_ESCAPE);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         case '\'':
@@ -1160,6 +1193,7 @@ iERR _ion_scanner_skip_single_quoted_string(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_SINGLE_QUOTE | ION_SCANNER_CC_ESCAPE);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         case '\'':
@@ -1195,8 +1229,9 @@ iERR _ion_scanner_skip_unknown_lob(ION_SCANNER *scanner)
             IONCHECK(_ion_scanner_skip_single_quoted_string(scanner));
             break;
         case '\"':
+            // this consumes the closing braces too
             IONCHECK(_ion_scanner_skip_plain_clob(scanner));
-            break;
+            SUCCEED();
         case '}':
             IONCHECK(_ion_scanner_read_char(scanner, &c));
             if (c == '}') {
@@ -1272,6 +1307,7 @@ iERR _ion_scanner_skip_blob(ION_SCANNER *scanner)
     int c;
 
     for (;;) {
+        _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_BRACKET);
         IONCHECK(_ion_scanner_read_char(scanner, &c));
         switch (c) {
         case '}':
@@ -1381,6 +1417,8 @@ just_another_char: // yes this is evil
             if (c == close_char) {
                 SUCCEED();
             }
+            // nothing up to the next quote, bracket or comment can end this container
+            _ion_scanner_skip_to_class(scanner, ION_SCANNER_CC_STRUCTURAL);
             break;
         }
     }
@@ -279,6 +279,56 @@ GLOBAL BOOL  _ion_binary_character_value[256]
 #endif
 ;
 
+//
+// character classes for the structural index the scanner uses to skip
+// over runs of bytes it doesn't need to look at one at a time (see
+// _ion_scanner_index_find). A byte can be in more than one class.
+//
+#define ION_SCANNER_CC_NEWLINE      0x01  /* '\n' '\r' - always stop, lines have to be counted */
+#define ION_SCANNER_CC_ESCAPE       0x02  /* '\\' */
+#define ION_SCANNER_CC_DOUBLE_QUOTE 0x04  /* '"' */
+#define ION_SCANNER_CC_SINGLE_QUOTE 0x08  /* '\'' */
+#define ION_SCANNER_CC_BRACKET      0x10  /* '(' ')' '[' ']' '{' '}' */
+#define ION_SCANNER_CC_COMMENT      0x20  /* '/' '*' */
+#define ION_SCANNER_CC_WHITESPACE   0x40  /* ' ' '\t' '\v' '\f' '\0', but not the new lines */
+
+#define ION_SCANNER_CC_STRUCTURAL   (ION_SCANNER_CC_DOUBLE_QUOTE | ION_SCANNER_CC_SINGLE_QUOTE \
+                                    | ION_SCANNER_CC_BRACKET | ION_SCANNER_CC_COMMENT)
+
+#define ION_SCANNER_CHAR_CLASS(x) (_ion_scanner_char_class[(x)])
+GLOBAL BYTE  _ion_scanner_char_class[256]
+#ifdef INIT_STATICS
+= { //   0     1     2     3     4     5     6     7     8     9
+      0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,   //   0 -   9  '\0'=0, '\t'=9
+      0x01, 0x40, 0x40, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  10 -  19  '\n'=10, '\v'=11, '\f'=12, '\r'=13
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  20 -  29
+      0x00, 0x00, 0x40, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x08,   //  30 -  39  ' '=32, '"'=34, '\''=39
+      0x10, 0x10, 0x20, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,   //  40 -  49  '('=40, ')'=41, '*'=42, '/'=47
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  50 -  59
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  60 -  69
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  70 -  79
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  80 -  89
+      0x00, 0x10, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   //  90 -  99  '['=91, '\\'=92, ']'=93
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 100 - 109
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 110 - 119
+      0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00,   // 120 - 129  '{'=123, '}'=125
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 130 - 139
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 140 - 149
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 150 - 159
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 160 - 169
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 170 - 179
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 180 - 189
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 190 - 199
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 200 - 209
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 210 - 219
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 220 - 229
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 230 - 239
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 240 - 249
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00                            // 250 - 255
+}
+#endif
+;
+
 typedef enum { ION_INT_DECIMAL, ION_INT_HEX, ION_INT_BINARY } ION_INT_RADIX;
 
 #define IS_RADIX_CHAR(x, r) ((r == ION_INT_DECIMAL && isdigit(x)) || (r == ION_INT_BINARY && IS_BINARY_CHAR(x)) || (r == ION_INT_HEX && IS_HEX_CHAR(x)))
@@ -439,6 +489,13 @@ iERR _ion_scanner_skip_list                         (ION_SCANNER *scanner);
 iERR _ion_scanner_skip_struct                       (ION_SCANNER *scanner);
 iERR _ion_scanner_skip_container                    (ION_SCANNER *scanner, int close_char);
 
+BYTE *_ion_scanner_index_scan_scalar               (BYTE *curr, BYTE *limit, int classes, BOOL in_class);
+BYTE *_ion_scanner_index_scan                      (BYTE *curr, BYTE *limit, int classes, BOOL in_class);
+BYTE *_ion_scanner_index_find                      (BYTE *curr, BYTE *limit, int classes);
+BYTE *_ion_scanner_index_span                      (BYTE *curr, BYTE *limit, int classes);
+void _ion_scanner_skip_to_class                     (ION_SCANNER *scanner, int classes);
+void _ion_scanner_skip_blanks                       (ION_SCANNER *scanner);
+
 iERR _ion_scanner_read_cached_bytes                 (ION_SCANNER *scanner, BYTE *buf, SIZE len, SIZE *p_bytes_written);
 
 iERR _ion_scanner_read_as_string                    (ION_SCANNER *scanner, BYTE *buf, SIZE len, ION_SUB_TYPE ist, SIZE *p_bytes_written, BOOL *p_eos_encountered);
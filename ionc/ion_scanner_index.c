@@ -0,0 +1,179 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/*
+ *  structural index for the text scanner
+ *
+ *  the scanner reads text one character at a time, which is what it
+ *  needs to do for the characters it's interested in, but most of the
+ *  bytes in a string or in a container that's being skipped are of
+ *  no interest at all. These routines classify a block of bytes at a
+ *  time (see _ion_scanner_char_class in ion_scanner.h) and return the
+ *  next position the scanner has to look at, so the byte at a time
+ *  loops can jump from one structural character to the next.
+ *
+ *  the blocks are 32 bytes with AVX2, 16 bytes with SSE2 and there's
+ *  a table driven scalar version for everything else (and for the
+ *  tail of a buffer). Define ION_SCANNER_INDEX_SCALAR to force the
+ *  scalar version.
+ */
+
+#include <ionc/ion.h>
+#include "ion_internal.h"
+
+#if !defined(ION_SCANNER_INDEX_SCALAR)
+  #if defined(__AVX2__)
+    #define ION_SCANNER_INDEX_AVX2
+    #include <immintrin.h>
+  #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ION_SCANNER_INDEX_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif
+
+#if defined(ION_SCANNER_INDEX_AVX2) || defined(ION_SCANNER_INDEX_SSE2)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline int _ion_scanner_index_first_bit(uint32_t mask)
+{
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+}
+#else
+#define _ion_scanner_index_first_bit(mask) __builtin_ctz(mask)
+#endif
+
+// the members of each class, this has to agree with _ion_scanner_char_class
+#define ION_SCANNER_INDEX_MAX_CHARS 16
+
+typedef struct _ion_scanner_index_class
+{
+    int         char_class;
+    const char *chars;
+    int         count;
+} ION_SCANNER_INDEX_CLASS;
+
+static const ION_SCANNER_INDEX_CLASS _ion_scanner_index_classes[] = {
+    { ION_SCANNER_CC_NEWLINE,      "\n\r",         2 },
+    { ION_SCANNER_CC_ESCAPE,       "\\",           1 },
+    { ION_SCANNER_CC_DOUBLE_QUOTE, "\"",           1 },
+    { ION_SCANNER_CC_SINGLE_QUOTE, "'",            1 },
+    { ION_SCANNER_CC_BRACKET,      "()[]{}",       6 },
+    { ION_SCANNER_CC_COMMENT,      "/*",           2 },
+    { ION_SCANNER_CC_WHITESPACE,   " \t\v\f\0",    5 },
+    { 0, NULL, 0 }
+};
+
+static int _ion_scanner_index_chars(int classes, BYTE *chars)
+{
+    const ION_SCANNER_INDEX_CLASS *cc;
+    int count = 0, ii;
+
+    for (cc = _ion_scanner_index_classes; cc->chars; cc++) {
+        if ((classes & cc->char_class) == 0) continue;
+        for (ii = 0; ii < cc->count; ii++) {
+            ASSERT(count < ION_SCANNER_INDEX_MAX_CHARS);
+            chars[count++] = (BYTE)cc->chars[ii];
+        }
+    }
+    return count;
+}
+
+#endif
+
+BYTE *_ion_scanner_index_scan_scalar(BYTE *curr, BYTE *limit, int classes, BOOL in_class)
+{
+    if (in_class) {
+        while (curr < limit && (ION_SCANNER_CHAR_CLASS(*curr) & classes) == 0) curr++;
+    }
+    else {
+        while (curr < limit && (ION_SCANNER_CHAR_CLASS(*curr) & classes) != 0) curr++;
+    }
+    return curr;
+}
+
+BYTE *_ion_scanner_index_scan(BYTE *curr, BYTE *limit, int classes, BOOL in_class)
+{
+#if defined(ION_SCANNER_INDEX_AVX2)
+    BYTE     chars[ION_SCANNER_INDEX_MAX_CHARS], *stop;
+    __m256i  needles[ION_SCANNER_INDEX_MAX_CHARS], block, hits;
+    uint32_t mask;
+    int      count, ii;
+
+    // short runs are the common case and aren't worth setting up the needles for
+    stop = (limit - curr > 32) ? curr + 32 : limit;
+    curr = _ion_scanner_index_scan_scalar(curr, stop, classes, in_class);
+    if (curr < stop || stop == limit) return curr;
+    if (limit - curr < 32) return _ion_scanner_index_scan_scalar(curr, limit, classes, in_class);
+
+    count = _ion_scanner_index_chars(classes, chars);
+    if (count == 0) return _ion_scanner_index_scan_scalar(curr, limit, classes, in_class);
+    for (ii = 0; ii < count; ii++) {
+        needles[ii] = _mm256_set1_epi8((char)chars[ii]);
+    }
+    while (limit - curr >= 32) {
+        block = _mm256_loadu_si256((const __m256i *)curr);
+        hits = _mm256_cmpeq_epi8(block, needles[0]);
+        for (ii = 1; ii < count; ii++) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[ii]));
+        }
+        mask = (uint32_t)_mm256_movemask_epi8(hits);
+        if (!in_class) mask = ~mask;
+        if (mask) return curr + _ion_scanner_index_first_bit(mask);
+        curr += 32;
+    }
+#elif defined(ION_SCANNER_INDEX_SSE2)
+    BYTE     chars[ION_SCANNER_INDEX_MAX_CHARS], *stop;
+    __m128i  needles[ION_SCANNER_INDEX_MAX_CHARS], block, hits;
+    uint32_t mask;
+    int      count, ii;
+
+    // short runs are the common case and aren't worth setting up the needles for
+    stop = (limit - curr > 16) ? curr + 16 : limit;
+    curr = _ion_scanner_index_scan_scalar(curr, stop, classes, in_class);
+    if (curr < stop || stop == limit) return curr;
+    if (limit - curr < 16) return _ion_scanner_index_scan_scalar(curr, limit, classes, in_class);
+
+    count = _ion_scanner_index_chars(classes, chars);
+    if (count == 0) return _ion_scanner_index_scan_scalar(curr, limit, classes, in_class);
+    for (ii = 0; ii < count; ii++) {
+        needles[ii] = _mm_set1_epi8((char)chars[ii]);
+    }
+    while (limit - curr >= 16) {
+        block = _mm_loadu_si128((const __m128i *)curr);
+        hits = _mm_cmpeq_epi8(block, needles[0]);
+        for (ii = 1; ii < count; ii++) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[ii]));
+        }
+        mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (!in_class) mask = ~mask & 0xffff;
+        if (mask) return curr + _ion_scanner_index_first_bit(mask);
+        curr += 16;
+    }
+#endif
+    return _ion_scanner_index_scan_scalar(curr, limit, classes, in_class);
+}
+
+BYTE *_ion_scanner_index_find(BYTE *curr, BYTE *limit, int classes)
+{
+    // new lines always stop the scan, the scanner has to count them
+    return _ion_scanner_index_scan(curr, limit, classes | ION_SCANNER_CC_NEWLINE, TRUE);
+}
+
+BYTE *_ion_scanner_index_span(BYTE *curr, BYTE *limit, int classes)
+{
+    return _ion_scanner_index_scan(curr, limit, classes & ~ION_SCANNER_CC_NEWLINE, FALSE);
+}
@@ -159,6 +159,19 @@
   #define READ read
 #endif
 
+#ifdef ION_PLATFORM_WINDOWS
+  #include <windows.h>
+  #define OPEN _open
+  #define CLOSE _close
+  #define OPEN_READ_FLAGS (_O_RDONLY | _O_BINARY)
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #define OPEN open
+  #define CLOSE close
+  #define OPEN_READ_FLAGS (O_RDONLY)
+#endif
+
 
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -469,6 +482,238 @@ iERR ion_stream_open_handler_out( ION_STREAM_HANDLER fn_output_handler, void *ha
   iRETURN;
 }
 
+iERR ion_stream_open_mmap( int fd, ION_STREAM_MMAP_ADVICE advice, ION_STREAM **pp_stream )
+{
+  iENTER;
+  ION_STREAM       *stream = NULL;
+  ION_STREAM_MMAP  *mapped;
+  BYTE             *base = NULL;
+  size_t            length = 0;
+#ifdef ION_PLATFORM_WINDOWS
+  HANDLE            file, mapping;
+  LARGE_INTEGER     size;
+#else
+  struct stat       st;
+#endif
+
+  if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
+  if (fd < 0)     FAILWITH(IERR_INVALID_ARG);
+
+#ifdef ION_PLATFORM_WINDOWS
+  file = (HANDLE)_get_osfhandle(fd);
+  if (file == INVALID_HANDLE_VALUE) FAILWITH(IERR_INVALID_ARG);
+  // pipes, sockets and consoles can't be mapped - use ion_stream_open_fd_in for those
+  if (GetFileType(file) != FILE_TYPE_DISK) FAILWITH(IERR_INVALID_ARG);
+  if (!GetFileSizeEx(file, &size)) FAILWITH(IERR_READ_ERROR);
+  if ((uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) FAILWITH(IERR_NO_MEMORY);
+
+  length = (size_t)size.QuadPart;
+  if (length > 0) {
+    // a file mapping of an empty file fails, so (as with mmap) nothing is mapped for one
+    mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) FAILWITH(IERR_READ_ERROR);
+    base = (BYTE *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // the view holds its own reference to the mapping (and so the file), so fd may be closed by the caller
+    CloseHandle(mapping);
+    if (!base) FAILWITH(IERR_READ_ERROR);
+  }
+#else
+  if (fstat(fd, &st) != 0)  FAILWITH(IERR_READ_ERROR);
+  // pipes, sockets and ttys can't be mapped - use ion_stream_open_fd_in for those
+  if (!S_ISREG(st.st_mode)) FAILWITH(IERR_INVALID_ARG);
+
+  length = (size_t)st.st_size;
+  if (length > 0) {
+    // the mapping holds its own reference to the file, so fd may be closed by the caller
+    base = (BYTE *)mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ((void *)base == MAP_FAILED) FAILWITH(IERR_READ_ERROR);
+  }
+#endif
+
+  // the one and only "page" is the whole mapping, _buffer_size is only
+  // consulted for paged or writable streams so clamping it is harmless
+  err = _ion_stream_open_helper(ION_STREAM_MMAP_IN, (length > MAX_SIZE) ? MAX_SIZE : (SIZE)length, &stream);
+  if (err) {
+#ifdef ION_PLATFORM_WINDOWS
+    if (base) UnmapViewOfFile(base);
+#else
+    if (base) munmap(base, length);
+#endif
+    FAILWITH(err);
+  }
+
+  mapped = (ION_STREAM_MMAP *)stream;
+  mapped->_map_base   = base;
+  mapped->_map_length = length;
+
+  // here we manualy set up the state to mimic a paged stream
+  // see ion_stream_open_buffer, an empty file gets an empty buffer
+  stream->_buffer = base;
+  stream->_offset = 0;
+  stream->_limit  = base + length;
+  stream->_curr   = base;
+
+  err = ion_stream_mmap_advise(stream, advice);
+  if (err) {
+    ion_stream_close(stream);
+    FAILWITH(err);
+  }
+
+  *pp_stream = stream;
+  SUCCEED();
+
+  iRETURN;
+}
+
+iERR ion_stream_open_mmap_path( const char *path, ION_STREAM_MMAP_ADVICE advice, ION_STREAM **pp_stream )
+{
+  iENTER;
+  int fd;
+
+  if (!path)      FAILWITH(IERR_INVALID_ARG);
+  if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
+
+  fd = OPEN(path, OPEN_READ_FLAGS);
+  if (fd < 0) FAILWITH(IERR_CANT_FIND_FILE);
+
+  // the mapping outlives the descriptor, so we're done with it either way
+  err = ion_stream_open_mmap(fd, advice, pp_stream);
+  CLOSE(fd);
+  IONCHECK(err);
+
+  iRETURN;
+}
+
+iERR ion_stream_mmap_advise( ION_STREAM *stream, ION_STREAM_MMAP_ADVICE advice )
+{
+  iENTER;
+#ifndef ION_PLATFORM_WINDOWS
+  ION_STREAM_MMAP *mapped;
+  int              posix_advice;
+#endif
+
+  if (!stream) FAILWITH(IERR_INVALID_ARG);
+  if (!_ion_stream_is_mmap(stream)) FAILWITH(IERR_INVALID_ARG);
+
+#ifndef ION_PLATFORM_WINDOWS
+  switch (advice) {
+  case ION_STREAM_MMAP_ADVICE_NORMAL:     posix_advice = POSIX_MADV_NORMAL;     break;
+  case ION_STREAM_MMAP_ADVICE_SEQUENTIAL: posix_advice = POSIX_MADV_SEQUENTIAL; break;
+  case ION_STREAM_MMAP_ADVICE_RANDOM:     posix_advice = POSIX_MADV_RANDOM;     break;
+  case ION_STREAM_MMAP_ADVICE_WILLNEED:   posix_advice = POSIX_MADV_WILLNEED;   break;
+  default:                                FAILWITH(IERR_INVALID_ARG);
+  }
+
+  mapped = (ION_STREAM_MMAP *)stream;
+  if (mapped->_map_base) {
+    // this is only a hint, a kernel that ignores it doesn't change the stream contents
+    (void)posix_madvise(mapped->_map_base, mapped->_map_length, posix_advice);
+  }
+#endif
+  SUCCEED();
+
+  iRETURN;
+}
+
+iERR ion_stream_open_push( ION_STREAM **pp_stream )
+{
+  iENTER;
+  ION_STREAM       *stream = NULL;
+  BYTE             *buffer;
+
+  if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
+
+  buffer = (BYTE *)ion_xalloc(g_Ion_Stream_Default_Page_Size);
+  if (!buffer) FAILWITH(IERR_NO_MEMORY);
+
+  err = _ion_stream_open_helper(ION_STREAM_PUSH_IN, g_Ion_Stream_Default_Page_Size, &stream);
+  if (err) {
+    ion_xfree(buffer);
+    FAILWITH(err);
+  }
+  ((ION_STREAM_PUSH *)stream)->_input_ended = FALSE;
+
+  // here we manualy set up the state to mimic a paged stream
+  // see ion_stream_open_buffer, we start out with nothing to read
+  stream->_buffer = buffer;
+  stream->_offset = 0;
+  stream->_limit  = buffer;
+  stream->_curr   = buffer;
+
+  *pp_stream = stream;
+  SUCCEED();
+
+  iRETURN;
+}
+
+iERR ion_stream_push( ION_STREAM *stream, BYTE *buffer, SIZE length )
+{
+  iENTER;
+  BYTE     *keep, *grown;
+  SIZE      kept, size;
+  POSITION  mark;
+
+  if (!stream)                      FAILWITH(IERR_INVALID_ARG);
+  if (!_ion_stream_is_push(stream)) FAILWITH(IERR_INVALID_ARG);
+  if (!buffer && length > 0)        FAILWITH(IERR_INVALID_ARG);
+  if (length < 0)                   FAILWITH(IERR_INVALID_ARG);
+  if (_ion_stream_push_input_ended(stream)) FAILWITH(IERR_INVALID_STATE);
+
+  // everything before the current position has been read, unless
+  // it's held by a mark, and can go
+  keep = stream->_curr;
+  if (_ion_stream_is_mark_open(stream)) {
+    mark = _ion_stream_get_mark_start(stream);
+    if (mark < _ion_stream_position(stream)) {
+      keep = IH_CURR_OF(mark);
+    }
+  }
+  kept = (SIZE)(stream->_limit - keep);
+
+  if (kept + length > stream->_buffer_size) {
+    size = stream->_buffer_size;
+    while (size < kept + length) {
+      if (size > MAX_SIZE / 2) FAILWITH(IERR_NO_MEMORY);
+      size *= 2;
+    }
+    grown = (BYTE *)ion_xalloc(size);
+    if (!grown) FAILWITH(IERR_NO_MEMORY);
+    memcpy(grown, keep, kept);
+    ion_xfree(stream->_buffer);
+    stream->_buffer_size = size;
+  }
+  else {
+    grown = stream->_buffer;
+    memmove(grown, keep, kept);
+  }
+
+  // slide the window so positions stay where they were
+  stream->_offset += (POSITION)(keep - stream->_buffer);
+  stream->_curr    = grown + (stream->_curr - keep);
+  stream->_buffer  = grown;
+  stream->_limit   = grown + kept;
+
+  if (length > 0) {
+    memcpy(stream->_limit, buffer, length);
+    stream->_limit += length;
+  }
+  SUCCEED();
+
+  iRETURN;
+}
+
+iERR ion_stream_push_eof( ION_STREAM *stream )
+{
+  iENTER;
+
+  if (!stream)                      FAILWITH(IERR_INVALID_ARG);
+  if (!_ion_stream_is_push(stream)) FAILWITH(IERR_INVALID_ARG);
+
+  ((ION_STREAM_PUSH *)stream)->_input_ended = TRUE;
+  SUCCEED();
+
+  iRETURN;
+}
 
 iERR ion_stream_flush(ION_STREAM *stream)
 {
@@ -477,7 +722,7 @@ iERR ion_stream_flush(ION_STREAM *stream)
   if (!stream) FAILWITH(IERR_INVALID_ARG);
   if (_ion_stream_can_write(stream) != TRUE) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_flush_helper(stream));  
+  ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_stream_flush_helper(stream));
   SUCCEED();
 
   iRETURN;
@@ -490,7 +735,13 @@ iERR ion_stream_close(ION_STREAM *stream)
   if (!stream) FAILWITH(IERR_INVALID_ARG);  
   
   if (_ion_stream_can_write(stream) == TRUE) {
-    IONCHECK(_ion_stream_flush_helper(stream));
+    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_stream_flush_helper(stream));
+  }
+  if (_ion_stream_is_mmap(stream) == TRUE) {
+    IONCHECK(_ion_stream_mmap_unmap(stream));
+  }
+  if (_ion_stream_is_push(stream) == TRUE) {
+    IONCHECK(_ion_stream_push_release(stream));
   }
 
   // clear the stream out so that it is invalid in case
@@ -538,6 +789,24 @@ BOOL ion_stream_can_seek( ION_STREAM *stream )
   return can_seek;
 }
 
+BOOL ion_stream_is_mmap( ION_STREAM *stream )
+{
+  BOOL is_mmap = FALSE;
+  if (stream) {
+    is_mmap = _ion_stream_is_mmap(stream);
+  }
+  return is_mmap;
+}
+
+BOOL ion_stream_is_push( ION_STREAM *stream )
+{
+  BOOL is_push = FALSE;
+  if (stream) {
+    is_push = _ion_stream_is_push(stream);
+  }
+  return is_push;
+}
+
 BOOL ion_stream_is_dirty( ION_STREAM *stream )
 {
   BOOL is_dirty = FALSE;
@@ -700,8 +969,9 @@ iERR ion_stream_unread_byte(ION_STREAM *stream, int c)
   // do we need to fetch a previous page?
   if (stream->_curr <= stream->_buffer) 
   {
-    if (stream->_offset == 0) {
-      // you can unread past the beginning of the file
+    if (stream->_offset == 0 || _ion_stream_is_push(stream)) {
+      // you can unread past the beginning of the file (a push stream
+      // drops what's been read when it's given more, so it starts there)
       if (c != EOF) {
           // but only when we're unreading an EOF
           FAILWITH(IERR_UNEXPECTED_EOF);
@@ -977,7 +1247,17 @@ iERR ion_stream_skip( ION_STREAM *stream, SIZE distance, SIZE *p_skipped)
 
   original_pos = target_pos = _ion_stream_position(stream);
   target_pos += distance;
-  IONCHECK(_ion_stream_fetch_position(stream, target_pos));
+  err = _ion_stream_fetch_position(stream, target_pos);
+  if (err == IERR_EOF && distance > 0) {
+    // fetching the target looks for the byte there, which isn't in the input
+    // when the skip ends the input, so fetch the byte before it and step past
+    // it, as reading it would
+    IONCHECK(_ion_stream_fetch_position(stream, target_pos - 1));
+    stream->_curr++;
+  }
+  else {
+    IONCHECK(err);
+  }
   actual_pos = _ion_stream_position(stream);
    
   ASSERT((actual_pos - original_pos) <= (POSITION)distance); // we should never overshoot
@@ -1136,7 +1416,15 @@ iERR _ion_stream_open_helper(ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM *
 
   user_buffer = IS_FLAG_ON(flags, FLAG_IS_USER_BUFFER);
   if (user_buffer) {
-    len = sizeof(ION_STREAM);
+    if (IS_FLAG_ON(flags, FLAG_IS_MMAP)) {
+      len = sizeof(ION_STREAM_MMAP);
+    }
+    else if (IS_FLAG_ON(flags, FLAG_IS_PUSH)) {
+      len = sizeof(ION_STREAM_PUSH);
+    }
+    else {
+      len = sizeof(ION_STREAM);
+    }
   }
   else {
     user_managed = IS_FLAG_ON(flags, FLAG_USER_HANDLING);
@@ -1184,6 +1472,45 @@ iERR _ion_stream_open_helper(ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM *
  iRETURN;
 }
 
+iERR _ion_stream_mmap_unmap(ION_STREAM *stream)
+{
+  iENTER;
+  ION_STREAM_MMAP *mapped;
+
+  ASSERT(_ion_stream_is_mmap(stream));
+
+  mapped = (ION_STREAM_MMAP *)stream;
+  if (mapped->_map_base) {
+#ifdef ION_PLATFORM_WINDOWS
+    if (!UnmapViewOfFile(mapped->_map_base)) FAILWITH(IERR_STREAM_FAILED);
+#else
+    if (munmap(mapped->_map_base, mapped->_map_length) != 0) FAILWITH(IERR_STREAM_FAILED);
+#endif
+  }
+  mapped->_map_base = NULL;
+  mapped->_map_length = 0;
+  SUCCEED();
+
+  iRETURN;
+}
+
+iERR _ion_stream_push_release(ION_STREAM *stream)
+{
+  iENTER;
+
+  ASSERT(_ion_stream_is_push(stream));
+
+  if (stream->_buffer) {
+    ion_xfree(stream->_buffer);
+  }
+  stream->_buffer = NULL;
+  stream->_curr = NULL;
+  stream->_limit = NULL;
+  SUCCEED();
+
+  iRETURN;
+}
+
 iERR _ion_stream_flush_helper(ION_STREAM *stream)
 {
   iENTER;
@@ -1197,6 +1524,7 @@ iERR _ion_stream_flush_helper(ION_STREAM *stream)
   
   if (_ion_stream_is_dirty(stream)) {
     if (_ion_stream_is_file_backed(stream)) {
+      ION_PERF_COUNT(bytes_written, stream->_dirty_length);
       // now we either write through the user handler, or directly to the file
       if (_ion_stream_is_user_controlled(stream)) {
         user_stream = &(((ION_STREAM_USER_PAGED *)stream)->_user_stream);
@@ -1334,6 +1662,21 @@ BOOL _ion_stream_is_caching( ION_STREAM *stream)
   BOOL   is_caching = _ion_stream_is_mark_open(stream) || _ion_stream_is_fully_buffered(stream);
   return is_caching;
 }
+BOOL _ion_stream_is_mmap( ION_STREAM *stream)
+{
+  BOOL   is_mmap = IS_FLAG_ON(STREAM_FLAGS(stream), FLAG_IS_MMAP);
+  return is_mmap;
+}
+BOOL _ion_stream_is_push( ION_STREAM *stream)
+{
+  BOOL   is_push = IS_FLAG_ON(STREAM_FLAGS(stream), FLAG_IS_PUSH);
+  return is_push;
+}
+BOOL _ion_stream_push_input_ended( ION_STREAM *stream)
+{
+  ASSERT(_ion_stream_is_push(stream));
+  return ((ION_STREAM_PUSH *)stream)->_input_ended;
+}
 FILE *_ion_stream_get_file_stream( ION_STREAM *stream )
 {
   FILE *fp;
@@ -1566,7 +1909,7 @@ iERR _ion_stream_fetch_fill_page( ION_STREAM *stream, ION_PAGE *page, POSITION t
         // we will read directly into the page buffer between these two pointers
         dst = &(page->_buf[end_buf_offset]);
         end = dst + bytes_needed_buffer;
-        IONCHECK(_ion_stream_fread( stream, dst, end, &local_bytes_read ));
+        ION_PERF_CHECK(ION_PERF_PHASE_READ, _ion_stream_fread( stream, dst, end, &local_bytes_read ));
         if (local_bytes_read < 0) {
             // the read functions return negative lengths for unusual read conditions
             if (local_bytes_read == READ_EOF_LENGTH) {
@@ -1724,7 +2067,7 @@ iERR _ion_stream_read_for_seek( ION_STREAM *stream, POSITION target_position )
 
         if (dst < end) {
             // read the bytes (this will check for the type of input as necessary)
-            IONCHECK(_ion_stream_fread( stream, dst, end, &bytes_read ));
+            ION_PERF_CHECK(ION_PERF_PHASE_READ, _ion_stream_fread( stream, dst, end, &bytes_read ));
             if (bytes_read < 0) {
                 if (bytes_read == READ_EOF_LENGTH) {
                     FAILWITH(IERR_EOF);
@@ -2091,7 +2434,7 @@ iERR _ion_stream_page_make_current(ION_STREAM_PAGED *paged, ION_PAGE *page)
 
   // if we have a dirty bytes, flush them out first
   if (_ion_stream_is_dirty(stream )) {
-    IONCHECK(_ion_stream_flush_helper(stream));
+    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_stream_flush_helper(stream));
   }
 
   // determine the fate of the current page (if there is one)
@@ -132,6 +132,8 @@ typedef uint32_t  ION_STREAM_FLAG;
 #define FLAG_IS_FD_BACKED       0x04000
 #define FLAG_BUFFER_ALL         0x08000
 #define FLAG_IS_USER_BUFFER     0x10000
+#define FLAG_IS_MMAP            0x20000
+#define FLAG_IS_PUSH            0x40000
 
 // the low order bits are "operational" flags that
 // may be turned on or off during runtime
@@ -148,6 +150,8 @@ typedef uint32_t  ION_STREAM_FLAG;
 #define ION_STREAM_STDERR       (FLAG_IS_FILE_BACKED |                  FLAG_CAN_WRITE                      | FLAG_IS_TTY)
 #define ION_STREAM_FILE_RW      (FLAG_IS_FILE_BACKED | FLAG_CAN_READ  | FLAG_CAN_WRITE | FLAG_RANDOM_ACCESS)
 #define ION_STREAM_USER_BUF     (FLAG_BUFFER_ALL     | FLAG_CAN_READ  | FLAG_CAN_WRITE | FLAG_RANDOM_ACCESS | FLAG_IS_USER_BUFFER)
+#define ION_STREAM_MMAP_IN      (FLAG_BUFFER_ALL     | FLAG_CAN_READ                   | FLAG_RANDOM_ACCESS | FLAG_IS_USER_BUFFER | FLAG_IS_MMAP)
+#define ION_STREAM_PUSH_IN      (FLAG_BUFFER_ALL     | FLAG_CAN_READ                   | FLAG_RANDOM_ACCESS | FLAG_IS_USER_BUFFER | FLAG_IS_PUSH)
 #define ION_STREAM_MEMORY_ONLY  (FLAG_BUFFER_ALL     | FLAG_CAN_READ  | FLAG_CAN_WRITE | FLAG_RANDOM_ACCESS )
 
 #define ION_STREAM_FD_IN        (FLAG_IS_FD_BACKED   | FLAG_CAN_READ                   | FLAG_RANDOM_ACCESS )
@@ -195,14 +199,27 @@ struct _ion_stream_paged // extends _ion_stream
   ION_PAGE         *_free_pages;  // list of allocated pages but unused pages 
   // the ION_INDEX is a hashed index which requires pages to all be the same 
   // size so that locations can be converted to page numbers functionally
-  ION_INDEX         _index;       // index into current pages by page_offset (9 ptrs, 6 int32's, 1 byte == 61 or 97 bytes)
-}; // ( 15 ptrs, 9 int32's, 1 byte = 97 - 157 bytes) which means it's probably still worth having the two structs
+  ION_INDEX         _index;       // index into current pages by page_offset (6 ptrs, 3 int32's, 1 byte == 37 or 61 bytes)
+}; // ( 12 ptrs, 6 int32's, 1 byte = 73 - 121 bytes) which means it's probably still worth having the two structs
 
 struct _ion_stream_user_paged // extends _ion_stream_paged
 {
   struct _ion_stream_paged _paged_base;
   struct _ion_user_stream  _user_stream;
-}; // (157 bytes + 4 ptrs) 
+}; // (121 bytes + 4 ptrs) 
+
+struct _ion_stream_mmap // extends _ion_stream
+{
+  ION_STREAM        _base;        // _buffer/_limit span the whole mapping, so it behaves as a read only user buffer
+  void             *_map_base;    // address returned by mmap, NULL for an empty file (nothing is mapped)
+  size_t            _map_length;  // length of the mapping, needed for munmap and madvise
+};
+
+struct _ion_stream_push // extends _ion_stream
+{
+  ION_STREAM        _base;        // _buffer is owned by the stream and holds the pushed bytes not yet consumed
+  BOOL              _input_ended; // set by ion_stream_push_eof, until then running out of bytes isn't EOF
+};
 
 struct _ion_page
 {
@@ -235,6 +252,8 @@ struct _ion_page
 
 iERR _ion_stream_open_helper( ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM **pp_stream );
 iERR _ion_stream_flush_helper( ION_STREAM *stream );
+iERR _ion_stream_mmap_unmap( ION_STREAM *stream );
+iERR _ion_stream_push_release( ION_STREAM *stream );
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -256,6 +275,9 @@ BOOL      _ion_stream_is_user_controlled  ( ION_STREAM *stream );
 BOOL      _ion_stream_is_paged            ( ION_STREAM *stream );
 BOOL      _ion_stream_is_fully_buffered   ( ION_STREAM *stream );
 BOOL      _ion_stream_is_caching          ( ION_STREAM *stream );
+BOOL      _ion_stream_is_mmap             ( ION_STREAM *stream );
+BOOL      _ion_stream_is_push             ( ION_STREAM *stream );
+BOOL      _ion_stream_push_input_ended    ( ION_STREAM *stream );
 
 FILE *    _ion_stream_get_file_stream     ( ION_STREAM *stream );
 POSITION  _ion_stream_get_mark_start      ( ION_STREAM *stream );
@@ -18,6 +18,7 @@
 //
 
 #include "ion_internal.h"
+#include "ion_atomic.h"
 #include <ctype.h>
 #include <string.h>
 //#include "hashfn.h"
@@ -32,6 +33,7 @@ struct _ion_symbol_table
 {
     void               *owner;          // this may be a reader, writer, catalog or itself
     BOOL                is_locked;
+    BOOL                is_frozen;      // locked, and shared between threads: lookups must not write to it or allocate on its owner
     BOOL                has_local_symbols;
     ION_STRING          name;
     int32_t             version;
@@ -255,8 +257,15 @@ iERR ion_symbol_table_get_system_table(hSYMTAB *p_hsystem_table, int32_t version
     iRETURN;
 }
 
-// HACK - TODO - hate this
-static THREAD_LOCAL_STORAGE ION_SYMBOL_TABLE *p_system_symbol_table_version_1 = NULL;
+// the system symbol table is immutable, so there's one of it for the
+// whole process. It's built the first time any thread asks for it; the
+// other threads that ask while it's being built wait for it.
+#define ION_SYSTEM_SYMBOL_TABLE_UNBUILT  0
+#define ION_SYSTEM_SYMBOL_TABLE_BUILDING 1
+#define ION_SYSTEM_SYMBOL_TABLE_BUILT    2
+
+static ION_ATOMIC_INT    g_system_symbol_table_version_1_state = ION_SYSTEM_SYMBOL_TABLE_UNBUILT;
+static ION_SYMBOL_TABLE *p_system_symbol_table_version_1 = NULL;
 
 iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_table, int32_t version)
 {
@@ -265,8 +274,16 @@ iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_tab
     ASSERT( pp_system_table != NULL );
     ASSERT( version == 1 ); // only one we understand at this point
 
-    if (!p_system_symbol_table_version_1) {
-        IONCHECK(_ion_symbol_table_local_make_system_symbol_table_helper(version));
+    while (ION_ATOMIC_LOAD(&g_system_symbol_table_version_1_state) != ION_SYSTEM_SYMBOL_TABLE_BUILT) {
+        if (ION_ATOMIC_CAS(&g_system_symbol_table_version_1_state, ION_SYSTEM_SYMBOL_TABLE_UNBUILT, ION_SYSTEM_SYMBOL_TABLE_BUILDING)) {
+            err = _ion_symbol_table_local_make_system_symbol_table_helper(version);
+            ION_ATOMIC_STORE(&g_system_symbol_table_version_1_state,
+                             (err == IERR_OK) ? ION_SYSTEM_SYMBOL_TABLE_BUILT : ION_SYSTEM_SYMBOL_TABLE_UNBUILT);
+            IONCHECK(err);
+        }
+        else {
+            ION_ATOMIC_PAUSE();
+        }
     }
     *pp_system_table = p_system_symbol_table_version_1;
 
@@ -276,7 +293,7 @@ iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_tab
 
 // currently the system symbol table uses 1304 bytes or so
 #define kIonSystemSymbolMemorySize 2048
-static THREAD_LOCAL_STORAGE char gSystemSymbolMemory[kIonSystemSymbolMemorySize];
+static char gSystemSymbolMemory[kIonSystemSymbolMemorySize];
 
 void* smallLocalAllocationBlock()
 {
@@ -295,6 +312,7 @@ void* smallLocalAllocationBlock()
 }
 
 // HACK - hate this
+// only called by the thread that moved the system table's state to BUILDING
 iERR _ion_symbol_table_local_make_system_symbol_table_helper(int32_t version)
 {
     iENTER;
@@ -323,10 +341,9 @@ iERR _ion_symbol_table_local_make_system_symbol_table_helper(int32_t version)
     IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_MAX_ID_STRING, ION_SYS_SID_MAX_ID, NULL));
     IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_SHARED_SYMBOL_TABLE_STRING, ION_SYS_SID_SHARED_SYMBOL_TABLE, NULL));
 
-    IONCHECK(_ion_symbol_table_lock_helper(psymtab));
+    // every thread shares it from here on
+    IONCHECK(_ion_symbol_table_freeze_helper(psymtab));
 
-    // TODO: THREADING - THIS ASSIGNMENT NEEDS TO BE MAKE THREAD SAFE !!
-    // but we only need 1 copy of each system symbol table (the system symbol table)
     p_system_symbol_table_version_1 = psymtab;
 
     iRETURN;
@@ -461,7 +478,7 @@ iERR ion_symbol_table_load(hREADER hreader, hOWNER owner, hSYMTAB *p_hsymtab)
     preader = HANDLE_TO_PTR(hreader, ION_READER);
 
     IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
-    IONCHECK(_ion_symbol_table_load_helper(preader, owner, system, &psymtab));
+    ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_load_helper(preader, owner, system, &psymtab));
 
     *p_hsymtab = PTR_TO_HANDLE(psymtab);
 
@@ -810,6 +827,9 @@ iERR ion_symbol_table_lock(hSYMTAB hsymtab)
 iERR _ion_symbol_table_lock_helper(ION_SYMBOL_TABLE *symtab)
 {
     iENTER;
+    ION_COLLECTION_CURSOR symbol_cursor;
+    ION_SYMBOL           *sym;
+
     ASSERT(symtab != NULL);
     if (symtab->is_locked) SUCCEED();
 
@@ -817,11 +837,45 @@ iERR _ion_symbol_table_lock_helper(ION_SYMBOL_TABLE *symtab)
         IONCHECK(_ion_symbol_table_initialize_indices_helper(symtab));
     }
 
+    if (!ION_STRING_IS_NULL(&symtab->name)) {
+        // the symbols of a shared table know where they came from; set that
+        // now, so that finding them later doesn't have to write to the table
+        ION_COLLECTION_OPEN(&symtab->symbols, symbol_cursor);
+        for (;;) {
+            ION_COLLECTION_NEXT(symbol_cursor, sym);
+            if (!sym) break;
+            ION_STRING_ASSIGN(&sym->import_location.name, &symtab->name);
+            sym->import_location.location = sym->sid;
+        }
+        ION_COLLECTION_CLOSE(symbol_cursor);
+    }
+
     symtab->is_locked = TRUE;
 
     iRETURN;;
 }
 
+iERR _ion_symbol_table_freeze_helper(ION_SYMBOL_TABLE *symtab)
+{
+    iENTER;
+    ASSERT(symtab != NULL);
+
+    IONCHECK(_ion_symbol_table_lock_helper(symtab));
+    symtab->is_frozen = TRUE;
+
+    iRETURN;
+}
+
+iERR _ion_symbol_table_is_frozen_helper(ION_SYMBOL_TABLE *symtab, BOOL *p_is_frozen)
+{
+    ASSERT(symtab != NULL);
+    ASSERT(p_is_frozen != NULL);
+
+    *p_is_frozen = symtab->is_frozen;
+
+    return IERR_OK;
+}
+
 iERR ion_symbol_table_is_locked(hSYMTAB hsymtab, BOOL *p_is_locked)
 {
     iENTER;
@@ -1336,7 +1390,7 @@ iERR ion_symbol_table_find_by_name(hSYMTAB hsymtab, iSTRING name, SID *p_sid)
     iRETURN;
 }
 
-iERR _ion_symbol_table_parse_possible_symbol_identifier(ION_SYMBOL_TABLE *symtab, ION_STRING *name, SID *p_sid, ION_SYMBOL **p_sym, BOOL *p_is_symbol_identifier) {
+iERR _ion_symbol_table_parse_possible_symbol_identifier(ION_SYMBOL_TABLE *symtab, ION_STRING *name, SID *p_sid, ION_SYMBOL **p_sym, BOOL *p_is_symbol_identifier, hOWNER owner) {
     iENTER;
     SID sid = UNKNOWN_SID;
     ION_SYMBOL *sym = NULL;
@@ -1363,11 +1417,11 @@ iERR _ion_symbol_table_parse_possible_symbol_identifier(ION_SYMBOL_TABLE *symtab
         if (sid == 0 || sid > symtab->max_id) {
             // SID 0 is not in any symbol table, but is available in all symbol table contexts.
             // If the requested SID is out of range for the current symtab context, an error will be raised when the
-            // user retrieves the symbol token.
-            _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
+            // user retrieves the symbol token. The symbol belongs to the caller, symtab may be shared.
+            _ion_symbol_table_allocate_symbol_unknown_text(owner, sid, &sym);
         }
         else if (p_sym) {
-            IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, &sym));
+            IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, owner, &sym));
             ASSERT(sym != NULL); // This SID is within range. It MUST have a non-NULL symbol.
             if (ION_STRING_IS_NULL(&sym->value) && ION_SYMBOL_IMPORT_LOCATION_IS_NULL(sym) && sym->sid >= symtab->min_local_id) {
                 // This is a local symbol with unknown text, which is equivalent to symbol zero.
@@ -1401,14 +1455,14 @@ iERR _ion_symbol_table_find_by_name_helper(ION_SYMBOL_TABLE *symtab, ION_STRING
     ASSERT(p_sid != NULL);
 
     if (symbol_identifiers_as_sids) {
-        IONCHECK(_ion_symbol_table_parse_possible_symbol_identifier(symtab, name, &sid, &sym, &is_symbol_identifier));
+        IONCHECK(_ion_symbol_table_parse_possible_symbol_identifier(symtab, name, &sid, &sym, &is_symbol_identifier, symtab->owner));
         if (is_symbol_identifier) {
             goto done;
         }
     }
 
     // first we check the system symbol table, if there is one
-   IONCHECK(_ion_symbol_table_local_find_by_name(symtab->system_symbol_table, name, &sid, &sym));
+   ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_name(symtab->system_symbol_table, name, &sid, &sym));
 
     // first we have to look in the imported tables
     if (sid == UNKNOWN_SID && !ION_COLLECTION_IS_EMPTY(&symtab->import_list)) {
@@ -1421,7 +1475,7 @@ iERR _ion_symbol_table_find_by_name_helper(ION_SYMBOL_TABLE *symtab, ION_STRING
             imported = imp->shared_symbol_table;
             // If the import is not found, skip it -- its symbols have unknown text and therefore cannot be looked up by name.
             if (imported != NULL) {
-                IONCHECK(_ion_symbol_table_local_find_by_name(imported, name, &sid, &sym));
+                ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_name(imported, name, &sid, &sym));
                 if (sid > imp->descriptor.max_id) sid = UNKNOWN_SID;
                 if (sid != UNKNOWN_SID) {
                     sid += offset;
@@ -1435,7 +1489,7 @@ iERR _ion_symbol_table_find_by_name_helper(ION_SYMBOL_TABLE *symtab, ION_STRING
 
     // and last we look in the local table itself
     if (sid == UNKNOWN_SID) {
-        IONCHECK(_ion_symbol_table_local_find_by_name(symtab, name, &sid, &sym));
+        ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_name(symtab, name, &sid, &sym));
     }
 
 done:
@@ -1476,8 +1530,9 @@ iERR _ion_symbol_table_local_find_by_sid(ION_SYMBOL_TABLE *symtab, SID sid, ION_
         }
 
     }
-    if (sym && !ION_STRING_IS_NULL(&symtab->name)) {
-        // The symbol is found and this is a shared symbol table. Set the import location.
+    if (sym && !ION_STRING_IS_NULL(&symtab->name) && ION_STRING_IS_NULL(&sym->import_location.name)) {
+        // The symbol is found and this is a shared symbol table. Set the import location, unless the table was
+        // locked, which already set it (see _ion_symbol_table_lock_helper).
         ION_STRING_ASSIGN(&sym->import_location.name, &symtab->name);
         sym->import_location.location = sid;
     }
@@ -1506,13 +1561,14 @@ iERR ion_symbol_table_find_by_sid(hSYMTAB hsymtab, SID sid, iSTRING *p_name)
     iRETURN;
 }
 
-iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, ION_SYMBOL **p_sym)
+iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, hOWNER owner, ION_SYMBOL **p_sym)
 {
     iENTER;
     ION_SYMBOL              *sym = NULL;
     ION_SYMBOL_TABLE        *imported;
     ION_SYMBOL_TABLE_IMPORT *imp;
     ION_COLLECTION_CURSOR    import_cursor;
+    hOWNER                   symbol_owner;
     int32_t                  offset;
 
     ASSERT(symtab != NULL);
@@ -1521,7 +1577,7 @@ iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID s
 
     if (ION_STRING_IS_NULL(&symtab->name) && sid <= symtab->system_symbol_table->max_id) {
         // Only local symbol tables implicitly import the system symbol table. Shared symbol table SIDs start at 1.
-        IONCHECK(_ion_symbol_table_local_find_by_sid(symtab->system_symbol_table, sid, &sym));
+        ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_sid(symtab->system_symbol_table, sid, &sym));
     }
     else {
         if (!ION_COLLECTION_IS_EMPTY(&symtab->import_list)) {
@@ -1534,16 +1590,20 @@ iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID s
                 if (sid - offset <= imp->descriptor.max_id) {
                     imported = imp->shared_symbol_table;
                     if (imported != NULL) {
-                        IONCHECK(_ion_symbol_table_local_find_by_sid(imported, sid - offset, &sym));
+                        ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_sid(imported, sid - offset, &sym));
                     }
                     if (sym == NULL) {
                         // The SID is in range, but either the shared symbol table is not found, or the SID refers to a
-                        // NULL slot in the shared symbol table. This symbol has unknown text.
-                        _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
-                        ION_STRING_ASSIGN(&sym->import_location.name, &imp->descriptor.name);
-                        sym->import_location.location = sid - offset;
+                        // NULL slot in the shared symbol table. This symbol has unknown text. A frozen table can't
+                        // allocate it (other threads are reading it), so it goes to the caller's owner, if any.
+                        symbol_owner = symtab->is_frozen ? owner : symtab->owner;
+                        if (symbol_owner != NULL) {
+                            _ion_symbol_table_allocate_symbol_unknown_text(symbol_owner, sid, &sym);
+                            ION_STRING_ASSIGN(&sym->import_location.name, &imp->descriptor.name);
+                            sym->import_location.location = sid - offset;
+                        }
                     }
-                    ASSERT(sym);
+                    ASSERT(sym || (symtab->is_frozen && owner == NULL));
                     break;
                 }
                 offset += imp->descriptor.max_id;
@@ -1551,7 +1611,7 @@ iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID s
             ION_COLLECTION_CLOSE(import_cursor);
         }
         if (sym == NULL) {
-            IONCHECK(_ion_symbol_table_local_find_by_sid(symtab, sid, &sym));
+            ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_find_by_sid(symtab, sid, &sym));
         }
     }
 
@@ -1570,7 +1630,7 @@ iERR _ion_symbol_table_find_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, ION
 
     *p_name = NULL;
 
-    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, &sym));
+    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, NULL, &sym));
     if (sym != NULL) {
         *p_name = &sym->value;
         SUCCEED();
@@ -1671,7 +1731,7 @@ iERR ion_symbol_table_get_symbol(hSYMTAB hsymtab, SID sid, ION_SYMBOL **p_sym)
     if (sid < UNKNOWN_SID || sid > symtab->max_id) FAILWITH(IERR_INVALID_ARG);
     if (!p_sym) FAILWITH(IERR_INVALID_ARG);
 
-    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, &sym));
+    IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, NULL, &sym));
     *p_sym = sym;
 
     iRETURN;
@@ -1728,7 +1788,7 @@ iERR _ion_symbol_table_add_symbol_helper(ION_SYMBOL_TABLE *symtab, ION_STRING *n
 
         // we'll assign this symbol to the next id (_add_ will update max_id for us)
         sid = symtab->max_id + 1;
-        IONCHECK(_ion_symbol_table_local_add_symbol_helper(symtab, name, sid, &sym));
+        ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_add_symbol_helper(symtab, name, sid, &sym));
     }
 
     if (sym) sym->add_count++;
@@ -2144,30 +2204,11 @@ int_fast8_t  _ion_symbol_table_compare_fn(void *key1, void *key2, void *context)
 
 int_fast32_t _ion_symbol_table_hash_fn(void *key, void *context)
 {
-    ION_SYMBOL  *sym = (ION_SYMBOL *)key;
-    int_fast32_t hash;
-    int len;
-    BYTE *cb;
-    
+    ION_SYMBOL *sym = (ION_SYMBOL *)key;
+
     ASSERT(sym);
-    
-#if 0
-    hash = hashfn_mem(sym->value.value, sym->value.length);
-    return hash;
-#else
-    hash = 0;
-    len = sym->value.length;
-    cb = sym->value.value;
-    
-    while (len)
-    {
-        hash = *cb + (hash << 6) + (hash << 16) - hash;
-        ++cb;
-        --len;
-    }
-    // the previous hash function was only returning 24 bits.
-    return hash & 0x00FFFFFF;
-#endif
+
+    return _ion_index_hash_bytes(sym->value.value, sym->value.length);
 }
 
 iERR _ion_symbol_table_index_insert_helper(ION_SYMBOL_TABLE *symtab, ION_SYMBOL *sym) 
@@ -25,7 +25,7 @@
 iERR ion_writer_options_initialize_shared_imports(ION_WRITER_OPTIONS *options)
 {
     iENTER;
-    hOWNER owner = ion_alloc_owner(sizeof(int)); // Dummy allocation to create an owning pool for the collection.
+    hOWNER owner = ion_alloc_owner_with_allocator(sizeof(int), options->allocator); // Dummy allocation to create an owning pool for the collection.
     if (owner == NULL) FAILWITH(IERR_NO_MEMORY);
     _ion_collection_initialize(owner, &options->encoding_psymbol_table, sizeof(ION_SYMBOL_TABLE_IMPORT));
     iRETURN;
@@ -247,7 +247,7 @@ iERR _ion_writer_open_helper(ION_WRITER **p_pwriter, ION_STREAM *stream, ION_WRI
     ION_WRITER         *pwriter = NULL;
     ION_OBJ_TYPE        writer_type;
 
-    pwriter = ion_alloc_owner(sizeof(ION_WRITER));
+    pwriter = ion_alloc_owner_with_allocator(sizeof(ION_WRITER), p_options ? p_options->allocator : NULL);
     if (!pwriter) FAILWITH(IERR_NO_MEMORY);
     *p_pwriter = pwriter;
 
@@ -1348,15 +1348,16 @@ iERR _ion_writer_write_typed_null_helper(ION_WRITER *pwriter, ION_TYPE type)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_typed_null(pwriter, type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_typed_null(pwriter, type));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_typed_null(pwriter, type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_typed_null(pwriter, type));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, type);
     iRETURN;
 }
 
@@ -1383,15 +1384,16 @@ iERR _ion_writer_write_bool_helper(ION_WRITER *pwriter, BOOL value)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_bool(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_bool(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_bool(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_bool(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_BOOL);
     iRETURN;
 }
 
@@ -1478,15 +1480,16 @@ iERR _ion_writer_write_int64_helper(ION_WRITER *pwriter, int64_t value)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_int64(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_int64(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_int64(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_int64(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_INT);
     iRETURN;
 }
 
@@ -1512,15 +1515,16 @@ iERR _ion_writer_write_ion_int_helper(ION_WRITER *pwriter, ION_INT *value) {
 
     switch (pwriter->type) {
         case ion_type_text_writer:
-            IONCHECK(_ion_writer_text_write_ion_int(pwriter, value));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_ion_int(pwriter, value));
             break;
         case ion_type_binary_writer:
-            IONCHECK(_ion_writer_binary_write_ion_int(pwriter, value));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_ion_int(pwriter, value));
             break;
         default:
             FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_INT);
     iRETURN;
 }
 
@@ -1533,24 +1537,25 @@ iERR _ion_writer_write_mixed_int_helper(ION_WRITER *pwriter, ION_READER *preader
     switch (pwriter->type) {
     case ion_type_text_writer:
         if (preader->_int_helper._is_ion_int) {
-            IONCHECK(_ion_writer_text_write_ion_int(pwriter, &preader->_int_helper._as_ion_int));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_ion_int(pwriter, &preader->_int_helper._as_ion_int));
         }
         else {
-            IONCHECK(_ion_writer_text_write_int64(pwriter, preader->_int_helper._as_int64));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_int64(pwriter, preader->_int_helper._as_int64));
         }
         break;
     case ion_type_binary_writer:
         if (preader->_int_helper._is_ion_int) {
-            IONCHECK(_ion_writer_binary_write_ion_int(pwriter, &preader->_int_helper._as_ion_int));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_ion_int(pwriter, &preader->_int_helper._as_ion_int));
         }
         else {
-            IONCHECK(_ion_writer_binary_write_int64(pwriter, preader->_int_helper._as_int64));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_int64(pwriter, preader->_int_helper._as_int64));
         }
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_INT);
     iRETURN;
 }
 
@@ -1592,15 +1597,16 @@ iERR _ion_writer_write_float_helper(ION_WRITER *pwriter, float value)
     switch (pwriter->type) {
     case ion_type_text_writer:
         // We can defer text writing to the double implementation
-        IONCHECK(_ion_writer_text_write_double(pwriter, (double)value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_double(pwriter, (double)value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_float(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_float(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_FLOAT);
     iRETURN;
 }
 
@@ -1633,15 +1639,107 @@ iERR _ion_writer_write_double_helper(ION_WRITER *pwriter, double value)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_double(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_double(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_double(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_double(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_FLOAT);
+    iRETURN;
+}
+
+iERR ion_writer_write_int64_array(hWRITER hwriter, ION_TYPE container_type, int64_t *p_values, SIZE count)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if ((!p_values && count > 0) || count < 0) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_write_array_helper(pwriter, container_type, tid_INT, p_values, count));
+
+    iRETURN;
+}
+
+iERR ion_writer_write_double_array(hWRITER hwriter, ION_TYPE container_type, double *p_values, SIZE count)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if ((!p_values && count > 0) || count < 0) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_write_array_helper(pwriter, container_type, tid_FLOAT, p_values, count));
+
+    iRETURN;
+}
+
+iERR ion_writer_write_bool_array(hWRITER hwriter, ION_TYPE container_type, BOOL *p_values, SIZE count)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if ((!p_values && count > 0) || count < 0) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_write_array_helper(pwriter, container_type, tid_BOOL, p_values, count));
+
+    iRETURN;
+}
+
+iERR _ion_writer_write_array_helper(ION_WRITER *pwriter, ION_TYPE container_type, ION_TYPE element_type, void *p_values, SIZE count)
+{
+    iENTER;
+    hWRITER hwriter;
+    SIZE    ii;
+    BOOL    written = FALSE;
+
+    ASSERT(pwriter);
+
+    if (container_type != tid_LIST && container_type != tid_SEXP) FAILWITH(IERR_INVALID_ARG);
+
+    // the binary writer encodes the whole container at once, unless a symbol
+    // table is being intercepted or the floats might have to be compacted,
+    // which the value by value path below takes care of
+    if (pwriter->type == ion_type_binary_writer
+     && pwriter->_current_symtab_intercept_state == iWSIS_NONE
+     && !(element_type == tid_FLOAT && pwriter->options.compact_floats)
+    ) {
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_array(pwriter, container_type, element_type,
+                                                                            p_values, count, &written));
+        if (written) {
+            ION_PERF_COUNT_VALUE(values_written, container_type);
+            ION_PERF_COUNT_VALUES(values_written, element_type, count);
+            SUCCEED();
+        }
+    }
+
+    hwriter = PTR_TO_HANDLE(pwriter);
+    IONCHECK(ion_writer_start_container(hwriter, container_type));
+    for (ii = 0; ii < count; ii++) {
+        switch (ION_TYPE_INT(element_type)) {
+        case tid_INT_INT:
+            IONCHECK(ion_writer_write_int64(hwriter, ((int64_t *)p_values)[ii]));
+            break;
+        case tid_FLOAT_INT:
+            IONCHECK(ion_writer_write_double(hwriter, ((double *)p_values)[ii]));
+            break;
+        case tid_BOOL_INT:
+            IONCHECK(ion_writer_write_bool(hwriter, ((BOOL *)p_values)[ii]));
+            break;
+        default:
+            FAILWITH(IERR_INVALID_ARG);
+        }
+    }
+    IONCHECK(ion_writer_finish_container(hwriter));
+
     iRETURN;
 }
 
@@ -1668,15 +1766,16 @@ iERR _ion_writer_write_decimal_helper(ION_WRITER *pwriter, decQuad *value)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_decimal_quad(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_decimal_quad(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_decimal_quad(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_decimal_quad(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_DECIMAL);
     iRETURN;
 }
 
@@ -1705,11 +1804,11 @@ iERR _ion_writer_write_ion_decimal_helper(ION_WRITER *pwriter, ION_DECIMAL *valu
         case ion_type_text_writer:
             switch(value->type) {
                 case ION_DECIMAL_TYPE_QUAD:
-                    IONCHECK(_ion_writer_text_write_decimal_quad(pwriter, &value->value.quad_value));
+                    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_decimal_quad(pwriter, &value->value.quad_value));
                     break;
                 case ION_DECIMAL_TYPE_NUMBER_OWNED:
                 case ION_DECIMAL_TYPE_NUMBER:
-                    IONCHECK(_ion_writer_text_write_decimal_number(pwriter, value->value.num_value));
+                    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_decimal_number(pwriter, value->value.num_value));
                     break;
                 default:
                     FAILWITH(IERR_INVALID_STATE);
@@ -1718,11 +1817,11 @@ iERR _ion_writer_write_ion_decimal_helper(ION_WRITER *pwriter, ION_DECIMAL *valu
         case ion_type_binary_writer:
             switch(value->type) {
                 case ION_DECIMAL_TYPE_QUAD:
-                    IONCHECK(_ion_writer_binary_write_decimal_quad(pwriter, &value->value.quad_value));
+                    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_decimal_quad(pwriter, &value->value.quad_value));
                     break;
                 case ION_DECIMAL_TYPE_NUMBER_OWNED:
                 case ION_DECIMAL_TYPE_NUMBER:
-                    IONCHECK(_ion_writer_binary_write_decimal_number(pwriter, value->value.num_value));
+                    ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_decimal_number(pwriter, value->value.num_value));
                     break;
                 default:
                 FAILWITH(IERR_INVALID_STATE);
@@ -1732,6 +1831,7 @@ iERR _ion_writer_write_ion_decimal_helper(ION_WRITER *pwriter, ION_DECIMAL *valu
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_DECIMAL);
     iRETURN;
 }
 
@@ -1758,15 +1858,16 @@ iERR _ion_writer_write_timestamp_helper(ION_WRITER *pwriter, ION_TIMESTAMP *valu
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_timestamp(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_timestamp(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_timestamp(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_timestamp(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_TIMESTAMP);
     iRETURN;
 }
 
@@ -1833,15 +1934,16 @@ iERR _ion_writer_write_symbol_id_helper(ION_WRITER *pwriter, SID value)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_symbol_id(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_symbol_id(pwriter, value));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_symbol_id(pwriter, value));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_symbol_id(pwriter, value));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_SYMBOL);
     iRETURN;
 }
 
@@ -1869,15 +1971,16 @@ iERR _ion_writer_write_symbol_helper(ION_WRITER *pwriter, ION_STRING *symbol)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_symbol(pwriter, symbol));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_symbol(pwriter, symbol));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_symbol(pwriter, symbol));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_symbol(pwriter, symbol));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_SYMBOL);
     iRETURN;
 }
 
@@ -1966,7 +2069,8 @@ iERR _ion_writer_intercept_name_or_symbols(ION_WRITER *pwriter, ION_STRING *pstr
         case iWSIS_IN_SYMBOLS_LIST:
             ASSERT(pwriter->depth == 2);
             IONCHECK(_ion_symbol_table_get_max_sid_helper(pwriter->_pending_symbol_table, &max_id));
-            IONCHECK(_ion_symbol_table_local_add_symbol_helper(pwriter->_pending_symbol_table, pstr, max_id + 1, NULL));
+            ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_add_symbol_helper(pwriter->_pending_symbol_table,
+                                                                                             pstr, max_id + 1, NULL));
             break;
         case iWSIS_IMPORT_NAME:
             IONCHECK(_ion_writer_intercept_import_name(pwriter, pstr));
@@ -1998,15 +2102,16 @@ iERR _ion_writer_write_string_helper(ION_WRITER *pwriter, ION_STRING *pstr)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_string(pwriter, pstr));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_string(pwriter, pstr));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_string(pwriter, pstr));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_string(pwriter, pstr));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_STRING);
     iRETURN;
 }
 
@@ -2037,15 +2142,16 @@ iERR _ion_writer_write_clob_helper(ION_WRITER *pwriter, BYTE *p_buf, SIZE length
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_clob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_clob(pwriter, p_buf, length));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_clob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_clob(pwriter, p_buf, length));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_CLOB);
     iRETURN;
 }
 
@@ -2076,15 +2182,16 @@ iERR _ion_writer_write_blob_helper(ION_WRITER *pwriter, BYTE *p_buf, SIZE length
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_write_blob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_write_blob(pwriter, p_buf, length));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_write_blob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_blob(pwriter, p_buf, length));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, tid_BLOB);
     iRETURN;
 }
 
@@ -2113,15 +2220,16 @@ iERR _ion_writer_start_lob_helper(ION_WRITER *pwriter, ION_TYPE lob_type)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_start_lob(pwriter, lob_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_start_lob(pwriter, lob_type));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_start_lob(pwriter, lob_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_start_lob(pwriter, lob_type));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
 
+    ION_PERF_COUNT_VALUE(values_written, lob_type);
     iRETURN;
 }
 
@@ -2152,10 +2260,10 @@ iERR _ion_writer_append_lob_helper(ION_WRITER *pwriter, BYTE *p_buf, SIZE length
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_append_lob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_append_lob(pwriter, p_buf, length));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_append_lob(pwriter, p_buf, length));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_append_lob(pwriter, p_buf, length));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
@@ -2187,10 +2295,10 @@ iERR _ion_writer_finish_lob_helper(ION_WRITER *pwriter)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_finish_lob(pwriter));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_finish_lob(pwriter));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_finish_lob(pwriter));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_finish_lob(pwriter));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
@@ -2215,7 +2323,7 @@ iERR _ion_writer_transition_to_symtab_intercept_state(ION_WRITER *pwriter, ION_T
                     ASSERT(pwriter->_completed_symtab_intercept_states == 0);
                     pwriter->_current_symtab_intercept_state = iWSIS_IN_LST_STRUCT;
                     ASSERT(pwriter->_pending_symbol_table == NULL && pwriter->_pending_temp_entity_pool == NULL);
-                    pwriter->_pending_temp_entity_pool = ion_alloc_owner(sizeof(int)); // this is a fake allocation to hold the pool
+                    pwriter->_pending_temp_entity_pool = ion_alloc_owner_like(sizeof(int), pwriter); // this is a fake allocation to hold the pool
                     if (pwriter->_pending_temp_entity_pool == NULL) {
                         FAILWITH(IERR_NO_MEMORY);
                     }
@@ -2288,15 +2396,16 @@ iERR _ion_writer_start_container_helper(ION_WRITER *pwriter, ION_TYPE container_
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_start_container(pwriter, container_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_start_container(pwriter, container_type));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_start_container(pwriter, container_type));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_start_container(pwriter, container_type));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
     }
     pwriter->depth++;
+    ION_PERF_COUNT_VALUE(values_written, container_type);
     iRETURN;
 }
 
@@ -2343,7 +2452,9 @@ iERR _ion_writer_symbol_table_append(ION_WRITER *pwriter)
             ION_COLLECTION_NEXT(symbol_cursor, symbol_to_append);
             if (!symbol_to_append) break;
             IONCHECK(_ion_symbol_table_get_max_sid_helper(pwriter->symbol_table, &max_id));
-            IONCHECK(_ion_symbol_table_local_add_symbol_helper(pwriter->symbol_table, &symbol_to_append->value, max_id + 1, NULL));
+            ION_PERF_CHECK(ION_PERF_PHASE_SYMBOLS, _ion_symbol_table_local_add_symbol_helper(pwriter->symbol_table,
+                                                                                             &symbol_to_append->value,
+                                                                                             max_id + 1, NULL));
         }
         ION_COLLECTION_CLOSE(symbol_cursor);
     }
@@ -2450,10 +2561,10 @@ iERR _ion_writer_finish_container_helper(ION_WRITER *pwriter)
 
     switch (pwriter->type) {
     case ion_type_text_writer:
-        IONCHECK(_ion_writer_text_finish_container(pwriter));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_text_finish_container(pwriter));
         break;
     case ion_type_binary_writer:
-        IONCHECK(_ion_writer_binary_finish_container(pwriter));
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_finish_container(pwriter));
         break;
     default:
         FAILWITH(IERR_INVALID_ARG);
@@ -2513,7 +2624,7 @@ iERR _ion_writer_write_one_value_helper(ION_WRITER *pwriter, ION_READER *preader
     ION_STRING    string_value;
     ION_SYMBOL    symbol_value, *fld_name;
     int32_t       count, ii;
-    BOOL          is_null, bool_value, is_in_struct;
+    BOOL          is_null, bool_value, is_in_struct, copied;
     double        double_value;
     ION_DECIMAL   decimal_value;
     ION_TIMESTAMP timestamp_value;
@@ -2585,6 +2696,18 @@ iERR _ion_writer_write_one_value_helper(ION_WRITER *pwriter, ION_READER *preader
         FAILWITH(IERR_INVALID_STATE);
     }
 
+    if (pwriter->type == ion_type_binary_writer
+     && preader->type == ion_type_binary_reader
+     && preader->options.return_system_values == FALSE
+    ) {
+        // binary to binary, try to just copy the bytes
+        ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_write_one_value(pwriter, preader, &copied));
+        if (copied) {
+            ION_PERF_COUNT_VALUE(values_written, type);
+            SUCCEED();
+        }
+    }
+
     switch((intptr_t)type) {
     case (intptr_t)tid_BOOL:
         IONCHECK(_ion_reader_read_bool_helper(preader, &bool_value));
@@ -2772,7 +2895,7 @@ iERR _ion_writer_flush_helper(ION_WRITER *pwriter, SIZE *p_bytes_flushed)
         }
         start =  ion_stream_get_position(pwriter->output);
         if (pwriter->depth == 0) {
-            IONCHECK(_ion_writer_binary_flush_to_output(pwriter));
+            ION_PERF_CHECK(ION_PERF_PHASE_WRITE, _ion_writer_binary_flush_to_output(pwriter));
             IONCHECK(ion_temp_buffer_reset(&pwriter->temp_buffer));
         }
         finish = ion_stream_get_position(pwriter->output);
@@ -3242,7 +3365,7 @@ iERR _ion_writer_allocate_temp_pool( ION_WRITER *pwriter )
     iENTER;
     void *temp_owner;
 
-    temp_owner = ion_alloc_owner(sizeof(int)); // this is a fake allocation to hold the pool
+    temp_owner = ion_alloc_owner_like(sizeof(int), pwriter); // this is a fake allocation to hold the pool
     if (temp_owner == NULL) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -3264,10 +3387,16 @@ iERR _ion_writer_reset_temp_pool( ION_WRITER *pwriter )
 iERR _ion_writer_free_temp_pool( ION_WRITER *pwriter )
 {
     iENTER;
+    int ii;
 
     if ((pwriter->_temp_entity_pool != NULL)) {
         ion_free_owner( pwriter->_temp_entity_pool );
         pwriter->_temp_entity_pool = NULL;
+        // the annotations' text was copied into the pool, and ion_strdup
+        // would copy the next annotation over it if it were left in place
+        for (ii = 0; pwriter->annotations && ii < pwriter->annotation_count; ii++) {
+            ION_STRING_INIT(&pwriter->annotations[ii].value);
+        }
     }
     SUCCEED();
 
@@ -63,6 +63,11 @@
 //      }
 //      while (next patch || next_value_buffer) 
 //  
+//  with the pad_container_lengths option a collection's header is written
+//  into the value buffers when it starts, with a fixed width (zero padded)
+//  length that is filled in when it's popped. Its patch only lives while
+//  the collection is open, so the write is a single copy of the values.
+//
 
 #include <decNumber/decNumber.h>
 #include "ion_internal.h"
@@ -70,6 +75,7 @@
 
 
 #define LOCAL_STACK_BUFFER_SIZE 256
+#define ARRAY_ENCODE_BUFFER_SIZE 4096
 
 iERR _ion_writer_binary_initialize(ION_WRITER *pwriter) 
 {
@@ -103,12 +109,27 @@ iERR _ion_writer_binary_push_position(ION_WRITER *pwriter, int type_id)
     iENTER;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
     ION_BINARY_PATCH  *patch, **ppatch;
+    ION_STREAM        *ostream;
+    int                ii;
 
     // first we create a new patch at the end of the patch list
     patch = (ION_BINARY_PATCH *)_ion_collection_append(&bwriter->_patch_list);
     patch->_length = 0;
     patch->_offset = (int)ion_stream_get_position(bwriter->_value_stream);   // TODO - this needs 64bit care
     patch->_type   = type_id;
+
+    if (pwriter->options.pad_container_lengths) {
+        // write the header now, with room for the length which _ion_writer_binary_pop
+        // fills in. The caller has already counted the td byte against our parent.
+        ostream = bwriter->_value_stream;
+        ION_PUT(ostream, makeTypeDescriptor(type_id, ION_lnIsVarLen));
+        for (ii = 0; ii < ION_BINARY_PADDED_LENGTH_WIDTH; ii++) {
+            ION_PUT(ostream, (ii == ION_BINARY_PADDED_LENGTH_WIDTH - 1) ? 0x80 : 0x00);
+            // the value stream keeps all its pages until it's flushed, so this stays put
+            patch->_reserved[ii] = ostream->_curr - 1;
+        }
+        IONCHECK( _ion_writer_binary_patch_lengths( pwriter, ION_BINARY_PADDED_LENGTH_WIDTH ));
+    }
     
     // then we push a pointer to the patch onto our active stack
     ppatch = (ION_BINARY_PATCH **)_ion_collection_push(&bwriter->_patch_stack);
@@ -135,7 +156,13 @@ iERR _ion_writer_binary_pop(ION_WRITER *pwriter)
     ppatch = (ION_BINARY_PATCH **)_ion_collection_head( &bwriter->_patch_stack);
 
     patch_down = (*ppatch)->_length;
-    if (patch_down >= ION_lnIsVarLen) {
+    if (pwriter->options.pad_container_lengths) {
+        // the header was written (and counted) up front, so only the length is left.
+        // Open patches nest, so this one is always the last on the patch list.
+        IONCHECK( _ion_writer_binary_fill_length( *ppatch ));
+        _ion_collection_pop_tail( &bwriter->_patch_list );
+    }
+    else if (patch_down >= ION_lnIsVarLen) {
         patch_down += ion_binary_len_var_uint_64( patch_down );
     }
 
@@ -151,6 +178,24 @@ iERR _ion_writer_binary_pop(ION_WRITER *pwriter)
     iRETURN;
 }
 
+iERR _ion_writer_binary_fill_length(ION_BINARY_PATCH *patch)
+{
+    iENTER;
+    int32_t length = patch->_length;
+    int     ii;
+
+    if (ion_binary_len_var_uint_64(length) > ION_BINARY_PADDED_LENGTH_WIDTH) FAILWITH(IERR_NUMERIC_OVERFLOW);
+
+    // a VarUInt padded with leading zero bytes, only the last one has the end flag
+    for (ii = ION_BINARY_PADDED_LENGTH_WIDTH - 1; ii >= 0; ii--) {
+        *patch->_reserved[ii] = length & 0x7F;
+        length >>= 7;
+    }
+    *patch->_reserved[ION_BINARY_PADDED_LENGTH_WIDTH - 1] |= 0x80;
+
+    iRETURN;
+}
+
 iERR _ion_writer_binary_patch_lengths(ION_WRITER *pwriter, int added_length)
 {
     iENTER;
@@ -257,8 +302,10 @@ iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length)
             finish = (int)ion_stream_get_position(ostream);  // TODO - this needs 64bit care
             patch_len = finish - start + ION_BINARY_TYPE_DESC_LENGTH;  // for the uta type desc byte we'll write in when we fill this out on outpu
             IONCHECK(_ion_writer_binary_patch_lengths( pwriter, patch_len ));
-            start = finish; // we reset the patch lengths as we've accounted for the writting up until this point
             IONCHECK(_ion_writer_binary_push_position( pwriter, TID_UTA ));
+            // we reset the patch lengths as we've accounted for the writting up until this point
+            // (which includes the header push_position writes when lengths are padded)
+            start = (int)ion_stream_get_position(ostream);  // TODO - this needs 64bit care
         }
         else {
             // if we know the value length we can write the
@@ -584,6 +631,119 @@ iERR _ion_writer_binary_write_double(ION_WRITER *pwriter, double value)
 }
 
 
+// writes a whole list or sexp of plain values. The length is known up front,
+// so the header is written once, with no patch of its own, and the values are
+// encoded into a local buffer that's copied out a chunk at a time. Lists too
+// long for the writer's int lengths aren't written, and *p_written is left
+// FALSE for the caller to write them value by value.
+iERR _ion_writer_binary_write_array(ION_WRITER *pwriter, ION_TYPE container_type, ION_TYPE element_type,
+                                    void *p_values, SIZE count, BOOL *p_written)
+{
+    iENTER;
+    ION_STREAM *ostream = pwriter->_typed_writer.binary._value_stream;
+    BYTE        buffer[ARRAY_ENCODE_BUFFER_SIZE];
+    BYTE       *p, *end;
+    int64_t     len, ivalue;
+    uint64_t    bits;
+    double      dvalue;
+    SIZE        ii, written;
+    int         tid, td, header_len, value_len;
+
+    ASSERT(pwriter && pwriter->type == ion_type_binary_writer);
+    ASSERT(p_written);
+
+    *p_written = FALSE;
+
+    len = 0;
+    switch (ION_TYPE_INT(element_type)) {
+    case tid_INT_INT:
+        for (ii = 0; ii < count; ii++) {
+            len += ION_BINARY_TYPE_DESC_LENGTH + ion_binary_len_uint_64(abs_int64(((int64_t *)p_values)[ii]));
+        }
+        break;
+    case tid_FLOAT_INT:
+        for (ii = 0; ii < count; ii++) {
+            len += ION_BINARY_TYPE_DESC_LENGTH + ion_binary_len_ion_float_64(((double *)p_values)[ii]);
+        }
+        break;
+    case tid_BOOL_INT:
+        len = count * ION_BINARY_TYPE_DESC_LENGTH;
+        break;
+    default:
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    if (len > INT32_MAX - 16) SUCCEED(); // leaves room for the header
+
+    tid = (container_type == tid_SEXP) ? TID_SEXP : TID_LIST;
+    header_len = ION_BINARY_TYPE_DESC_LENGTH;
+    if (len >= ION_lnIsVarLen) {
+        header_len += ion_binary_len_var_uint_64(len);
+    }
+
+    IONCHECK(_ion_writer_binary_start_value(pwriter, header_len + (int)len));
+    IONCHECK(ion_binary_write_type_desc_with_length(ostream, tid, (int)len));
+
+    p = buffer;
+    end = buffer + ARRAY_ENCODE_BUFFER_SIZE - ION_BINARY_TYPE_DESC_LENGTH - sizeof(uint64_t);
+    for (ii = 0; ii < count; ii++) {
+        if (p > end) {
+            IONCHECK(ion_stream_write(ostream, buffer, (SIZE)(p - buffer), &written));
+            if (written != p - buffer) FAILWITH(IERR_WRITE_ERROR);
+            p = buffer;
+        }
+        switch (ION_TYPE_INT(element_type)) {
+        case tid_INT_INT:
+            ivalue = ((int64_t *)p_values)[ii];
+            bits = abs_int64(ivalue);
+            value_len = ion_binary_len_uint_64(bits);
+            td = (ivalue < 0) ? TID_NEG_INT : TID_POS_INT;
+            *p++ = (BYTE)makeTypeDescriptor(td, value_len);
+            while (value_len > 0) {
+                value_len--;
+                *p++ = (BYTE)(bits >> (value_len * 8));
+            }
+            break;
+        case tid_FLOAT_INT:
+            dvalue = ((double *)p_values)[ii];
+            if (ion_binary_len_ion_float_64(dvalue) == 0) {
+                *p++ = (BYTE)makeTypeDescriptor(TID_FLOAT, 0);
+                break;
+            }
+            // big endian, whatever the host's order is
+            memcpy(&bits, &dvalue, sizeof(bits));
+            p[0] = (BYTE)makeTypeDescriptor(TID_FLOAT, sizeof(bits));
+            p[1] = (BYTE)(bits >> 56);
+            p[2] = (BYTE)(bits >> 48);
+            p[3] = (BYTE)(bits >> 40);
+            p[4] = (BYTE)(bits >> 32);
+            p[5] = (BYTE)(bits >> 24);
+            p[6] = (BYTE)(bits >> 16);
+            p[7] = (BYTE)(bits >> 8);
+            p[8] = (BYTE)bits;
+            p += ION_BINARY_TYPE_DESC_LENGTH + sizeof(bits);
+            break;
+        case tid_BOOL_INT:
+            *p++ = (BYTE)(((BOOL *)p_values)[ii] ? IonTrue : IonFalse);
+            break;
+        }
+    }
+    if (p > buffer) {
+        IONCHECK(ion_stream_write(ostream, buffer, (SIZE)(p - buffer), &written));
+        if (written != p - buffer) FAILWITH(IERR_WRITE_ERROR);
+    }
+
+    IONCHECK(_ion_writer_binary_patch_lengths(pwriter, header_len + (int)len));
+
+    if (ION_COLLECTION_IS_EMPTY(&pwriter->_typed_writer.binary._patch_stack) && pwriter->options.flush_every_value) {
+        // finish_container would have done this
+        IONCHECK(_ion_writer_binary_flush_to_output(pwriter));
+    }
+
+    *p_written = TRUE;
+
+    iRETURN;
+}
+
 iERR _ion_writer_binary_write_decimal_helper(ION_STREAM *pstream, ION_INT *mantissa, SIZE mantissa_len,
                                              int32_t exponent) {
     iENTER;
@@ -1195,14 +1355,446 @@ iERR _ion_writer_binary_write_blob(ION_WRITER *pwriter, BYTE *pbuf, SIZE len)
     iRETURN;
 }
 
-iERR _ion_writer_binary_write_one_value(ION_WRITER *pwriter, ION_READER *preader)
+// Binary to binary fast path for ion_writer_write_one_value. The value the
+// binary reader is positioned on is copied as raw bytes into the value stream
+// rather than being decoded and re-encoded. The field name and annotations
+// have already been handed to the writer by the caller, so only the value
+// itself (type descriptor, length and contents) is copied here.
+//
+// Symbol ids have to mean the same thing on both sides. A symbol value is
+// simply re-written with the writer's sid for the same text. A container is
+// first scanned without touching either symbol table; if anything in it
+// can't be copied (a sid with no text, bad lengths or utf8), *p_copied is
+// FALSE, nothing has been written or added, and the caller takes the regular
+// path. Otherwise the symbols it references are added to the writer, in the
+// order the regular path would add them, and if their sids all stay the same
+// the bytes are copied as they are. If not, the sids are patched as the bytes
+// are copied, and the lengths of the containers and annotation wrappers
+// around them are re-sized to fit.
+iERR _ion_writer_binary_write_one_value(ION_WRITER *pwriter, ION_READER *preader, BOOL *p_copied)
 {
     iENTER;
+    ION_BINARY_READER          *binary;
+    ION_STREAM                 *istream, *ostream;
+    ION_WRITER_BINARY_RAW_COPY  copy;
+    BYTE                       *bytes;
+    int                         tid, header_len, ii;
+    SIZE                        len, written, new_len;
+    SID                         sid, writer_sid;
+    BOOL                        is_valid, has_text;
+
+    ASSERT(pwriter && pwriter->type == ion_type_binary_writer);
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_copied);
+
+    *p_copied = FALSE;
+
+    binary  = &preader->typed_reader.binary;
+    istream = preader->istream;
+    ostream = pwriter->_typed_writer.binary._value_stream;
+    tid     = getTypeCode(binary->_value_tid);
+    len     = binary->_value_len;
+
+    memset(&copy, 0, sizeof(copy));
+    copy.pwriter     = pwriter;
+    copy.preader     = preader;
+    copy.is_identity = TRUE;
+
+    if (getLowNibble(binary->_value_tid) == ION_lnIsNull) SUCCEED(); // nulls are only a td byte anyway
+
+    if (tid == TID_SYMBOL) {
+        IONCHECK(_ion_reader_binary_read_symbol_sid(preader, &sid));
+        copy.pass = ION_RAW_COPY_ADD;
+        IONCHECK(_ion_writer_binary_raw_copy_sid(&copy, sid, &has_text, &writer_sid));
+        if (!has_text) SUCCEED(); // let the regular path carry the import location over
+        IONCHECK(_ion_writer_binary_write_symbol_id(pwriter, writer_sid));
+        *p_copied = TRUE;
+        SUCCEED();
+    }
 
-    if (!pwriter) FAILWITH(IERR_BAD_HANDLE);
-    if (!preader) FAILWITH(IERR_INVALID_ARG);
+    if (binary->_state != S_BEFORE_CONTENTS) SUCCEED();
+
+    switch (tid) {
+    case TID_STRUCT:
+    case TID_LIST:
+    case TID_SEXP:
+        // we can only look ahead without consuming when the contents are in the current buffer
+        if (istream->_limit - istream->_curr < len) SUCCEED();
+        copy.pass = ION_RAW_COPY_SCAN;
+        IONCHECK(_ion_writer_binary_raw_copy_values(&copy, istream->_curr, istream->_curr + len,
+                                                    (tid == TID_STRUCT), preader->_depth + 1, &is_valid, &new_len));
+        if (!is_valid) SUCCEED();
+        // from here on the value is copied, so its symbols can go into the writer, starting with its own field
+        // name and annotations as start_container would
+        if (pwriter->_in_struct) {
+            IONCHECK(_ion_writer_get_field_name_as_sid_helper(pwriter, &writer_sid));
+        }
+        for (ii = 0; ii < pwriter->annotation_curr; ii++) {
+            IONCHECK(_ion_writer_get_annotation_as_sid_helper(pwriter, ii, &writer_sid));
+        }
+        copy.pass = ION_RAW_COPY_ADD;
+        IONCHECK(_ion_writer_binary_raw_copy_values(&copy, istream->_curr, istream->_curr + len,
+                                                    (tid == TID_STRUCT), preader->_depth + 1, &is_valid, &new_len));
+        break;
+    case TID_STRING:
+        if (preader->options.skip_character_validation == FALSE) {
+            // let the normal path report (or, when the string straddles pages, check) the contents
+            if (istream->_limit - istream->_curr < len) SUCCEED();
+            IONCHECK(_ion_writer_binary_scan_raw_string(istream->_curr, len, &is_valid));
+            if (!is_valid) SUCCEED();
+        }
+        break;
+    default:
+        break;
+    }
 
-    FAILWITH(IERR_NOT_IMPL);
+    IONCHECK(_ion_reader_binary_borrow_bytes(preader, len, &bytes));
+    binary->_state = S_BEFORE_TID; // the contents have been consumed
+
+    if (!copy.is_identity) {
+        IONCHECK(_ion_writer_binary_raw_copy_rewrite(&copy, tid, bytes, len));
+    }
+    else {
+        header_len = ION_BINARY_TYPE_DESC_LENGTH;
+        if (tid != TID_BOOL && len >= ION_lnIsVarLen) {
+            header_len += ion_binary_len_var_uint_64(len);
+        }
+
+        IONCHECK(_ion_writer_binary_start_value(pwriter, header_len + len));
+        if (tid == TID_BOOL) {
+            ION_PUT(ostream, binary->_value_tid); // the value is in the low nibble
+        }
+        else {
+            // this also normalizes sorted structs (0xD1) to a plain length prefix
+            IONCHECK(ion_binary_write_type_desc_with_length(ostream, tid, len));
+        }
+        IONCHECK(ion_stream_write(ostream, bytes, len, &written));
+        if (written != len) FAILWITH(IERR_WRITE_ERROR);
+        IONCHECK(_ion_writer_binary_patch_lengths(pwriter, header_len + len));
+    }
+
+    if (ION_COLLECTION_IS_EMPTY(&pwriter->_typed_writer.binary._patch_stack)
+     && pwriter->options.flush_every_value
+     && (tid == TID_STRUCT || tid == TID_LIST || tid == TID_SEXP)
+    ) {
+        // finish_container would have done this
+        IONCHECK(_ion_writer_binary_flush_to_output(pwriter));
+    }
+
+    *p_copied = TRUE;
+
+    iRETURN;
+}
+
+// writes a container whose sids change in the writer: sizes every container
+// and annotation wrapper in it with the writer's sids, then writes it out
+iERR _ion_writer_binary_raw_copy_rewrite(ION_WRITER_BINARY_RAW_COPY *copy, int tid, BYTE *contents, SIZE len)
+{
+    iENTER;
+    ION_WRITER *pwriter = copy->pwriter;
+    ION_STREAM *ostream = pwriter->_typed_writer.binary._value_stream;
+    SIZE        new_len, header_len;
+    BOOL        is_valid;
+
+    if (copy->length_count > 0) {
+        copy->lengths = (SIZE *)ion_alloc_owner_like(copy->length_count * sizeof(SIZE), pwriter);
+        if (!copy->lengths) FAILWITH(IERR_NO_MEMORY);
+    }
+
+    copy->pass = ION_RAW_COPY_SIZE;
+    copy->next_length = 0;
+    IONCHECK(_ion_writer_binary_raw_copy_values(copy, contents, contents + len, (tid == TID_STRUCT),
+                                                copy->preader->_depth + 1, &is_valid, &new_len));
+
+    header_len = ION_BINARY_TYPE_DESC_LENGTH;
+    if (new_len >= ION_lnIsVarLen) {
+        header_len += ion_binary_len_var_uint_64(new_len);
+    }
+    IONCHECK(_ion_writer_binary_start_value(pwriter, header_len + new_len));
+    IONCHECK(ion_binary_write_type_desc_with_length(ostream, tid, new_len));
+
+    copy->pass = ION_RAW_COPY_WRITE;
+    copy->next_length = 0;
+    IONCHECK(_ion_writer_binary_raw_copy_values(copy, contents, contents + len, (tid == TID_STRUCT),
+                                                copy->preader->_depth + 1, &is_valid, &new_len));
+    IONCHECK(_ion_writer_binary_patch_lengths(pwriter, header_len + new_len));
+
+fail:
+    if (copy->lengths) {
+        ion_free_owner(copy->lengths);
+        copy->lengths = NULL;
+    }
+    return err;
+}
+
+// maps a sid from the reader's current symbol table to the writer's sid for
+// the same text. Symbols with no known text can't be mapped, and *p_has_text
+// is FALSE. The scan only looks the text up; the later passes add it to the
+// writer's local symbol table when it's missing, as writing the symbol would.
+iERR _ion_writer_binary_raw_copy_sid(ION_WRITER_BINARY_RAW_COPY *copy, SID sid, BOOL *p_has_text, SID *p_sid)
+{
+    iENTER;
+    ION_STRING *text;
+
+    ASSERT(p_has_text);
+    ASSERT(p_sid);
+
+    *p_has_text = TRUE;
+    *p_sid = sid;
+
+    if (sid <= ION_SYS_SID_SHARED_SYMBOL_TABLE) {
+        // symbol zero and the system symbols are the same for every reader and writer
+        SUCCEED();
+    }
+
+    IONCHECK(_ion_symbol_table_find_by_sid_helper(copy->preader->_current_symtab, sid, &text));
+    if (text == NULL || ION_STRING_IS_NULL(text)) {
+        *p_has_text = FALSE;
+        SUCCEED();
+    }
+    if (copy->pass == ION_RAW_COPY_SCAN) SUCCEED();
+
+    IONCHECK(_ion_writer_make_symbol_helper(copy->pwriter, text, p_sid));
+    if (*p_sid != sid) {
+        copy->is_identity = FALSE;
+    }
+
+    iRETURN;
+}
+
+// reads a VarUInt out of memory, returning FALSE if it runs past end or
+// doesn't fit in 31 bits
+BOOL _ion_writer_binary_raw_var_uint(BYTE **pp, BYTE *end, int32_t *p_value)
+{
+    BYTE    *p = *pp;
+    uint32_t value = 0;
+    int      b;
+
+    do {
+        if (p >= end || value > (INT32_MAX >> 7)) return FALSE;
+        b = *p++;
+        value = (value << 7) | (b & 0x7F);
+    } while ((b & 0x80) == 0);
+
+    *pp = p;
+    *p_value = (int32_t)value;
+    return TRUE;
+}
+
+// maps the sid of a symbol value, or of the symbol value an annotation
+// wrapper holds, in contents the scan has already accepted
+iERR _ion_writer_binary_raw_copy_value_sid(ION_WRITER_BINARY_RAW_COPY *copy, int tid, BYTE *contents, BYTE *end)
+{
+    iENTER;
+    int32_t  annotation_len, len;
+    uint32_t sid = 0;
+    SID      writer_sid;
+    BOOL     has_text;
+    int      td;
+
+    if (tid == TID_UTA) {
+        if (!_ion_writer_binary_raw_var_uint(&contents, end, &annotation_len)) SUCCEED();
+        contents += annotation_len;
+        if (contents >= end) SUCCEED();
+        td = *contents++;
+        if (getTypeCode(td) != TID_SYMBOL || getLowNibble(td) == ION_lnIsNull) SUCCEED();
+        len = getLowNibble(td);
+        if (len == ION_lnIsVarLen && !_ion_writer_binary_raw_var_uint(&contents, end, &len)) SUCCEED();
+        end = contents + len;
+    }
+    else if (tid != TID_SYMBOL) {
+        SUCCEED();
+    }
+
+    while (contents < end) {
+        sid = (sid << 8) | *contents++;
+    }
+    IONCHECK(_ion_writer_binary_raw_copy_sid(copy, (SID)sid, &has_text, &writer_sid));
+
+    iRETURN;
+}
+
+#define ION_RAW_COPY_HEADER_LENGTH(len) \
+    (ION_BINARY_TYPE_DESC_LENGTH + (((len) >= ION_lnIsVarLen) ? ion_binary_len_var_uint_64(len) : 0))
+
+// walks the values encoded in [p, end) - the contents of a container - for
+// one pass of the copy (see ION_WRITER_BINARY_RAW_COPY_PASS), and sets
+// *p_length to their length with the writer's sids. In the scan, anything
+// unexpected (a sid with no text, bad lengths, too deep, bad utf8) sets
+// *p_is_valid to FALSE so the caller takes the regular path, which reports
+// real errors. The later passes only see contents the scan accepted.
+iERR _ion_writer_binary_raw_copy_values(ION_WRITER_BINARY_RAW_COPY *copy, BYTE *p, BYTE *end, BOOL is_struct, int depth, BOOL *p_is_valid, SIZE *p_length)
+{
+    iENTER;
+    ION_STREAM *ostream = copy->pwriter->_typed_writer.binary._value_stream;
+    ION_WRITER_BINARY_RAW_COPY_PASS pass = copy->pass;
+    BYTE       *start, *contents, *annotations, *annotations_end;
+    int         td, tid, ln, ii;
+    int32_t     len, field_sid, annotation_len, annotation_sid, slot = 0;
+    uint32_t    sid;
+    SID         writer_sid;
+    SIZE        length = 0, new_len, annotations_len, written;
+    BOOL        matches, has_text, is_valid = FALSE;
+
+    if (depth > copy->preader->options.max_container_depth) goto done;
+
+    while (p < end) {
+        if (is_struct) {
+            if (!_ion_writer_binary_raw_var_uint(&p, end, &field_sid)) goto done;
+            if (p >= end) goto done;
+        }
+
+        start = p;
+        td  = *p++;
+        tid = getTypeCode(td);
+        ln  = getLowNibble(td);
+        if (tid == TID_BOOL || ln == ION_lnIsNull) {
+            len = 0;
+        }
+        else if (ln == ION_lnIsVarLen || (tid == TID_STRUCT && ln == 1)) {
+            if (!_ion_writer_binary_raw_var_uint(&p, end, &len)) goto done;
+        }
+        else {
+            len = ln;
+        }
+        if (len > end - p) goto done;
+        contents = p;
+        p += len;
+
+        if (pass == ION_RAW_COPY_ADD) {
+            // writing a symbol value adds its text before its field name and annotations
+            IONCHECK(_ion_writer_binary_raw_copy_value_sid(copy, tid, contents, p));
+        }
+        if (is_struct) {
+            IONCHECK(_ion_writer_binary_raw_copy_sid(copy, field_sid, &has_text, &writer_sid));
+            if (!has_text) goto done;
+            length += ion_binary_len_var_uint_64(writer_sid);
+            if (pass == ION_RAW_COPY_WRITE) {
+                IONCHECK(ion_binary_write_var_uint_64(ostream, writer_sid));
+            }
+        }
+
+        if (tid == TID_UTA) {
+            if (pass == ION_RAW_COPY_SCAN) {
+                copy->length_count++;
+            }
+            else {
+                slot = copy->next_length++;
+            }
+            if (!_ion_writer_binary_raw_var_uint(&contents, p, &annotation_len)) goto done;
+            if (annotation_len < 1 || annotation_len > p - contents) goto done;
+            annotations = contents;
+            annotations_end = contents + annotation_len;
+            annotations_len = 0;
+            while (contents < annotations_end) {
+                if (!_ion_writer_binary_raw_var_uint(&contents, annotations_end, &annotation_sid)) goto done;
+                IONCHECK(_ion_writer_binary_raw_copy_sid(copy, annotation_sid, &has_text, &writer_sid));
+                if (!has_text) goto done;
+                annotations_len += ion_binary_len_var_uint_64(writer_sid);
+            }
+            // the wrapped value is a sequence of exactly one value
+            if (contents >= p || getTypeCode(*contents) == TID_UTA) goto done;
+            if (pass == ION_RAW_COPY_WRITE) {
+                IONCHECK(ion_binary_write_type_desc_with_length(ostream, TID_UTA, copy->lengths[slot]));
+                IONCHECK(ion_binary_write_var_uint_64(ostream, annotations_len));
+                while (annotations < annotations_end) {
+                    _ion_writer_binary_raw_var_uint(&annotations, annotations_end, &annotation_sid);
+                    IONCHECK(_ion_writer_binary_raw_copy_sid(copy, annotation_sid, &has_text, &writer_sid));
+                    IONCHECK(ion_binary_write_var_uint_64(ostream, writer_sid));
+                }
+            }
+            IONCHECK(_ion_writer_binary_raw_copy_values(copy, contents, p, FALSE, depth, &matches, &new_len));
+            if (!matches) goto done;
+            new_len += ion_binary_len_var_uint_64(annotations_len) + annotations_len;
+            if (pass == ION_RAW_COPY_SIZE) {
+                copy->lengths[slot] = new_len;
+            }
+            length += ION_RAW_COPY_HEADER_LENGTH(new_len) + new_len;
+            continue;
+        }
+        if (tid == TID_BOOL || ln == ION_lnIsNull) {
+            if (pass == ION_RAW_COPY_WRITE) {
+                ION_PUT(ostream, td);
+            }
+            length += ION_BINARY_TYPE_DESC_LENGTH;
+            continue;
+        }
+
+        switch (tid) {
+        case TID_SYMBOL:
+            if (len > (int32_t)sizeof(int32_t)) goto done;
+            sid = 0;
+            for (ii = 0; ii < len; ii++) {
+                sid = (sid << 8) | contents[ii];
+            }
+            if (sid > INT32_MAX) goto done;
+            IONCHECK(_ion_writer_binary_raw_copy_sid(copy, (SID)sid, &has_text, &writer_sid));
+            if (!has_text) goto done;
+            new_len = ion_binary_len_uint_64(writer_sid);
+            if (pass == ION_RAW_COPY_WRITE) {
+                ION_PUT(ostream, makeTypeDescriptor(TID_SYMBOL, new_len));
+                if (writer_sid > 0) {
+                    IONCHECK(ion_binary_write_uint_64(ostream, writer_sid));
+                }
+            }
+            length += ION_BINARY_TYPE_DESC_LENGTH + new_len;
+            continue;
+        case TID_STRUCT:
+        case TID_LIST:
+        case TID_SEXP:
+            if (pass == ION_RAW_COPY_SCAN) {
+                copy->length_count++;
+            }
+            else {
+                slot = copy->next_length++;
+            }
+            if (pass == ION_RAW_COPY_WRITE) {
+                // this also normalizes sorted structs (0xD1) to a plain length prefix
+                IONCHECK(ion_binary_write_type_desc_with_length(ostream, tid, copy->lengths[slot]));
+            }
+            IONCHECK(_ion_writer_binary_raw_copy_values(copy, contents, p, (tid == TID_STRUCT), depth + 1, &matches, &new_len));
+            if (!matches) goto done;
+            if (pass == ION_RAW_COPY_SIZE) {
+                copy->lengths[slot] = new_len;
+            }
+            length += ION_RAW_COPY_HEADER_LENGTH(new_len) + new_len;
+            continue;
+        case TID_STRING:
+            if (pass == ION_RAW_COPY_SCAN && copy->preader->options.skip_character_validation == FALSE) {
+                IONCHECK(_ion_writer_binary_scan_raw_string(contents, len, &matches));
+                if (!matches) goto done;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // everything else holds no sids and goes across exactly as it was encoded
+        if (pass == ION_RAW_COPY_WRITE) {
+            IONCHECK(ion_stream_write(ostream, start, (SIZE)(p - start), &written));
+            if (written != (SIZE)(p - start)) FAILWITH(IERR_WRITE_ERROR);
+        }
+        length += (SIZE)(p - start);
+    }
+    is_valid = TRUE;
+
+done:
+    *p_is_valid = is_valid;
+    *p_length = length;
+    SUCCEED();
+
+    iRETURN;
+}
+
+// sets *p_is_valid to whether the bytes are complete, valid utf8
+iERR _ion_writer_binary_scan_raw_string(BYTE *p, SIZE len, BOOL *p_is_valid)
+{
+    iENTER;
+    SIZE remaining;
+
+    err = _ion_reader_binary_validate_utf8(p, len, 0, &remaining);
+    *p_is_valid = (err == IERR_OK && remaining == 0);
+    SUCCEED();
 
     iRETURN;
 }
@@ -107,11 +107,15 @@ typedef struct _ion_text_writer
 
 } ION_TEXT_WRITER;
 
+// the width of the length reserved for a container when pad_container_lengths is on
+#define ION_BINARY_PADDED_LENGTH_WIDTH (4)
+
 typedef struct _ion_binary_patch {
     int     _offset;
     int     _type;
     int     _length;
     BOOL    _in_struct;
+    BYTE   *_reserved[ION_BINARY_PADDED_LENGTH_WIDTH]; // where the length goes, it may straddle a page
 } ION_BINARY_PATCH;
 
 typedef struct _ion_binary_writer
@@ -119,7 +123,7 @@ typedef struct _ion_binary_writer
     ION_TYPE            _lob_in_progress;
 
     ION_COLLECTION      _patch_stack;  // stack of patch pointers
-    ION_COLLECTION      _patch_list;   // list of patches
+    ION_COLLECTION      _patch_list;   // list of patches (only the open ones with pad_container_lengths)
     ION_COLLECTION      _value_list;   // list of pointers to value buffers of some size (like 8k)
 
     ION_STREAM         *_value_stream; // temporary in memory buffer for holding values to merge with the patch list
@@ -207,6 +211,7 @@ iERR _ion_writer_open_stream_helper(ION_WRITER **p_pwriter, ION_STREAM p_stream,
 iERR _ion_writer_open_helper(ION_WRITER **p_pwriter, ION_STREAM *stream, ION_WRITER_OPTIONS *p_options);
 void _ion_writer_initialize_option_defaults(ION_WRITER_OPTIONS *p_options);
 iERR _ion_writer_initialize(ION_WRITER *pwriter, ION_OBJ_TYPE writer_type);
+iERR _ion_writer_initialize_local_symbol_table(ION_WRITER *pwriter);
 
 iERR _ion_writer_get_depth_helper(ION_WRITER *pwriter, SIZE *p_depth);
 iERR _ion_writer_set_temp_size_helper(ION_WRITER *pwriter, SIZE size_of_temp_space);
@@ -234,6 +239,7 @@ iERR _ion_writer_write_ion_int_helper(ION_WRITER *pwriter, ION_INT *value);
 iERR _ion_writer_write_mixed_int_helper(ION_WRITER *pwriter, ION_READER *preader);
 iERR _ion_writer_write_float_helper(ION_WRITER *pwriter, float value);
 iERR _ion_writer_write_double_helper(ION_WRITER *pwriter, double value);
+iERR _ion_writer_write_array_helper(ION_WRITER *pwriter, ION_TYPE container_type, ION_TYPE element_type, void *p_values, SIZE count);
 iERR _ion_writer_write_decimal_helper(ION_WRITER *pwriter, decQuad *value);
 iERR _ion_writer_write_ion_decimal_helper(ION_WRITER *pwriter, ION_DECIMAL *value);
 iERR _ion_writer_write_timestamp_helper(ION_WRITER *pwriter, ION_TIMESTAMP *value);
@@ -323,6 +329,24 @@ iERR _ion_writer_text_start_container(ION_WRITER *pwriter, ION_TYPE container_ty
 iERR _ion_writer_text_finish_container(ION_WRITER *pwriter);
 iERR _ion_writer_text_close(ION_WRITER *pwriter);
 
+// the passes _ion_writer_binary_write_one_value makes over the contents of a container it copies
+typedef enum _ion_writer_binary_raw_copy_pass {
+    ION_RAW_COPY_SCAN,  // checks the encoding, and that every sid has text in the reader, without changing anything
+    ION_RAW_COPY_ADD,   // adds the symbols to the writer and notes whether any of them get a different sid
+    ION_RAW_COPY_SIZE,  // works out the lengths of the containers and annotation wrappers with the writer's sids
+    ION_RAW_COPY_WRITE, // writes the values with the writer's sids
+} ION_WRITER_BINARY_RAW_COPY_PASS;
+
+typedef struct _ion_writer_binary_raw_copy {
+    ION_WRITER                      *pwriter;
+    ION_READER                      *preader;
+    ION_WRITER_BINARY_RAW_COPY_PASS  pass;
+    BOOL                             is_identity;   // every sid is the same in the writer
+    int32_t                          length_count;  // containers and annotation wrappers, counted by the scan
+    int32_t                          next_length;
+    SIZE                            *lengths;       // their contents' lengths with the writer's sids, in order
+} ION_WRITER_BINARY_RAW_COPY;
+
 //
 // internal binary impl's of public api's
 //
@@ -333,6 +357,7 @@ iERR _ion_writer_binary_write_int64(ION_WRITER *pwriter, int64_t value);
 iERR _ion_writer_binary_write_ion_int(ION_WRITER *pwriter, ION_INT *iint);
 iERR _ion_writer_binary_write_float(ION_WRITER *pwriter, float value);
 iERR _ion_writer_binary_write_double(ION_WRITER *pwriter, double value);
+iERR _ion_writer_binary_write_array(ION_WRITER *pwriter, ION_TYPE container_type, ION_TYPE element_type, void *p_values, SIZE count, BOOL *p_written);
 iERR _ion_writer_binary_write_decimal_quad(ION_WRITER *pwriter, decQuad *value);
 iERR _ion_writer_binary_write_decimal_number(ION_WRITER *pwriter, decNumber *value);
 iERR _ion_writer_binary_write_timestamp(ION_WRITER *pwriter, iTIMESTAMP value);
@@ -347,6 +372,13 @@ iERR _ion_writer_binary_finish_lob(ION_WRITER *pwriter);
 iERR _ion_writer_binary_start_container(ION_WRITER *pwriter, ION_TYPE container_type);
 iERR _ion_writer_binary_finish_container(ION_WRITER *pwriter);
 iERR _ion_writer_binary_close(ION_WRITER *pwriter);
+iERR _ion_writer_binary_write_one_value(ION_WRITER *pwriter, ION_READER *preader, BOOL *p_copied);
+iERR _ion_writer_binary_raw_copy_sid(ION_WRITER_BINARY_RAW_COPY *copy, SID sid, BOOL *p_has_text, SID *p_sid);
+iERR _ion_writer_binary_raw_copy_value_sid(ION_WRITER_BINARY_RAW_COPY *copy, int tid, BYTE *contents, BYTE *end);
+iERR _ion_writer_binary_raw_copy_values(ION_WRITER_BINARY_RAW_COPY *copy, BYTE *p, BYTE *end, BOOL is_struct, int depth, BOOL *p_is_valid, SIZE *p_length);
+iERR _ion_writer_binary_raw_copy_rewrite(ION_WRITER_BINARY_RAW_COPY *copy, int tid, BYTE *contents, SIZE len);
+iERR _ion_writer_binary_scan_raw_string(BYTE *p, SIZE len, BOOL *p_is_valid);
+BOOL _ion_writer_binary_raw_var_uint(BYTE **pp, BYTE *end, int32_t *p_value);
 
 iERR _ion_writer_binary_output_stream_handler(ION_STREAM *pstream);
 iERR _ion_writer_binary_input_stream_handler(ION_STREAM *pstream);
@@ -354,6 +386,7 @@ iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length);
 iERR _ion_writer_binary_close_value(ION_WRITER *writer);
 iERR _ion_writer_binary_push_position(ION_WRITER *bwriter, int type_id);
 iERR _ion_writer_binary_pop(ION_WRITER *bwriter);
+iERR _ion_writer_binary_fill_length(ION_BINARY_PATCH *patch);
 iERR _ion_writer_binary_patch_lengths(ION_WRITER *bwriter, int added_length);
 iERR _ion_writer_binary_top_length(ION_WRITER *bwriter, int *plength);
 iERR _ion_writer_binary_top_position(ION_WRITER *bwriter, int *poffset);
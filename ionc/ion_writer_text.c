@@ -19,6 +19,7 @@
 
 #include "ion_internal.h"
 #include "ion_decimal_impl.h"
+#include "ion_float_impl.h"
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
@@ -521,7 +522,7 @@ fail:
 iERR _ion_writer_text_write_double(ION_WRITER *pwriter, double value)
 {
     iENTER;
-    char image[64], *mark;
+    char image[ION_FLOAT_STRING_MAX];
     int  fpc;
 
     IONCHECK(_ion_writer_text_start_value(pwriter));
@@ -566,24 +567,9 @@ iERR _ion_writer_text_write_double(ION_WRITER *pwriter, double value)
     case FP_NORMAL:
     case FP_SUBNORMAL:
 #endif
-
-        // TODO this is a terrible way to convert this!
-        // See: https://github.com/amzn/ion-c/issues/112
-        // For now:
-        // "If an IEEE 754 double-precision number is converted to a decimal string with at least
-        //  17 significant digits, and then converted back to double-precision representation,
-        //  the final result must match the original number."
-        // (https://en.wikipedia.org/wiki/Double-precision_floating-point_format)
-        // Leaving room for '.', '+'/'-', and 'e', we get 17 + 1 + 1 +1 = 20
-        sprintf(image, "%.20g", value);
-        assert(strlen(image) < sizeof(image));
-
-        mark = strchr(image, 'e');
-        if (!mark) {
-            strcat(image, "e+0");
-        }
-        for (mark = image; *mark == ' '; mark++) ; // strip leading spaces
-        IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, mark));    
+        // the shortest digits that round trip (see issue #112)
+        _ion_float_to_string(value, image);
+        IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, image));
         break;
 
     default:
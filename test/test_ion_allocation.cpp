@@ -0,0 +1,239 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <ion_event_util.h>
+#include "ion_assert.h"
+#include "ion_helpers.h"
+#include "ion_test_util.h"
+#include "ion_alloc.h"
+#include <atomic>
+#include <set>
+#include <thread>
+
+typedef struct {
+    int alloc_count;
+    int free_count;
+} ION_TEST_COUNTING_ALLOCATOR;
+
+void *ion_test_counting_alloc(void *context, SIZE size) {
+    ((ION_TEST_COUNTING_ALLOCATOR *)context)->alloc_count++;
+    return malloc((size_t)size);
+}
+
+void ion_test_counting_free(void *context, void *ptr) {
+    ((ION_TEST_COUNTING_ALLOCATOR *)context)->free_count++;
+    free(ptr);
+}
+
+TEST(IonAllocator, ReaderWriterAndCatalogAllocateWithTheirOwn) {
+    ION_TEST_COUNTING_ALLOCATOR writer_counts = {0, 0}, reader_counts = {0, 0}, catalog_counts = {0, 0};
+    ION_ALLOCATOR writer_allocator = {&ion_test_counting_alloc, &ion_test_counting_free, &writer_counts};
+    ION_ALLOCATOR reader_allocator = {&ion_test_counting_alloc, &ion_test_counting_free, &reader_counts};
+    ION_ALLOCATOR catalog_allocator = {&ion_test_counting_alloc, &ion_test_counting_free, &catalog_counts};
+    ION_WRITER_OPTIONS writer_options;
+    ION_READER_OPTIONS reader_options;
+    ION_STREAM *ion_stream = NULL;
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hCATALOG catalog = NULL;
+    hSYMTAB symtab = NULL;
+    ION_STRING name, value;
+    ION_TYPE type;
+    BYTE *data;
+    SIZE data_length;
+    char buffer[16];
+
+    ION_ASSERT_OK(ion_stream_open_memory_only(&ion_stream));
+    ion_event_initialize_writer_options(&writer_options);
+    writer_options.output_as_binary = TRUE;
+    writer_options.allocator = &writer_allocator;
+    ION_ASSERT_OK(ion_writer_open(&writer, ion_stream, &writer_options));
+    for (int ii = 0; ii < 1000; ii++) {
+        snprintf(buffer, sizeof(buffer), "sym%d", ii);
+        ION_ASSERT_OK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&value, buffer, (SIZE)strlen(buffer))));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    ASSERT_LT(0, writer_counts.alloc_count);
+    ASSERT_EQ(writer_counts.alloc_count, writer_counts.free_count);
+
+    ion_event_initialize_reader_options(&reader_options);
+    reader_options.allocator = &reader_allocator;
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_length, &reader_options));
+    for (int ii = 0; ii < 1000; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_SYMBOL, type);
+        ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+        snprintf(buffer, sizeof(buffer), "sym%d", ii);
+        assertStringsEqual(buffer, (char *)value.value, value.length);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ASSERT_LT(0, reader_counts.alloc_count);
+    ASSERT_EQ(reader_counts.alloc_count, reader_counts.free_count);
+
+    // Tables added to the catalog are copied into its memory.
+    ION_ASSERT_OK(ion_catalog_open_with_allocator(&catalog, &catalog_allocator));
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&symtab, NULL, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(symtab, ion_string_assign_cstr(&name, (char *)"shared", 6)));
+    ION_ASSERT_OK(ion_symbol_table_set_version(symtab, 1));
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(symtab, ion_string_assign_cstr(&value, (char *)"sym", 3), NULL));
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, symtab));
+    ION_ASSERT_OK(ion_symbol_table_close(symtab));
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 1, &symtab));
+    ASSERT_TRUE(symtab != NULL);
+    ASSERT_LT(0, catalog_counts.alloc_count);
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+    ASSERT_EQ(catalog_counts.alloc_count, catalog_counts.free_count);
+
+    free(data);
+}
+
+TEST(IonAllocator, ReaderScratchArenaStopsAllocating) {
+    ION_TEST_COUNTING_ALLOCATOR counts = {0, 0};
+    ION_ALLOCATOR allocator = {&ion_test_counting_alloc, &ion_test_counting_free, &counts};
+    ION_READER_OPTIONS reader_options;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_STRING annotations[2];
+    SIZE annotation_count;
+    int64_t warm_count = 0;
+    std::string text;
+
+    for (int ii = 0; ii < 1000; ii++) {
+        text += "annotation_one::annotation_two::123 ";
+    }
+
+    // Without the arena, the pool for each top-level value is allocated again; with it, the reader stops allocating
+    // once the arena holds a value.
+    for (SIZE scratch_arena_size = 0; scratch_arena_size <= 16; scratch_arena_size += 16) {
+        counts.alloc_count = counts.free_count = 0;
+        ion_event_initialize_reader_options(&reader_options);
+        reader_options.allocator = &allocator;
+        reader_options.scratch_arena_size = scratch_arena_size;
+        ION_ASSERT_OK(ion_reader_open_buffer(&reader, (BYTE *)text.c_str(), (SIZE)text.length(), &reader_options));
+        for (int ii = 0; ii < 1000; ii++) {
+            if (ii == 10) warm_count = counts.alloc_count;
+            ION_ASSERT_OK(ion_reader_next(reader, &type));
+            ASSERT_EQ(tid_INT, type);
+            ION_ASSERT_OK(ion_reader_get_annotations(reader, annotations, 2, &annotation_count));
+            ASSERT_EQ(2, annotation_count);
+            assertStringsEqual("annotation_two", (char *)annotations[1].value, annotations[1].length);
+        }
+        if (scratch_arena_size == 0) {
+            ASSERT_LT(warm_count + 900, counts.alloc_count);
+        }
+        else {
+            ASSERT_EQ(warm_count, counts.alloc_count);
+        }
+        ION_ASSERT_OK(ion_reader_close(reader));
+        ASSERT_EQ(counts.alloc_count, counts.free_count);
+    }
+}
+
+TEST(IonAllocator, SharedPagePoolMovesPagesBetweenThreads) {
+    ION_SHARED_PAGE_POOL_OPTIONS options;
+    ION_SHARED_PAGE_POOL_STATS stats;
+    hCATALOG catalogs[64];
+
+    memset(&options, 0, sizeof(options));
+    options.batch_size = 4;
+    ION_ASSERT_OK(ion_initialize_shared_page_pool(&options));
+    ASSERT_EQ(IERR_INVALID_STATE, ion_initialize_shared_page_pool(&options));
+
+    // Each catalog takes a page. The pages freed on one thread past its own pool's limit go to the shared pool...
+    std::thread([&]() {
+        for (int ii = 0; ii < 64; ii++) {
+            ION_ASSERT_OK(ion_catalog_open(&catalogs[ii]));
+        }
+        for (int ii = 0; ii < 64; ii++) {
+            ION_ASSERT_OK(ion_catalog_close(catalogs[ii]));
+        }
+        // A thread that's done hands the rest of its pages over too.
+        ion_release_page_pool();
+    }).join();
+    ion_shared_page_pool_stats(&stats);
+    ASSERT_EQ(0, stats.hits);
+    ASSERT_LT(0, stats.misses);
+    ASSERT_LT(0, stats.bytes_retained);
+
+    // ...and another thread uses them, rather than allocating its own.
+    int64_t misses = stats.misses;
+    std::thread([&]() {
+        for (int ii = 0; ii < 32; ii++) {
+            ION_ASSERT_OK(ion_catalog_open(&catalogs[ii]));
+        }
+        for (int ii = 0; ii < 32; ii++) {
+            ION_ASSERT_OK(ion_catalog_close(catalogs[ii]));
+        }
+        ion_release_page_pool();
+    }).join();
+    ion_shared_page_pool_stats(&stats);
+    ASSERT_LE(32, stats.hits);
+    ASSERT_EQ(misses, stats.misses);
+    ASSERT_EQ(64 * 64 * 1024, stats.bytes_retained);
+
+    ion_release_shared_page_pool();
+    ion_shared_page_pool_stats(&stats);
+    ASSERT_EQ(0, stats.bytes_retained);
+}
+
+TEST(IonAllocator, SharedPagePoolPopsOneBatchAtATimeFromManyThreads) {
+    ION_SHARED_PAGE_POOL_OPTIONS options;
+    ION_SHARED_PAGE_POOL_STATS stats;
+    ION_SHARED_BATCH *batch;
+    std::set<ION_SHARED_BATCH *> batches;
+    std::vector<std::thread> threads;
+    const int batch_count = 64, thread_count = 8;
+
+    memset(&options, 0, sizeof(options));
+    options.max_retained_bytes = INT32_MAX;
+    ION_ASSERT_OK(ion_initialize_shared_page_pool(&options));
+    for (int ii = 0; ii < batch_count; ii++) {
+        batch = (ION_SHARED_BATCH *)ion_xalloc(g_ion_shared_page_pool.page_size);
+        ASSERT_TRUE(batch != NULL);
+        batch->next = NULL;
+        batch->page_count = 1;
+        _ion_shared_page_pool_push(0, batch);
+    }
+
+    // With fewer threads than batches, every pop finds one, and none of them empties the stack for the others.
+    std::atomic<int> empty_pops(0);
+    for (int ii = 0; ii < thread_count; ii++) {
+        threads.push_back(std::thread([&]() {
+            for (int jj = 0; jj < 20000; jj++) {
+                ION_SHARED_BATCH *popped = _ion_shared_page_pool_pop(0);
+                if (popped == NULL) {
+                    empty_pops++;
+                    continue;
+                }
+                _ion_shared_page_pool_push(0, popped);
+            }
+        }));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(0, empty_pops.load());
+
+    // And the same batches are all still there, each once.
+    while ((batch = _ion_shared_page_pool_pop(0)) != NULL) {
+        ASSERT_TRUE(batches.insert(batch).second);
+    }
+    ASSERT_EQ(batch_count, batches.size());
+    ion_shared_page_pool_stats(&stats);
+    ASSERT_EQ(0, stats.bytes_retained);
+    for (auto popped : batches) {
+        ion_xfree(popped);
+    }
+    ion_release_shared_page_pool();
+}
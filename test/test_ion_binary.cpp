@@ -18,6 +18,7 @@
 #include "ion_helpers.h"
 #include "ion_test_util.h"
 #include "ion_event_equivalence.h"
+#include "ion_event_util.h"
 
 TEST(IonBinaryLen, UInt64) {
 
@@ -63,6 +64,36 @@ TEST(IonWriterAddAnnotation, SameInTextAndBinary) {
     ASSERT_TRUE(ion_compare_streams(&binary_stream, &text_stream));
 }
 
+TEST(IonWriterAddAnnotation, AnnotatesValuesAfterFinish) {
+    // finish frees the pool that held the last value's annotation text
+    hWRITER writer = NULL;
+    ION_STREAM *ion_stream = NULL;
+    ION_STRING annot_str;
+    BYTE *binary_data;
+    SIZE binary_len, flushed;
+    IonEventStream binary_stream, text_stream;
+    const char *expected = "annot::{a:1} annot::{a:2} annot::{a:3}";
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_string_from_cstr("annot", &annot_str));
+    for (int i = 1; i <= 3; i++) {
+        ION_STRING field_str;
+        ION_ASSERT_OK(ion_string_from_cstr("a", &field_str));
+        ION_ASSERT_OK(ion_writer_add_annotation(writer, &annot_str));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_str));
+        ION_ASSERT_OK(ion_writer_write_int(writer, i));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_finish(writer, &flushed));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &binary_data, &binary_len));
+    ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(binary_data, binary_len, NULL, &binary_stream));
+    ION_ASSERT_OK(ion_event_stream_read_all_from_bytes((BYTE *)expected, (SIZE)strlen(expected), NULL,
+                                                       &text_stream));
+    ASSERT_TRUE(ion_compare_streams(&binary_stream, &text_stream));
+    free(binary_data);
+}
+
 TEST(IonBinaryTimestamp, WriterConvertsToUTC) {
     hWRITER writer = NULL;
     ION_STREAM *ion_stream = NULL;
@@ -693,3 +724,790 @@ TEST(IonBinaryFloat, WriterSupportsCompactFloatsOption) {
     //    4    0    8    6    6    6    6    6
     test_ion_binary_writer_supports_compact_floats(TRUE, truncated, "\xE0\x01\x00\xEA\x44\x40\x86\x66\x66", 9);
 }
+
+TEST(IonBinaryReader, StringViewPointsIntoInputBuffer) {
+    // "abc" followed by the symbol 'name' ($4) and the clob {{"xy"}}
+    BYTE data[] = "\xE0\x01\x00\xEA\x83\x61\x62\x63\x71\x04\x92\x78\x79";
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, sizeof(data) - 1, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_read_string_view(reader, &value));
+    ASSERT_EQ(3, value.length);
+    ASSERT_EQ(&data[5], value.value);
+
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_string_view(reader, &value));
+    assertStringsEqual("name", (char *)value.value, value.length);
+
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_CLOB, type);
+    ION_ASSERT_OK(ion_reader_read_lob_view(reader, &value));
+    ASSERT_EQ(2, value.length);
+    ASSERT_EQ(&data[11], value.value);
+
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonBinaryReader, StringViewRejectsInvalidUtf8) {
+    // a two byte UTF-8 header with no trailing byte
+    BYTE data[] = "\xE0\x01\x00\xEA\x81\xC3";
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, sizeof(data) - 1, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ASSERT_EQ(IERR_INVALID_UTF8, ion_reader_read_string_view(reader, &value));
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+iERR test_binary_chunk_handler(struct _ion_user_stream *pstream) {
+    iENTER;
+    _ion_user_stream *next_stream = (_ion_user_stream *)pstream->handler_state;
+    if (!next_stream) FAILWITH(IERR_EOF);
+    memcpy(pstream, next_stream, sizeof(_ion_user_stream));
+    iRETURN;
+}
+
+TEST(IonBinaryReader, StringViewCopiesValuesThatStraddlePages) {
+    // the string "abcdef" is split across two user stream pages
+    BYTE chunk1[] = "\xE0\x01\x00\xEA\x86\x61\x62";
+    BYTE chunk2[] = "\x63\x64\x65\x66";
+    _ion_user_stream chunk1_stream, chunk2_stream;
+    chunk1_stream.curr = chunk1;
+    chunk1_stream.limit = chunk1 + sizeof(chunk1) - 1;
+    chunk1_stream.handler_state = &chunk2_stream;
+    chunk1_stream.handler = &test_binary_chunk_handler;
+    chunk2_stream.curr = chunk2;
+    chunk2_stream.limit = chunk2 + sizeof(chunk2) - 1;
+    chunk2_stream.handler_state = NULL;
+    chunk2_stream.handler = &test_binary_chunk_handler;
+
+    ION_STREAM *stream = NULL;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    ION_ASSERT_OK(ion_stream_open_handler_in(&test_binary_chunk_handler, &chunk1_stream, &stream));
+    ION_ASSERT_OK(ion_reader_open(&reader, stream, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_read_string_view(reader, &value));
+    assertStringsEqual("abcdef", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
+
+TEST(IonBinaryReader, SkipsUnreadValueThatEndsTheStream) {
+    // the string "abcdef" is never read, and nothing follows it
+    BYTE chunk1[] = "\xE0\x01\x00\xEA\x86\x61\x62\x63\x64\x65\x66";
+    _ion_user_stream chunk1_stream;
+    chunk1_stream.curr = chunk1;
+    chunk1_stream.limit = chunk1 + sizeof(chunk1) - 1;
+    chunk1_stream.handler_state = NULL;
+    chunk1_stream.handler = &test_binary_chunk_handler;
+
+    ION_STREAM *stream = NULL;
+    hREADER reader;
+    ION_TYPE type;
+
+    ION_ASSERT_OK(ion_stream_open_handler_in(&test_binary_chunk_handler, &chunk1_stream, &stream));
+    ION_ASSERT_OK(ion_reader_open(&reader, stream, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
+
+TEST(IonBinaryWriter, WriteOneValueCopiesContainerBytes) {
+    // the list [1] with a trailing NOP pad; re-encoding would drop the pad, copying keeps it
+    BYTE data[] = "\xE0\x01\x00\xEA\xB3\x21\x01\x00";
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_TYPE type;
+    BYTE *result = NULL;
+    SIZE result_len;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, sizeof(data) - 1, NULL));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_LIST, type);
+    ION_ASSERT_OK(ion_writer_write_one_value(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    assertBytesEqual((char *)data, sizeof(data) - 1, result, result_len);
+    free(result);
+}
+
+TEST(IonBinaryWriter, WriteAllValuesRemapsLocalSymbols) {
+    // {b:a::c} with the local symbols [a, b, c]
+    BYTE data[] = "\xE0\x01\x00\xEA"
+                  "\xEB\x81\x83\xD8\x87\xB6\x81\x61\x81\x62\x81\x63"
+                  "\xD6\x8B\xE4\x81\x8A\x71\x0C";
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_TYPE type;
+    ION_STRING str;
+    BYTE *result = NULL;
+    SIZE result_len;
+    int32_t count;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, sizeof(data) - 1, NULL));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+    // 'z' takes sid 10 in the writer, so none of the reader's sids carry over
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&str, (char *)"z", 1)));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, result, result_len, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &str));
+    assertStringsEqual("z", (char *)str.value, str.length);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_get_field_name(reader, &str));
+    assertStringsEqual("b", (char *)str.value, str.length);
+    ION_ASSERT_OK(ion_reader_get_annotation_count(reader, &count));
+    ASSERT_EQ(1, count);
+    ION_ASSERT_OK(ion_reader_get_an_annotation(reader, 0, &str));
+    assertStringsEqual("a", (char *)str.value, str.length);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &str));
+    assertStringsEqual("c", (char *)str.value, str.length);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(result);
+}
+
+// writes the values in data after the first skip as text
+void ion_test_binary_values_as_text(BYTE *data, SIZE len, int skip, std::string *text) {
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_TYPE type;
+    BYTE *result = NULL;
+    SIZE result_len;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, len, NULL));
+    for (int ii = 0; ii < skip; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+    }
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, FALSE));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    text->assign((char *)result, (size_t)result_len);
+    free(result);
+}
+
+TEST(IonBinaryWriter, WriteOneValuePatchesSidsThatChangeLength) {
+    // The reader's sids for s0..s199 are 10..209. With one symbol ahead of them in the writer, the referenced ones
+    // are renumbered from 11 and their encodings shrink (s120 is 130, a two byte VarUInt, and s250 isn't there);
+    // with 300 ahead of them they're renumbered from 310 and grow.
+    std::string input = "[", expected, actual;
+    char buffer[16];
+    hREADER reader;
+    hWRITER writer;
+    hSYMTAB symtab;
+    ION_STREAM *stream;
+    ION_TYPE type;
+    ION_STRING str;
+    BYTE *data = NULL, *result = NULL;
+    SIZE data_len, result_len;
+    SID max_id;
+    const char *value = "x::{s0:[s120::s199, {s1:s0}, s120::[]], s120:\"str\", s2:s0::null.int, s3:true, "
+                        "s4:1.5e0, s5:(s6 s7::s8)}";
+
+    for (int ii = 0; ii < 200; ii++) {
+        snprintf(buffer, sizeof(buffer), "s%d,", ii);
+        input += buffer;
+    }
+    input += "] ";
+    input += value;
+    ION_ASSERT_OK(ion_test_new_text_reader(input.c_str(), &reader));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ion_test_binary_values_as_text(data, data_len, 1, &expected);
+
+    for (int ahead = 1; ahead <= 300; ahead += 299) {
+        ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_len, NULL));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRUCT, type);
+        ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+        for (int ii = 0; ii < ahead; ii++) {
+            snprintf(buffer, sizeof(buffer), "z%d", ii);
+            ION_ASSERT_OK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&str, buffer, (SIZE)strlen(buffer))));
+        }
+        ION_ASSERT_OK(ion_writer_write_one_value(writer, reader));
+        // only the symbols the value references were added: x, s0..s8, s120 and s199
+        ION_ASSERT_OK(ion_writer_get_symbol_table(writer, &symtab));
+        ION_ASSERT_OK(ion_symbol_table_get_max_sid(symtab, &max_id));
+        ASSERT_EQ(9 + ahead + 12, max_id);
+        ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+        ION_ASSERT_OK(ion_reader_close(reader));
+
+        ion_test_binary_values_as_text(result, result_len, ahead, &actual);
+        ASSERT_EQ(expected, actual);
+        free(result);
+    }
+    free(data);
+}
+
+void test_ion_binary_write_padded_from_text(const char *ion_text, BYTE **result, SIZE *result_len) {
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_WRITER_OPTIONS options;
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ion_event_initialize_writer_options(&options);
+    options.output_as_binary = TRUE;
+    options.pad_container_lengths = TRUE;
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, &options));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, result, result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+void test_ion_binary_to_text(BYTE *data, SIZE data_len, BYTE **result, SIZE *result_len) {
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_len, NULL));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, FALSE));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, result, result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonBinaryWriter, PadContainerLengthsReservesFixedWidthLengths) {
+    BYTE *result = NULL;
+    SIZE result_len;
+
+    test_ion_binary_write_padded_from_text("[1] a::{}", &result, &result_len);
+    // the list and the struct (and the annotation wrapper around it) each get a four byte length;
+    // the local symbol table is written separately and keeps its minimal lengths
+    assertBytesEqual("\xE0\x01\x00\xEA"
+                     "\xE7\x81\x83\xD4\x87\xB2\x81\x61"
+                     "\xBE\x00\x00\x00\x82\x21\x01"
+                     "\xEE\x00\x00\x00\x87\x81\x8A\xDE\x00\x00\x00\x80",
+                     31, result, result_len);
+    free(result);
+}
+
+TEST(IonBinaryWriter, PadContainerLengthsRoundTrips) {
+    const char *ion_text = "{a:[1,\"two\",(three 4e+0)],b:c::d::{e:{{\"blob\"}},f:[]},g:{}} 5 [[[6]]]";
+    BYTE *binary = NULL, *text = NULL;
+    SIZE binary_len, text_len;
+
+    test_ion_binary_write_padded_from_text(ion_text, &binary, &binary_len);
+    test_ion_binary_to_text(binary, binary_len, &text, &text_len);
+    assertStringsEqual(ion_text, (char *)text, text_len);
+    free(binary);
+    free(text);
+}
+
+TEST(IonBinaryWriter, PadContainerLengthsFillsLengthsAcrossPages) {
+    // a top level list much larger than a stream page, so its length is filled in on an earlier page
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_WRITER_OPTIONS options;
+    ION_TYPE type;
+    BYTE *result = NULL;
+    SIZE result_len;
+    int64_t value;
+    int ii;
+
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ion_event_initialize_writer_options(&options);
+    options.output_as_binary = TRUE;
+    options.pad_container_lengths = TRUE;
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, &options));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+    for (ii = 0; ii < 10000; ii++) {
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_SEXP));
+        ION_ASSERT_OK(ion_writer_write_int64(writer, ii));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+    }
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, result, result_len, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_LIST, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    for (ii = 0; ii < 10000; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_SEXP, type);
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_read_int64(reader, &value));
+        ASSERT_EQ(ii, value);
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(result);
+}
+
+TEST(IonBinaryReader, PushReaderWaitsForCompleteTopLevelValues) {
+    // a local symbol table declaring 'name', then {name:"abc"} and 1
+    BYTE data[] = "\xE0\x01\x00\xEA"
+                  "\xEA\x81\x83\xD7\x87\xB5\x84\x6E\x61\x6D\x65"
+                  "\xD5\x8A\x83\x61\x62\x63"
+                  "\x21\x01";
+    SIZE data_len = sizeof(data) - 1;
+    SIZE struct_end = data_len - 2;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+    int64_t int_value;
+    SIZE ii;
+
+    ION_ASSERT_OK(ion_reader_open_push(&reader, NULL));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+
+    // one byte at a time, nothing is returned until the struct is all there
+    for (ii = 0; ii < struct_end - 1; ii++) {
+        ION_ASSERT_OK(ion_reader_push(reader, &data[ii], 1));
+        ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    }
+    ION_ASSERT_OK(ion_reader_push(reader, &data[ii], 1));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_get_field_name(reader, &value));
+    assertStringsEqual("name", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+    assertStringsEqual("abc", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, &data[struct_end], 2));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &int_value));
+    ASSERT_EQ(1, int_value);
+
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push_eof(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ASSERT_EQ(IERR_INVALID_STATE, ion_reader_push(reader, data, 1));
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonBinaryReader, PushReaderSkipsUnreadValues) {
+    // "abcdef" is never read, next has to skip it even though it was pushed in pieces
+    BYTE data[] = "\xE0\x01\x00\xEA\x86\x61\x62\x63\x64\x65\x66\x21\x07";
+    hREADER reader;
+    ION_TYPE type;
+    int64_t int_value;
+
+    ION_ASSERT_OK(ion_reader_open_push(&reader, NULL));
+    ION_ASSERT_OK(ion_reader_push(reader, data, 8));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, &data[8], 3));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, &data[11], 1));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, &data[12], 1));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &int_value));
+    ASSERT_EQ(7, int_value);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonBinaryReader, PushReaderFailsOnTruncatedValueAtEof) {
+    BYTE data[] = "\xE0\x01\x00\xEA\x86\x61\x62";
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    ION_ASSERT_OK(ion_reader_open_push(&reader, NULL));
+    ION_ASSERT_OK(ion_reader_push(reader, data, sizeof(data) - 1));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push_eof(reader));
+    iERR err = ion_reader_next(reader, &type);
+    if (err == IERR_OK) {
+        ASSERT_EQ(tid_STRING, type);
+        err = ion_reader_read_string(reader, &value);
+    }
+    ASSERT_NE(IERR_OK, err);
+    ASSERT_NE(IERR_NEED_MORE_DATA, err);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonBinaryReader, ReaderGrowsStacksPastItsOptions) {
+    // deeper, and more heavily annotated, than the default reader options describe
+    const int depth = 100, annotation_count = 25;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_WRITER_OPTIONS writer_options;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING annotation, annotations[annotation_count];
+    BYTE *data;
+    SIZE data_len, reader_depth, count;
+    int32_t int_count;
+    int value;
+    char text[annotation_count][8];
+
+    memset(&writer_options, 0, sizeof(writer_options));
+    writer_options.output_as_binary = TRUE;
+    writer_options.max_annotation_count = annotation_count;
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, &writer_options));
+    for (int ii = 0; ii < depth; ii++) {
+        ION_ASSERT_OK(ion_writer_start_container(writer, (ii % 2) ? tid_STRUCT : tid_LIST));
+        if (ii % 2) ION_ASSERT_OK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&annotation, (char *)"f", 1)));
+    }
+    for (int ii = 0; ii < annotation_count; ii++) {
+        snprintf(text[ii], sizeof(text[ii]), "a%d", ii);
+        ION_ASSERT_OK(ion_writer_add_annotation(writer, ion_string_assign_cstr(&annotation, text[ii], (SIZE)strlen(text[ii]))));
+    }
+    ION_ASSERT_OK(ion_writer_write_int(writer, 7));
+    for (int ii = 0; ii < depth; ii++) {
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_len, NULL));
+    for (int ii = 0; ii < depth; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+    }
+    ION_ASSERT_OK(ion_reader_get_depth(reader, &reader_depth));
+    ASSERT_EQ(depth, reader_depth);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_get_annotation_count(reader, &int_count));
+    ASSERT_EQ(annotation_count, int_count);
+    ION_ASSERT_OK(ion_reader_get_annotations(reader, annotations, annotation_count, &count));
+    ASSERT_EQ(annotation_count, count);
+    for (int ii = 0; ii < annotation_count; ii++) {
+        assertStringsEqual(text[ii], (char *)annotations[ii].value, annotations[ii].length);
+    }
+    ION_ASSERT_OK(ion_reader_read_int(reader, &value));
+    ASSERT_EQ(7, value);
+    for (int ii = depth; ii > 0; ii--) {
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+        ION_ASSERT_OK(ion_reader_get_depth(reader, &reader_depth));
+        ASSERT_EQ(ii - 1, reader_depth);
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(data);
+}
+
+TEST(IonBinaryReader, ReadsArraysOfScalars) {
+    const int count = 1000;
+    hWRITER writer;
+    ION_STREAM *stream;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING annotation;
+    ION_TIMESTAMP timestamp;
+    BYTE *data;
+    SIZE data_len, read_count, total;
+    int64_t ints[64];
+    double doubles[64];
+    BOOL bools[64];
+    time_t times[4];
+    time_t epoch = 1500000000;
+
+    for (int is_binary = 0; is_binary <= 1; is_binary++) {
+        ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, (BOOL)is_binary));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        for (int ii = 0; ii < count; ii++) {
+            // one annotated value in the middle, which the binary reader can't decode directly
+            if (ii == 500) ION_ASSERT_OK(ion_writer_add_annotation(writer, ion_string_assign_cstr(&annotation, (char *)"a", 1)));
+            ION_ASSERT_OK(ion_writer_write_int64(writer, (ii % 3 == 0) ? -ii * 1000003LL : (ii == 1) ? INT64_MIN : (ii == 2) ? INT64_MAX : ii));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_SEXP));
+        for (int ii = 0; ii < count; ii++) {
+            ION_ASSERT_OK(ion_writer_write_double(writer, (ii % 2) ? ii / 4.0 : 0));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        for (int ii = 0; ii < count; ii++) {
+            ION_ASSERT_OK(ion_writer_write_bool(writer, (BOOL)(ii % 3 == 0)));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        for (int ii = 0; ii < 2; ii++) {
+            time_t time = epoch + ii;
+            ION_ASSERT_OK(ion_timestamp_for_time_t(&timestamp, &time));
+            ION_ASSERT_OK(ion_writer_write_timestamp(writer, &timestamp));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        ION_ASSERT_OK(ion_writer_write_int64(writer, 1));
+        ION_ASSERT_OK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&annotation, (char *)"a", 1)));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+
+        ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_len, NULL));
+        ASSERT_EQ(IERR_INVALID_STATE, ion_reader_read_int64_array(reader, ints, 64, &read_count));
+
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        for (total = 0; total < count; total += read_count) {
+            ION_ASSERT_OK(ion_reader_read_int64_array(reader, ints, 64, &read_count));
+            ASSERT_EQ((count - total < 64) ? count - total : 64, read_count);
+            for (int ii = 0; ii < read_count; ii++) {
+                int jj = total + ii;
+                ASSERT_EQ((jj % 3 == 0) ? -jj * 1000003LL : (jj == 1) ? INT64_MIN : (jj == 2) ? INT64_MAX : jj, ints[ii]);
+            }
+        }
+        // Having read fewer than asked for, the reader is at the end of the list.
+        ION_ASSERT_OK(ion_reader_get_type(reader, &type));
+        ASSERT_EQ(tid_EOF, type);
+        ION_ASSERT_OK(ion_reader_read_int64_array(reader, ints, 64, &read_count));
+        ASSERT_EQ(0, read_count);
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        for (total = 0; total < count; total += read_count) {
+            ION_ASSERT_OK(ion_reader_read_double_array(reader, doubles, 64, &read_count));
+            ASSERT_LT(0, read_count);
+            for (int ii = 0; ii < read_count; ii++) {
+                int jj = total + ii;
+                ASSERT_EQ((jj % 2) ? jj / 4.0 : 0, doubles[ii]);
+            }
+        }
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        for (total = 0; total < count; total += read_count) {
+            ION_ASSERT_OK(ion_reader_read_bool_array(reader, bools, 64, &read_count));
+            ASSERT_LT(0, read_count);
+            for (int ii = 0; ii < read_count; ii++) {
+                ASSERT_EQ((BOOL)((total + ii) % 3 == 0), bools[ii]);
+            }
+        }
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        ION_ASSERT_OK(ion_reader_read_timestamp_epoch_array(reader, times, 4, &read_count));
+        ASSERT_EQ(2, read_count);
+        ASSERT_EQ(epoch, times[0]);
+        ASSERT_EQ(epoch + 1, times[1]);
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        ASSERT_EQ(IERR_INVALID_STATE, ion_reader_read_int64_array(reader, ints, 64, &read_count));
+        ASSERT_EQ(1, read_count);
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+
+        ION_ASSERT_OK(ion_reader_close(reader));
+        free(data);
+    }
+}
+
+TEST(IonBinaryWriter, WritesArraysOfScalars) {
+    const int count = 2000;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_STRING field_name, annotation;
+    BYTE *expected, *actual;
+    SIZE expected_len, actual_len;
+    int64_t *ints = (int64_t *)malloc(count * sizeof(int64_t));
+    double *doubles = (double *)malloc(count * sizeof(double));
+    BOOL *bools = (BOOL *)malloc(count * sizeof(BOOL));
+
+    for (int ii = 0; ii < count; ii++) {
+        ints[ii] = (ii % 3 == 0) ? -ii * 1000003LL : (ii == 1) ? INT64_MIN : (ii == 2) ? INT64_MAX : ii;
+        doubles[ii] = (ii % 2) ? ii / 4.0 : (ii == 4) ? -0.0 : 0;
+        bools[ii] = (BOOL)(ii % 3 == 0);
+    }
+    ion_string_assign_cstr(&field_name, (char *)"f", 1);
+    ion_string_assign_cstr(&annotation, (char *)"a", 1);
+
+    for (int is_binary = 0; is_binary <= 1; is_binary++) {
+        // The same values, one at a time.
+        ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, (BOOL)is_binary));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        for (int ii = 0; ii < count; ii++) {
+            ION_ASSERT_OK(ion_writer_write_int64(writer, ints[ii]));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_name));
+        ION_ASSERT_OK(ion_writer_add_annotation(writer, &annotation));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_SEXP));
+        for (int ii = 0; ii < count; ii++) {
+            ION_ASSERT_OK(ion_writer_write_double(writer, doubles[ii]));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_name));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        for (int ii = 0; ii < 3; ii++) {
+            ION_ASSERT_OK(ion_writer_write_bool(writer, bools[ii]));
+        }
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &expected, &expected_len));
+
+        ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, (BOOL)is_binary));
+        ASSERT_EQ(IERR_INVALID_ARG, ion_writer_write_int64_array(writer, tid_STRUCT, ints, count));
+        ION_ASSERT_OK(ion_writer_write_int64_array(writer, tid_LIST, ints, count));
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_name));
+        ION_ASSERT_OK(ion_writer_add_annotation(writer, &annotation));
+        ION_ASSERT_OK(ion_writer_write_double_array(writer, tid_SEXP, doubles, count));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_name));
+        ION_ASSERT_OK(ion_writer_write_bool_array(writer, tid_LIST, bools, 3));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+        ION_ASSERT_OK(ion_writer_write_int64_array(writer, tid_LIST, NULL, 0));
+        ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &actual, &actual_len));
+
+        assertBytesEqual((const char *)expected, expected_len, actual, actual_len);
+        free(expected);
+        free(actual);
+    }
+
+    free(ints);
+    free(doubles);
+    free(bools);
+}
+
+TEST(IonBinary, DecodesVarUIntsVarIntsAndUInts) {
+    const uint64_t uints[] = {
+        0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000, 0xFFFFFFFF, 0xFFFFFFFFFFFFFFULL, 0x100000000000000ULL,
+        0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, 0xFFFFFFFFFFFFFFFFULL
+    };
+    const int64_t ints[] = {
+        0, 1, -1, 0x3FFFFFFFFFFFFFLL, -0x3FFFFFFFFFFFFFLL, 64, -64, 8191, -8192, 0x7FFFFFFFFFFFFFLL, -0x7FFFFFFFFFFFFFLL, 0x80000000000000LL,
+        INT64_MAX, -INT64_MAX
+    };
+    const int count = sizeof(uints) / sizeof(uints[0]);
+    ION_STREAM *stream;
+    BYTE buffer[64];
+    SIZE length, uint_length;
+    uint64_t uint_value;
+    int64_t int_value;
+
+    for (int ii = 0; ii < count; ii++) {
+        // The value is written as a var uint, a var int and a uint, and read
+        // back with nothing after it, and with more than a word after it.
+        memset(buffer, 0, sizeof(buffer));
+        ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+        ION_ASSERT_OK(ion_binary_write_var_uint_64(stream, uints[ii]));
+        ION_ASSERT_OK(ion_binary_write_var_int_64(stream, ints[ii]));
+        uint_length = (SIZE)ion_stream_get_position(stream);
+        ION_ASSERT_OK(ion_binary_write_uint_64(stream, uints[ii]));
+        length = (SIZE)ion_stream_get_position(stream);
+        uint_length = length - uint_length;
+        ION_ASSERT_OK(ion_stream_seek(stream, 0));
+        ION_ASSERT_OK(ion_stream_read(stream, buffer, length, &length));
+        ION_ASSERT_OK(ion_stream_close(stream));
+
+        for (SIZE padding = 0; padding <= 16; padding += 16) {
+            ION_ASSERT_OK(ion_stream_open_buffer(buffer, length + padding, length + padding, TRUE, &stream));
+            ION_ASSERT_OK(ion_binary_read_var_uint_64(stream, &uint_value));
+            ASSERT_EQ(uints[ii], uint_value);
+            ION_ASSERT_OK(ion_binary_read_var_int_64(stream, &int_value));
+            ASSERT_EQ(ints[ii], int_value);
+            ION_ASSERT_OK(ion_binary_read_uint_64(stream, uint_length, &uint_value));
+            ASSERT_EQ(uints[ii], uint_value);
+            ASSERT_EQ(length, ion_stream_get_position(stream));
+            ION_ASSERT_OK(ion_stream_close(stream));
+        }
+    }
+
+    // A var uint with no stop bit runs past 64 bits, or off the end of the buffer.
+    memset(buffer, 0x01, 16);
+    ION_ASSERT_OK(ion_stream_open_buffer(buffer, 16, 16, TRUE, &stream));
+    ASSERT_EQ(IERR_NUMERIC_OVERFLOW, ion_binary_read_var_uint_64(stream, &uint_value));
+    ION_ASSERT_OK(ion_stream_close(stream));
+    ION_ASSERT_OK(ion_stream_open_buffer(buffer, 4, 4, TRUE, &stream));
+    ASSERT_EQ(IERR_UNEXPECTED_EOF, ion_binary_read_var_uint_64(stream, &uint_value));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
+
+TEST(IonBinary, PerfCountsArrayValuesAndConsumedBytes) {
+    const int count = 100;
+    int64_t ints[count], read_ints[count];
+    hWRITER writer;
+    hREADER reader;
+    ION_STREAM *stream;
+    BYTE *data;
+    SIZE data_len, read_count;
+    ION_TYPE type;
+    ION_PERF_STATS stats;
+
+    for (int ii = 0; ii < count; ii++) {
+        ints[ii] = ii * 1000;
+    }
+
+    ion_perf_reset();
+    ion_perf_enable(TRUE);
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+    ION_ASSERT_OK(ion_writer_write_int64_array(writer, tid_LIST, ints, count));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+
+    ION_ASSERT_OK(ion_test_new_reader(data, data_len, &reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_read_int64_array(reader, read_ints, count, &read_count));
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ion_perf_enable(FALSE);
+    ion_perf_get_stats(&stats);
+    free(data);
+
+    ASSERT_EQ(count, read_count);
+    ASSERT_EQ(count, stats.values_written[ION_PERF_TYPE_INDEX(tid_INT)]);
+    ASSERT_EQ(1, stats.values_written[ION_PERF_TYPE_INDEX(tid_LIST)]);
+    ASSERT_EQ(count, stats.values_read[ION_PERF_TYPE_INDEX(tid_INT)]);
+    ASSERT_EQ(1, stats.values_read[ION_PERF_TYPE_INDEX(tid_LIST)]);
+    // Only what the reader consumed, once, however the buffer was handed to it.
+    ASSERT_EQ(data_len, stats.bytes_read);
+}
@@ -12,6 +12,10 @@
  * language governing permissions and limitations under the License.
  */
 
+#include <sstream>
+#include <fstream>
+#include <unistd.h>
+#include <signal.h>
 #include <gtest/gtest.h>
 #include <ion_event_stream.h>
 #include "cli.h"
@@ -89,6 +93,18 @@ void test_ion_cli_compare(const char *input, ION_CLI_IO_TYPE input_type, ION_STR
     ion_cli_command_compare(&common_args, comparison_type, command_output, report);
 }
 
+void test_ion_cli_filter_input(IonCliIO input, const char *filter, ION_STRING *command_output,
+                               IonEventReport *report) {
+    IonCliCommonArgs common_args;
+    IonCliProcessArgs process_args;
+    test_ion_cli_init_common_args(&common_args);
+    common_args.input_files.push_back(input);
+    test_ion_cli_init_process_args(&process_args);
+    process_args.filter = filter;
+    ION_STRING_INIT(command_output);
+    ion_cli_command_process(&common_args, &process_args, command_output, report);
+}
+
 void test_ion_cli_read_stream_successfully(BYTE *data, size_t data_len, IonEventStream *stream) {
     hREADER reader;
     IonEventResult result;
@@ -111,6 +127,29 @@ void test_ion_cli_assert_streams_equal(const char *expected_str, ION_STRING *act
     ASSERT_FALSE(result.has_error_description);
 }
 
+/**
+ * Filters the given text, and the same data as binary, expecting the given output from both.
+ */
+void test_ion_cli_assert_filter_outputs(const char *input, const char *filter, const char *expected) {
+    ION_STRING text_output, binary_input, binary_output;
+    IonEventReport text_report, binary_report, conversion_report;
+
+    test_ion_cli_filter_input(IonCliIO(input, IO_TYPE_MEMORY), filter, &text_output, &text_report);
+    ASSERT_FALSE(text_report.hasErrors());
+    test_ion_cli_assert_streams_equal(expected, &text_output);
+    ion_cli_free_command_output(&text_output);
+
+    ION_STRING_INIT(&binary_input);
+    test_ion_cli_process(input, IO_TYPE_MEMORY, &binary_input, &conversion_report, OUTPUT_TYPE_BINARY);
+    ASSERT_FALSE(conversion_report.hasErrors());
+    test_ion_cli_filter_input(IonCliIO(std::string((char *)binary_input.value, (size_t)binary_input.length),
+                                       IO_TYPE_MEMORY), filter, &binary_output, &binary_report);
+    ASSERT_FALSE(binary_report.hasErrors());
+    test_ion_cli_assert_streams_equal(expected, &binary_output);
+    ion_cli_free_command_output(&binary_input);
+    ion_cli_free_command_output(&binary_output);
+}
+
 TEST(IonCli, ProcessBasic) {
     ION_STRING command_output;
     IonEventReport report;
@@ -589,3 +628,221 @@ TEST(IonCli, ComparingInnerVersionMarkersSucceeds) {
     ASSERT_FALSE(report2.hasErrors());
     free(events);
 }
+
+TEST(IonCli, FilterFollowsPaths) {
+    const char *input = "{a:{b:[1, 2, 3]}, c:d} {a:{b:[4]}} {a:{\"x y\":5}} [6, {b:7}] 8";
+    test_ion_cli_assert_filter_outputs(input, ".", input);
+    test_ion_cli_assert_filter_outputs(input, ".a.b[1]", "2");
+    test_ion_cli_assert_filter_outputs(input, ".a.b[]", "1 2 3 4");
+    test_ion_cli_assert_filter_outputs(input, ".a | .b | .[0]", "1 4");
+    test_ion_cli_assert_filter_outputs(input, ".a.\"x y\" | .", "5");
+    test_ion_cli_assert_filter_outputs(input, ".[\"c\"]", "d");
+    test_ion_cli_assert_filter_outputs(input, ".[1].b", "7");
+    test_ion_cli_assert_filter_outputs(input, ".[]", "{b:[1, 2, 3]} d {b:[4]} {\"x y\":5} 6 {b:7}");
+}
+
+TEST(IonCli, FilterSelectsOnTheValueItself) {
+    const char *input = "[1, 5, 10, 5.0, \"5\", null.int] [2019T, 2020-06-01T, \"abc\", abd]";
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. == 5)", "5");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. > 1 and . <= 10)", "5 10");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. != 5)",
+                                       "1 10 5.0 \"5\" null.int 2019T 2020-06-01T \"abc\" abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. != 5.0)",
+                                       "1 5 10 \"5\" null.int 2019T 2020-06-01T \"abc\" abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. != \"abc\" and . != 2019T)",
+                                       "1 5 10 5.0 \"5\" null.int 2020-06-01T abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. != null)",
+                                       "1 5 10 5.0 \"5\" 2019T 2020-06-01T \"abc\" abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. > 2019-06-01T)", "2020-06-01T");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. >= \"abc\")", "\"abc\" abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. == 'abd')", "abd");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. == 5.0)", "5.0");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. == 5.00)", "");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. == null)", "null.int");
+    test_ion_cli_assert_filter_outputs(input, ".[] | select(. > 5 or . < 2)", "1 10");
+    test_ion_cli_assert_filter_outputs(input, "select(.[0] == 1)", "[1, 5, 10, 5.0, \"5\", null.int]");
+}
+
+TEST(IonCli, FilterSelectsOnChildren) {
+    const char *input = "{name:a, n:1, tags:[x, y], ok:true} {name:b, n:7, tags:[z], ok:false} {name:c, n:null} 3";
+    test_ion_cli_assert_filter_outputs(input, "select(.n > 1) | .name", "b");
+    test_ion_cli_assert_filter_outputs(input, "select(.ok) | .name", "a");
+    test_ion_cli_assert_filter_outputs(input, "select(.ok == false or .n == null) | .name", "b c");
+    test_ion_cli_assert_filter_outputs(input, "select(.n >= 1 and .n < 7 or .tags[] == z) | .name", "a b");
+    test_ion_cli_assert_filter_outputs(input, "select(.tags[1]) | .tags", "[x, y]");
+    test_ion_cli_assert_filter_outputs(input, "select(.n > 0) | select(.tags[0] == z) | .tags[] | select(. == z)",
+                                       "z");
+    test_ion_cli_assert_filter_outputs(input, "select(.name != a) | .n | select(. != null)", "7");
+    // A path that leads to nothing compares as null.
+    test_ion_cli_assert_filter_outputs(input, "select(.n != 1) | .name", "b c");
+    test_ion_cli_assert_filter_outputs(input, "select(.ok == null) | .name", "c");
+    test_ion_cli_assert_filter_outputs(input, "select(.ok != true) | .name", "b c");
+    test_ion_cli_assert_filter_outputs(input, "select(.tags[0] != x) | .name", "b c");
+    test_ion_cli_assert_filter_outputs(input, "select(.n < 7) | .name", "a");
+    test_ion_cli_assert_filter_outputs(input, "select(.n != 1)",
+                                       "{name:b, n:7, tags:[z], ok:false} {name:c, n:null} 3");
+}
+
+TEST(IonCli, FilterSelectsOnChildrenOfManyValues) {
+    // Enough values that the filter's copies of them span several symbol tables.
+    std::ostringstream input, expected;
+    for (int i = 0; i < 2500; i++) {
+        input << "{id:" << i << ", kind:k" << (i % 3) << ", sym:s" << i << "} ";
+        if (i % 3 == 1) {
+            expected << "s" << i << " ";
+        }
+    }
+    test_ion_cli_assert_filter_outputs(input.str().c_str(), "select(.kind == k1) | .sym", expected.str().c_str());
+}
+
+TEST(IonCli, FilterSelectsAnnotatedValues) {
+    // Annotations and symbols keep their meaning in the filter's copies of the values, however those are made.
+    std::ostringstream input, expected, expected_tags;
+    for (int i = 0; i < 200; i++) {
+        input << "a" << (i % 5) << "::{id:" << i << ", tags:[t" << i << ", u::" << i << "]} ";
+        if (i % 50 == 7) {
+            expected << "a" << (i % 5) << "::{id:" << i << ", tags:[t" << i << ", u::" << i << "]} ";
+            expected_tags << "t" << i << " ";
+        }
+    }
+    test_ion_cli_assert_filter_outputs(input.str().c_str(), "select(.id == 7 or .id == 57 or .id == 107 or .id == 157)",
+                                       expected.str().c_str());
+    test_ion_cli_assert_filter_outputs(input.str().c_str(),
+                                       "select(.id > 0) | .tags[] | select(. == t7 or . == t57 or . == t107 or "
+                                       ". == t157)",
+                                       expected_tags.str().c_str());
+}
+
+TEST(IonCli, FilterSyntaxErrorIsConveyed) {
+    const char *filters[] = {"a", ".a[", ".[-1]", "select(.a", "select(.a > )", "select(.a == true false)",
+                             "select(.a < null)", ".a | ", ".a .b", "select(.a > {})"};
+    for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++) {
+        ION_STRING command_output;
+        IonEventReport report;
+        test_ion_cli_filter_input(IonCliIO("{a:1}", IO_TYPE_MEMORY), filters[i], &command_output, &report);
+        ASSERT_TRUE(report.hasErrors()) << filters[i];
+        ASSERT_EQ(ERROR_TYPE_STATE, report.getErrors()->at(0).error_type) << filters[i];
+        ion_cli_free_command_output(&command_output);
+    }
+}
+
+TEST(IonCli, FilterWithEventsOutputFails) {
+    IonCliCommonArgs common_args;
+    IonCliProcessArgs process_args;
+    ION_STRING command_output;
+    IonEventReport report;
+    test_ion_cli_init_common_args(&common_args, OUTPUT_TYPE_EVENTS);
+    test_ion_cli_add_input("{a:1}", IO_TYPE_MEMORY, &common_args);
+    test_ion_cli_init_process_args(&process_args);
+    process_args.filter = ".a";
+    ION_STRING_INIT(&command_output);
+    ion_cli_command_process(&common_args, &process_args, &command_output, &report);
+    ASSERT_TRUE(report.hasErrors());
+    ion_cli_free_command_output(&command_output);
+}
+
+/**
+ * Moves to the field with the given name among the rest of the current struct's fields.
+ */
+void test_ion_cli_next_field(hREADER reader, const char *name) {
+    ION_TYPE type;
+    ION_STRING field_name;
+    while (TRUE) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_NE(tid_EOF, type) << "Missing field " << name;
+        ION_ASSERT_OK(ion_reader_get_field_name(reader, &field_name));
+        if (field_name.length == strlen(name) && !memcmp(field_name.value, name, field_name.length)) return;
+    }
+}
+
+void test_ion_cli_assert_int_field(hREADER reader, const char *name, int64_t expected) {
+    int64_t actual;
+    test_ion_cli_next_field(reader, name);
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &actual));
+    ASSERT_EQ(expected, actual) << name;
+}
+
+void test_ion_cli_assert_value_count(hREADER reader, const char *type, int64_t expected) {
+    test_ion_cli_next_field(reader, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    test_ion_cli_assert_int_field(reader, "count", expected);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+}
+
+static void test_ion_cli_host_handler(int signal) {
+}
+
+TEST(IonCli, ProcessWithPerfReport) {
+    const char *input = "{a:1, b:[2, 3]} 4";
+    char report_path[] = "/tmp/ion_cli_perf_report_XXXXXX";
+    IonCliCommonArgs common_args;
+    IonCliProcessArgs process_args;
+    ION_STRING command_output;
+    IonEventReport report;
+    std::stringstream report_contents;
+    std::string report_data;
+    hREADER reader;
+    ION_TYPE type;
+    int phases = 0;
+    struct sigaction host_action, previous_action, restored_action;
+
+    int fd = mkstemp(report_path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    // A program the CLI is embedded in keeps its own handler.
+    memset(&host_action, 0, sizeof(host_action));
+    host_action.sa_handler = test_ion_cli_host_handler;
+    sigemptyset(&host_action.sa_mask);
+    ASSERT_EQ(0, sigaction(SIGPROF, &host_action, &previous_action));
+
+    test_ion_cli_init_common_args(&common_args);
+    test_ion_cli_add_input(input, IO_TYPE_MEMORY, &common_args);
+    test_ion_cli_init_process_args(&process_args);
+    process_args.perf_report = IonCliIO(report_path);
+    ION_STRING_INIT(&command_output);
+    ion_cli_command_process(&common_args, &process_args, &command_output, &report);
+    ASSERT_EQ(0, sigaction(SIGPROF, &previous_action, &restored_action));
+    ASSERT_EQ((void *)test_ion_cli_host_handler, (void *)restored_action.sa_handler);
+    ASSERT_FALSE(report.hasErrors());
+    test_ion_cli_assert_streams_equal(input, &command_output);
+    ion_cli_free_command_output(&command_output);
+
+    std::ifstream report_file(report_path);
+    report_contents << report_file.rdbuf();
+    report_data = report_contents.str();
+    remove(report_path);
+
+    ION_ASSERT_OK(ion_test_new_reader((BYTE *)report_data.c_str(), (SIZE)report_data.length(), &reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+
+    test_ion_cli_next_field(reader, "phases");
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    while (TRUE) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        phases++;
+    }
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+    ASSERT_EQ(ION_PERF_PHASE_COUNT, phases);
+
+    test_ion_cli_assert_int_field(reader, "bytes_read", (int64_t)strlen(input));
+
+    test_ion_cli_next_field(reader, "values_read");
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    test_ion_cli_assert_value_count(reader, "INT", 4);
+    test_ion_cli_assert_value_count(reader, "LIST", 1);
+    test_ion_cli_assert_value_count(reader, "STRUCT", 1);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+
+    test_ion_cli_next_field(reader, "values_written");
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    test_ion_cli_assert_value_count(reader, "INT", 4);
+    test_ion_cli_assert_value_count(reader, "LIST", 1);
+    test_ion_cli_assert_value_count(reader, "STRUCT", 1);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
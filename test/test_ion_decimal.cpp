@@ -703,3 +703,27 @@ TEST(IonDecimal, ToAndFromString) {
     ION_DECIMAL_FREE_5(&ion_quad, &ion_number_small, &ion_number_large, &ion_quad_after, &ion_number_small_after);
     ION_DECIMAL_FREE_1(&ion_number_large_after);
 }
+
+TEST(IonTextDecimal, ReaderBuildsQuadsLikeFromString) {
+    // the reader builds decQuads straight from the digits, these have to come out as decQuadFromString has them
+    const char *cases[] = {
+        "0.", "-0.", "0d-5", "-0.000", "1.50", "-123.456d7", "123.4500", "1d2", "1D-2", "12345678901234567890123456789012.34",
+        "-9999999999999999999999999999999999.", "0.000000000000000000000000000000000000001234", "1d6111", "1d-6176",
+        "1234d6110", "1d6140", "1.000000000000000000000000000000000",
+    };
+    decContext context;
+    decQuad expected, quad;
+    char expected_text[DECQUAD_String], text[DECQUAD_String];
+    ION_DECIMAL_READER_DECLARE;
+
+    decContextDefault(&context, DEC_INIT_DECQUAD);
+    for (size_t ii = 0; ii < sizeof(cases) / sizeof(cases[0]); ii++) {
+        decQuadFromString(&expected, cases[ii], &context);
+        ION_ASSERT_OK(ion_test_new_text_reader(cases[ii], &reader));
+        ION_DECIMAL_READER_NEXT;
+        ION_ASSERT_OK(ion_reader_read_decimal(reader, &quad));
+        ASSERT_EQ(0, memcmp(&expected, &quad, sizeof(quad)))
+            << cases[ii] << ": " << decQuadToString(&expected, expected_text) << " != " << decQuadToString(&quad, text);
+        ION_ASSERT_OK(ion_reader_close(reader));
+    }
+}
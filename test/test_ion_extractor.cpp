@@ -197,6 +197,14 @@ void assertMatchesInt1or3(hREADER reader, ION_EXTRACTOR_PATH_DESCRIPTOR *matched
     ASSERT_TRUE(value == 1 || value == 3);
 }
 
+/**
+ * Doesn't touch the reader, so it can follow an assertion that read the value (which a binary reader can only do once).
+ */
+void assertMatchesAny(hREADER reader, ION_EXTRACTOR_PATH_DESCRIPTOR *matched_path,
+                      ION_EXTRACTOR_PATH_DESCRIPTOR *original_path, ION_EXTRACTOR_CONTROL *control) {
+    ASSERT_TRUE(matched_path == original_path);
+}
+
 void assertMatchesTextDEForInt123(hREADER reader, ION_EXTRACTOR_PATH_DESCRIPTOR *matched_path,
                                   ION_EXTRACTOR_PATH_DESCRIPTOR *original_path, ION_EXTRACTOR_CONTROL *control) {
     ION_STRING str_value;
@@ -784,6 +792,300 @@ TEST(IonExtractorSucceedsWhen, SkippingNestedSexps) {
     ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 0);
 }
 
+/**
+ * Writes {first_name: first_value, second_name: second_value} as a binary stream of its own, which starts with a local
+ * symbol table that assigns SIDs to the field names in the order they're written.
+ */
+void writeBinaryStruct(const char *first_name, int first_value, const char *second_name, int second_value,
+                       BYTE **out, SIZE *len) {
+    hWRITER writer;
+    ION_STREAM *ion_stream;
+    ION_STRING field_name;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&field_name, (char *)first_name,
+                                                                             (SIZE)strlen(first_name))));
+    ION_ASSERT_OK(ion_writer_write_int(writer, first_value));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&field_name, (char *)second_name,
+                                                                             (SIZE)strlen(second_name))));
+    ION_ASSERT_OK(ion_writer_write_int(writer, second_value));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, out, len));
+}
+
+TEST(IonExtractorSucceedsWhen, FieldSIDsChangeMeaningBetweenSymbolTables) {
+    ION_EXTRACTOR_TEST_INIT;
+    BYTE *first, *second, *data;
+    SIZE first_len, second_len;
+
+    // Both streams assign SIDs 10 and 11 to abc and def, but in opposite orders.
+    writeBinaryStruct("abc", 3, "def", 1, &first, &first_len);
+    writeBinaryStruct("def", 1, "abc", 3, &second, &second_len);
+    data = (BYTE *)malloc((size_t)(first_len + second_len));
+    memcpy(data, first, (size_t)first_len);
+    memcpy(data + first_len, second, (size_t)second_len);
+
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(abc)", &assertMatchesInt3);
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(*)", &assertMatchesAny);
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(1)", &assertMatchesAny);
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(def)", &assertMatchesAny);
+
+    ION_ASSERT_OK(ion_test_new_reader(data, first_len + second_len, &reader));
+    ION_ASSERT_OK(ion_extractor_match(extractor, reader));
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 2);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(1, 4);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(2, 2);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(3, 2);
+
+    // The same extractor, over a new reader whose symbol table isn't the one it saw last.
+    ION_ASSERT_OK(ion_test_new_reader(second, second_len, &reader));
+    ION_EXTRACTOR_TEST_MATCH_READER(reader);
+
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 3);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(1, 6);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(2, 3);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(3, 3);
+
+    free(first);
+    free(second);
+    free(data);
+}
+
+TEST(IonExtractorSucceedsWhen, OrdinalPathsSkipTheRestOfTheContainer) {
+    ION_EXTRACTOR_TEST_INIT;
+    const char *ion_text = "{abc: [1, \"two\", 3, \"four\", {def: 3}], ghi: (1 2 3)}";
+
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(abc 2)", &assertMatchesInt3);
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(ghi 2)", &assertMatchesInt3);
+
+    ION_EXTRACTOR_TEST_MATCH;
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 1);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(1, 1);
+}
+
+TEST(IonExtractorSucceedsWhen, FieldPathsDoNotMatchInsideLists) {
+    ION_EXTRACTOR_TEST_INIT;
+    const char *ion_text = "{abc: [{def: 1}, def], ghi: {def: 3}}";
+
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(* def)", &assertMatchesInt3);
+
+    ION_EXTRACTOR_TEST_MATCH;
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 1);
+}
+
+TEST(IonExtractorSucceedsWhen, BinaryValuesAfterTheLastCandidateAreNotDecoded) {
+    ION_EXTRACTOR_TEST_INIT;
+    // [1, 2, 3, <a reserved type code>] then 3. The list's length lets the reader skip the bad byte without reading it.
+    BYTE ion_data[] = {0xE0, 0x01, 0x00, 0xEA, 0xB7, 0x21, 0x01, 0x21, 0x02, 0x21, 0x03, 0xF0, 0x21, 0x03};
+
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("(2)", &assertMatchesInt3);
+    ION_EXTRACTOR_TEST_PATH_FROM_TEXT("()", &assertMatchesAny);
+
+    ION_ASSERT_OK(ion_test_new_reader(ion_data, sizeof(ion_data), &reader));
+    ION_EXTRACTOR_TEST_MATCH_READER(reader);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 1);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(1, 2);
+}
+
+/**
+ * Counts the matches of the path it's registered with in an int given as user context.
+ */
+iERR countingCallback(hREADER reader, ION_EXTRACTOR_PATH_DESCRIPTOR *matched_path, void *user_context,
+                      ION_EXTRACTOR_CONTROL *control) {
+    (*(int *)user_context)++;
+    return IERR_OK;
+}
+
+/**
+ * Adds predicates to a path.
+ */
+typedef iERR (*ADD_PREDICATES)(hPATH path);
+
+/**
+ * Counts the values matched by the path from `path_text`, to whose last component `add_predicates` adds predicates,
+ * in `ion_text`, read both as text and as binary. The counts must agree.
+ */
+void countPredicateMatches(const char *ion_text, const char *path_text, ADD_PREDICATES add_predicates, int *p_count) {
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *ion_stream;
+    hEXTRACTOR extractor;
+    hPATH path;
+    BYTE *binary;
+    SIZE binary_len;
+    int text_count = 0, binary_count = 0;
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &binary, &binary_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    for (int is_binary = 0; is_binary < 2; is_binary++) {
+        ION_ASSERT_OK(ion_extractor_open(&extractor, NULL));
+        ION_ASSERT_OK(ion_extractor_path_create_from_ion(extractor, &countingCallback,
+                                                         is_binary ? &binary_count : &text_count, (BYTE *)path_text,
+                                                         (SIZE)strlen(path_text), &path));
+        ION_ASSERT_OK(add_predicates(path));
+        if (is_binary) {
+            ION_ASSERT_OK(ion_test_new_reader(binary, binary_len, &reader));
+        }
+        else {
+            ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+        }
+        ION_ASSERT_OK(ion_extractor_match(extractor, reader));
+        ION_ASSERT_OK(ion_extractor_close(extractor));
+        ION_ASSERT_OK(ion_reader_close(reader));
+    }
+    free(binary);
+    ASSERT_EQ(text_count, binary_count);
+    *p_count = text_count;
+}
+
+#define ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(n, ion_text, path_text, add_predicates) { \
+    int count; \
+    countPredicateMatches(ion_text, path_text, add_predicates, &count); \
+    ASSERT_EQ(n, count) << path_text << " over " << ion_text; \
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesCompareInts) {
+    const char *ion_text = "{status: 500} {status: 404} {status: 500} {status: null.int} {status: \"500\"} "
+                           "{status: -5} {status: 123456789012345678901234567890} {status: -9223372036854775808}";
+
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(status)", [](hPATH path) {
+        return ion_extractor_path_require_int(path, ION_EXTRACTOR_EQUALS, 500);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(4, ion_text, "(status)", [](hPATH path) {
+        return ion_extractor_path_require_int(path, ION_EXTRACTOR_NOT_EQUALS, 500);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(status)", [](hPATH path) {
+        return ion_extractor_path_require_int(path, ION_EXTRACTOR_LESS_THAN, 500);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(1, ion_text, "(status)", [](hPATH path) {
+        return ion_extractor_path_require_int(path, ION_EXTRACTOR_GREATER_THAN, 500);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(1, ion_text, "(status)", [](hPATH path) {
+        return ion_extractor_path_require_int(path, ION_EXTRACTOR_LESS_THAN_OR_EQUALS, INT64_MIN);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(status)", [](hPATH path) {
+        iENTER;
+        IONCHECK(ion_extractor_path_require_int(path, ION_EXTRACTOR_GREATER_THAN_OR_EQUALS, -5));
+        IONCHECK(ion_extractor_path_require_int(path, ION_EXTRACTOR_LESS_THAN, 500));
+        iRETURN;
+    });
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesCompareFloats) {
+    const char *ion_text = "[1.5e0, 2e0, nan, -0e0, 2, null.float]";
+
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(*)", [](hPATH path) {
+        return ion_extractor_path_require_float(path, ION_EXTRACTOR_GREATER_THAN, 1.0);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        return ion_extractor_path_require_float(path, ION_EXTRACTOR_NOT_EQUALS, 2.0);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(1, ion_text, "(*)", [](hPATH path) {
+        return ion_extractor_path_require_float(path, ION_EXTRACTOR_EQUALS, 0.0);
+    });
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesCompareText) {
+    const char *ion_text = "{a: foo, b: \"foo\", c: bar, d: x::'foo', e: food, f: fo, g: null.symbol, h: 1}";
+
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        ION_STRING text;
+        return ion_extractor_path_require_text(path, ION_EXTRACTOR_EQUALS, ion_string_assign_cstr(&text, (char *)"foo", 3));
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        ION_STRING text;
+        return ion_extractor_path_require_text(path, ION_EXTRACTOR_NOT_EQUALS, ion_string_assign_cstr(&text, (char *)"foo", 3));
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(*)", [](hPATH path) {
+        ION_STRING text;
+        return ion_extractor_path_require_text(path, ION_EXTRACTOR_LESS_THAN, ion_string_assign_cstr(&text, (char *)"foo", 3));
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(1, ion_text, "(*)", [](hPATH path) {
+        ION_STRING text;
+        return ion_extractor_path_require_text(path, ION_EXTRACTOR_GREATER_THAN, ion_string_assign_cstr(&text, (char *)"foo", 3));
+    });
+}
+
+/**
+ * Requires timestamps that compare to the one in `text` as specified.
+ */
+iERR requireTimestamp(hPATH path, ION_EXTRACTOR_COMPARISON comparison, const char *text) {
+    iENTER;
+    ION_TIMESTAMP timestamp;
+    decContext context;
+    SIZE used;
+
+    decContextDefault(&context, DEC_INIT_DECQUAD);
+    IONCHECK(ion_timestamp_parse(&timestamp, (char *)text, (SIZE)strlen(text), &used, &context));
+    IONCHECK(ion_extractor_path_require_timestamp(path, comparison, &timestamp));
+    iRETURN;
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesCompareTimestamps) {
+    const char *ion_text = "[2020T, 2020-01-01T00:00Z, 2020-01-01T01:00+01:00, 2020-06-15T12:30:00.5Z, "
+                           "2020-06-15T12:30:00Z, 2020-06-15T05:30:00.50-07:00, 2021-01-01, null.timestamp]";
+
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        return requireTimestamp(path, ION_EXTRACTOR_EQUALS, "2020-01-01T00:00Z");
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        return requireTimestamp(path, ION_EXTRACTOR_GREATER_THAN, "2020-06-15T12:30:00Z");
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(*)", [](hPATH path) {
+        return requireTimestamp(path, ION_EXTRACTOR_EQUALS, "2020-06-15T12:30:00.500Z");
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(4, ion_text, "(*)", [](hPATH path) {
+        return requireTimestamp(path, ION_EXTRACTOR_LESS_THAN_OR_EQUALS, "2020-06-15T12:30:00Z");
+    });
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesRequireAnnotationsAndNonNulls) {
+    const char *ion_text = "{a: null, b: x::1, c: null.struct, d: y::x::{}, e: x::null}";
+
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(*)", [](hPATH path) {
+        return ion_extractor_path_require_non_null(path);
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(3, ion_text, "(*)", [](hPATH path) {
+        ION_STRING text;
+        return ion_extractor_path_require_annotation(path, ion_string_assign_cstr(&text, (char *)"x", 1));
+    });
+    ION_EXTRACTOR_TEST_ASSERT_PREDICATE_MATCHES(2, ion_text, "(*)", [](hPATH path) {
+        iENTER;
+        ION_STRING text;
+        IONCHECK(ion_extractor_path_require_annotation(path, ion_string_assign_cstr(&text, (char *)"x", 1)));
+        IONCHECK(ion_extractor_path_require_non_null(path));
+        iRETURN;
+    });
+}
+
+TEST(IonExtractorSucceedsWhen, PredicatesOnTopLevelValuesSkipTheirContents) {
+    ION_EXTRACTOR_TEST_INIT;
+    ION_STRING text;
+    // Nothing in an info record is looked at, so its malformed field isn't noticed.
+    BYTE ion_data[] = {0xE0, 0x01, 0x00, 0xEA,
+                       0xE6, 0x81, 0x84, 0xD3, 0x84, 0x21, 0x03,  // name::{name: 3} (SID 4 is "name")
+                       0xE6, 0x81, 0x85, 0xD3, 0x84, 0xF0, 0x00,  // version::{name: <reserved type code>}
+                       0xE6, 0x81, 0x84, 0xD3, 0x84, 0x21, 0x03}; // name::{name: 3}
+
+    ION_EXTRACTOR_TEST_NEXT_CONTEXT(&assertMatchesInt3);
+    ION_ASSERT_OK(ion_extractor_path_create(extractor, 1, &testCallback, assertion_context, &path));
+    ION_ASSERT_OK(ion_extractor_path_require_annotation(path, ion_string_assign_cstr(&text, (char *)"name", 4)));
+    ION_ASSERT_OK(ion_extractor_path_append_field(path, &text));
+    ION_ASSERT_OK(ion_extractor_path_require_int(path, ION_EXTRACTOR_EQUALS, 3));
+    ION_EXTRACTOR_TEST_PATH_END;
+
+    ION_ASSERT_OK(ion_test_new_reader(ion_data, sizeof(ion_data), &reader));
+    ION_EXTRACTOR_TEST_MATCH_READER(reader);
+    ION_EXTRACTOR_TEST_ASSERT_MATCHED(0, 2);
+}
+
 /* -----------------------
  * Failure tests
  */
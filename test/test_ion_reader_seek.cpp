@@ -13,6 +13,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <vector>
 #include "ion_event_util.h"
 #include <ionc/ion_types.h>
 #include <ionc/ion_stream.h>
@@ -20,6 +23,10 @@
 #include "ion_index.h"
 #include "ion_stream_impl.h"
 #include <ionc/ion.h>
+#include <ionc/ion_reader_index.h>
+#include <ionc/ion_reader_split.h>
+#include "ion_reader_split_impl.h"
+#include "ion_reader_index_impl.h"
 #include "ion_helpers.h"
 #include "ion_test_util.h"
 #include "ion_assert.h"
@@ -757,4 +764,688 @@ TEST_P(TextAndBinary, ReaderPopulatesStructFieldsOnSeek) {
     // Easy assertions: there's only one value, "value," and we should have read it both times
     assertStringsEqual((char *)value1.value, cread_val1, strlen(cread_val1));
     assertStringsEqual((char *)value2.value, cread_val2, strlen(cread_val2));
-}
\ No newline at end of file
+}
+
+iERR ion_test_build_reader_index(BYTE *data, SIZE data_length, ION_READER_INDEX_OPTIONS *options, BYTE **index,
+                                 SIZE *index_length, int64_t *record_count) {
+    iENTER;
+    hREADER reader = NULL;
+    ION_STREAM *index_stream = NULL;
+    POSITION length;
+
+    IONCHECK(ion_test_new_reader(data, data_length, &reader));
+    IONCHECK(ion_stream_open_memory_only(&index_stream));
+    IONCHECK(ion_reader_index_build(reader, index_stream, options, record_count));
+    length = ion_stream_get_position(index_stream);
+    IONCHECK(ion_stream_seek(index_stream, 0));
+    *index = (BYTE *)malloc((size_t)length);
+    IONCHECK(ion_stream_read(index_stream, *index, (SIZE)length, index_length));
+fail:
+    if (index_stream) UPDATEERROR(ion_stream_close(index_stream));
+    if (reader) UPDATEERROR(ion_reader_close(reader));
+    return err;
+}
+
+// Each record is {id: <key>, name: <symbol>}, the key is read with the index's key callback.
+iERR ion_test_reader_index_key_from_id(hREADER reader, void *user_context, int64_t *p_key) {
+    iENTER;
+    ION_TYPE type;
+    ION_STRING field_name;
+    IONCHECK(ion_reader_step_in(reader));
+    for (;;) {
+        IONCHECK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) FAILWITH(IERR_KEY_NOT_FOUND);
+        IONCHECK(ion_reader_get_field_name(reader, &field_name));
+        if (field_name.length == 2 && !memcmp(field_name.value, "id", 2)) break;
+    }
+    IONCHECK(ion_reader_read_int64(reader, p_key));
+    IONCHECK(ion_reader_step_out(reader));
+    iRETURN;
+}
+
+iERR ion_test_write_indexed_records(hWRITER writer, int64_t *ids, int count, int records_per_symbol_table) {
+    iENTER;
+    ION_STRING field_name, name;
+    char buffer[16];
+    for (int ii = 0; ii < count; ii++) {
+        if (ii > 0 && ii % records_per_symbol_table == 0) {
+            // Forces a symbol table boundary.
+            IONCHECK(ion_writer_finish(writer, NULL));
+        }
+        snprintf(buffer, sizeof(buffer), "name%d", ii);
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+        IONCHECK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&field_name, (char *)"id", 2)));
+        IONCHECK(ion_writer_write_int64(writer, ids[ii]));
+        IONCHECK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&field_name, (char *)"name", 4)));
+        IONCHECK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&name, buffer, (SIZE)strlen(buffer))));
+        IONCHECK(ion_writer_finish_container(writer));
+    }
+    iRETURN;
+}
+
+void ion_test_assert_indexed_record(hREADER reader, int64_t id, int ordinal) {
+    ION_TYPE type;
+    ION_STRING field_name, name;
+    int64_t id_read;
+    char buffer[16];
+
+    snprintf(buffer, sizeof(buffer), "name%d", ordinal);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_get_field_name(reader, &field_name));
+    assertStringsEqual("id", (char *)field_name.value, field_name.length);
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &id_read));
+    ASSERT_EQ(id, id_read);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_get_field_name(reader, &field_name));
+    assertStringsEqual("name", (char *)field_name.value, field_name.length);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &name));
+    assertStringsEqual(buffer, (char *)name.value, name.length);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+}
+
+TEST_P(TextAndBinary, ReaderIndexSeeksToRecordWithItsSymbolTable) {
+    int64_t ids[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hREADER_INDEX index = NULL;
+    ION_STREAM *ion_stream = NULL;
+    ION_TYPE type;
+    BYTE *data, *index_bytes;
+    SIZE data_length, index_length;
+    int64_t record_count;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, is_binary));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 10, 3));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    ION_ASSERT_OK(ion_test_build_reader_index(data, data_length, NULL, &index_bytes, &index_length, &record_count));
+    ASSERT_EQ(10, record_count);
+
+    // A fresh reader, which hasn't seen any of the data's symbol tables.
+    ION_ASSERT_OK(ion_test_new_reader(data, data_length, &reader));
+    ION_ASSERT_OK(ion_reader_index_open(&index, reader, index_bytes, index_length));
+    ION_ASSERT_OK(ion_reader_index_get_record_count(index, &record_count));
+    ASSERT_EQ(10, record_count);
+
+    ION_ASSERT_OK(ion_reader_index_seek_record(index, 7));
+    ion_test_assert_indexed_record(reader, 7, 7);
+    // Reading continues into the next symbol table.
+    ion_test_assert_indexed_record(reader, 8, 8);
+    ion_test_assert_indexed_record(reader, 9, 9);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+
+    for (int ii = 9; ii >= 0; ii--) {
+        ION_ASSERT_OK(ion_reader_index_seek_record(index, ii));
+        ion_test_assert_indexed_record(reader, ii, ii);
+    }
+    ION_ASSERT_OK(ion_reader_index_seek_record(index, 2));
+    ion_test_assert_indexed_record(reader, 2, 2);
+    ion_test_assert_indexed_record(reader, 3, 3);
+
+    ION_ASSERT_FAIL(ion_reader_index_seek_record(index, 10));
+    ION_ASSERT_FAIL(ion_reader_index_seek_record(index, -1));
+
+    ION_ASSERT_OK(ion_reader_index_close(index));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(index_bytes);
+    free(data);
+}
+
+TEST_P(TextAndBinary, ReaderIndexSeeksToKey) {
+    int64_t ids[] = {10, 20, 20, 30, 40, 50, 60};
+    ION_READER_INDEX_OPTIONS options;
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hREADER_INDEX index = NULL;
+    ION_STREAM *ion_stream = NULL;
+    ION_TYPE type;
+    BYTE *data, *index_bytes;
+    SIZE data_length, index_length, length;
+    POSITION offset;
+    int64_t record_count, record, key;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, is_binary));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 7, 2));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    memset(&options, 0, sizeof(options));
+    options.key_fn = &ion_test_reader_index_key_from_id;
+    ION_ASSERT_OK(ion_test_build_reader_index(data, data_length, &options, &index_bytes, &index_length, &record_count));
+    ASSERT_EQ(7, record_count);
+
+    ION_ASSERT_OK(ion_test_new_reader(data, data_length, &reader));
+    ION_ASSERT_OK(ion_reader_index_open(&index, reader, index_bytes, index_length));
+
+    ION_ASSERT_OK(ion_reader_index_get_record(index, 3, &offset, &length, &key));
+    ASSERT_EQ(30, key);
+    ASSERT_LT(0, offset);
+    if (is_binary) {
+        ASSERT_LT(0, length);
+    }
+
+    ION_ASSERT_OK(ion_reader_index_seek_key(index, 20, &record));
+    ASSERT_EQ(1, record);
+    ion_test_assert_indexed_record(reader, 20, 1);
+    ION_ASSERT_OK(ion_reader_index_seek_key(index, 41, &record));
+    ASSERT_EQ(5, record);
+    ion_test_assert_indexed_record(reader, 50, 5);
+    ION_ASSERT_OK(ion_reader_index_seek_key(index, -100, &record));
+    ASSERT_EQ(0, record);
+    ion_test_assert_indexed_record(reader, 10, 0);
+    ION_ASSERT_OK(ion_reader_index_seek_key(index, 61, &record));
+    ASSERT_EQ(7, record);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_index_seek_key(index, 60, &record));
+    ASSERT_EQ(6, record);
+    ion_test_assert_indexed_record(reader, 60, 6);
+
+    ION_ASSERT_OK(ion_reader_index_close(index));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(index_bytes);
+    free(data);
+}
+
+void ion_test_set_index_int64(BYTE *dest, uint64_t value) {
+    for (int ii = 0; ii < 8; ii++) {
+        dest[ii] = (BYTE)(value >> (8 * ii));
+    }
+}
+
+TEST_P(TextAndBinary, ReaderIndexRejectsCountsLargerThanTheIndex) {
+    int64_t ids[] = {10, 20, 30, 40, 50, 60, 70};
+    ION_READER_INDEX_OPTIONS options;
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hREADER_INDEX index = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *data, *index_bytes, *trailer;
+    SIZE data_length, index_length;
+    int64_t record_count;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, is_binary));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 7, 2));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    memset(&options, 0, sizeof(options));
+    options.key_fn = &ion_test_reader_index_key_from_id;
+    ION_ASSERT_OK(ion_test_build_reader_index(data, data_length, &options, &index_bytes, &index_length, &record_count));
+    ION_ASSERT_OK(ion_test_new_reader(data, data_length, &reader));
+    trailer = index_bytes + index_length - ION_READER_INDEX_TRAILER_SIZE;
+
+    // A record count whose records would end where the real ones do, once the multiplication wraps around.
+    ion_test_set_index_int64(trailer, ((uint64_t)1 << 59) + record_count);
+    ASSERT_EQ(IERR_INVALID_BINARY, ion_reader_index_open(&index, reader, index_bytes, index_length));
+    ion_test_set_index_int64(trailer, (uint64_t)record_count);
+    ION_ASSERT_OK(ion_reader_index_open(&index, reader, index_bytes, index_length));
+    ION_ASSERT_OK(ion_reader_index_close(index));
+
+    // More contexts than there's room for.
+    ion_test_set_index_int64(trailer + 8, INT32_MAX);
+    ASSERT_EQ(IERR_INVALID_BINARY, ion_reader_index_open(&index, reader, index_bytes, index_length));
+
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(index_bytes);
+    free(data);
+}
+
+TEST_P(TextAndBinary, ReaderIndexFailsOnDecreasingKeys) {
+    int64_t ids[] = {10, 20, 15};
+    ION_READER_INDEX_OPTIONS options;
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    ION_STREAM *ion_stream = NULL, *index_stream = NULL;
+    BYTE *data;
+    SIZE data_length;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, is_binary));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 3, 3));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    memset(&options, 0, sizeof(options));
+    options.key_fn = &ion_test_reader_index_key_from_id;
+
+    ION_ASSERT_OK(ion_test_new_reader(data, data_length, &reader));
+    ION_ASSERT_OK(ion_stream_open_memory_only(&index_stream));
+    ASSERT_EQ(IERR_INVALID_ARG, ion_reader_index_build(reader, index_stream, &options, NULL));
+    ION_ASSERT_OK(ion_stream_close(index_stream));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(data);
+}
+
+TEST(IonReaderIndex, OpensDataAndIndexFiles) {
+    int64_t ids[] = {1, 2, 3, 4, 5};
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hREADER_INDEX index = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *data, *index_bytes;
+    SIZE data_length, index_length;
+    int64_t record_count;
+    char data_path[] = "/tmp/ion_reader_index_data_XXXXXX";
+    char index_path[] = "/tmp/ion_reader_index_XXXXXX";
+    FILE *fp;
+    int fd;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 5, 2));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    ION_ASSERT_OK(ion_test_build_reader_index(data, data_length, NULL, &index_bytes, &index_length, &record_count));
+
+    fd = mkstemp(data_path);
+    ASSERT_LE(0, fd);
+    fp = fdopen(fd, "wb");
+    ASSERT_EQ((size_t)data_length, fwrite(data, 1, data_length, fp));
+    fclose(fp);
+    fd = mkstemp(index_path);
+    ASSERT_LE(0, fd);
+    fp = fdopen(fd, "wb");
+    ASSERT_EQ((size_t)index_length, fwrite(index_bytes, 1, index_length, fp));
+    fclose(fp);
+
+    ION_ASSERT_OK(ion_reader_index_open_path(&index, data_path, index_path, NULL));
+    ION_ASSERT_OK(ion_reader_index_get_reader(index, &reader));
+    ION_ASSERT_OK(ion_reader_index_seek_record(index, 4));
+    ion_test_assert_indexed_record(reader, 5, 4);
+    ION_ASSERT_OK(ion_reader_index_seek_record(index, 1));
+    ion_test_assert_indexed_record(reader, 2, 1);
+    ION_ASSERT_OK(ion_reader_index_close(index));
+
+    // the data is not an index
+    ASSERT_EQ(IERR_INVALID_BINARY, ion_reader_index_open_path(&index, data_path, data_path, NULL));
+
+    remove(data_path);
+    remove(index_path);
+    free(index_bytes);
+    free(data);
+}
+
+TEST(IonReaderSplit, SplitsAtSymbolTablesAndUnitSize) {
+    int64_t ids[20];
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    hREADER_SPLIT split = NULL;
+    ION_STREAM *ion_stream = NULL;
+    ION_TYPE type;
+    BYTE *data;
+    SIZE data_length, length;
+    POSITION offset;
+    int64_t unit_count, first_value, value_count;
+
+    for (int ii = 0; ii < 20; ii++) ids[ii] = ii;
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids, 20, 3));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+
+    // Units are as big as they can be without spanning a symbol table.
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, data, data_length, 0, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_EQ(7, unit_count);
+    for (int ii = 0; ii < 7; ii++) {
+        ION_ASSERT_OK(ion_reader_split_get_unit(split, ii, &offset, &length, &first_value, &value_count));
+        ASSERT_EQ(3 * ii, first_value);
+        ASSERT_EQ((ii < 6) ? 3 : 2, value_count);
+        ASSERT_LT(0, offset);
+        ASSERT_LE(offset + length, data_length);
+    }
+
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    for (int ii = 6; ii >= 0; ii--) {
+        ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, ii));
+        for (int jj = 3 * ii; jj < 20 && jj < 3 * ii + 3; jj++) {
+            ion_test_assert_indexed_record(reader, jj, jj);
+        }
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_EOF, type);
+    }
+    ION_ASSERT_FAIL(ion_reader_split_seek_unit(split, reader, 7));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+
+    // Every value past the unit size starts a new unit.
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, data, data_length, 1, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_EQ(20, unit_count);
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    for (int ii = 19; ii >= 0; ii -= 3) {
+        ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, ii));
+        ion_test_assert_indexed_record(reader, ii, ii);
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_EOF, type);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+
+    free(data);
+}
+
+typedef struct {
+    hREADER_SPLIT split;
+    std::atomic<int> *seen;
+    std::atomic<int> mismatches;
+    int64_t failing_unit;
+} ION_TEST_SPLIT_RUN;
+
+// Checks each record is {id: <its value number>, name: name<its value number>}.
+iERR ion_test_split_check_unit(hREADER reader, int64_t unit, void *user_context) {
+    iENTER;
+    ION_TEST_SPLIT_RUN *run = (ION_TEST_SPLIT_RUN *)user_context;
+    ION_TYPE type;
+    ION_STRING name;
+    int64_t first_value, value_count, id;
+    char buffer[16];
+
+    if (unit == run->failing_unit) FAILWITH(IERR_INVALID_STATE);
+    IONCHECK(ion_reader_split_get_unit(run->split, unit, NULL, NULL, &first_value, &value_count));
+    for (int64_t ii = first_value; ; ii++) {
+        IONCHECK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) {
+            if (ii != first_value + value_count) run->mismatches++;
+            break;
+        }
+        IONCHECK(ion_reader_step_in(reader));
+        IONCHECK(ion_reader_next(reader, &type));
+        IONCHECK(ion_reader_read_int64(reader, &id));
+        IONCHECK(ion_reader_next(reader, &type));
+        IONCHECK(ion_reader_read_string(reader, &name));
+        IONCHECK(ion_reader_step_out(reader));
+        snprintf(buffer, sizeof(buffer), "name%d", (int)ii);
+        if (id != ii || name.length != (SIZE)strlen(buffer) || memcmp(name.value, buffer, name.length)) {
+            run->mismatches++;
+        }
+        run->seen[id]++;
+    }
+    iRETURN;
+}
+
+TEST(IonReaderSplit, RunReadsEveryValueOnce) {
+    const int record_count = 2000;
+    std::vector<int64_t> ids(record_count);
+    hWRITER writer = NULL;
+    hREADER_SPLIT split = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *data;
+    SIZE data_length;
+    int64_t unit_count;
+    ION_TEST_SPLIT_RUN run;
+
+    for (int ii = 0; ii < record_count; ii++) ids[ii] = ii;
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, TRUE));
+    ION_ASSERT_OK(ion_test_write_indexed_records(writer, ids.data(), record_count, 70));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, data, data_length, 64, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_LT(100, unit_count);
+
+    std::vector<std::atomic<int> > seen(record_count);
+    for (int thread_count = 1; thread_count <= 8; thread_count *= 8) {
+        for (int ii = 0; ii < record_count; ii++) seen[ii] = 0;
+        run.split = split;
+        run.seen = seen.data();
+        run.mismatches = 0;
+        run.failing_unit = -1;
+        ION_ASSERT_OK(ion_reader_split_run(split, thread_count, &ion_test_split_check_unit, &run));
+        ASSERT_EQ(0, run.mismatches.load());
+        for (int ii = 0; ii < record_count; ii++) {
+            ASSERT_EQ(1, seen[ii].load()) << "value " << ii << " with " << thread_count << " threads";
+        }
+    }
+
+    // The first error stops the run.
+    run.failing_unit = unit_count / 2;
+    ASSERT_EQ(IERR_INVALID_STATE, ion_reader_split_run(split, 4, &ion_test_split_check_unit, &run));
+
+    ION_ASSERT_OK(ion_reader_split_close(split));
+    free(data);
+}
+
+// Reads the id field of the struct the reader is on, and the symbol in its name field when there is one.
+void ion_test_split_read_text_record(hREADER reader, int64_t *p_id, std::string *p_name) {
+    ION_TYPE type;
+    ION_STRING field, value;
+
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    p_name->clear();
+    for (;;) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        ION_ASSERT_OK(ion_reader_get_field_name(reader, &field));
+        if (field.length == 2 && !memcmp(field.value, "id", 2)) {
+            ION_ASSERT_OK(ion_reader_read_int64(reader, p_id));
+        }
+        else if (type == tid_SYMBOL) {
+            ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+            p_name->assign((char *)value.value, (size_t)value.length);
+        }
+    }
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+}
+
+TEST(IonReaderSplit, SplitsTextAtContainersAndSymbolTables) {
+    const char *text =
+        "{id:0, s:\"a}b\"} // c }\n"
+        "{id:1, s:'''x\n}''', l:{{ YS8vYg== }}}\n"
+        "$ion_symbol_table::{symbols:[\"foo\"]}\n"
+        "{id:2, f:$10}\n"
+        "$ion_1_0 {id:3, f:$ion_symbol_table::x} five";
+    hREADER_SPLIT split = NULL;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_STRING value;
+    POSITION offset;
+    SIZE length;
+    int64_t unit_count, first_value, value_count, id;
+    std::string name;
+
+    // Every container past the unit size ends a unit, and so does every system value.
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text, (SIZE)strlen(text), 1, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_EQ(5, unit_count);
+    ION_ASSERT_OK(ion_reader_split_get_unit(split, 0, &offset, &length, &first_value, &value_count));
+    ASSERT_EQ(0, offset);
+    ASSERT_EQ((SIZE)strlen("{id:0, s:\"a}b\"}"), length);
+    ASSERT_EQ(-1, first_value);
+    ASSERT_EQ(-1, value_count);
+
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    for (int ii = 3; ii >= 0; ii--) {
+        ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, ii));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRUCT, type);
+        ion_test_split_read_text_record(reader, &id, &name);
+        ASSERT_EQ(ii, id);
+        if (ii == 2) ASSERT_EQ("foo", name);
+        if (ii == 3) ASSERT_EQ("x", name);
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_EOF, type);
+    }
+    ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, 4));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+    ASSERT_EQ(4, value.length);
+    ASSERT_EQ(0, memcmp("five", value.value, 4));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+
+    // Otherwise only the system values split it.
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text, (SIZE)strlen(text), 0, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_EQ(3, unit_count);
+    ION_ASSERT_OK(ion_reader_split_close(split));
+}
+
+TEST(IonReaderSplit, ReadsImportedSymbolsWithUnknownText) {
+    // The units share a frozen copy of the symbol table, which has to give the same symbols for the missing import's
+    // sids as the reader's own table would.
+    const char *text =
+        "$ion_symbol_table::{imports:[{name:\"missing\", version:1, max_id:2}], symbols:[\"a\"]}\n"
+        "$10 $11 $12";
+    hREADER_SPLIT split = NULL;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_SYMBOL symbol;
+
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text, (SIZE)strlen(text), 0, NULL));
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, 0));
+    for (int ii = 1; ii <= 2; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_SYMBOL, type);
+        ION_ASSERT_OK(ion_reader_read_ion_symbol(reader, &symbol));
+        ASSERT_TRUE(ION_STRING_IS_NULL(&symbol.value));
+        assertStringsEqual("missing", (char *)symbol.import_location.name.value, symbol.import_location.name.length);
+        ASSERT_EQ(ii, symbol.import_location.location);
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_ion_symbol(reader, &symbol));
+    assertStringsEqual("a", (char *)symbol.value.value, symbol.value.length);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+}
+
+TEST(IonReaderSplit, ReadsSymbolsFromLargeMissingImports) {
+    // Freezing the units' symbol table must not make anything per declared sid of the missing import.
+    const char *text =
+        "$ion_symbol_table::{imports:[{name:\"missing\", version:1, max_id:100000000}]}\n"
+        "$100000009";
+    hREADER_SPLIT split = NULL;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_SYMBOL symbol;
+
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text, (SIZE)strlen(text), 0, NULL));
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, 0));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_ion_symbol(reader, &symbol));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&symbol.value));
+    assertStringsEqual("missing", (char *)symbol.import_location.name.value, symbol.import_location.name.length);
+    ASSERT_EQ(100000000, symbol.import_location.location);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+}
+
+TEST(IonReaderSplit, RejectsUnbalancedText) {
+    hREADER_SPLIT split = NULL;
+
+    ASSERT_EQ(IERR_INVALID_SYNTAX, ion_reader_split_open_buffer(&split, (BYTE *)"{a:1} }", 7, 0, NULL));
+    ASSERT_EQ(IERR_UNEXPECTED_EOF, ion_reader_split_open_buffer(&split, (BYTE *)"{a:\"1}", 6, 0, NULL));
+    ASSERT_EQ(IERR_UNEXPECTED_EOF, ion_reader_split_open_buffer(&split, (BYTE *)"[1, /* ] */", 11, 0, NULL));
+}
+
+typedef struct {
+    std::atomic<int> *seen;
+    std::atomic<int> mismatches;
+    int table_period;
+} ION_TEST_SPLIT_TEXT_RUN;
+
+// Checks each record's name is the symbol of the table in effect for it.
+iERR ion_test_split_check_text_unit(hREADER reader, int64_t unit, void *user_context) {
+    iENTER;
+    ION_TEST_SPLIT_TEXT_RUN *run = (ION_TEST_SPLIT_TEXT_RUN *)user_context;
+    ION_TYPE type;
+    int64_t id = -1;
+    std::string name;
+    char buffer[16];
+
+    for (;;) {
+        IONCHECK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        ion_test_split_read_text_record(reader, &id, &name);
+        snprintf(buffer, sizeof(buffer), "name%d", (int)(id / run->table_period));
+        if (name != buffer) run->mismatches++;
+        run->seen[id]++;
+    }
+    iRETURN;
+}
+
+TEST(IonReaderSplit, RunReadsEveryTextValueOnce) {
+    // Big enough for several chunks. Two of every three lines end in a long string or a block comment, so most
+    // chunks start in one.
+    const int record_count = 60000, table_period = 1000;
+    std::string text;
+    char buffer[128];
+    hREADER_SPLIT split = NULL;
+    int64_t unit_count;
+    ION_TEST_SPLIT_TEXT_RUN run;
+
+    for (int ii = 0; ii < record_count; ii++) {
+        if (ii % table_period == 0) {
+            snprintf(buffer, sizeof(buffer), "$ion_symbol_table::{symbols:[\"name%d\"]}\n", ii / table_period);
+            text += buffer;
+        }
+        snprintf(buffer, sizeof(buffer), "{id:%d, name:$10, note:'''first\nsecond ] '''} /* a\n} */\n", ii);
+        text += buffer;
+    }
+    ASSERT_LT(3 * 1024 * 1024, (int)text.length());
+
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text.data(), (SIZE)text.length(), 64 * 1024, NULL));
+    ION_ASSERT_OK(ion_reader_split_get_unit_count(split, &unit_count));
+    ASSERT_LE(record_count / table_period, unit_count);
+
+    std::vector<std::atomic<int> > seen(record_count);
+    for (int thread_count = 1; thread_count <= 8; thread_count *= 8) {
+        for (int ii = 0; ii < record_count; ii++) seen[ii] = 0;
+        run.seen = seen.data();
+        run.mismatches = 0;
+        run.table_period = table_period;
+        ION_ASSERT_OK(ion_reader_split_run(split, thread_count, &ion_test_split_check_text_unit, &run));
+        ASSERT_EQ(0, run.mismatches.load());
+        for (int ii = 0; ii < record_count; ii++) {
+            ASSERT_EQ(1, seen[ii].load()) << "value " << ii << " with " << thread_count << " threads";
+        }
+    }
+    ION_ASSERT_OK(ion_reader_split_close(split));
+}
+
+TEST(IonReaderSplit, SplitsTextAfterCrlfLineContinuation) {
+    // The first chunk would end right after a backslash and \r\n in a short string; it has to run on to the next
+    // new line instead.
+    const char *last = "{id:1, s:\"ab\\\r\ncd\"}\r\n";
+    std::string text = "{id:0}\r\n";
+    hREADER_SPLIT split = NULL;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_STRING field, value;
+    int64_t id;
+
+    text.append(ION_READER_SPLIT_TEXT_CHUNK_SIZE - text.length() - (strstr(last, "\n") - last) - 1, ' ');
+    text += last;
+    ASSERT_EQ('\n', text[ION_READER_SPLIT_TEXT_CHUNK_SIZE - 1]);
+    ASSERT_EQ('\\', text[ION_READER_SPLIT_TEXT_CHUNK_SIZE - 3]);
+
+    ION_ASSERT_OK(ion_reader_split_open_buffer(&split, (BYTE *)text.data(), (SIZE)text.length(), 0, NULL));
+    ION_ASSERT_OK(ion_reader_split_open_reader(split, &reader));
+    ION_ASSERT_OK(ion_reader_split_seek_unit(split, reader, 0));
+    for (int ii = 0; ii < 2; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRUCT, type);
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_read_int64(reader, &id));
+        ASSERT_EQ(ii, id);
+        if (ii == 1) {
+            ION_ASSERT_OK(ion_reader_next(reader, &type));
+            ASSERT_EQ(tid_STRING, type);
+            ION_ASSERT_OK(ion_reader_get_field_name(reader, &field));
+            ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+            ASSERT_EQ(4, value.length);
+            ASSERT_EQ(0, memcmp("abcd", value.value, 4));
+        }
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_reader_split_close(split));
+}
@@ -229,3 +229,136 @@ TEST(IonStream, WriteToUserStream) {
 
     free(context.data);
 }
+
+#ifndef ION_PLATFORM_WINDOWS
+
+/**
+ * Writes the given bytes to an anonymous temporary file and rewinds it.
+ */
+FILE *ion_test_temp_file_with(BYTE *data, SIZE len) {
+    FILE *fp = tmpfile();
+    if (fp && len > 0) {
+        fwrite(data, 1, (size_t)len, fp);
+        fflush(fp);
+    }
+    return fp;
+}
+
+TEST(IonStream, MmapReadAndSeek) {
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    ION_STREAM *stream = NULL;
+    BYTE *data;
+    SIZE data_len;
+    ION_TYPE type;
+    ION_STRING str;
+    int32_t int_value;
+    POSITION struct_position;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, TRUE));
+    ION_ASSERT_OK(ion_writer_write_int32(writer, 1));
+    ION_ASSERT_OK(ion_writer_write_string(writer, ion_string_assign_cstr(&str, (char *)"two", 3)));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&str, (char *)"three", 5)));
+    ION_ASSERT_OK(ion_writer_write_int32(writer, 3));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+
+    FILE *fp = ion_test_temp_file_with(data, data_len);
+    ASSERT_TRUE(fp != NULL);
+    ION_ASSERT_OK(ion_stream_open_mmap(fileno(fp), ION_STREAM_MMAP_ADVICE_SEQUENTIAL, &stream));
+    // The mapping keeps the file contents alive; the descriptor is no longer needed.
+    fclose(fp);
+    ASSERT_TRUE(ion_stream_is_mmap(stream));
+    ASSERT_FALSE(ion_stream_can_write(stream));
+
+    ION_ASSERT_OK(ion_reader_open(&reader, stream, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_read_int32(reader, &int_value));
+    ASSERT_EQ(1, int_value);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_get_value_offset(reader, &struct_position));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+
+    // Switch to random access and jump back into the mapping.
+    ION_ASSERT_OK(ion_stream_mmap_advise(stream, ION_STREAM_MMAP_ADVICE_RANDOM));
+    ION_ASSERT_OK(ion_reader_seek(reader, struct_position, -1));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_get_field_name(reader, &str));
+    assertStringsEqual("three", (char *)str.value, str.length);
+    ION_ASSERT_OK(ion_reader_read_int32(reader, &int_value));
+    ASSERT_EQ(3, int_value);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_stream_close(stream));
+    free(data);
+}
+
+TEST(IonStream, MmapEmptyFile) {
+    hREADER reader = NULL;
+    ION_STREAM *stream = NULL;
+    ION_TYPE type;
+
+    FILE *fp = ion_test_temp_file_with(NULL, 0);
+    ASSERT_TRUE(fp != NULL);
+    ION_ASSERT_OK(ion_stream_open_mmap(fileno(fp), ION_STREAM_MMAP_ADVICE_NORMAL, &stream));
+    fclose(fp);
+
+    ASSERT_EQ(0, ion_stream_get_position(stream));
+    ION_ASSERT_OK(ion_reader_open(&reader, stream, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
+
+TEST(IonStream, MmapRejectsInvalidInput) {
+    ION_STREAM *stream = NULL;
+    ION_ASSERT_FAIL(ion_stream_open_mmap(-1, ION_STREAM_MMAP_ADVICE_NORMAL, &stream));
+    ION_ASSERT_FAIL(ion_stream_open_mmap_path("/this/path/does/not/exist.10n", ION_STREAM_MMAP_ADVICE_NORMAL, &stream));
+
+    // Only mapped streams accept access hints.
+    BYTE buf[1];
+    ION_ASSERT_OK(ion_stream_open_buffer(buf, sizeof(buf), 0, TRUE, &stream));
+    ASSERT_FALSE(ion_stream_is_mmap(stream));
+    ION_ASSERT_FAIL(ion_stream_mmap_advise(stream, ION_STREAM_MMAP_ADVICE_RANDOM));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
+
+#endif
+
+TEST(IonStream, PushStreamKeepsPositionAcrossPushes) {
+    ION_STREAM *stream = NULL;
+    BYTE chunk[100];
+    int ii, b;
+
+    for (ii = 0; ii < (int)sizeof(chunk); ii++) {
+        chunk[ii] = (BYTE)ii;
+    }
+
+    ION_ASSERT_OK(ion_stream_open_push(&stream));
+    ASSERT_TRUE(ion_stream_is_push(stream));
+    ION_ASSERT_OK(ion_stream_read_byte(stream, &b));
+    ASSERT_EQ(EOF, b);
+
+    // push far more than the initial buffer holds, reading as we go
+    for (ii = 0; ii < 1000; ii++) {
+        ION_ASSERT_OK(ion_stream_push(stream, chunk, sizeof(chunk)));
+        ION_ASSERT_OK(ion_stream_read_byte(stream, &b));
+        ASSERT_EQ(ii % (int)sizeof(chunk), b);
+        ASSERT_EQ((POSITION)ii + 1, ion_stream_get_position(stream));
+    }
+    ION_ASSERT_OK(ion_stream_push_eof(stream));
+    ASSERT_EQ(IERR_INVALID_STATE, ion_stream_push(stream, chunk, 1));
+    ION_ASSERT_OK(ion_stream_close(stream));
+}
@@ -17,6 +17,8 @@
 #include "ion_test_util.h"
 #include "ion_event_util.h"
 #include "ion_event_equivalence.h"
+#include <thread>
+#include <vector>
 
 // Creates a BinaryAndTextTest fixture instantiation for IonSymbolTable tests. This allows tests to be declared with
 // the BinaryAndTextTest fixture and receive the is_binary flag with both the TRUE and FALSE values.
@@ -702,6 +704,125 @@ TEST_P(BinaryAndTextTest, SymbolTableSetterWithManualLSTInProgressFails) {
     ION_ASSERT_OK(ion_symbol_table_close(symbol_table));
 }
 
+TEST(IonSymbolTable, LargeLocalSymbolTableFindsEverySymbolByName) {
+    // enough symbols for the name index to grow many times, with names that share long prefixes
+    const int symbol_count = 100000;
+    ION_SYMBOL_TABLE *symbol_table;
+    ION_STRING name;
+    char text[32];
+    SID sid, first_sid = UNKNOWN_SID;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&symbol_table, NULL));
+    for (int ii = 0; ii < symbol_count; ii++) {
+        snprintf(text, sizeof(text), "symbol_with_a_long_prefix_%d", ii);
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(symbol_table, ion_string_assign_cstr(&name, text, (SIZE)strlen(text)), &sid));
+        if (ii == 0) first_sid = sid;
+        ASSERT_EQ(first_sid + ii, sid);
+    }
+    // adding a name again gives back the existing symbol
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(symbol_table, ion_string_assign_cstr(&name, text, (SIZE)strlen(text)), &sid));
+    ASSERT_EQ(first_sid + symbol_count - 1, sid);
+
+    for (int ii = symbol_count - 1; ii >= 0; ii--) {
+        snprintf(text, sizeof(text), "symbol_with_a_long_prefix_%d", ii);
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(symbol_table, ion_string_assign_cstr(&name, text, (SIZE)strlen(text)), &sid));
+        ASSERT_EQ(first_sid + ii, sid);
+    }
+    ION_ASSERT_OK(ion_symbol_table_find_by_name(symbol_table, ion_string_assign_cstr(&name, (char *)"symbol_with_a_long_prefix_", 26), &sid));
+    ASSERT_EQ(UNKNOWN_SID, sid);
+
+    ION_ASSERT_OK(ion_symbol_table_close(symbol_table));
+}
+
+TEST_P(BinaryAndTextTest, FrozenCatalogIsSharedByReadersAndWritersOnManyThreads) {
+    const int symbol_count = 1000, thread_count = 8;
+    hCATALOG catalog;
+    hSYMTAB shared, writer_imports[1];
+    ION_STRING name, text;
+    char buf[32];
+    SID sid;
+    BOOL is_frozen;
+
+    ION_ASSERT_OK(ion_catalog_open(&catalog));
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&shared, catalog, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(shared, ion_string_assign_cstr(&name, (char *)"shared", 6)));
+    ION_ASSERT_OK(ion_symbol_table_set_version(shared, 1));
+    for (int ii = 0; ii < symbol_count; ii++) {
+        snprintf(buf, sizeof(buf), "shared_%d", ii);
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(shared, ion_string_assign_cstr(&text, buf, (SIZE)strlen(buf)), &sid));
+    }
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, shared));
+    ION_ASSERT_OK(ion_catalog_freeze(catalog));
+    ION_ASSERT_OK(ion_catalog_is_frozen(catalog, &is_frozen));
+    ASSERT_TRUE(is_frozen);
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_catalog_add_symbol_table(catalog, shared));
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_catalog_release_symbol_table(catalog, shared));
+
+    // every value is a symbol from the shared table, written as such by a writer that imports it
+    writer_imports[0] = shared;
+    ION_SYMBOL_TEST_OPEN_WRITER_WITH_IMPORTS(is_binary, writer_imports, 1);
+    for (int ii = 0; ii < symbol_count; ii++) {
+        snprintf(buf, sizeof(buf), "shared_%d", ii);
+        ION_ASSERT_OK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&text, buf, (SIZE)strlen(buf))));
+    }
+    BYTE *data;
+    SIZE data_len;
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &data, &data_len));
+
+    std::vector<int> mismatches(thread_count, -1);
+    std::vector<std::thread> threads;
+    for (int tt = 0; tt < thread_count; tt++) {
+        threads.push_back(std::thread([&, tt]() {
+            hREADER reader;
+            hWRITER thread_writer;
+            ION_STREAM *thread_stream;
+            ION_READER_OPTIONS reader_options;
+            ION_WRITER_OPTIONS thread_writer_options = writer_options;
+            ION_TYPE type;
+            ION_SYMBOL symbol;
+            BYTE *rewritten;
+            SIZE rewritten_len;
+            char expected[32];
+            int bad = 0;
+
+            ion_event_initialize_reader_options(&reader_options);
+            reader_options.pcatalog = catalog;
+            for (int pass = 0; pass < 10; pass++) {
+                if (ion_reader_open_buffer(&reader, data, data_len, &reader_options)) { bad++; break; }
+                for (int ii = 0; ii < symbol_count; ii++) {
+                    if (ion_reader_next(reader, &type) || type != tid_SYMBOL) { bad++; break; }
+                    if (ion_reader_read_ion_symbol(reader, &symbol)) { bad++; break; }
+                    snprintf(expected, sizeof(expected), "shared_%d", ii);
+                    if (symbol.value.length != (SIZE)strlen(expected)
+                     || memcmp(symbol.value.value, expected, symbol.value.length) != 0) bad++;
+                    if (is_binary && (symbol.import_location.location != ii + 1
+                     || !ion_equals_string(&name, &symbol.import_location.name))) bad++;
+                }
+                ion_reader_close(reader);
+
+                // and writing through the frozen catalog reproduces the data
+                if (ion_reader_open_buffer(&reader, data, data_len, &reader_options)) { bad++; break; }
+                if (ion_stream_open_memory_only(&thread_stream)
+                 || ion_writer_open(&thread_writer, thread_stream, &thread_writer_options)
+                 || ion_writer_write_all_values(thread_writer, reader)
+                 || ion_test_writer_get_bytes(thread_writer, thread_stream, &rewritten, &rewritten_len)) { bad++; break; }
+                if (rewritten_len != data_len || memcmp(rewritten, data, data_len) != 0) bad++;
+                free(rewritten);
+                ion_reader_close(reader);
+            }
+            mismatches[tt] = bad;
+        }));
+    }
+    for (int tt = 0; tt < thread_count; tt++) {
+        threads[tt].join();
+        ASSERT_EQ(0, mismatches[tt]);
+    }
+
+    free(data);
+    ION_ASSERT_OK(ion_writer_options_close_shared_imports(&writer_options));
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
 TEST(IonSymbolTable, TextWritingKnownSymbolFromSIDResolvesText) {
     // If the user writes a SID in the import range and that import is found in the writer's imports list, that SID
     // should be resolved to its text representation. There is no need to include the local symbol table in the stream.
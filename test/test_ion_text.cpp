@@ -16,8 +16,13 @@
 #include "ion_helpers.h"
 #include "ion_test_util.h"
 #include "ion_event_equivalence.h"
+#include "ion_scanner.h"
+#include "ion_float_impl.h"
 
 #include "stdlib.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
 
 TEST(IonTextSexp, ReaderHandlesNested)
 {
@@ -654,6 +659,23 @@ TEST(IonTextBlob, CanFullyReadBlobUsingPartialReads) {
                        tid_BLOB, 23, "This is a BLOB of text.");
 }
 
+TEST(IonTextBlob, CanReadBlobAsView) {
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    ION_ASSERT_OK(ion_test_new_text_reader("{{ VGhpcyBpcyBhIEJMT0Igb2YgdGV4dC4= }} \"abc\"", &reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_BLOB, type);
+    ION_ASSERT_OK(ion_reader_read_lob_view(reader, &value));
+    assertStringsEqual("This is a BLOB of text.", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_read_string_view(reader, &value));
+    assertStringsEqual("abc", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
 TEST(IonTextStruct, AcceptsFieldNameWithKeywordPrefix) {
     const char *ion_text = "{falsehood: 123}";
     hREADER  reader;
@@ -684,6 +706,40 @@ TEST(IonTextReader, UnpositionedReaderHasTypeNone) {
     ASSERT_EQ(tid_none, type);
 }
 
+TEST(IonTextReader, ReaderGrowsContainerStackPastItsOptions) {
+    // deeper than the default max_container_depth
+    const int depth = 100;
+    std::string ion_text;
+    hREADER reader;
+    ION_TYPE type;
+    SIZE reader_depth;
+    int value;
+
+    for (int ii = 0; ii < depth; ii++) ion_text += (ii % 3 == 0) ? "[" : (ii % 3 == 1) ? "(" : "{f:";
+    ion_text += "7";
+    for (int ii = depth - 1; ii >= 0; ii--) ion_text += (ii % 3 == 0) ? "]" : (ii % 3 == 1) ? ")" : "}";
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text.c_str(), &reader));
+    for (int ii = 0; ii < depth; ii++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+    }
+    ION_ASSERT_OK(ion_reader_get_depth(reader, &reader_depth));
+    ASSERT_EQ(depth, reader_depth);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_read_int(reader, &value));
+    ASSERT_EQ(7, value);
+    for (int ii = depth; ii > 0; ii--) {
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+        ION_ASSERT_OK(ion_reader_get_depth(reader, &reader_depth));
+        ASSERT_EQ(ii - 1, reader_depth);
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
 TEST(IonTextStruct, FailsOnFieldNameWithNoValueAtStructEnd) {
     const char *ion_text = "{a: }";
     hREADER  reader;
@@ -720,3 +776,289 @@ TEST(IonTextInt, BinaryLiterals) {
     ION_ASSERT_OK(ion_reader_read_int64(reader, &value));
     ASSERT_EQ(-4, value);
 }
+
+TEST(IonTextScannerIndex, BlockScanMatchesScalarScan) {
+    const char *alphabet = "abc 123\t\n\r\"'\\()[]{}/*\v\f";
+    int classes[] = {
+        ION_SCANNER_CC_NEWLINE,
+        ION_SCANNER_CC_DOUBLE_QUOTE | ION_SCANNER_CC_ESCAPE,
+        ION_SCANNER_CC_SINGLE_QUOTE | ION_SCANNER_CC_ESCAPE,
+        ION_SCANNER_CC_STRUCTURAL,
+        ION_SCANNER_CC_WHITESPACE,
+    };
+    BYTE buffer[300];
+    BYTE *limit = buffer + sizeof(buffer);
+    size_t alphabet_len = strlen(alphabet);
+    int ii, start, cc;
+
+    srand(1);
+    for (ii = 0; ii < (int)sizeof(buffer); ii++) {
+        // mostly letters, so the interesting bytes are spread out across blocks
+        buffer[ii] = (rand() % 8 == 0) ? (BYTE)alphabet[rand() % alphabet_len] : (BYTE)('a' + rand() % 26);
+    }
+    // and a long run of each kind
+    memset(&buffer[100], ' ', 70);
+    memset(&buffer[200], 'x', 70);
+
+    for (cc = 0; cc < (int)(sizeof(classes) / sizeof(classes[0])); cc++) {
+        for (start = 0; start < (int)sizeof(buffer); start++) {
+            ASSERT_EQ(_ion_scanner_index_scan_scalar(&buffer[start], limit, classes[cc], TRUE),
+                      _ion_scanner_index_scan(&buffer[start], limit, classes[cc], TRUE));
+            ASSERT_EQ(_ion_scanner_index_scan_scalar(&buffer[start], limit, classes[cc], FALSE),
+                      _ion_scanner_index_scan(&buffer[start], limit, classes[cc], FALSE));
+        }
+    }
+}
+
+TEST(IonTextReader, SkipsContainersWithStructuralCharactersInValues) {
+    // every kind of value that can hide a closing bracket from the skip, over four lines
+    const char *element = "\"str]ing \\\" with } brackets\",\n"
+                          "'''long ] string''' '''continued )'''\n"
+                          ", 'sym]bol', /* comment ] */ // line comment }\n"
+                          "(x * y / z), {{ aGVsbG8= }}, {{ \"cl}ob\" }},        \n";
+    std::string ion_text = "{a:[";
+    int32_t elements = 200, line, offset;
+    int64_t bytes;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    for (int ii = 0; ii < elements; ii++) {
+        ion_text += element;
+    }
+    ion_text += "], b:\"after\"} after";
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text.c_str(), &reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+    assertStringsEqual("after", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_get_position(reader, &bytes, &line, &offset));
+    ASSERT_EQ(elements * 4 + 1, line);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+void test_ion_text_write_double(double value, std::string *out) {
+    hWRITER writer = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *result;
+    SIZE result_len;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, FALSE));
+    ION_ASSERT_OK(ion_writer_write_double(writer, value));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &result, &result_len));
+    out->assign((char *)result, result_len);
+    free(result);
+}
+
+TEST(IonTextFloat, WriterWritesShortestRoundTripDigits) {
+    struct { double value; const char *text; } cases[] = {
+        { 0.1,                     "0.1e+0" },
+        { -1.5,                    "-1.5e+0" },
+        { 100,                     "100e+0" },
+        { 0.0001,                  "0.0001e+0" },
+        { 1e-5,                    "1e-5" },
+        { 1e17,                    "1e+17" },
+        { 1.0 / 3,                 "0.3333333333333333e+0" },
+        { 5e-324,                  "5e-324" },
+        { 2.2250738585072014e-308, "2.2250738585072014e-308" },
+        { 1.7976931348623157e308,  "1.7976931348623157e+308" },
+        { -0.0,                    "-0e0" },
+    };
+    std::string text;
+
+    for (size_t ii = 0; ii < sizeof(cases) / sizeof(cases[0]); ii++) {
+        test_ion_text_write_double(cases[ii].value, &text);
+        ASSERT_STREQ(cases[ii].text, text.c_str());
+    }
+}
+
+TEST(IonTextFloat, WriterOutputReadsBackExactly) {
+    uint64_t state = 88172645463325252ULL, bits;
+    double value, read_value;
+    std::string text;
+    hREADER reader;
+    ION_TYPE type;
+
+    for (int ii = 0; ii < 20000; ii++) {
+        // every bit pattern is as likely as any other, so every exponent is covered
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bits = state;
+        memcpy(&value, &bits, sizeof(value));
+        if (value != value) continue; // nan
+
+        test_ion_text_write_double(value, &text);
+        ION_ASSERT_OK(ion_test_new_text_reader(text.c_str(), &reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_FLOAT, type);
+        ION_ASSERT_OK(ion_reader_read_double(reader, &read_value));
+        ASSERT_EQ(value, read_value) << text;
+        ION_ASSERT_OK(ion_reader_close(reader));
+    }
+}
+
+TEST(IonTextFloat, DigitsAreTheShortestAndClosest) {
+    uint64_t state = 88172645463325252ULL, bits;
+    uint32_t bits_32;
+    float value_32;
+    double value;
+    char digits[ION_FLOAT64_MAX_DIGITS + 1], image[ION_FLOAT_STRING_MAX];
+    int length, exponent, precision;
+
+    for (int ii = 0; ii < 60000; ii++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bits = state & ~((uint64_t)1 << 63);
+        memcpy(&value, &bits, sizeof(value));
+        if (ii % 3 == 1) {
+            // short decimals, which are most of what's written in practice
+            value = (double)(state % 1000000) / 1000;
+        }
+        else if (ii % 3 == 2) {
+            // widened floats, whose digits are often exactly halfway between two of the shortest length
+            bits_32 = (uint32_t)state & 0x7FFFFFFF;
+            memcpy(&value_32, &bits_32, sizeof(value_32));
+            value = value_32;
+        }
+        if (!(value > 0) || std::isinf(value)) continue;
+
+        // the fewest correctly rounded digits that read back
+        for (precision = 1; precision < ION_FLOAT64_MAX_DIGITS; precision++) {
+            snprintf(image, sizeof(image), "%.*e", precision - 1, value);
+            if (strtod(image, NULL) == value) break;
+        }
+        snprintf(image, sizeof(image), "%.*e", precision - 1, value);
+        length = _ion_float_to_shortest_digits(value, digits, &exponent);
+        ASSERT_EQ(atoi(strchr(image, 'e') + 1) - (precision - 1), exponent) << image;
+        image[1] = image[0]; // over the decimal point
+        ASSERT_EQ(std::string(image + 1, precision), std::string(digits, length)) << image;
+    }
+}
+
+TEST(IonTextFloat, ReaderReadsNearestDouble) {
+    // halfway cases, subnormals, the edges of the range and more digits than fit in 64 bits
+    const char *cases[] = {
+        "0e0", "-0e0", "1e0", "0.1e0", "-1.5e0", "123_456.789e0", "1e23", "8.98846567431158e307",
+        "9007199254740993e0", "9007199254740993.0000000000000000001e0", "2.2250738585072011e-308",
+        "2.2250738585072012e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1.7976931348623157e308", "1.7976931348623158e308",
+        "1.7976931348623159e308", "1e-400", "1e400", "7.2057594037927933e16",
+        "1.00000000000000011102230246251565404236316680908203125e0",
+        "1.00000000000000011102230246251565404236316680908203124e0",
+        "1.00000000000000011102230246251565404236316680908203126e0",
+        "0.000000000000000000000000000000000000000000001e0", "123456789012345678901234567890e-10",
+    };
+    std::string digits;
+    double value;
+    hREADER reader;
+    ION_TYPE type;
+
+    for (size_t ii = 0; ii < sizeof(cases) / sizeof(cases[0]); ii++) {
+        ION_ASSERT_OK(ion_test_new_text_reader(cases[ii], &reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_FLOAT, type);
+        ION_ASSERT_OK(ion_reader_read_double(reader, &value));
+        digits = cases[ii];
+        digits.erase(std::remove(digits.begin(), digits.end(), '_'), digits.end());
+        double expected = strtod(digits.c_str(), NULL);
+        ASSERT_EQ(0, memcmp(&expected, &value, sizeof(value))) << cases[ii];
+        ION_ASSERT_OK(ion_reader_close(reader));
+    }
+}
+
+TEST(IonTextReader, PushReaderWaitsForCompleteTopLevelValues) {
+    // symbols and long strings can't be returned until the next token is in, that can make them annotations or
+    // continue them. The local symbol table and the version markers are skipped.
+    const char *ion_text =
+        "$ion_1_0 $ion_symbol_table::{symbols:[\"sym\"]} // comment\n"
+        "a :: b::$10 'quoted' /* c */ '''long''' '''string''' {s:\"}]\", l:'''x'''} [1, (a / b)]\r\n"
+        "{{\"cl}}ob\"}} 2007-01-01T12:30Z '$ion_1_0' $2 '''tail''' 'q' 42 end";
+    SIZE text_len = (SIZE)strlen(ion_text);
+    std::string expected, actual;
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_TYPE type;
+    BYTE *result = NULL;
+    SIZE result_len, ii;
+    int values = 0;
+    iERR err;
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, FALSE));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    expected.assign((char *)result, (size_t)result_len);
+    free(result);
+
+    ION_ASSERT_OK(ion_reader_open_push(&reader, NULL));
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &stream, FALSE));
+    for (ii = 0; ii < text_len; ii++) {
+        ION_ASSERT_OK(ion_reader_push(reader, (BYTE *)&ion_text[ii], 1));
+        while ((err = ion_reader_next(reader, &type)) == IERR_OK) {
+            ASSERT_NE(tid_EOF, type);
+            ION_ASSERT_OK(ion_writer_write_one_value(writer, reader));
+            values++;
+        }
+        ASSERT_EQ(IERR_NEED_MORE_DATA, err);
+    }
+    // all but the last symbol, which might still go on
+    ASSERT_EQ(10, values);
+    ION_ASSERT_OK(ion_reader_push_eof(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_writer_write_one_value(writer, reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &result, &result_len));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    actual.assign((char *)result, (size_t)result_len);
+    free(result);
+
+    ASSERT_EQ(expected, actual);
+}
+
+TEST(IonTextReader, PushReaderStepsIntoValuesPushedInPieces) {
+    const char *ion_text = "{a:[1, 2], b:\"three\"} 4 ";
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+    int64_t int_value;
+
+    ION_ASSERT_OK(ion_reader_open_push(&reader, NULL));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, (BYTE *)ion_text, 12));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, (BYTE *)&ion_text[12], 9));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRUCT, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_LIST, type);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_STRING, type);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+    assertStringsEqual("three", (char *)value.value, value.length);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+
+    // a number isn't over until what follows it is in
+    ION_ASSERT_OK(ion_reader_push(reader, (BYTE *)&ion_text[21], 2));
+    ASSERT_EQ(IERR_NEED_MORE_DATA, ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_push(reader, (BYTE *)&ion_text[23], 1));
+    ION_ASSERT_OK(ion_reader_push_eof(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_INT, type);
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &int_value));
+    ASSERT_EQ(4, int_value);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
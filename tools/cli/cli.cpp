@@ -22,6 +22,8 @@
 #include "ion_event_stream_impl.h"
 #include "ion_event_equivalence.h"
 #include "cli.h"
+#include "filter.h"
+#include "perf.h"
 
 /**
  * Stores the resources required by an ION_READER.
@@ -42,15 +44,6 @@ public:
     }
 };
 
-iERR ion_cli_command_process_filter(IonEventWriterContext *writer_context, IonCliCommonArgs *common_args,
-                                    IonCliProcessArgs *process_args, ION_CATALOG *catalog, IonEventResult *result) {
-    iENTER;
-    ION_SET_ERROR_CONTEXT(&common_args->output.contents, NULL);
-    // TODO implement jq-style filtering.
-    IONFAILSTATE(IERR_NOT_IMPL, "Filtering not yet implemented.");
-    cRETURN;
-}
-
 iERR ion_cli_command_process_traverse(IonEventWriterContext *writer_context, IonCliCommonArgs *common_args,
                                       IonCliProcessArgs *process_args, ION_CATALOG *catalog, IonEventResult *result) {
     iENTER;
@@ -293,6 +286,48 @@ iERR ion_cli_command_process_standard(IonEventWriterContext *writer_context, Ion
     cRETURN;
 }
 
+iERR ion_cli_filter_input(IonCliFilter *filter, IonEventWriterContext *writer_context, IonCliIO *input,
+                          ION_CATALOG *catalog, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(&input->contents, NULL);
+    IonCliReaderContext reader_context;
+    reader_context.options.pcatalog = catalog;
+    IONREPORT(ion_cli_open_reader_basic(&reader_context, input, result));
+    IONREPORT(ion_cli_filter_apply(filter, reader_context.reader, writer_context->writer, &input->contents, result));
+cleanup:
+    UPDATEERROR(ion_cli_close_reader(&reader_context, err, result));
+    iRETURN;
+}
+
+iERR ion_cli_command_process_filter(IonEventWriterContext *writer_context, IonCliCommonArgs *common_args,
+                                    IonCliProcessArgs *process_args, ION_CATALOG *catalog, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(&common_args->output.contents, NULL);
+    IonCliFilter filter;
+    if (common_args->output_format == OUTPUT_TYPE_EVENTS) {
+        // Filters write the values they select as they go, without building an event stream.
+        IONFAILSTATE(IERR_NOT_IMPL, "Filtering is not supported with output-format = events.");
+    }
+    IONREPORT(ion_cli_filter_compile(&process_args->filter, catalog, &filter, result));
+    for (size_t i = 0; i < common_args->input_files.size(); i++) {
+        IONREPORT(ion_cli_filter_input(&filter, writer_context, &common_args->input_files.at(i), catalog, result));
+    }
+    cRETURN;
+}
+
+iERR ion_cli_write_perf_report(IonCliPerf *perf, IonCliIO *report_destination, IonEventResult *result) {
+    iENTER;
+    IonEventWriterContext writer_context;
+    ION_STRING output;
+    ION_STRING_INIT(&output);
+    IONREPORT(ion_cli_open_writer_basic(report_destination, OUTPUT_TYPE_TEXT_PRETTY, &writer_context, result));
+    IONREPORT(ion_cli_perf_write_report(perf, writer_context.writer, result));
+cleanup:
+    UPDATEERROR(ion_cli_close_writer(&writer_context, report_destination->type, &output, err, result));
+    ion_cli_free_command_output(&output);
+    iRETURN;
+}
+
 iERR ion_cli_command_process(IonCliCommonArgs *common_args, IonCliProcessArgs *process_args, ION_STRING *output,
                              IonEventReport *report) {
     iENTER;
@@ -301,7 +336,14 @@ iERR ion_cli_command_process(IonCliCommonArgs *common_args, IonCliProcessArgs *p
     IonEventWriterContext writer_context;
     ION_CATALOG *catalog = NULL;
     ION_COLLECTION *imports = NULL;
+    IonCliPerf perf;
+    bool measuring = false;
 
+    if (!process_args->perf_report.contents.empty()) {
+        // Everything from here on is measured, including opening the catalog, readers and writer, and closing them.
+        IONREPORT(ion_cli_perf_start(&perf, result));
+        measuring = true;
+    }
     IONREPORT(ion_cli_create_catalog(&common_args->catalogs, &catalog, result));
     IONREPORT(ion_cli_create_imports(&process_args->imports, &imports, result));
     if (common_args->output_format == OUTPUT_TYPE_EVENTS) {
@@ -318,11 +360,6 @@ iERR ion_cli_command_process(IonCliCommonArgs *common_args, IonCliProcessArgs *p
         // TODO add "silent" support.
         IONFAILSTATE(IERR_NOT_IMPL, "output-format = none not yet implemented.");
     }
-    if (!process_args->perf_report.contents.empty()) {
-        // TODO add perf report support
-        IONFAILSTATE(IERR_NOT_IMPL, "Performance reporting not yet implemented.");
-    }
-
     if (!process_args->filter.empty()) {
         IONREPORT(ion_cli_command_process_filter(&writer_context, common_args, process_args, catalog, result));
         IONCLEANEXIT;
@@ -343,6 +380,12 @@ cleanup:
     if (imports) {
         ion_free_owner(imports);
     }
+    if (measuring) {
+        ion_cli_perf_stop(&perf);
+        if (err == IERR_OK) {
+            err = ion_cli_write_perf_report(&perf, &process_args->perf_report, result);
+        }
+    }
     report->addResult(result);
     iRETURN;
 }
@@ -0,0 +1,935 @@
+/*
+ * Copyright 2009-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <ionc/ion_errors.h>
+#include <ionc/ion.h>
+#include "ion_helpers.h"
+#include "ion_reader_impl.h"
+#include "filter.h"
+
+static bool ion_cli_filter_is_identifier_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+/**
+ * The position of a parser within the text of a filter.
+ */
+class IonCliFilterParser {
+public:
+    std::string *text;
+    size_t pos;
+
+    IonCliFilterParser(std::string *text) {
+        this->text = text;
+        this->pos = 0;
+    }
+
+    bool atEnd() {
+        return pos >= text->length();
+    }
+
+    char peek() {
+        return atEnd() ? '\0' : text->at(pos);
+    }
+
+    void skipWhitespace() {
+        while (!atEnd() && isspace((unsigned char)peek())) {
+            pos++;
+        }
+    }
+
+    /**
+     * Consumes the given keyword if it's next, and isn't just the start of a longer identifier.
+     */
+    bool consumeKeyword(const char *keyword) {
+        size_t len = strlen(keyword);
+        if (text->compare(pos, len, keyword) != 0) {
+            return false;
+        }
+        if (pos + len < text->length() && ion_cli_filter_is_identifier_char(text->at(pos + len))) {
+            return false;
+        }
+        pos += len;
+        return true;
+    }
+
+    std::string error(const char *expected) {
+        std::ostringstream ss;
+        ss << "Invalid filter: expected " << expected << " at offset " << pos << ".";
+        return ss.str();
+    }
+};
+
+bool IonCliFilterTerm::isPredicate() {
+    switch (ION_TYPE_INT(literal_type)) {
+        case tid_INT_INT:
+        case tid_FLOAT_INT:
+        case tid_STRING_INT:
+        case tid_TIMESTAMP_INT:
+            // The extractor's predicates only hold for values of the operand's type, which `!=` holds for the rest of.
+            return comparison != ION_EXTRACTOR_NOT_EQUALS;
+        case tid_NULL_INT:
+            return comparison == ION_EXTRACTOR_NOT_EQUALS;
+        default:
+            return false;
+    }
+}
+
+bool IonCliFilterTerm::isNegatedPredicate() {
+    switch (ION_TYPE_INT(literal_type)) {
+        case tid_INT_INT:
+        case tid_FLOAT_INT:
+        case tid_STRING_INT:
+        case tid_TIMESTAMP_INT:
+            return comparison == ION_EXTRACTOR_NOT_EQUALS;
+        default:
+            return false;
+    }
+}
+
+bool IonCliFilterTerm::holds() {
+    if (values == 0) {
+        // A path that leads to no value compares as null. A predicate, which only sees the values that satisfy it,
+        // doesn't hold either way.
+        if (comparison == ION_EXTRACTOR_NOT_EQUALS) {
+            return literal_type != tid_NULL;
+        }
+        return comparison == ION_EXTRACTOR_EQUALS && literal_type == tid_NULL;
+    }
+    if (isNegatedPredicate()) {
+        return values > equal_values;
+    }
+    return satisfied;
+}
+
+IonCliFilter::~IonCliFilter() {
+    for (size_t i = 0; i < segments.size(); i++) {
+        IonCliFilterSegment *segment = segments.at(i);
+        if (segment->extractor) {
+            ion_extractor_close(segment->extractor);
+        }
+        if (segment->condition_extractor) {
+            ion_extractor_close(segment->condition_extractor);
+        }
+        if (segment->condition_reader) {
+            ion_reader_close(segment->condition_reader);
+        }
+        if (segment->value_reader) {
+            ion_reader_close(segment->value_reader);
+        }
+        ion_event_writer_close(&segment->scratch, NULL, IERR_OK, false, NULL, NULL);
+        for (size_t j = 0; j < segment->condition.size(); j++) {
+            for (size_t k = 0; k < segment->condition.at(j).size(); k++) {
+                IonCliFilterTerm *term = &segment->condition.at(j).at(k);
+                if (term->literal_type == tid_DECIMAL) {
+                    ion_decimal_free(&term->decimal_value);
+                }
+            }
+        }
+        delete segment;
+    }
+}
+
+/**
+ * Scans a quoted string or symbol, returning it with its quotes so that it can be read as Ion text.
+ */
+iERR ion_cli_filter_scan_quoted(IonCliFilterParser *parser, std::string *token, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    size_t start = parser->pos;
+    char quote = parser->peek();
+    parser->pos++;
+    while (!parser->atEnd() && parser->peek() != quote) {
+        if (parser->peek() == '\\') {
+            parser->pos++;
+        }
+        parser->pos++;
+    }
+    if (parser->atEnd()) {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("a closing quote"));
+    }
+    parser->pos++;
+    *token = parser->text->substr(start, parser->pos - start);
+    cRETURN;
+}
+
+/**
+ * Reads the one value in the given Ion text as the literal of a term.
+ */
+iERR ion_cli_filter_read_literal(IonCliFilterParser *parser, std::string *token, IonCliFilterTerm *term,
+                                 IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    hREADER reader = NULL;
+    ION_READER_OPTIONS options;
+    ION_TYPE type;
+    BOOL is_null;
+    ION_STRING text;
+
+    ion_event_initialize_reader_options(&options);
+    IONCREAD(ion_reader_open_buffer(&reader, (BYTE *)token->c_str(), (SIZE)token->length(), &options));
+    IONCREAD(ion_reader_next(reader, &type));
+    if (type == tid_EOF) {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("a literal"));
+    }
+    IONCREAD(ion_reader_is_null(reader, &is_null));
+    if (is_null) {
+        term->literal_type = tid_NULL;
+    }
+    else {
+        switch (ION_TYPE_INT(type)) {
+            case tid_INT_INT:
+                IONCSTATE(ion_reader_read_int64(reader, &term->int_value), "Int literals must fit in 64 bits.");
+                break;
+            case tid_FLOAT_INT:
+                IONCREAD(ion_reader_read_double(reader, &term->float_value));
+                break;
+            case tid_DECIMAL_INT:
+                IONCREAD(ion_reader_read_ion_decimal(reader, &term->decimal_value));
+                break;
+            case tid_STRING_INT:
+            case tid_SYMBOL_INT:
+                IONCREAD(ion_reader_read_string(reader, &text));
+                if (ION_STRING_IS_NULL(&text)) {
+                    IONFAILSTATE(IERR_INVALID_ARG, "Symbol literals must have known text.");
+                }
+                term->text_value = std::string((char *)text.value, (size_t)text.length);
+                type = tid_STRING;
+                break;
+            case tid_TIMESTAMP_INT:
+                IONCREAD(ion_reader_read_timestamp(reader, &term->timestamp_value));
+                break;
+            case tid_BOOL_INT:
+                IONCREAD(ion_reader_read_bool(reader, &term->bool_value));
+                break;
+            default:
+                IONFAILSTATE(IERR_INVALID_ARG, "Literals must be ints, floats, decimals, text, timestamps, bools or "
+                                               "null.");
+        }
+        term->literal_type = type;
+    }
+    IONCREAD(ion_reader_next(reader, &type));
+    if (type != tid_EOF) {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("one literal"));
+    }
+    if ((term->literal_type == tid_NULL || term->literal_type == tid_BOOL)
+        && term->comparison != ION_EXTRACTOR_EQUALS && term->comparison != ION_EXTRACTOR_NOT_EQUALS) {
+        IONFAILSTATE(IERR_INVALID_ARG, "Bools and nulls may only be compared with == and !=.");
+    }
+cleanup:
+    if (reader) {
+        ION_NON_FATAL(ion_reader_close(reader), "Failed to close reader.");
+    }
+    iRETURN;
+}
+
+/**
+ * Parses a field name that's an identifier or a quoted string.
+ */
+iERR ion_cli_filter_parse_field(IonCliFilterParser *parser, std::vector<IonCliFilterStep> *path,
+                                IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    IonCliFilterStep step(FILTER_STEP_FIELD);
+    IonCliFilterTerm literal;
+    std::string token;
+
+    if (parser->peek() == '"') {
+        IONREPORT(ion_cli_filter_scan_quoted(parser, &token, result));
+        IONREPORT(ion_cli_filter_read_literal(parser, &token, &literal, result));
+        step.field = literal.text_value;
+    }
+    else {
+        size_t start = parser->pos;
+        while (!parser->atEnd() && ion_cli_filter_is_identifier_char(parser->peek())) {
+            parser->pos++;
+        }
+        if (parser->pos == start) {
+            IONFAILSTATE(IERR_INVALID_ARG, parser->error("a field name"));
+        }
+        step.field = parser->text->substr(start, parser->pos - start);
+    }
+    path->push_back(step);
+    cRETURN;
+}
+
+/**
+ * Parses `[]`, `[n]` or `["name"]`.
+ */
+iERR ion_cli_filter_parse_brackets(IonCliFilterParser *parser, std::vector<IonCliFilterStep> *path,
+                                   IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    IonCliFilterStep step(FILTER_STEP_WILDCARD);
+
+    parser->pos++; // [
+    parser->skipWhitespace();
+    if (parser->peek() == '"') {
+        IONREPORT(ion_cli_filter_parse_field(parser, path, result));
+    }
+    else if (isdigit((unsigned char)parser->peek())) {
+        step.type = FILTER_STEP_ORDINAL;
+        while (isdigit((unsigned char)parser->peek())) {
+            step.ordinal = step.ordinal * 10 + (parser->peek() - '0');
+            if (step.ordinal > INT32_MAX) {
+                IONFAILSTATE(IERR_INVALID_ARG, parser->error("a smaller index"));
+            }
+            parser->pos++;
+        }
+        path->push_back(step);
+    }
+    else if (parser->peek() == ']') {
+        path->push_back(step);
+    }
+    else {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("a non-negative index, a quoted field name or ']'"));
+    }
+    parser->skipWhitespace();
+    if (parser->peek() != ']') {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("']'"));
+    }
+    parser->pos++;
+    cRETURN;
+}
+
+/**
+ * Parses a path that starts with `.`, appending its steps to the given path.
+ */
+iERR ion_cli_filter_parse_path(IonCliFilterParser *parser, std::vector<IonCliFilterStep> *path,
+                               IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+
+    if (parser->peek() != '.') {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("a path"));
+    }
+    parser->pos++;
+    if (parser->peek() == '"' || ion_cli_filter_is_identifier_char(parser->peek())) {
+        IONREPORT(ion_cli_filter_parse_field(parser, path, result));
+    }
+    while (TRUE) {
+        if (parser->peek() == '[') {
+            IONREPORT(ion_cli_filter_parse_brackets(parser, path, result));
+        }
+        else if (parser->peek() == '.') {
+            parser->pos++;
+            if (parser->peek() == '[') {
+                IONREPORT(ion_cli_filter_parse_brackets(parser, path, result));
+            }
+            else {
+                IONREPORT(ion_cli_filter_parse_field(parser, path, result));
+            }
+        }
+        else {
+            break;
+        }
+    }
+    cRETURN;
+}
+
+/**
+ * Parses a path, optionally compared to a literal.
+ */
+iERR ion_cli_filter_parse_term(IonCliFilterParser *parser, IonCliFilterTerm *term, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    static const struct {
+        const char *op;
+        ION_EXTRACTOR_COMPARISON comparison;
+    } operators[] = { // Longest first, so that `<=` isn't read as `<`.
+        {"==", ION_EXTRACTOR_EQUALS},
+        {"!=", ION_EXTRACTOR_NOT_EQUALS},
+        {"<=", ION_EXTRACTOR_LESS_THAN_OR_EQUALS},
+        {">=", ION_EXTRACTOR_GREATER_THAN_OR_EQUALS},
+        {"<", ION_EXTRACTOR_LESS_THAN},
+        {">", ION_EXTRACTOR_GREATER_THAN},
+    };
+    std::string token;
+    size_t start;
+    bool has_operator = false;
+
+    parser->skipWhitespace();
+    IONREPORT(ion_cli_filter_parse_path(parser, &term->path, result));
+    parser->skipWhitespace();
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++) {
+        if (parser->text->compare(parser->pos, strlen(operators[i].op), operators[i].op) == 0) {
+            term->comparison = operators[i].comparison;
+            parser->pos += strlen(operators[i].op);
+            has_operator = true;
+            break;
+        }
+    }
+    if (!has_operator) {
+        IONCLEANEXIT;
+    }
+    parser->skipWhitespace();
+    if (parser->peek() == '"' || parser->peek() == '\'') {
+        IONREPORT(ion_cli_filter_scan_quoted(parser, &token, result));
+    }
+    else {
+        start = parser->pos;
+        while (!parser->atEnd() && !isspace((unsigned char)parser->peek()) && parser->peek() != ')'
+               && parser->peek() != '|') {
+            parser->pos++;
+        }
+        token = parser->text->substr(start, parser->pos - start);
+    }
+    IONREPORT(ion_cli_filter_read_literal(parser, &token, term, result));
+    cRETURN;
+}
+
+/**
+ * Parses the condition of a `select`, up to its closing parenthesis.
+ */
+iERR ion_cli_filter_parse_condition(IonCliFilterParser *parser, IonCliFilterCondition *condition,
+                                    IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+
+    condition->push_back(std::vector<IonCliFilterTerm>());
+    while (TRUE) {
+        condition->back().push_back(IonCliFilterTerm());
+        IONREPORT(ion_cli_filter_parse_term(parser, &condition->back().back(), result));
+        parser->skipWhitespace();
+        if (parser->consumeKeyword("or")) {
+            condition->push_back(std::vector<IonCliFilterTerm>());
+        }
+        else if (!parser->consumeKeyword("and")) {
+            break;
+        }
+    }
+    if (parser->peek() != ')') {
+        IONFAILSTATE(IERR_INVALID_ARG, parser->error("'and', 'or' or ')'"));
+    }
+    parser->pos++;
+    cRETURN;
+}
+
+/**
+ * True if the condition can be checked entirely by predicates on the current value.
+ */
+static bool ion_cli_filter_is_pushed_down(IonCliFilterCondition *condition) {
+    if (condition->size() != 1) {
+        return false;
+    }
+    for (size_t i = 0; i < condition->at(0).size(); i++) {
+        IonCliFilterTerm *term = &condition->at(0).at(i);
+        if (!term->path.empty() || !term->isPredicate()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Parses the stages of the filter, dividing them into segments.
+ */
+iERR ion_cli_filter_parse(IonCliFilterParser *parser, IonCliFilter *filter, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(parser->text, NULL);
+    IonCliFilterSegment *segment = NULL;
+    IonCliFilterCondition condition;
+
+    do {
+        if (segment == NULL || !segment->condition.empty()) {
+            // Whatever follows a select that had to be buffered starts from the buffered value.
+            segment = new IonCliFilterSegment();
+            segment->filter = filter;
+            if (!filter->segments.empty()) {
+                filter->segments.back()->next = segment;
+            }
+            filter->segments.push_back(segment);
+        }
+        parser->skipWhitespace();
+        if (parser->peek() == '.') {
+            IONREPORT(ion_cli_filter_parse_path(parser, &segment->path, result));
+        }
+        else if (parser->consumeKeyword("select")) {
+            parser->skipWhitespace();
+            if (parser->peek() != '(') {
+                IONFAILSTATE(IERR_INVALID_ARG, parser->error("'('"));
+            }
+            parser->pos++;
+            condition.clear();
+            IONREPORT(ion_cli_filter_parse_condition(parser, &condition, result));
+            if (ion_cli_filter_is_pushed_down(&condition)) {
+                for (size_t i = 0; i < condition.at(0).size(); i++) {
+                    segment->predicates.push_back(std::make_pair(segment->path.size(), condition.at(0).at(i)));
+                }
+            }
+            else {
+                segment->condition = condition;
+            }
+        }
+        else {
+            IONFAILSTATE(IERR_INVALID_ARG, parser->error("a path or 'select'"));
+        }
+        parser->skipWhitespace();
+        if (parser->peek() == '|') {
+            parser->pos++;
+        }
+        else if (!parser->atEnd()) {
+            IONFAILSTATE(IERR_INVALID_ARG, parser->error("'|'"));
+        }
+        else {
+            break;
+        }
+    } while (TRUE);
+    cRETURN;
+}
+
+static bool ion_cli_filter_compared(ION_EXTRACTOR_COMPARISON comparison, int32_t order) {
+    switch (comparison) {
+        case ION_EXTRACTOR_EQUALS:
+            return order == 0;
+        case ION_EXTRACTOR_NOT_EQUALS:
+            return order != 0;
+        case ION_EXTRACTOR_LESS_THAN:
+            return order < 0;
+        case ION_EXTRACTOR_LESS_THAN_OR_EQUALS:
+            return order <= 0;
+        case ION_EXTRACTOR_GREATER_THAN:
+            return order > 0;
+        case ION_EXTRACTOR_GREATER_THAN_OR_EQUALS:
+            return order >= 0;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Checks the terms that aren't predicates against the reader's current value, which has been read if it's a bool or a
+ * decimal.
+ */
+static iERR ion_cli_filter_check_terms(std::vector<IonCliFilterTerm *> *terms, ION_TYPE type, BOOL is_null,
+                                       BOOL bool_value, ION_DECIMAL *decimal_value) {
+    iENTER;
+    int32_t order;
+    bool holds;
+
+    for (size_t i = 0; i < terms->size(); i++) {
+        IonCliFilterTerm *term = terms->at(i);
+        term->values++;
+        if (term->isPredicate()) {
+            // The extractor has already checked it.
+            term->satisfied = true;
+            continue;
+        }
+        switch (ION_TYPE_INT(term->literal_type)) {
+            case tid_none_INT:
+                holds = !is_null && (type != tid_BOOL || bool_value);
+                break;
+            case tid_NULL_INT:
+                // `!= null` is a predicate.
+                holds = (is_null == TRUE);
+                break;
+            case tid_BOOL_INT:
+                holds = !is_null && type == tid_BOOL && ((bool_value != FALSE) == (term->bool_value != FALSE));
+                if (term->comparison == ION_EXTRACTOR_NOT_EQUALS) {
+                    holds = !holds;
+                }
+                break;
+            case tid_DECIMAL_INT:
+                holds = (term->comparison == ION_EXTRACTOR_NOT_EQUALS);
+                if (!is_null && type == tid_DECIMAL) {
+                    IONCHECK(ion_decimal_compare(decimal_value, &term->decimal_value, &g_IonEventDecimalContext,
+                                                 &order));
+                    holds = ion_cli_filter_compared(term->comparison, order);
+                }
+                break;
+            case tid_INT_INT:
+            case tid_FLOAT_INT:
+            case tid_STRING_INT:
+            case tid_TIMESTAMP_INT:
+                // A `!=`, which holds for the values that aren't among its equal ones.
+                ASSERT(term->isNegatedPredicate());
+                continue;
+            default:
+                FAILWITH(IERR_INVALID_STATE);
+        }
+        term->satisfied |= holds;
+    }
+    iRETURN;
+}
+
+/**
+ * Checks the terms that share the matched path. Since a value can only be read once, they're checked together.
+ */
+static iERR ion_cli_filter_term_callback(hREADER reader, hPATH matched_path, void *user_context,
+                                         ION_EXTRACTOR_CONTROL *p_control) {
+    iENTER;
+    std::vector<IonCliFilterTerm *> *terms = (std::vector<IonCliFilterTerm *> *)user_context;
+    ION_TYPE type;
+    BOOL is_null, bool_value = FALSE;
+    ION_DECIMAL decimal_value;
+
+    *p_control = ion_extractor_control_next();
+    IONCHECK(ion_reader_get_type(reader, &type));
+    IONCHECK(ion_reader_is_null(reader, &is_null));
+    if (!is_null && type == tid_BOOL) {
+        IONCHECK(ion_reader_read_bool(reader, &bool_value));
+    }
+    else if (!is_null && type == tid_DECIMAL) {
+        IONCHECK(ion_reader_read_ion_decimal(reader, &decimal_value));
+        err = ion_cli_filter_check_terms(terms, type, is_null, bool_value, &decimal_value);
+        ion_decimal_free(&decimal_value);
+        IONCHECK(err);
+        SUCCEED();
+    }
+    IONCHECK(ion_cli_filter_check_terms(terms, type, is_null, bool_value, NULL));
+    iRETURN;
+}
+
+/**
+ * Counts a value that's equal to the literal of a `!=` term.
+ */
+static iERR ion_cli_filter_equal_callback(hREADER reader, hPATH matched_path, void *user_context,
+                                          ION_EXTRACTOR_CONTROL *p_control) {
+    IonCliFilterTerm *term = (IonCliFilterTerm *)user_context;
+
+    *p_control = ion_extractor_control_next();
+    term->equal_values++;
+    return IERR_OK;
+}
+
+/**
+ * Copies the reader's current value to the segment's readers. A binary value is copied as it's encoded, after the
+ * readers are given the reader's symbol table if it has changed. A text value is written by the scratch writer, which
+ * keeps its symbol table from one value to the next, so that the readers (and the extractors matching them) don't
+ * have to start over with a new one each time, but starts a new one every so often, so that it doesn't grow without
+ * bound.
+ */
+static iERR ion_cli_filter_buffer_value(IonCliFilterSegment *segment, hREADER reader) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(segment->filter->location, NULL);
+    IonEventResult *result = segment->filter->result;
+    ION_READER *preader = HANDLE_TO_PTR(reader, ION_READER);
+    ION_STREAM *stream = segment->scratch.ion_stream;
+    hSYMTAB symtab;
+    SIZE bytes_flushed, bytes_read;
+    POSITION length;
+
+    if (preader->type == ion_type_binary_reader) {
+        if (segment->symtab_generation != preader->_symtab_generation) {
+            IONCREAD(ion_reader_get_symbol_table(reader, &symtab));
+            IONCREAD(ion_reader_set_symbol_table(segment->condition_reader, symtab));
+            IONCREAD(ion_reader_set_symbol_table(segment->value_reader, symtab));
+            segment->symtab_generation = preader->_symtab_generation;
+        }
+        IONCREAD(_ion_reader_binary_copy_value(preader, stream));
+    }
+    else {
+        if (segment->symtab_generation != -1) {
+            // The readers have another symbol table, so the scratch writer has to write its own again.
+            IONCWRITE(ion_writer_finish(segment->scratch.writer, &bytes_flushed));
+            segment->buffered_values = 0;
+            segment->symtab_generation = -1;
+        }
+        IONCWRITE(ion_writer_write_one_value(segment->scratch.writer, reader));
+        if (++segment->buffered_values % ION_CLI_FILTER_SYMBOL_TABLE_VALUES == 0) {
+            IONCWRITE(ion_writer_finish(segment->scratch.writer, &bytes_flushed));
+        }
+        else {
+            IONCWRITE(ion_writer_flush(segment->scratch.writer, &bytes_flushed));
+        }
+    }
+    length = ion_stream_get_position(stream);
+    segment->buffer.resize((size_t)length);
+    IONCWRITE(ion_stream_seek(stream, 0));
+    IONCWRITE(ion_stream_read(stream, &segment->buffer[0], (SIZE)length, &bytes_read));
+    if (bytes_read != (SIZE)length) {
+        IONFAILSTATE(IERR_EOF, "Read an invalid number of bytes from the filter's buffer.");
+    }
+    IONCWRITE(ion_stream_seek(stream, 0));
+    IONCWRITE(ion_stream_truncate(stream));
+    IONCREAD(ion_reader_push(segment->condition_reader, &segment->buffer[0], (SIZE)length));
+    IONCREAD(ion_reader_push(segment->value_reader, &segment->buffer[0], (SIZE)length));
+    cRETURN;
+}
+
+/**
+ * Matches the given extractor against the last value pushed to the given reader.
+ */
+static iERR ion_cli_filter_match_pushed(IonCliFilterSegment *segment, hEXTRACTOR extractor, hREADER reader) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(segment->filter->location, NULL);
+    IonEventResult *result = segment->filter->result;
+
+    err = ion_extractor_match(extractor, reader);
+    if (err == IERR_NEED_MORE_DATA) {
+        // The reader has run out of values, until the next one is pushed.
+        err = IERR_OK;
+    }
+    else if (err && !result->has_error_description) {
+        IONCREAD(err);
+    }
+    cRETURN;
+}
+
+static iERR ion_cli_filter_segment_callback(hREADER reader, hPATH matched_path, void *user_context,
+                                            ION_EXTRACTOR_CONTROL *p_control) {
+    iENTER;
+    IonCliFilterSegment *segment = (IonCliFilterSegment *)user_context;
+    ION_SET_ERROR_CONTEXT(segment->filter->location, NULL);
+    IonEventResult *result = segment->filter->result;
+    ION_TYPE type;
+    bool passes = false;
+
+    *p_control = ion_extractor_control_next();
+    if (segment->condition.empty()) {
+        // Only the last segment can end without a select.
+        IONCWRITE(ion_writer_write_one_value(segment->filter->output, reader));
+        IONCLEANEXIT;
+    }
+    IONREPORT(ion_cli_filter_buffer_value(segment, reader));
+    for (size_t i = 0; i < segment->condition.size(); i++) {
+        for (size_t j = 0; j < segment->condition.at(i).size(); j++) {
+            segment->condition.at(i).at(j).satisfied = false;
+            segment->condition.at(i).at(j).values = 0;
+            segment->condition.at(i).at(j).equal_values = 0;
+        }
+    }
+    IONREPORT(ion_cli_filter_match_pushed(segment, segment->condition_extractor, segment->condition_reader));
+    for (size_t i = 0; i < segment->condition.size() && !passes; i++) {
+        passes = true;
+        for (size_t j = 0; j < segment->condition.at(i).size(); j++) {
+            passes &= segment->condition.at(i).at(j).holds();
+        }
+    }
+    if (passes && segment->next) {
+        IONREPORT(ion_cli_filter_match_pushed(segment, segment->next->extractor, segment->value_reader));
+    }
+    else {
+        // Either way, the value reader moves on to the value, so that it's in step with the condition reader.
+        IONCREAD(ion_reader_next(segment->value_reader, &type));
+        if (passes) {
+            IONCWRITE(ion_writer_write_one_value(segment->filter->output, segment->value_reader));
+        }
+    }
+    cRETURN;
+}
+
+static bool ion_cli_filter_paths_equal(std::vector<IonCliFilterStep> *lhs, std::vector<IonCliFilterStep> *rhs) {
+    if (lhs->size() != rhs->size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs->size(); i++) {
+        IonCliFilterStep *left = &lhs->at(i), *right = &rhs->at(i);
+        if (left->type != right->type || left->field != right->field || left->ordinal != right->ordinal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static iERR ion_cli_filter_append_steps(hPATH path, std::vector<IonCliFilterStep> *steps, size_t start, size_t end) {
+    iENTER;
+    ION_STRING field;
+
+    for (size_t i = start; i < end; i++) {
+        IonCliFilterStep *step = &steps->at(i);
+        switch (step->type) {
+            case FILTER_STEP_FIELD:
+                ION_EVENT_ION_STRING_FROM_STRING(&field, step->field);
+                IONCHECK(ion_extractor_path_append_field(path, &field));
+                break;
+            case FILTER_STEP_ORDINAL:
+                IONCHECK(ion_extractor_path_append_ordinal(path, step->ordinal));
+                break;
+            default:
+                IONCHECK(ion_extractor_path_append_wildcard(path));
+                break;
+        }
+    }
+    iRETURN;
+}
+
+/**
+ * Requires the term's comparison of the path's values, or the given one in its place (for a `!=` that's checked by
+ * finding the values that are `==`).
+ */
+static iERR ion_cli_filter_add_predicate(hPATH path, IonCliFilterTerm *term, ION_EXTRACTOR_COMPARISON comparison) {
+    iENTER;
+    ION_STRING text;
+
+    switch (ION_TYPE_INT(term->literal_type)) {
+        case tid_INT_INT:
+            IONCHECK(ion_extractor_path_require_int(path, comparison, term->int_value));
+            break;
+        case tid_FLOAT_INT:
+            IONCHECK(ion_extractor_path_require_float(path, comparison, term->float_value));
+            break;
+        case tid_STRING_INT:
+            ION_EVENT_ION_STRING_FROM_STRING(&text, term->text_value);
+            IONCHECK(ion_extractor_path_require_text(path, comparison, &text));
+            break;
+        case tid_TIMESTAMP_INT:
+            IONCHECK(ion_extractor_path_require_timestamp(path, comparison, &term->timestamp_value));
+            break;
+        case tid_NULL_INT:
+            IONCHECK(ion_extractor_path_require_non_null(path));
+            break;
+        default:
+            FAILWITH(IERR_INVALID_STATE);
+    }
+    iRETURN;
+}
+
+static iERR ion_cli_filter_open_extractor(size_t num_paths, size_t max_path_length, hEXTRACTOR *p_extractor) {
+    iENTER;
+    ION_EXTRACTOR_OPTIONS options;
+
+    if (num_paths > ION_EXTRACTOR_MAX_NUM_PATHS || max_path_length > ION_EXTRACTOR_MAX_PATH_LENGTH) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    memset(&options, 0, sizeof(options));
+    options.max_num_paths = (ION_EXTRACTOR_SIZE)num_paths;
+    options.max_path_length = (ION_EXTRACTOR_SIZE)((max_path_length > 0) ? max_path_length : 1);
+    IONCHECK(ion_extractor_open(p_extractor, &options));
+    iRETURN;
+}
+
+/**
+ * Registers the segment's path, with its predicates, and the terms of its condition, if any.
+ */
+static iERR ion_cli_filter_prepare_segment(IonCliFilterSegment *segment) {
+    iENTER;
+    hPATH path;
+    size_t steps = 0, max_path_length = 0;
+    std::vector<IonCliFilterTerm *> negated;
+
+    IONCHECK(ion_cli_filter_open_extractor(1, segment->path.size(), &segment->extractor));
+    IONCHECK(ion_extractor_path_create(segment->extractor, (ION_EXTRACTOR_SIZE)segment->path.size(),
+                                       ion_cli_filter_segment_callback, segment, &path));
+    for (size_t i = 0; i < segment->predicates.size(); i++) {
+        IONCHECK(ion_cli_filter_append_steps(path, &segment->path, steps, segment->predicates.at(i).first));
+        steps = segment->predicates.at(i).first;
+        IONCHECK(ion_cli_filter_add_predicate(path, &segment->predicates.at(i).second,
+                                              segment->predicates.at(i).second.comparison));
+    }
+    IONCHECK(ion_cli_filter_append_steps(path, &segment->path, steps, segment->path.size()));
+
+    if (segment->condition.empty()) {
+        SUCCEED();
+    }
+    // Each predicate needs a path of its own. The other terms share one with the terms that have the same path.
+    for (size_t i = 0; i < segment->condition.size(); i++) {
+        for (size_t j = 0; j < segment->condition.at(i).size(); j++) {
+            IonCliFilterTerm *term = &segment->condition.at(i).at(j);
+            size_t group = segment->term_groups.size();
+            if (term->isNegatedPredicate()) {
+                negated.push_back(term);
+            }
+            if (!term->isPredicate()) {
+                for (group = 0; group < segment->term_groups.size(); group++) {
+                    IonCliFilterTerm *first = segment->term_groups.at(group).at(0);
+                    if (!first->isPredicate() && ion_cli_filter_paths_equal(&first->path, &term->path)) {
+                        break;
+                    }
+                }
+            }
+            if (group == segment->term_groups.size()) {
+                segment->term_groups.push_back(std::vector<IonCliFilterTerm *>());
+                max_path_length = std::max(max_path_length, term->path.size());
+            }
+            segment->term_groups.at(group).push_back(term);
+        }
+    }
+    IONCHECK(ion_cli_filter_open_extractor(segment->term_groups.size() + negated.size(), max_path_length,
+                                           &segment->condition_extractor));
+    for (size_t i = 0; i < segment->term_groups.size(); i++) {
+        IonCliFilterTerm *term = segment->term_groups.at(i).at(0);
+        IONCHECK(ion_extractor_path_create(segment->condition_extractor, (ION_EXTRACTOR_SIZE)term->path.size(),
+                                           ion_cli_filter_term_callback, &segment->term_groups.at(i), &path));
+        IONCHECK(ion_cli_filter_append_steps(path, &term->path, 0, term->path.size()));
+        if (term->isPredicate()) {
+            IONCHECK(ion_cli_filter_add_predicate(path, term, term->comparison));
+        }
+    }
+    // A `!=` also needs a path that finds the values that are `==`, since it holds for the rest.
+    for (size_t i = 0; i < negated.size(); i++) {
+        IonCliFilterTerm *term = negated.at(i);
+        IONCHECK(ion_extractor_path_create(segment->condition_extractor, (ION_EXTRACTOR_SIZE)term->path.size(),
+                                           ion_cli_filter_equal_callback, term, &path));
+        IONCHECK(ion_cli_filter_append_steps(path, &term->path, 0, term->path.size()));
+        IONCHECK(ion_cli_filter_add_predicate(path, term, ION_EXTRACTOR_EQUALS));
+    }
+    iRETURN;
+}
+
+/**
+ * Opens a reader for a segment's buffered values. Binary values are copied to it without a version marker, so it's
+ * given one and reads past it first. Otherwise it would read the marker after it was given a symbol table, and lose
+ * the table.
+ */
+static iERR ion_cli_filter_open_push_reader(IonCliFilter *filter, hREADER *p_reader) {
+    iENTER;
+    ION_TYPE type;
+
+    IONCHECK(ion_reader_open_push(p_reader, &filter->reader_options));
+    IONCHECK(ion_reader_push(*p_reader, ION_VERSION_MARKER, ION_VERSION_MARKER_LENGTH));
+    err = ion_reader_next(*p_reader, &type);
+    if (err != IERR_NEED_MORE_DATA) {
+        FAILWITH((err == IERR_OK) ? IERR_INVALID_STATE : err);
+    }
+    err = IERR_OK;
+    iRETURN;
+}
+
+iERR ion_cli_filter_compile(std::string *filter_text, ION_CATALOG *catalog, IonCliFilter *filter,
+                            IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(filter_text, NULL);
+    IonCliFilterParser parser(filter_text);
+
+    filter->reader_options.pcatalog = catalog;
+    IONREPORT(ion_cli_filter_parse(&parser, filter, result));
+    for (size_t i = 0; i < filter->segments.size(); i++) {
+        IonCliFilterSegment *segment = filter->segments.at(i);
+        IONCSTATE(ion_cli_filter_prepare_segment(segment), "Filter is too long or has too many terms.");
+        if (!segment->condition.empty()) {
+            IONREPORT(ion_event_in_memory_writer_open(&segment->scratch, OUTPUT_TYPE_BINARY, NULL, catalog,
+                                                      filter_text, result));
+            IONCREAD(ion_cli_filter_open_push_reader(filter, &segment->condition_reader));
+            IONCREAD(ion_cli_filter_open_push_reader(filter, &segment->value_reader));
+        }
+    }
+    cRETURN;
+}
+
+iERR ion_cli_filter_apply(IonCliFilter *filter, hREADER reader, hWRITER writer, std::string *location,
+                          IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(location, NULL);
+    IonCliFilterSegment *segment;
+    ASSERT(!filter->segments.empty());
+
+    filter->output = writer;
+    filter->location = location;
+    filter->result = result;
+    segment = filter->segments.at(0);
+    if (segment->next == NULL && segment->path.empty() && segment->predicates.empty() && segment->condition.empty()) {
+        // `.` passes on everything.
+        IONCWRITE(ion_writer_write_all_values(writer, reader));
+        IONCLEANEXIT;
+    }
+    err = ion_extractor_match(segment->extractor, reader);
+    if (err && !result->has_error_description) {
+        IONCREAD(err);
+    }
+    cRETURN;
+}
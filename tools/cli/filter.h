@@ -0,0 +1,250 @@
+/*
+ * Copyright 2009-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**
+ * Filters for `ion process --filter`, which are a subset of jq's language:
+ *
+ *  - `.` is the value itself.
+ *  - `.name`, `."name"` and `.["name"]` are the named field of a struct.
+ *  - `.[n]` is the nth child of a container, and `.[]` is every child.
+ *  - `select(condition)` passes on the values for which the condition holds. The condition is made of terms joined
+ *    by `and` and `or` (which binds looser). A term is a path, which holds if it leads to a value that isn't null or
+ *    false, or a path compared to a literal with one of `==`, `!=`, `<`, `<=`, `>` or `>=`.
+ *  - `|` passes each output of the filter on its left to the filter on its right.
+ *
+ * Steps may be chained, as in `.a.b[0][]`. Literals are Ion text: ints, floats, decimals, strings and symbols,
+ * timestamps, bools and `null`. Unlike in jq, comparisons only hold between values of the literal's type (so
+ * `.a == 1` doesn't hold for `1.0` or `"1"`, and `.a < 1` doesn't hold for null), decimals are compared with their
+ * precision (so `5.0 != 5.00`), text is ordered by its UTF-8 bytes, and bools and nulls may only be compared with
+ * `==` and `!=`. As in jq, `!=` holds wherever `==` doesn't, including for values of other types and nulls, and a
+ * path that leads to no value, like `.x` of a value without an `x` field, compares as null: `select(.x != 1)` and
+ * `select(.x == null)` pass on the values without an `x`.
+ *
+ * Filters are compiled into ion_extractor paths. Consecutive steps make up one path, and a `select` that only
+ * compares `.` itself becomes predicates on the path's last step, so the values a filter like
+ * `.[] | select(. != null) | .a | select(. > 5)` skips are never decoded. A `select` on any other path has to see
+ * the whole value before deciding whether to pass it on, so each value that reaches one is copied to a buffer first.
+ */
+
+#ifndef IONC_CLI_FILTER_H
+#define IONC_CLI_FILTER_H
+
+#include <string>
+#include <vector>
+#include <ionc/ion.h>
+#include <ionc/ion_extractor.h>
+#include "ion_event_util.h"
+#include "ion_event_stream_impl.h"
+
+/**
+ * The number of text values a segment buffers with one symbol table. Each value that adds symbols to it makes the
+ * segment's readers copy the whole table, so it's kept small.
+ */
+#define ION_CLI_FILTER_SYMBOL_TABLE_VALUES 64
+
+typedef enum _ion_cli_filter_step_type {
+    FILTER_STEP_FIELD = 0,
+    FILTER_STEP_ORDINAL,
+    FILTER_STEP_WILDCARD
+} ION_CLI_FILTER_STEP_TYPE;
+
+/**
+ * One step of a path, e.g. `.name` or `[2]`.
+ */
+class IonCliFilterStep {
+public:
+    ION_CLI_FILTER_STEP_TYPE type;
+    std::string field;
+    POSITION ordinal;
+
+    IonCliFilterStep(ION_CLI_FILTER_STEP_TYPE type) {
+        this->type = type;
+        this->ordinal = 0;
+    }
+};
+
+/**
+ * A term of a `select` condition: a path, and what's required of the values it leads to.
+ */
+class IonCliFilterTerm {
+public:
+    std::vector<IonCliFilterStep> path;
+
+    /**
+     * tid_none if the term only requires a truthy value. Otherwise the type of the literal the value is compared to,
+     * which is tid_NULL for `null`.
+     */
+    ION_TYPE literal_type;
+    ION_EXTRACTOR_COMPARISON comparison;
+    int64_t int_value;
+    double float_value;
+    ION_DECIMAL decimal_value;
+    std::string text_value;
+    ION_TIMESTAMP timestamp_value;
+    BOOL bool_value;
+
+    /**
+     * Whether the term held for any of the values its path led to in the value the condition is being checked on.
+     */
+    bool satisfied;
+
+    /**
+     * The number of values its path led to, and, for a `!=` that isn't a predicate, the number of those that were
+     * equal to the literal, which the extractor counts with an `==` predicate.
+     */
+    size_t values;
+    size_t equal_values;
+
+    IonCliFilterTerm() {
+        literal_type = tid_none;
+        comparison = ION_EXTRACTOR_EQUALS;
+        int_value = 0;
+        float_value = 0;
+        bool_value = FALSE;
+        satisfied = false;
+        values = 0;
+        equal_values = 0;
+        memset(&decimal_value, 0, sizeof(decimal_value));
+        memset(&timestamp_value, 0, sizeof(timestamp_value));
+    }
+
+    /**
+     * True if the extractor can check the term by itself, as a predicate. Otherwise the term's callback reads the
+     * value to check it.
+     */
+    bool isPredicate();
+
+    /**
+     * True if the term needs an `==` predicate to find the values that are equal to the literal, so that it holds
+     * for the rest.
+     */
+    bool isNegatedPredicate();
+
+    /**
+     * Whether the term holds, once the value the condition is being checked on has been matched.
+     */
+    bool holds();
+};
+
+/**
+ * A `select` condition: a disjunction of conjunctions of terms.
+ */
+typedef std::vector<std::vector<IonCliFilterTerm> > IonCliFilterCondition;
+
+class IonCliFilter;
+
+/**
+ * A part of a filter that's matched by one extractor: a path, with predicates on some of its steps, followed by at
+ * most one `select` that can't be turned into predicates. The next segment, if any, starts from each value that
+ * passes that `select`.
+ */
+class IonCliFilterSegment {
+public:
+    std::vector<IonCliFilterStep> path;
+
+    /**
+     * The terms that become predicates, each with the number of steps of `path` that came before it.
+     */
+    std::vector<std::pair<size_t, IonCliFilterTerm> > predicates;
+    IonCliFilterCondition condition;
+
+    hEXTRACTOR extractor;
+
+    /**
+     * Matches the terms of `condition`, marking the terms that hold as satisfied.
+     */
+    hEXTRACTOR condition_extractor;
+
+    /**
+     * The terms of `condition`, grouped by the path of `condition_extractor` that checks them.
+     */
+    std::vector<std::vector<IonCliFilterTerm *> > term_groups;
+
+    /**
+     * Copies each value that reaches `condition` to `condition_reader`, which is matched by `condition_extractor`,
+     * and to `value_reader`, from which the value is passed on if it satisfies the condition. Binary values are copied
+     * as they're encoded, and the readers share the symbol table of the reader the value came from. Text values are
+     * written by `scratch`, in binary.
+     */
+    IonEventWriterContext scratch;
+    std::vector<BYTE> buffer;
+    size_t buffered_values;
+    hREADER condition_reader;
+    hREADER value_reader;
+
+    /**
+     * The generation of the binary reader's symbol table that the readers were last given, or -1 while they're
+     * reading the symbol tables written by `scratch`.
+     */
+    int64_t symtab_generation;
+
+    IonCliFilter *filter;
+    IonCliFilterSegment *next;
+
+    IonCliFilterSegment() {
+        extractor = NULL;
+        condition_extractor = NULL;
+        buffered_values = 0;
+        condition_reader = NULL;
+        value_reader = NULL;
+        symtab_generation = -1;
+        filter = NULL;
+        next = NULL;
+    }
+};
+
+/**
+ * A compiled filter. Its segments and their extractors are shared by every value the filter is applied to.
+ */
+class IonCliFilter {
+public:
+    std::vector<IonCliFilterSegment *> segments;
+
+    /**
+     * Opens the readers the segments copy values to.
+     */
+    ION_READER_OPTIONS reader_options;
+
+    /**
+     * The writer, input location and result of the current call to `ion_cli_filter_apply`.
+     */
+    hWRITER output;
+    std::string *location;
+    IonEventResult *result;
+
+    IonCliFilter() {
+        ion_event_initialize_reader_options(&reader_options);
+        output = NULL;
+        location = NULL;
+        result = NULL;
+    }
+
+    ~IonCliFilter();
+};
+
+/**
+ * Parses the given filter and prepares it to be applied. Symbols in values copied for a `select` are resolved
+ * with the given catalog, which may be NULL.
+ */
+iERR ion_cli_filter_compile(std::string *filter_text, ION_CATALOG *catalog, IonCliFilter *filter,
+                            IonEventResult *result);
+
+/**
+ * Applies the filter to each top-level value from the given reader, writing the filter's outputs to the given writer
+ * as top-level values.
+ */
+iERR ion_cli_filter_apply(IonCliFilter *filter, hREADER reader, hWRITER writer, std::string *location,
+                          IonEventResult *result);
+
+#endif //IONC_CLI_FILTER_H
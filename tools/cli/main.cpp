@@ -90,7 +90,7 @@ static const int MAX_NO_INPUTS = 48;
 static const char *const OUTPUT_SHORT_OPT = "o";
 static const char *const OUTPUT_LONG_OPT = "output";
 static const char *const FILE_DATATYPE = "<file>";
-static const char *const OUTPUT_FILE_GLOSSARY = "Output file [default: stdout].";
+static const char *const OUTPUT_FILE_GLOSSARY = "Output file, or '-' for stdout [default: stdout].";
 
 static const char *const ERR_SHORT_OPT = "e";
 static const char *const ERR_LONG_OPT = "error-report";
@@ -376,7 +376,12 @@ void ion_print_process_examples() {
 
             "Read input1.ion and input2.10n and output to stdout any values in the streams \n"
             "that match the filter .foo:\n"
-            "\t$ ion process --filter .foo input1.ion input2.10n\n\n";
+            "\t$ ion process --filter .foo input1.ion input2.10n\n\n"
+
+            "Output the values in input.ion whose field n isn't 1, including those without \n"
+            "an n (a path that leads to no value compares as null, and != holds for values \n"
+            "of any other type):\n"
+            "\t$ ion process --filter 'select(.n != 1)' input.ion\n\n";
 
     std::cout << s << std::endl;
 
@@ -642,7 +647,7 @@ iERR ion_cli_common_args(IonEventReport *report,
     ION_CLI_IO_TYPE err_report_type = IO_TYPE_CONSOLE;
     std::string err_destination("stderr"); // default is STDERR
 
-    if (out_count == 1) {
+    if (out_count == 1 && !is_hyphen(std::string(out_fname))) {
         out_destination = std::string(out_fname);
         output_type = IO_TYPE_FILE;
     }
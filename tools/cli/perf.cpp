@@ -0,0 +1,243 @@
+/*
+ * Copyright 2009-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <string>
+#include <ionc/ion_errors.h>
+#include <ionc/ion.h>
+#include "perf.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static const char *ion_cli_perf_phase_names[ION_PERF_PHASE_COUNT] = {
+    "other", "read", "decode", "symbols", "write"
+};
+
+#ifndef _WIN32
+
+static void ion_cli_perf_sample_cpu(int signal) {
+    ion_perf_sample(ION_PERF_CLOCK_CPU);
+}
+
+static void ion_cli_perf_sample_wall(int signal) {
+    ion_perf_sample(ION_PERF_CLOCK_WALL);
+}
+
+static int ion_cli_perf_set_timer(int which, int signal, void (*handler)(int), long interval_usec,
+                                  struct sigaction *previous_action, struct itimerval *previous_timer) {
+    struct sigaction action;
+    struct itimerval timer;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handler;
+    // Reads and writes interrupted by a sample carry on as if it hadn't been taken.
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(signal, &action, previous_action)) return -1;
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = interval_usec;
+    timer.it_value = timer.it_interval;
+    if (setitimer(which, &timer, previous_timer)) {
+        sigaction(signal, previous_action, NULL);
+        return -1;
+    }
+    return 0;
+}
+
+static void ion_cli_perf_restore_timer(int which, int signal, struct sigaction *previous_action,
+                                       struct itimerval *previous_timer) {
+    // The timer goes first, so that it can't fire into the restored handler on our behalf.
+    setitimer(which, previous_timer, NULL);
+    sigaction(signal, previous_action, NULL);
+}
+
+#endif
+
+iERR ion_cli_perf_start(IonCliPerf *perf, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(NULL, NULL);
+    ion_perf_reset();
+    ion_perf_enable(TRUE);
+#ifndef _WIN32
+    if (ion_cli_perf_set_timer(ITIMER_PROF, SIGPROF, ion_cli_perf_sample_cpu, ION_CLI_PERF_SAMPLE_INTERVAL_USEC,
+                               &perf->previous_cpu_action, &perf->previous_cpu_timer)) {
+        ion_perf_enable(FALSE);
+        IONFAILSTATE(IERR_INVALID_STATE, "Failed to start the performance report's timers.");
+    }
+    if (ion_cli_perf_set_timer(ITIMER_REAL, SIGALRM, ion_cli_perf_sample_wall, ION_CLI_PERF_SAMPLE_INTERVAL_USEC,
+                               &perf->previous_wall_action, &perf->previous_wall_timer)) {
+        ion_cli_perf_restore_timer(ITIMER_PROF, SIGPROF, &perf->previous_cpu_action, &perf->previous_cpu_timer);
+        ion_perf_enable(FALSE);
+        IONFAILSTATE(IERR_INVALID_STATE, "Failed to start the performance report's timers.");
+    }
+    perf->timers_set = true;
+#endif
+    perf->wall_start = std::chrono::steady_clock::now();
+    perf->cpu_start = std::clock();
+    cRETURN;
+}
+
+void ion_cli_perf_stop(IonCliPerf *perf) {
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - perf->wall_start;
+    perf->wall_seconds = wall.count();
+    perf->cpu_seconds = (double)(std::clock() - perf->cpu_start) / CLOCKS_PER_SEC;
+#ifndef _WIN32
+    if (perf->timers_set) {
+        ion_cli_perf_restore_timer(ITIMER_PROF, SIGPROF, &perf->previous_cpu_action, &perf->previous_cpu_timer);
+        ion_cli_perf_restore_timer(ITIMER_REAL, SIGALRM, &perf->previous_wall_action, &perf->previous_wall_timer);
+        perf->timers_set = false;
+    }
+#endif
+    ion_perf_enable(FALSE);
+    ion_perf_get_stats(&perf->stats);
+}
+
+static iERR ion_cli_perf_write_field_name(hWRITER writer, const char *name) {
+    ION_STRING field;
+    return ion_writer_write_field_name(writer, ion_string_assign_cstr(&field, (char *)name, (SIZE)strlen(name)));
+}
+
+static iERR ion_cli_perf_write_int_field(hWRITER writer, const char *name, int64_t value) {
+    iENTER;
+    IONCHECK(ion_cli_perf_write_field_name(writer, name));
+    IONCHECK(ion_writer_write_int64(writer, value));
+    iRETURN;
+}
+
+static iERR ion_cli_perf_write_double_field(hWRITER writer, const char *name, double value) {
+    iENTER;
+    IONCHECK(ion_cli_perf_write_field_name(writer, name));
+    IONCHECK(ion_writer_write_double(writer, value));
+    iRETURN;
+}
+
+static double ion_cli_perf_rate(double count, double seconds) {
+    return (seconds > 0) ? count / seconds : 0;
+}
+
+/**
+ * The time a phase's share of the samples taken with the given clock accounts for.
+ */
+static double ion_cli_perf_phase_seconds(IonCliPerf *perf, int phase, ION_PERF_CLOCK clock, double seconds) {
+    int64_t samples = 0;
+    for (int i = 0; i < ION_PERF_PHASE_COUNT; i++) {
+        samples += perf->stats.phases[i].samples[clock];
+    }
+    return (samples > 0) ? seconds * perf->stats.phases[phase].samples[clock] / samples : 0;
+}
+
+static iERR ion_cli_perf_write_values(hWRITER writer, const char *name, int64_t *counts, double wall_seconds) {
+    iENTER;
+    ION_STRING *type_name;
+    IONCHECK(ion_cli_perf_write_field_name(writer, name));
+    IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+    for (int i = 0; i < ION_PERF_TYPE_COUNT; i++) {
+        type_name = ion_event_ion_type_to_string((ION_TYPE)(intptr_t)(i << 8));
+        if (!type_name || counts[i] == 0) continue;
+        IONCHECK(ion_writer_write_field_name(writer, type_name));
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+        IONCHECK(ion_cli_perf_write_int_field(writer, "count", counts[i]));
+        IONCHECK(ion_cli_perf_write_double_field(writer, "per_second", ion_cli_perf_rate(counts[i], wall_seconds)));
+        IONCHECK(ion_writer_finish_container(writer));
+    }
+    IONCHECK(ion_writer_finish_container(writer));
+    iRETURN;
+}
+
+static iERR ion_cli_perf_write_phases(hWRITER writer, IonCliPerf *perf) {
+    iENTER;
+    ION_PERF_PHASE_STATS *phase;
+    ION_STRING name;
+    IONCHECK(ion_cli_perf_write_field_name(writer, "phases"));
+    IONCHECK(ion_writer_start_container(writer, tid_LIST));
+    for (int i = 0; i < ION_PERF_PHASE_COUNT; i++) {
+        phase = &perf->stats.phases[i];
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+        IONCHECK(ion_cli_perf_write_field_name(writer, "phase"));
+        IONCHECK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&name, (char *)ion_cli_perf_phase_names[i],
+                                                                        (SIZE)strlen(ion_cli_perf_phase_names[i]))));
+        IONCHECK(ion_cli_perf_write_int_field(writer, "calls", phase->calls));
+        IONCHECK(ion_cli_perf_write_int_field(writer, "wall_samples", phase->samples[ION_PERF_CLOCK_WALL]));
+        IONCHECK(ion_cli_perf_write_int_field(writer, "cpu_samples", phase->samples[ION_PERF_CLOCK_CPU]));
+        IONCHECK(ion_cli_perf_write_double_field(writer, "wall_seconds",
+                                                 ion_cli_perf_phase_seconds(perf, i, ION_PERF_CLOCK_WALL,
+                                                                            perf->wall_seconds)));
+        IONCHECK(ion_cli_perf_write_double_field(writer, "cpu_seconds",
+                                                 ion_cli_perf_phase_seconds(perf, i, ION_PERF_CLOCK_CPU,
+                                                                            perf->cpu_seconds)));
+        IONCHECK(ion_writer_finish_container(writer));
+    }
+    IONCHECK(ion_writer_finish_container(writer));
+    iRETURN;
+}
+
+static iERR ion_cli_perf_write_memory(hWRITER writer, IonCliPerf *perf) {
+    iENTER;
+    int64_t peak_rss = 0;
+#ifndef _WIN32
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+#ifdef __APPLE__
+        peak_rss = usage.ru_maxrss;
+#else
+        peak_rss = (int64_t)usage.ru_maxrss * 1024;
+#endif
+    }
+#endif
+    IONCHECK(ion_cli_perf_write_field_name(writer, "memory"));
+    IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "peak_rss_bytes", peak_rss));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "peak_block_bytes", perf->stats.peak_block_bytes));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "allocations", perf->stats.allocations));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "frees", perf->stats.frees));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "blocks_allocated", perf->stats.blocks_allocated));
+    IONCHECK(ion_writer_finish_container(writer));
+    iRETURN;
+}
+
+static iERR ion_cli_perf_write_page_pool(hWRITER writer, IonCliPerf *perf) {
+    iENTER;
+    int64_t hits = perf->stats.page_pool_hits, misses = perf->stats.page_pool_misses;
+    IONCHECK(ion_cli_perf_write_field_name(writer, "page_pool"));
+    IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "hits", hits));
+    IONCHECK(ion_cli_perf_write_int_field(writer, "misses", misses));
+    IONCHECK(ion_cli_perf_write_double_field(writer, "hit_rate", (hits + misses > 0)
+                                                                 ? (double)hits / (hits + misses) : 0));
+    IONCHECK(ion_writer_finish_container(writer));
+    iRETURN;
+}
+
+iERR ion_cli_perf_write_report(IonCliPerf *perf, hWRITER writer, IonEventResult *result) {
+    iENTER;
+    ION_SET_ERROR_CONTEXT(NULL, NULL);
+    IONCWRITE(ion_writer_start_container(writer, tid_STRUCT));
+    IONCWRITE(ion_cli_perf_write_double_field(writer, "wall_seconds", perf->wall_seconds));
+    IONCWRITE(ion_cli_perf_write_double_field(writer, "cpu_seconds", perf->cpu_seconds));
+    IONCWRITE(ion_cli_perf_write_phases(writer, perf));
+    IONCWRITE(ion_cli_perf_write_int_field(writer, "bytes_read", perf->stats.bytes_read));
+    IONCWRITE(ion_cli_perf_write_double_field(writer, "bytes_read_per_second",
+                                              ion_cli_perf_rate(perf->stats.bytes_read, perf->wall_seconds)));
+    IONCWRITE(ion_cli_perf_write_int_field(writer, "bytes_written", perf->stats.bytes_written));
+    IONCWRITE(ion_cli_perf_write_double_field(writer, "bytes_written_per_second",
+                                              ion_cli_perf_rate(perf->stats.bytes_written, perf->wall_seconds)));
+    IONCWRITE(ion_cli_perf_write_values(writer, "values_read", perf->stats.values_read, perf->wall_seconds));
+    IONCWRITE(ion_cli_perf_write_values(writer, "values_written", perf->stats.values_written, perf->wall_seconds));
+    IONCWRITE(ion_cli_perf_write_memory(writer, perf));
+    IONCWRITE(ion_cli_perf_write_page_pool(writer, perf));
+    IONCWRITE(ion_writer_finish_container(writer));
+    cRETURN;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2009-2017 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+/**
+ * Performance reports for `ion process --perf-report`. While a command is measured, the library's performance
+ * counters (see ion_perf.h) are enabled, and profiling timers sample the phase the command is in once a millisecond
+ * of CPU time and once a millisecond of wall time. The report is an Ion struct:
+ *
+ *  - `wall_seconds` and `cpu_seconds`: the time the command took.
+ *  - `phases`: for each of `read`, `decode`, `symbols`, `write` and `other` (time outside of Ion's readers and
+ *    writers), the times it was entered, its samples, and the time its share of the samples accounts for.
+ *  - `bytes_read` and `bytes_written`, with rates per second of wall time.
+ *  - `values_read` and `values_written`: for each type, the number of values and their rate per second.
+ *  - `memory`: the peak resident set size, the peak memory held in blocks, and the number of allocations, frees and
+ *    blocks allocated.
+ *  - `page_pool`: the blocks taken from the page pools, the blocks allocated because they had none, and the hit rate.
+ *
+ * Where profiling timers aren't available (on Windows) no samples are taken, and only the totals are reported.
+ */
+
+#ifndef IONC_CLI_PERF_H
+#define IONC_CLI_PERF_H
+
+#include <ctime>
+#include <chrono>
+#include <ionc/ion.h>
+#include "ion_event_util.h"
+#include "ion_event_stream_impl.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+/**
+ * The interval between samples, in microseconds.
+ */
+#define ION_CLI_PERF_SAMPLE_INTERVAL_USEC 1000
+
+class IonCliPerf {
+public:
+    std::chrono::steady_clock::time_point wall_start;
+    std::clock_t cpu_start;
+    double wall_seconds;
+    double cpu_seconds;
+    ION_PERF_STATS stats;
+
+#ifndef _WIN32
+    /**
+     * The handlers and timers that were in place before sampling started, which are put back when it stops so that a
+     * program `ion_cli_main` is embedded in keeps its own.
+     */
+    struct sigaction previous_cpu_action;
+    struct sigaction previous_wall_action;
+    struct itimerval previous_cpu_timer;
+    struct itimerval previous_wall_timer;
+    bool timers_set;
+#endif
+
+    IonCliPerf() {
+        cpu_start = 0;
+        wall_seconds = 0;
+        cpu_seconds = 0;
+        memset(&stats, 0, sizeof(stats));
+#ifndef _WIN32
+        memset(&previous_cpu_action, 0, sizeof(previous_cpu_action));
+        memset(&previous_wall_action, 0, sizeof(previous_wall_action));
+        memset(&previous_cpu_timer, 0, sizeof(previous_cpu_timer));
+        memset(&previous_wall_timer, 0, sizeof(previous_wall_timer));
+        timers_set = false;
+#endif
+    }
+};
+
+/**
+ * Enables the performance counters and starts sampling. Must be called before the readers and writers to be
+ * measured are opened.
+ */
+iERR ion_cli_perf_start(IonCliPerf *perf, IonEventResult *result);
+
+/**
+ * Stops sampling, restoring the signal handlers and timers that were in place before, disables the performance
+ * counters, and collects them.
+ */
+void ion_cli_perf_stop(IonCliPerf *perf);
+
+/**
+ * Writes the report on a measured command as one top-level value.
+ */
+iERR ion_cli_perf_write_report(IonCliPerf *perf, hWRITER writer, IonEventResult *result);
+
+#endif //IONC_CLI_PERF_H
@@ -0,0 +1,787 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+//
+//  micro benchmarks for the ion library. Each benchmark runs a fixed
+//  workload a number of times and reports the cpu time per iteration,
+//  so the numbers are only good for comparing modes (or builds) on
+//  the same machine.
+//
+//      ionbench [ <benchmark> [ <iterations> ] ]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ionc/ion.h>
+#include <ionc/ion_reader_split.h>
+#include "ion_helpers.h"
+#include "ion_binary.h"
+
+#define APP_NAME                "ionbench"
+#define BENCH_DEFAULT_ITERATIONS 20
+#define BENCH_RECORD_COUNT      10000
+
+typedef iERR (*BENCH_FN)(int iterations);
+
+typedef struct _bench
+{
+    const char *name;
+    BENCH_FN    fn;
+    const char *description;
+} BENCH;
+
+iERR bench_binary_writer(int iterations);
+iERR bench_text_skip(int iterations);
+iERR bench_text_floats(int iterations);
+iERR bench_text_numbers(int iterations);
+iERR bench_symbol_table(int iterations);
+iERR bench_binary_nested(int iterations);
+iERR bench_field_sids(int iterations);
+iERR bench_parallel_scan(int iterations);
+
+BENCH g_benchmarks[] = {
+    { "binary_writer", bench_binary_writer, "binary writer with the patch list vs padded container lengths" },
+    { "text_skip",     bench_text_skip,     "text reader skipping over unread containers and long strings" },
+    { "text_floats",   bench_text_floats,   "text writer on a float heavy dataset" },
+    { "text_numbers",  bench_text_numbers,  "text reader reading floats and decimals" },
+    { "symbol_table",  bench_symbol_table,  "interning and finding symbols in a large local symbol table" },
+    { "binary_nested", bench_binary_nested, "binary reader stepping through deeply nested, annotated values" },
+    { "field_sids",    bench_field_sids,    "binary reader on wide structs, and decoding their field sids alone" },
+    { "parallel_scan", bench_parallel_scan, "binary scan of every value, split across 1 and all processors" },
+    { NULL, NULL, NULL }
+};
+
+double bench_ms_per_iteration(clock_t start, clock_t finish, int iterations)
+{
+    return ((double)(finish - start) * 1000.0 / CLOCKS_PER_SEC) / iterations;
+}
+
+iERR bench_write_field(hWRITER writer, char *name)
+{
+    iENTER;
+    ION_STRING str;
+
+    IONCHECK(ion_writer_write_field_name(writer, ion_string_assign_cstr(&str, name, (SIZE)strlen(name))));
+
+    iRETURN;
+}
+
+// writes records shaped like {id:1,name:"record",tags:[a,b,c],point:{x:1.5e0,y:2.5e0},rows:[[1,2],[3,4]]}
+// which is mostly small nested containers, the case the container length handling matters for
+iERR bench_write_records(hWRITER writer, int count)
+{
+    iENTER;
+    ION_STRING str;
+    int        ii, row;
+
+    for (ii = 0; ii < count; ii++) {
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+
+        IONCHECK(bench_write_field(writer, "id"));
+        IONCHECK(ion_writer_write_int64(writer, ii));
+        IONCHECK(bench_write_field(writer, "name"));
+        IONCHECK(ion_writer_write_string(writer, ion_string_assign_cstr(&str, "record", 6)));
+
+        IONCHECK(bench_write_field(writer, "tags"));
+        IONCHECK(ion_writer_start_container(writer, tid_LIST));
+        IONCHECK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&str, "a", 1)));
+        IONCHECK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&str, "b", 1)));
+        IONCHECK(ion_writer_write_symbol(writer, ion_string_assign_cstr(&str, "c", 1)));
+        IONCHECK(ion_writer_finish_container(writer));
+
+        IONCHECK(bench_write_field(writer, "point"));
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+        IONCHECK(bench_write_field(writer, "x"));
+        IONCHECK(ion_writer_write_double(writer, 1.5));
+        IONCHECK(bench_write_field(writer, "y"));
+        IONCHECK(ion_writer_write_double(writer, 2.5));
+        IONCHECK(ion_writer_finish_container(writer));
+
+        IONCHECK(bench_write_field(writer, "rows"));
+        IONCHECK(ion_writer_start_container(writer, tid_LIST));
+        for (row = 0; row < 2; row++) {
+            IONCHECK(ion_writer_start_container(writer, tid_LIST));
+            IONCHECK(ion_writer_write_int64(writer, 2 * row + 1));
+            IONCHECK(ion_writer_write_int64(writer, 2 * row + 2));
+            IONCHECK(ion_writer_finish_container(writer));
+        }
+        IONCHECK(ion_writer_finish_container(writer));
+
+        IONCHECK(ion_writer_finish_container(writer));
+    }
+
+    iRETURN;
+}
+
+iERR bench_binary_writer_run(BOOL pad_container_lengths, int iterations, double *p_ms, POSITION *p_length)
+{
+    iENTER;
+    ION_WRITER_OPTIONS options;
+    ION_STREAM        *stream = NULL;
+    hWRITER            writer = NULL;
+    clock_t            start;
+    int                ii;
+
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    options.pad_container_lengths = pad_container_lengths;
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_stream_open_memory_only(&stream));
+        IONCHECK(ion_writer_open(&writer, stream, &options));
+        IONCHECK(bench_write_records(writer, BENCH_RECORD_COUNT));
+        IONCHECK(ion_writer_close(writer));
+        writer = NULL;
+        *p_length = ion_stream_get_position(stream);
+        IONCHECK(ion_stream_close(stream));
+        stream = NULL;
+    }
+    *p_ms = bench_ms_per_iteration(start, clock(), iterations);
+
+fail:
+    if (writer) ion_writer_close(writer);
+    if (stream) ion_stream_close(stream);
+    return err;
+}
+
+iERR bench_binary_writer(int iterations)
+{
+    iENTER;
+    double   ms;
+    POSITION length;
+
+    IONCHECK(bench_binary_writer_run(FALSE, iterations, &ms, &length));
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "patch list", ms, (long)length);
+    IONCHECK(bench_binary_writer_run(TRUE, iterations, &ms, &length));
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "padded container lengths", ms, (long)length);
+
+    iRETURN;
+}
+
+// a text log shaped document: lists of small structs each holding a long
+// string and a list, none of which the reader steps into
+iERR bench_text_skip_make_input(BYTE **p_buffer, SIZE *p_length)
+{
+    iENTER;
+    const char *entry = "  {level:info, message:\"request handled for user 'someone' in 12ms, "
+                        "nothing of interest here [ok] {done}\", "
+                        "trace:[frame_1, frame_2, \"frame (3)\", '''long frame 4''', (call 5 6)]},\n";
+    SIZE        entry_length = (SIZE)strlen(entry);
+    BYTE       *buffer, *pos;
+    int         ii, jj;
+
+    buffer = (BYTE *)malloc(BENCH_RECORD_COUNT / 10 * (10 * entry_length + 4));
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+
+    pos = buffer;
+    for (ii = 0; ii < BENCH_RECORD_COUNT / 10; ii++) {
+        *pos++ = '[';
+        *pos++ = '\n';
+        for (jj = 0; jj < 10; jj++) {
+            memcpy(pos, entry, entry_length);
+            pos += entry_length;
+        }
+        *pos++ = ']';
+        *pos++ = '\n';
+    }
+    *p_buffer = buffer;
+    *p_length = (SIZE)(pos - buffer);
+
+    iRETURN;
+}
+
+iERR bench_text_skip(int iterations)
+{
+    iENTER;
+    BYTE    *buffer = NULL;
+    SIZE     length;
+    hREADER  reader = NULL;
+    ION_TYPE type;
+    clock_t  start;
+    int      ii;
+
+    IONCHECK(bench_text_skip_make_input(&buffer, &length));
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_reader_open_buffer(&reader, buffer, length, NULL));
+        do {
+            IONCHECK(ion_reader_next(reader, &type));
+        } while (type != tid_EOF);
+        IONCHECK(ion_reader_close(reader));
+        reader = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "skip top level lists",
+           bench_ms_per_iteration(start, clock(), iterations), (long)length);
+
+fail:
+    if (reader) ion_reader_close(reader);
+    if (buffer) free(buffer);
+    return err;
+}
+
+// rows of sensor style readings: a mix of short decimal fractions, values
+// computed in binary (which need all 17 digits) and very large and small magnitudes
+iERR bench_text_floats(int iterations)
+{
+    iENTER;
+    ION_WRITER_OPTIONS options;
+    ION_STREAM        *stream = NULL;
+    hWRITER            writer = NULL;
+    POSITION           length = 0;
+    clock_t            start;
+    int                ii, row;
+
+    memset(&options, 0, sizeof(options));
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_stream_open_memory_only(&stream));
+        IONCHECK(ion_writer_open(&writer, stream, &options));
+        for (row = 0; row < BENCH_RECORD_COUNT; row++) {
+            IONCHECK(ion_writer_start_container(writer, tid_LIST));
+            IONCHECK(ion_writer_write_double(writer, row * 0.25));
+            IONCHECK(ion_writer_write_double(writer, row / 7.0));
+            IONCHECK(ion_writer_write_double(writer, 20.5 + (row % 100) / 10.0));
+            IONCHECK(ion_writer_write_double(writer, 6.02214076e23 * row));
+            IONCHECK(ion_writer_write_double(writer, 1.602176634e-19 / (row + 1)));
+            IONCHECK(ion_writer_finish_container(writer));
+        }
+        IONCHECK(ion_writer_close(writer));
+        writer = NULL;
+        length = ion_stream_get_position(stream);
+        IONCHECK(ion_stream_close(stream));
+        stream = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "write doubles",
+           bench_ms_per_iteration(start, clock(), iterations), (long)length);
+
+fail:
+    if (writer) ion_writer_close(writer);
+    if (stream) ion_stream_close(stream);
+    return err;
+}
+
+// the same sort of rows as bench_text_floats, along with prices and
+// measurements as decimals, written as text
+iERR bench_text_numbers_make_input(BYTE **p_buffer, SIZE *p_length)
+{
+    iENTER;
+    char *buffer, *pos;
+    int   row;
+
+    buffer = (char *)malloc(BENCH_RECORD_COUNT * 256);
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+
+    pos = buffer;
+    for (row = 0; row < BENCH_RECORD_COUNT; row++) {
+        pos += sprintf(pos, "[%.16e, %.16e, %.3e, %.16e, %d.%02d, %d.%06dd-3, -%d.5]\n",
+                       row / 7.0, 6.02214076e23 * row, 20.5 + (row % 100) / 10.0, 1.602176634e-19 / (row + 1),
+                       row, row % 100, row * 31, row % 1000000, row % 1000);
+    }
+    *p_buffer = (BYTE *)buffer;
+    *p_length = (SIZE)(pos - buffer);
+
+    iRETURN;
+}
+
+iERR bench_text_numbers(int iterations)
+{
+    iENTER;
+    BYTE    *buffer = NULL;
+    SIZE     length;
+    hREADER  reader = NULL;
+    ION_TYPE type;
+    double   value;
+    decQuad  quad;
+    clock_t  start;
+    int      ii;
+
+    IONCHECK(bench_text_numbers_make_input(&buffer, &length));
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_reader_open_buffer(&reader, buffer, length, NULL));
+        for (;;) {
+            IONCHECK(ion_reader_next(reader, &type));
+            if (type == tid_EOF) break;
+            IONCHECK(ion_reader_step_in(reader));
+            for (;;) {
+                IONCHECK(ion_reader_next(reader, &type));
+                if (type == tid_EOF) break;
+                if (type == tid_FLOAT) {
+                    IONCHECK(ion_reader_read_double(reader, &value));
+                }
+                else {
+                    IONCHECK(ion_reader_read_decimal(reader, &quad));
+                }
+            }
+            IONCHECK(ion_reader_step_out(reader));
+        }
+        IONCHECK(ion_reader_close(reader));
+        reader = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "read floats and decimals",
+           bench_ms_per_iteration(start, clock(), iterations), (long)length);
+
+fail:
+    if (reader) ion_reader_close(reader);
+    if (buffer) free(buffer);
+    return err;
+}
+
+// local symbol tables of generated field names (which share their prefixes,
+// as they tend to), each name added and then looked up a few times, in an
+// order that has nothing to do with the order they were added in
+#define BENCH_SYMBOL_COUNT      (10 * BENCH_RECORD_COUNT)
+#define BENCH_SYMBOL_MAX_LENGTH 32
+#define BENCH_SYMBOL_STRIDE     7919 // a prime, so this visits every symbol
+
+iERR bench_symbol_table(int iterations)
+{
+    iENTER;
+    hSYMTAB    symtab = NULL;
+    ION_STRING name;
+    SID        sid;
+    clock_t    start;
+    char      *names = NULL, *pos;
+    int        ii, jj, lookup;
+
+    names = (char *)malloc(BENCH_SYMBOL_COUNT * BENCH_SYMBOL_MAX_LENGTH);
+    if (!names) FAILWITH(IERR_NO_MEMORY);
+    for (jj = 0; jj < BENCH_SYMBOL_COUNT; jj++) {
+        sprintf(names + jj * BENCH_SYMBOL_MAX_LENGTH, "customer_field_%d", jj);
+    }
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_symbol_table_open(&symtab, NULL));
+        for (jj = 0; jj < BENCH_SYMBOL_COUNT; jj++) {
+            ion_string_assign_cstr(&name, names + jj * BENCH_SYMBOL_MAX_LENGTH, (SIZE)strlen(names + jj * BENCH_SYMBOL_MAX_LENGTH));
+            IONCHECK(ion_symbol_table_add_symbol(symtab, &name, &sid));
+        }
+        for (lookup = 0; lookup < 4; lookup++) {
+            for (jj = 0; jj < BENCH_SYMBOL_COUNT; jj++) {
+                pos = names + (int)(((int64_t)jj * BENCH_SYMBOL_STRIDE) % BENCH_SYMBOL_COUNT) * BENCH_SYMBOL_MAX_LENGTH;
+                ion_string_assign_cstr(&name, pos, (SIZE)strlen(pos));
+                IONCHECK(ion_symbol_table_find_by_name(symtab, &name, &sid));
+            }
+        }
+        IONCHECK(ion_symbol_table_close(symtab));
+        symtab = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10d symbols\n", "add and find symbols",
+           bench_ms_per_iteration(start, clock(), iterations), BENCH_SYMBOL_COUNT);
+
+fail:
+    if (symtab) ion_symbol_table_close(symtab);
+    if (names) free(names);
+    return err;
+}
+
+// records of annotated containers nested BENCH_NESTED_DEPTH deep, with
+// a couple of scalars at each level: the reader spends its time stepping
+// in and out and collecting annotations rather than reading values
+#define BENCH_NESTED_DEPTH       8
+#define BENCH_NESTED_ANNOTATIONS 3
+
+iERR bench_binary_nested_write(hWRITER writer, int depth)
+{
+    iENTER;
+    ION_STRING str;
+    int        ii;
+
+    for (ii = 0; ii < BENCH_NESTED_ANNOTATIONS; ii++) {
+        IONCHECK(ion_writer_add_annotation(writer, ion_string_assign_cstr(&str, (ii & 1) ? "odd" : "even", (ii & 1) ? 3 : 4)));
+    }
+    IONCHECK(ion_writer_start_container(writer, (depth & 1) ? tid_SEXP : tid_LIST));
+    IONCHECK(ion_writer_write_int64(writer, depth));
+    if (depth < BENCH_NESTED_DEPTH) {
+        IONCHECK(bench_binary_nested_write(writer, depth + 1));
+        IONCHECK(bench_binary_nested_write(writer, depth + 1));
+    }
+    IONCHECK(ion_writer_add_annotation(writer, ion_string_assign_cstr(&str, "leaf", 4)));
+    IONCHECK(ion_writer_write_bool(writer, TRUE));
+    IONCHECK(ion_writer_finish_container(writer));
+
+    iRETURN;
+}
+
+iERR bench_binary_nested_read(hREADER reader, long *p_annotations)
+{
+    iENTER;
+    ION_TYPE   type;
+    ION_STRING annotation;
+    SIZE       count;
+    BOOL       found;
+    int        ii;
+
+    for (;;) {
+        IONCHECK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        IONCHECK(ion_reader_get_annotation_count(reader, &count));
+        for (ii = 0; ii < count; ii++) {
+            IONCHECK(ion_reader_get_an_annotation(reader, ii, &annotation));
+        }
+        IONCHECK(ion_reader_has_annotation(reader, ion_string_assign_cstr(&annotation, "leaf", 4), &found));
+        *p_annotations += count;
+        if (type == tid_LIST || type == tid_SEXP) {
+            IONCHECK(ion_reader_step_in(reader));
+            IONCHECK(bench_binary_nested_read(reader, p_annotations));
+            IONCHECK(ion_reader_step_out(reader));
+        }
+    }
+
+    iRETURN;
+}
+
+iERR bench_binary_nested(int iterations)
+{
+    iENTER;
+    ION_WRITER_OPTIONS options;
+    ION_STREAM        *stream = NULL;
+    hWRITER            writer = NULL;
+    hREADER            reader = NULL;
+    BYTE              *buffer = NULL;
+    POSITION           length;
+    SIZE               copied;
+    clock_t            start;
+    long               annotations = 0;
+    int                ii;
+
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    IONCHECK(ion_stream_open_memory_only(&stream));
+    IONCHECK(ion_writer_open(&writer, stream, &options));
+    for (ii = 0; ii < BENCH_RECORD_COUNT / 100; ii++) {
+        IONCHECK(bench_binary_nested_write(writer, 1));
+    }
+    IONCHECK(ion_writer_close(writer));
+    writer = NULL;
+
+    length = ion_stream_get_position(stream);
+    IONCHECK(ion_stream_seek(stream, 0));
+    buffer = (BYTE *)malloc((size_t)length);
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+    IONCHECK(ion_stream_read(stream, buffer, (SIZE)length, &copied));
+    IONCHECK(ion_stream_close(stream));
+    stream = NULL;
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_reader_open_buffer(&reader, buffer, (SIZE)length, NULL));
+        IONCHECK(bench_binary_nested_read(reader, &annotations));
+        IONCHECK(ion_reader_close(reader));
+        reader = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "step through nested values",
+           bench_ms_per_iteration(start, clock(), iterations), (long)length);
+
+fail:
+    if (reader) ion_reader_close(reader);
+    if (writer) ion_writer_close(writer);
+    if (stream) ion_stream_close(stream);
+    if (buffer) free(buffer);
+    return err;
+}
+
+// records with a couple hundred fields, so most field sids take two bytes,
+// read once through the reader and once as the raw var uints alone
+#define BENCH_FIELD_SID_COUNT 200
+
+iERR bench_field_sids_write(hWRITER writer, int count)
+{
+    iENTER;
+    char name[16];
+    int  ii, field;
+
+    for (ii = 0; ii < count; ii++) {
+        IONCHECK(ion_writer_start_container(writer, tid_STRUCT));
+        for (field = 0; field < BENCH_FIELD_SID_COUNT; field++) {
+            snprintf(name, sizeof(name), "field_%d", field);
+            IONCHECK(bench_write_field(writer, name));
+            IONCHECK(ion_writer_write_int64(writer, (int64_t)ii * field));
+        }
+        IONCHECK(ion_writer_finish_container(writer));
+    }
+
+    iRETURN;
+}
+
+iERR bench_field_sids(int iterations)
+{
+    iENTER;
+    ION_WRITER_OPTIONS options;
+    ION_STREAM        *stream = NULL;
+    hWRITER            writer = NULL;
+    hREADER            reader = NULL;
+    ION_TYPE           type;
+    ION_SYMBOL        *field_name;
+    BYTE              *buffer = NULL;
+    POSITION           length;
+    SIZE               copied, sid_length;
+    clock_t            start;
+    uint64_t           sid, sid_total = 0, sid_seed = 1;
+    int64_t            value;
+    int                ii, jj;
+
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    IONCHECK(ion_stream_open_memory_only(&stream));
+    IONCHECK(ion_writer_open(&writer, stream, &options));
+    IONCHECK(bench_field_sids_write(writer, BENCH_RECORD_COUNT / 10));
+    IONCHECK(ion_writer_close(writer));
+    writer = NULL;
+
+    length = ion_stream_get_position(stream);
+    IONCHECK(ion_stream_seek(stream, 0));
+    buffer = (BYTE *)malloc((size_t)length);
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+    IONCHECK(ion_stream_read(stream, buffer, (SIZE)length, &copied));
+    IONCHECK(ion_stream_close(stream));
+    stream = NULL;
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_reader_open_buffer(&reader, buffer, (SIZE)length, NULL));
+        for (;;) {
+            IONCHECK(ion_reader_next(reader, &type));
+            if (type == tid_EOF) break;
+            IONCHECK(ion_reader_step_in(reader));
+            for (;;) {
+                IONCHECK(ion_reader_next(reader, &type));
+                if (type == tid_EOF) break;
+                IONCHECK(ion_reader_get_field_name_symbol(reader, &field_name));
+                IONCHECK(ion_reader_read_int64(reader, &value));
+            }
+            IONCHECK(ion_reader_step_out(reader));
+        }
+        IONCHECK(ion_reader_close(reader));
+        reader = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "read every field",
+           bench_ms_per_iteration(start, clock(), iterations), (long)length);
+    free(buffer);
+    buffer = NULL;
+
+    // the same number of sids on their own, one to three bytes long in no
+    // particular order, so the branch predictor can't learn the lengths
+    IONCHECK(ion_stream_open_memory_only(&stream));
+    for (jj = 0; jj < BENCH_RECORD_COUNT / 10 * BENCH_FIELD_SID_COUNT; jj++) {
+        sid_seed = sid_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        IONCHECK(ion_binary_write_var_uint_64(stream, (sid_seed >> 40) >> ((sid_seed >> 33) % 20)));
+    }
+    sid_length = (SIZE)ion_stream_get_position(stream);
+    IONCHECK(ion_stream_seek(stream, 0));
+    buffer = (BYTE *)malloc((size_t)sid_length);
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+    IONCHECK(ion_stream_read(stream, buffer, sid_length, &copied));
+    IONCHECK(ion_stream_close(stream));
+    stream = NULL;
+
+    start = clock();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_stream_open_buffer(buffer, sid_length, sid_length, TRUE, &stream));
+        for (jj = 0; jj < BENCH_RECORD_COUNT / 10 * BENCH_FIELD_SID_COUNT; jj++) {
+            IONCHECK(ion_binary_read_var_uint_64(stream, &sid));
+            sid_total += sid;
+        }
+        IONCHECK(ion_stream_close(stream));
+        stream = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "decode var uint sids",
+           bench_ms_per_iteration(start, clock(), iterations), (long)sid_length);
+    if (sid_total == 0) FAILWITH(IERR_INVALID_STATE); // keeps the loop from being optimized away
+
+fail:
+    if (reader) ion_reader_close(reader);
+    if (writer) ion_writer_close(writer);
+    if (stream) ion_stream_close(stream);
+    if (buffer) free(buffer);
+    return err;
+}
+
+// an ionizer style scan: every value is visited and the scalars are read,
+// first on one thread then on one per processor. This reports wall clock
+// time, the cpu time of the threads adds up to about the same in both
+#define BENCH_PARALLEL_RECORD_COUNT (20 * BENCH_RECORD_COUNT)
+
+double bench_wall_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+iERR bench_parallel_scan_values(hREADER reader, int64_t *p_count)
+{
+    iENTER;
+    ION_TYPE   type;
+    ION_STRING str;
+    int64_t    int_value, child_count;
+    double     double_value;
+
+    for (*p_count = 0;; (*p_count)++) {
+        IONCHECK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        if (type == tid_LIST || type == tid_SEXP || type == tid_STRUCT) {
+            IONCHECK(ion_reader_step_in(reader));
+            IONCHECK(bench_parallel_scan_values(reader, &child_count));
+            IONCHECK(ion_reader_step_out(reader));
+        }
+        else if (type == tid_INT) {
+            IONCHECK(ion_reader_read_int64(reader, &int_value));
+        }
+        else if (type == tid_FLOAT) {
+            IONCHECK(ion_reader_read_double(reader, &double_value));
+        }
+        else if (type == tid_STRING || type == tid_SYMBOL) {
+            IONCHECK(ion_reader_read_string(reader, &str));
+        }
+    }
+
+    iRETURN;
+}
+
+// each unit counts its records, so the run can be checked for having seen them all
+iERR bench_parallel_scan_unit(hREADER reader, int64_t unit, void *user_context)
+{
+    return bench_parallel_scan_values(reader, &((int64_t *)user_context)[unit]);
+}
+
+iERR bench_parallel_scan(int iterations)
+{
+    iENTER;
+    ION_WRITER_OPTIONS options;
+    ION_STREAM        *stream = NULL;
+    hWRITER            writer = NULL;
+    hREADER_SPLIT      split = NULL;
+    BYTE              *buffer = NULL;
+    int64_t           *unit_counts = NULL, unit_count, unit, record_count;
+    POSITION           length;
+    SIZE               copied;
+    double             start;
+    int                ii, threads;
+
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    IONCHECK(ion_stream_open_memory_only(&stream));
+    IONCHECK(ion_writer_open(&writer, stream, &options));
+    IONCHECK(bench_write_records(writer, BENCH_PARALLEL_RECORD_COUNT));
+    IONCHECK(ion_writer_close(writer));
+    writer = NULL;
+
+    length = ion_stream_get_position(stream);
+    IONCHECK(ion_stream_seek(stream, 0));
+    buffer = (BYTE *)malloc((size_t)length);
+    if (!buffer) FAILWITH(IERR_NO_MEMORY);
+    IONCHECK(ion_stream_read(stream, buffer, (SIZE)length, &copied));
+    IONCHECK(ion_stream_close(stream));
+    stream = NULL;
+
+    start = bench_wall_ms();
+    for (ii = 0; ii < iterations; ii++) {
+        IONCHECK(ion_reader_split_open_buffer(&split, buffer, (SIZE)length, 0, NULL));
+        IONCHECK(ion_reader_split_close(split));
+        split = NULL;
+    }
+    printf("  %-26s %8.3f ms/iteration %10ld bytes\n", "pre-scan",
+           (bench_wall_ms() - start) / iterations, (long)length);
+
+    // 0 threads is one per processor
+    for (threads = 1; threads >= 0; threads--) {
+        IONCHECK(ion_reader_split_open_buffer(&split, buffer, (SIZE)length, 0, NULL));
+        IONCHECK(ion_reader_split_get_unit_count(split, &unit_count));
+        unit_counts = (int64_t *)calloc((size_t)unit_count, sizeof(int64_t));
+        if (!unit_counts) FAILWITH(IERR_NO_MEMORY);
+        start = bench_wall_ms();
+        for (ii = 0; ii < iterations; ii++) {
+            IONCHECK(ion_reader_split_run(split, threads, &bench_parallel_scan_unit, unit_counts));
+        }
+        printf("  %-26s %8.3f ms/iteration %10ld bytes\n", threads ? "scan on 1 thread" : "scan on every processor",
+               (bench_wall_ms() - start) / iterations, (long)length);
+        for (record_count = 0, unit = 0; unit < unit_count; unit++) {
+            record_count += unit_counts[unit];
+        }
+        if (record_count != BENCH_PARALLEL_RECORD_COUNT) FAILWITH(IERR_INVALID_STATE);
+        free(unit_counts);
+        unit_counts = NULL;
+        IONCHECK(ion_reader_split_close(split));
+        split = NULL;
+    }
+
+fail:
+    if (unit_counts) free(unit_counts);
+    if (split) ion_reader_split_close(split);
+    if (writer) ion_writer_close(writer);
+    if (stream) ion_stream_close(stream);
+    if (buffer) free(buffer);
+    return err;
+}
+
+void bench_usage(void)
+{
+    BENCH *bench;
+
+    fprintf(stderr, "usage: %s [ <benchmark> [ <iterations> ] ]\n", APP_NAME);
+    for (bench = g_benchmarks; bench->name; bench++) {
+        fprintf(stderr, "  %-16s %s\n", bench->name, bench->description);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    iENTER;
+    BENCH      *bench;
+    const char *name = NULL;
+    int         iterations = BENCH_DEFAULT_ITERATIONS;
+    BOOL        found = FALSE;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+            bench_usage();
+            return 0;
+        }
+        name = argv[1];
+    }
+    if (argc > 2) {
+        iterations = atoi(argv[2]);
+        if (iterations < 1) {
+            bench_usage();
+            return 1;
+        }
+    }
+
+    for (bench = g_benchmarks; bench->name; bench++) {
+        if (name && strcmp(name, bench->name) != 0) continue;
+        found = TRUE;
+        printf("%s (%d iterations)\n", bench->name, iterations);
+        IONCHECK(bench->fn(iterations));
+    }
+    if (!found) {
+        bench_usage();
+        return 1;
+    }
+
+fail:
+    if (err != IERR_OK) {
+        fprintf(stderr, "%s failed: %s\n", APP_NAME, ion_error_to_str(err));
+        return 1;
+    }
+    return 0;
+}